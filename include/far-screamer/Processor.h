@@ -0,0 +1,117 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of far-screamer
+ * Created on: 18 окт. 2026 г.
+ *
+ * far-screamer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * far-screamer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with far-screamer. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef FAR_SCREAMER_PROCESSOR_H_
+#define FAR_SCREAMER_PROCESSOR_H_
+
+#include <lsp-plug.in/common/status.h>
+#include <lsp-plug.in/runtime/LSPString.h>
+#include <lsp-plug.in/dsp-units/sampling/Sample.h>
+#include <far-screamer/types.h>
+#include <far-screamer/config.h>
+
+namespace far_screamer
+{
+    using namespace lsp;
+
+    class IRPool;
+
+    /**
+     * Convolution processor for embedding into applications. The impulse
+     * response is loaded and prepared once on initialization, after that
+     * the processor may convolve buffers and files repeatedly. Processing
+     * methods may be called from several threads at the same time, each
+     * call takes its own copy of the configuration. The scratch memory used
+     * by the calling thread is released to the system after each call.
+     *
+     * The interface passes objects of lsp libraries (dspu::Sample, LSPString
+     * and containers of config_t). Symbols of lsp libraries are not exported
+     * by the far-screamer library, so the application links its own copy of
+     * lsp-common-lib, lsp-lltl-lib, lsp-runtime-lib, lsp-dsp-lib and
+     * lsp-dsp-units of exactly the same versions that are listed in the
+     * dependencies.mk file of the far-screamer build: objects are shared by
+     * both copies and should have the same layout. The memory of these objects
+     * is allocated by the standard C library, so it may be released by either copy.
+     */
+    class FAR_SCREAMER_API Processor
+    {
+        private:
+            Processor & operator = (const Processor &);
+            Processor(const Processor &);
+
+        protected:
+            config_t           *pConfig;    // Configuration of the processor
+            IRPool             *pPool;      // Pool of prepared impulse responses
+            callbacks_t         sCallbacks; // Default callbacks of processing calls
+            bool                bCallbacks; // Default callbacks are set
+
+        public:
+            explicit Processor();
+            ~Processor();
+
+        public:
+            /**
+             * Initialize the processor and prepare the impulse response. The
+             * impulse response is prepared immediately if the sample rate of
+             * the configuration is set, otherwise on the first processing call
+             *
+             * @param cfg configuration, the input and output files are ignored
+             * @param cb callbacks receiving log messages, also used by processing
+             *   calls which do not specify own callbacks, may be NULL
+             * @return status of operation
+             */
+            status_t            init(const config_t *cfg, const callbacks_t *cb = NULL);
+
+            /**
+             * Destroy the processor and release the prepared impulse responses
+             */
+            void                destroy();
+
+        public:
+            /**
+             * Convolve the input buffer with the impulse response. The channels
+             * of the mapping refer to channels of the input buffer. The input is
+             * resampled if the sample rate of the configuration is set and
+             * differs from the sample rate of the buffer.
+             *
+             * @param out output buffer
+             * @param in input buffer, the sample rate should be set
+             * @param cb callbacks receiving log messages and progress, NULL to use
+             *   callbacks passed to init()
+             * @return status of operation
+             */
+            status_t            process(dspu::Sample *out, const dspu::Sample *in, const callbacks_t *cb = NULL);
+
+            /**
+             * Convolve the input file with the impulse response and save the
+             * result to the output file
+             *
+             * @param out name of the output file
+             * @param in name of the input file
+             * @param cb callbacks receiving log messages and progress, NULL to use
+             *   callbacks passed to init()
+             * @return status of operation
+             */
+            status_t            process(const LSPString *out, const LSPString *in, const callbacks_t *cb = NULL);
+    };
+}
+
+#endif /* FAR_SCREAMER_PROCESSOR_H_ */
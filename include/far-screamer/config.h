@@ -0,0 +1,146 @@
+/*
+ * Copyright (C) 2021 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2021 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of far-screamer
+ * Created on: 20 мая 2021 г.
+ *
+ * far-screamer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * far-screamer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with far-screamer. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef FAR_SCREAMER_CONFIG_H_
+#define FAR_SCREAMER_CONFIG_H_
+
+#include <lsp-plug.in/common/types.h>
+#include <lsp-plug.in/common/status.h>
+#include <lsp-plug.in/runtime/LSPString.h>
+#include <lsp-plug.in/lltl/darray.h>
+#include <lsp-plug.in/lltl/parray.h>
+#include <lsp-plug.in/dsp-units/filters/common.h>
+#include <far-screamer/types.h>
+
+#define MIN_GAIN                -200.0f     /* Gains (in dB) below the minimum gain turn the signal off */
+#define CONV_RANK               16          /* Maximum FFT rank of convolvers */
+
+namespace far_screamer
+{
+    using namespace lsp;
+
+    typedef struct mapping_t
+    {
+        size_t      out;        // Number of the output channel
+        size_t      in;         // Number of the input channel
+        size_t      ir;         // Number of the IR channel
+        float       gain;       // The applied gain
+    } mapping_t;
+
+    enum normalize_t
+    {
+        NORM_NONE,              // No normalization
+        NORM_ABOVE,             // When the maximum peak is above the threshold
+        NORM_BELOW,             // When the maximum peak is below the threshold
+        NORM_ALWAYS             // Always normalize
+    };
+
+    enum plan_format_t
+    {
+        PLAN_NONE,              // Process the job
+        PLAN_TEXT,              // Output the plan of the job in human-readable form
+        PLAN_JSON               // Output the plan of the job in JSON form
+    };
+
+    enum compact_t
+    {
+        COMPACT_NONE,           // Keep the input as 32-bit floating-point data
+        COMPACT_INT16,          // Keep the input as 16-bit integer data
+        COMPACT_INT24,          // Keep the input as packed 24-bit integer data
+        COMPACT_HALF            // Keep the input as 16-bit floating-point data
+    };
+
+    /**
+     * Overall configuration
+     */
+    struct FAR_SCREAMER_API config_t
+    {
+        private:
+            config_t & operator = (const config_t &);
+
+        public:
+            ssize_t                                 nSampleRate;    // Sample rate
+            float                                   fDry;           // Amount of dry signal
+            float                                   fWet;           // Amount of wet signal
+            float                                   fMid;           // Amount of the middle signal
+            float                                   fSide;          // Amount of the size signal
+            float                                   fPreDelay;      // Pre-delay of the signal
+            float                                   fFadeIn;        // Fade-in length
+            float                                   fFadeOut;       // Fade-out length
+            float                                   fHeadCut;       // Head cut
+            float                                   fTailCut;       // Tail cut
+            ssize_t                                 nNormalize;     // Normalization method
+            float                                   fNormGain;      // Normalization gain
+            bool                                    bTrim;          // Trim to original file
+            bool                                    bDecimate;      // Decimate the band-limited wet signal path
+            bool                                    bDraft;         // Fast draft render with reduced fidelity
+            bool                                    bIncremental;   // Skip processing of up-to-date output files
+            float                                   fTailThreshold; // Threshold of the output tail
+            float                                   fTailWindow;    // Window the tail should stay below the threshold
+            float                                   fSparse;        // Threshold of the sparse IR head detection
+            float                                   fMultirateSplit;    // Split point of the IR for multirate processing
+            ssize_t                                 nMultirateFactor;   // Decimation factor of the late IR part
+            ssize_t                                 nWorkers;       // Number of worker threads in daemon mode
+            wsize_t                                 nMaxMemory;     // Memory budget in bytes, 0 for unlimited
+            wsize_t                                 nWetCacheLimit; // Size limit of the wet stem cache in bytes, 0 for unlimited
+            ssize_t                                 nPlan;          // Output the plan of the job instead of processing
+            ssize_t                                 nCompact;       // Compact storage format of the input
+            double                                  fStart;         // Start of the rendered region (in seconds)
+            double                                  fEnd;           // End of the rendered region (in seconds), negative for the end of the output
+            float                                   fCheckpoint;    // Interval of checkpoints of the out-of-core render (in seconds), non-positive to disable
+            bool                                    bResume;        // Resume the out-of-core render from the last checkpoint
+            ssize_t                                 nShard;         // Index of the rendered shard of the output
+            ssize_t                                 nShards;        // Number of shards of the output, 0 to render the whole output
+            float                                   fCueFade;       // Crossfade window between IRs of the cue list (in milliseconds)
+            LSPString                               sInFile;        // Source file
+            LSPString                               sOutFile;       // Destination file
+            LSPString                               sIRFile;        // Impulse response file
+            LSPString                               sServe;         // UNIX socket path for the daemon mode
+            LSPString                               sWatchDir;      // Directory to watch for new input files
+            LSPString                               sOutDir;        // Output directory for the watch mode
+            LSPString                               sWetCache;      // Directory of the wet stem cache
+            LSPString                               sScratchDir;    // Directory of scratch files for the out-of-core mode
+            LSPString                               sCueList;       // Cue list switching the IR over time
+            dspu::filter_params_t                   sLPF;           // Low-pass filter
+            dspu::filter_params_t                   sHPF;           // Hi-pass filter
+            lltl::darray<mapping_t>                 sMapping;       // Mapping of the IR convolution
+            lltl::parray<LSPString>                 sMerge;         // Shard files to merge into the output file
+            lltl::parray<LSPString>                 sAlbum;         // Input files of the gapless album
+
+        public:
+            explicit config_t();
+            ~config_t();
+
+        public:
+            void clear();
+
+            /**
+             * Copy all settings from another configuration
+             *
+             * @param src configuration to copy
+             * @return status of operation
+             */
+            status_t copy(const config_t *src);
+    };
+}
+
+
+#endif /* FAR_SCREAMER_CONFIG_H_ */
@@ -0,0 +1,73 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of far-screamer
+ * Created on: 18 окт. 2026 г.
+ *
+ * far-screamer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * far-screamer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with far-screamer. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef FAR_SCREAMER_TYPES_H_
+#define FAR_SCREAMER_TYPES_H_
+
+#include <lsp-plug.in/common/types.h>
+
+// Symbols of the library API are visible outside of the shared library
+#if defined(__GNUC__) || defined(__clang__)
+    #define FAR_SCREAMER_API            __attribute__((visibility("default")))
+#else
+    #define FAR_SCREAMER_API
+#endif
+
+namespace far_screamer
+{
+    /**
+     * Level of the log message
+     */
+    enum log_level_t
+    {
+        LOG_INFO,               // Information about the processing
+        LOG_ERROR               // Error or warning
+    };
+
+    /**
+     * Callbacks receiving log messages and progress of processing instead of
+     * the standard output and the standard error. Callbacks are called from
+     * the thread performing the processing.
+     */
+    typedef struct callbacks_t
+    {
+        /**
+         * Log message, NULL to output messages to the standard output and error
+         *
+         * @param arg argument of callbacks
+         * @param level level of the message
+         * @param message text of the message without the trailing line break
+         */
+        void      (*log)(void *arg, log_level_t level, const char *message);
+
+        /**
+         * Progress of the convolution, may be NULL
+         *
+         * @param arg argument of callbacks
+         * @param progress part of the convolution completed, from 0 to 1
+         */
+        void      (*progress)(void *arg, float progress);
+
+        void       *arg;        // Argument passed to callbacks
+    } callbacks_t;
+}
+
+#endif /* FAR_SCREAMER_TYPES_H_ */
@@ -0,0 +1,148 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of far-screamer
+ * Created on: 18 окт. 2026 г.
+ *
+ * far-screamer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * far-screamer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with far-screamer. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef PRIVATE_ARENA_H_
+#define PRIVATE_ARENA_H_
+
+#include <lsp-plug.in/common/types.h>
+
+namespace far_screamer
+{
+    using namespace lsp;
+
+    /**
+     * Arena allocator for temporary buffers of the job. Memory is taken from large
+     * chunks aligned to the huge page boundary by bumping the pointer, each allocation
+     * is aligned for SIMD processing. Buffers are not freed one by one: the owner of
+     * the scope saves the mark before allocation and rewinds the arena to the mark
+     * when buffers are not needed anymore, so nested scopes should be released in the
+     * reverse order. Chunks are kept between jobs to avoid fragmentation of the heap
+     * in the long-running processes.
+     */
+    class Arena
+    {
+        private:
+            Arena & operator = (const Arena &);
+            Arena(const Arena &);
+
+        protected:
+            typedef struct chunk_t
+            {
+                chunk_t        *next;       // Next chunk
+                uint8_t        *data;       // Aligned data of the chunk
+                size_t          size;       // Size of the data
+                size_t          base;       // Position of the chunk in the arena
+                void           *mapping;    // Allocated memory region
+                size_t          mapped;     // Size of the allocated memory region
+            } chunk_t;
+
+        protected:
+            chunk_t        *pHead;          // The first chunk
+            chunk_t        *pCurr;          // The current chunk
+            size_t          nUsed;          // Current position in the arena
+            size_t          nPeak;          // Peak position in the arena since the last reset
+            size_t          nHint;          // Size of the chunk to allocate after the reset
+            wsize_t         nTotal;         // Total number of bytes allocated since the last reset
+
+        protected:
+            static chunk_t *alloc_chunk(size_t size);
+            static void     free_chunk(chunk_t *c);
+            void            free_chunks(chunk_t *c);
+
+        public:
+            explicit Arena();
+            ~Arena();
+
+        public:
+            /**
+             * Allocate memory from the arena
+             *
+             * @param size number of bytes to allocate
+             * @return pointer to the aligned memory or NULL if there is not enough memory
+             */
+            void           *allocate(size_t size);
+
+            /**
+             * Allocate array from the arena
+             *
+             * @param count number of elements
+             * @return pointer to the aligned array or NULL if there is not enough memory
+             */
+            template <class T>
+            inline T       *alloc(size_t count)     { return static_cast<T *>(allocate(count * sizeof(T))); }
+
+            /**
+             * Get the mark of the current position in the arena
+             *
+             * @return the mark of the current position
+             */
+            inline size_t   mark() const            { return nUsed; }
+
+            /**
+             * Release all memory allocated after the mark, marks above the current
+             * position are ignored
+             *
+             * @param mark the mark obtained by the mark() call
+             */
+            void            rewind(size_t mark);
+
+            /**
+             * Release all allocated memory and reset counters before the next job.
+             * If the previous job required several chunks, they are replaced by
+             * one chunk of the peak size on the next allocation.
+             */
+            void            reset();
+
+            /**
+             * Release all memory to the system
+             */
+            void            destroy();
+
+        public:
+            /**
+             * Get the peak amount of memory used since the last reset
+             * @return the peak amount of memory in bytes
+             */
+            inline size_t   peak() const            { return nPeak; }
+
+            /**
+             * Get the total amount of memory allocated since the last reset
+             * @return the total amount of memory in bytes
+             */
+            inline wsize_t  total() const           { return nTotal; }
+
+            /**
+             * Get the amount of memory held by the arena
+             * @return the amount of memory in bytes
+             */
+            size_t          reserved() const;
+    };
+
+    /**
+     * Get the arena of the current thread, each worker thread processes jobs
+     * with its own arena
+     *
+     * @return the arena of the current thread
+     */
+    Arena *thread_arena();
+}
+
+#endif /* PRIVATE_ARENA_H_ */
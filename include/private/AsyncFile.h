@@ -0,0 +1,128 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of far-screamer
+ * Created on: 18 окт. 2026 г.
+ *
+ * far-screamer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * far-screamer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with far-screamer. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef PRIVATE_ASYNCFILE_H_
+#define PRIVATE_ASYNCFILE_H_
+
+#include <lsp-plug.in/common/types.h>
+#include <lsp-plug.in/common/status.h>
+#include <private/WorkerPool.h>
+
+#ifdef PLATFORM_UNIX_COMPATIBLE
+    #include <pthread.h>
+    #include <sys/uio.h>
+#endif /* PLATFORM_UNIX_COMPATIBLE */
+
+#define ASYNC_QUEUE_DEPTH       4           // Number of blocks in flight of audio readers and writers
+
+namespace far_screamer
+{
+    using namespace lsp;
+
+    /**
+     * Asynchronous positional reads and writes of the file with several requests in flight.
+     * On Linux the requests are submitted to the io_uring of the kernel, if the io_uring is
+     * not available the requests are served by the pool of threads performing pread() and
+     * pwrite() calls. On other platforms the requests are served synchronously.
+     */
+    class AsyncFile
+    {
+        private:
+            AsyncFile & operator = (const AsyncFile &);
+            AsyncFile(const AsyncFile &);
+
+        public:
+            typedef struct request_t
+            {
+                void               *buf;        // Buffer with data
+                size_t              size;       // Number of bytes to transfer
+                wsize_t             offset;     // Offset in the file
+                ssize_t             result;     // Number of transferred bytes or negative error code
+                bool                write;      // Write request
+                volatile bool       pending;    // Request is in flight
+            #ifdef PLATFORM_UNIX_COMPATIBLE
+                struct iovec        iov;        // Vector of the io_uring request
+            #endif /* PLATFORM_UNIX_COMPATIBLE */
+            } request_t;
+
+        protected:
+            struct uring_t;
+
+        protected:
+            int                 hFD;            // File descriptor
+            uring_t            *pRing;          // The io_uring of the file
+            size_t              nPending;       // Number of requests in flight of the io_uring
+            WorkerPool          sPool;          // Fallback pool of I/O threads
+        #ifdef PLATFORM_UNIX_COMPATIBLE
+            pthread_mutex_t     sMutex;         // Mutex protecting completion of requests
+            pthread_cond_t      sCond;          // Condition to wake up waiting thread
+        #endif /* PLATFORM_UNIX_COMPATIBLE */
+
+        protected:
+            void                transfer(request_t *req);
+            static void         process_request(void *task, void *arg);
+            void                complete(request_t *req, ssize_t result);
+            status_t            open_ring(size_t depth);
+            status_t            submit_ring(request_t *req);
+            status_t            reap_ring();
+            void                close_ring();
+
+        public:
+            explicit AsyncFile();
+            ~AsyncFile();
+
+        public:
+            /**
+             * Attach to the file descriptor, the descriptor remains owned by the caller
+             *
+             * @param fd file descriptor
+             * @param depth maximum number of requests in flight
+             * @return status of operation
+             */
+            status_t            open(int fd, size_t depth);
+
+            /**
+             * Wait for completion of all pending requests and detach from the file
+             */
+            void                close();
+
+            /**
+             * Submit the request, the request and its buffer should stay valid until it is completed
+             *
+             * @param req request to submit
+             * @return status of operation
+             */
+            status_t            submit(request_t *req);
+
+            /**
+             * Wait for completion of the request
+             *
+             * @param req request to wait for
+             * @return status of operation
+             */
+            status_t            wait(request_t *req);
+
+        public:
+            inline bool         uring() const       { return pRing != NULL; }
+    };
+}
+
+#endif /* PRIVATE_ASYNCFILE_H_ */
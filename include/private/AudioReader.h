@@ -0,0 +1,126 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of far-screamer
+ * Created on: 18 окт. 2026 г.
+ *
+ * far-screamer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * far-screamer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with far-screamer. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef PRIVATE_AUDIOREADER_H_
+#define PRIVATE_AUDIOREADER_H_
+
+#include <lsp-plug.in/common/types.h>
+#include <lsp-plug.in/common/status.h>
+#include <lsp-plug.in/io/Path.h>
+#include <lsp-plug.in/mm/InAudioFileStream.h>
+#include <private/AsyncFile.h>
+#include <private/audio.h>
+
+#include <stdio.h>
+
+namespace far_screamer
+{
+    using namespace lsp;
+
+    /**
+     * Reader of the audio file which decodes frames by blocks directly to the planar
+     * buffers. PCM 16/24/32-bit and 32-bit floating-point WAV, RF64 and Wave64 files
+     * are decoded by the built-in codec which keeps several large blocks of raw data
+     * in flight and converts them channel by channel while the next blocks are read,
+     * all other formats are decoded by the audio file stream of the library.
+     */
+    class AudioReader
+    {
+        public:
+            typedef void (*decode_t)(float *dst, const uint8_t *src, size_t stride, size_t count);
+
+        private:
+            AudioReader & operator = (const AudioReader &);
+            AudioReader(const AudioReader &);
+
+        protected:
+            mm::InAudioFileStream   sStream;        // Fallback stream
+            AsyncFile               sAsync;         // Asynchronous reader of raw data
+            AsyncFile::request_t    vReq[ASYNC_QUEUE_DEPTH];    // Read requests of blocks
+            audio_info_t            sInfo;          // Information about the file
+            FILE                   *pFD;            // File descriptor of the natively decoded file
+            decode_t                pDecode;        // Sample decoding function
+            uint8_t                *pBuf;           // Buffer for raw or interleaved data
+            size_t                  nBlockAlign;    // Size of the frame in bytes
+            size_t                  nBufFrames;     // Capacity of the buffer in frames
+            size_t                  nFrames;        // Number of frames left to read
+            size_t                  nSlot;          // Current read request
+            size_t                  nPos;           // Position in the current block in frames
+            size_t                  nAvail;         // Number of frames available in the current block
+            wsize_t                 nNextOffset;    // Offset of the next block to read
+            wsize_t                 nDataEnd;       // Offset of the end of audio data
+            bool                    bStarted;       // Reading of blocks has been started
+            bool                    bOpened;        // The file is opened
+
+        protected:
+            status_t                start_native();
+            status_t                submit_block(AsyncFile::request_t *req);
+            status_t                open_native(const io::Path *path);
+            status_t                open_stream(const io::Path *path);
+            ssize_t                 read_native(float * const *dst, size_t frames);
+            ssize_t                 read_stream(float * const *dst, size_t frames);
+
+        public:
+            explicit AudioReader();
+            ~AudioReader();
+
+        public:
+            /**
+             * Open the audio file
+             *
+             * @param path path to the file
+             * @return status of operation
+             */
+            status_t                open(const io::Path *path);
+
+            /**
+             * Close the audio file
+             */
+            void                    close();
+
+            /**
+             * Skip frames at the current position. Frames of natively decoded files
+             * are skipped without reading if decoding has not been started yet
+             *
+             * @param frames number of frames to skip
+             * @return status of operation
+             */
+            status_t                skip(size_t frames);
+
+            /**
+             * Decode frames to the planar buffers, channels with NULL buffers are skipped
+             *
+             * @param dst array of pointers to buffers of each channel
+             * @param frames maximum number of frames to decode
+             * @return number of decoded frames, zero at the end of the file or negative error code
+             */
+            ssize_t                 read(float * const *dst, size_t frames);
+
+        public:
+            inline const audio_info_t  *info() const    { return &sInfo;            }
+            inline size_t           channels() const    { return sInfo.channels;    }
+            inline size_t           length() const      { return sInfo.length;      }
+            inline size_t           sample_rate() const { return sInfo.sample_rate; }
+            inline bool             native() const      { return pFD != NULL;       }
+    };
+}
+
+#endif /* PRIVATE_AUDIOREADER_H_ */
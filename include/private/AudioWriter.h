@@ -0,0 +1,101 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of far-screamer
+ * Created on: 18 окт. 2026 г.
+ *
+ * far-screamer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * far-screamer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with far-screamer. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef PRIVATE_AUDIOWRITER_H_
+#define PRIVATE_AUDIOWRITER_H_
+
+#include <lsp-plug.in/common/types.h>
+#include <lsp-plug.in/common/status.h>
+#include <lsp-plug.in/io/Path.h>
+#include <private/AsyncFile.h>
+
+#include <stdio.h>
+
+namespace far_screamer
+{
+    using namespace lsp;
+
+    /**
+     * Writer of the 32-bit floating-point WAV file which encodes frames from the planar
+     * buffers. The number of frames is known before writing, so the header is written
+     * once, the file is promoted to RF64 if it does not fit into 4 GiB and the space for
+     * the whole file is preallocated where supported. Data is written by large blocks
+     * at offsets aligned to the size of the block, several blocks are kept in flight
+     * while the next ones are encoded.
+     */
+    class AudioWriter
+    {
+        private:
+            AudioWriter & operator = (const AudioWriter &);
+            AudioWriter(const AudioWriter &);
+
+        protected:
+            FILE               *pFD;            // File descriptor
+            AsyncFile           sAsync;         // Asynchronous writer of encoded data
+            AsyncFile::request_t    vReq[ASYNC_QUEUE_DEPTH];    // Write requests of blocks
+            uint8_t            *pBuf;           // Buffers of encoded data
+            size_t              nSlot;          // Current write request
+            size_t              nFill;          // Number of bytes in the current buffer
+            wsize_t             nOffset;        // Offset of the current buffer in the file
+            size_t              nChannels;      // Number of channels
+            size_t              nLength;        // Number of frames to write
+            size_t              nWritten;       // Number of frames written
+
+        protected:
+            status_t            complete(AsyncFile::request_t *req);
+            status_t            flush(size_t bytes);
+
+        public:
+            explicit AudioWriter();
+            ~AudioWriter();
+
+        public:
+            /**
+             * Create the audio file and write the header
+             *
+             * @param path path to the file
+             * @param channels number of channels
+             * @param length number of frames to write
+             * @param sample_rate sample rate
+             * @param rf64 write the RF64 header even if the file fits into 4 GiB
+             * @return status of operation
+             */
+            status_t            open(const io::Path *path, size_t channels, size_t length, size_t sample_rate, bool rf64 = false);
+
+            /**
+             * Encode frames from the planar buffers
+             *
+             * @param src array of pointers to buffers of each channel
+             * @param frames number of frames to encode
+             * @return number of encoded frames or negative error code
+             */
+            ssize_t             write(const float * const *src, size_t frames);
+
+            /**
+             * Flush the pending data and close the file
+             *
+             * @return status of operation, error if not all declared frames were written
+             */
+            status_t            close();
+    };
+}
+
+#endif /* PRIVATE_AUDIOWRITER_H_ */
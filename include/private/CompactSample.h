@@ -0,0 +1,133 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of far-screamer
+ * Created on: 18 окт. 2026 г.
+ *
+ * far-screamer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * far-screamer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with far-screamer. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef PRIVATE_COMPACTSAMPLE_H_
+#define PRIVATE_COMPACTSAMPLE_H_
+
+#include <lsp-plug.in/common/types.h>
+#include <lsp-plug.in/common/status.h>
+#include <lsp-plug.in/dsp-units/sampling/Sample.h>
+
+namespace far_screamer
+{
+    using namespace lsp;
+
+    /**
+     * Planar multi-channel audio data stored in the compact format (see compact_t):
+     * 16-bit integer, packed 24-bit integer or 16-bit floating-point samples. Integer
+     * formats keep samples in range [-1 .. 1) and are lossless for the input files of
+     * the same bit depth, samples outside of the range are clipped. The data is
+     * converted from and to the floating-point format by blocks.
+     */
+    class CompactSample
+    {
+        private:
+            CompactSample & operator = (const CompactSample &);
+            CompactSample(const CompactSample &);
+
+        protected:
+            uint8_t        *pData;          // Encoded data
+            size_t          nFormat;        // Storage format
+            size_t          nStride;        // Distance between channels in bytes
+            size_t          nChannels;      // Number of channels
+            size_t          nLength;        // Number of samples per channel
+            size_t          nSampleRate;    // Sample rate
+            wsize_t         nClipped;       // Number of clipped samples
+
+        public:
+            explicit CompactSample();
+            ~CompactSample();
+
+        public:
+            /**
+             * Allocate the storage, the data is initially filled with silence
+             *
+             * @param channels number of channels
+             * @param length number of samples per channel
+             * @param sample_rate sample rate
+             * @param format storage format, should not be COMPACT_NONE
+             * @return status of operation
+             */
+            status_t        init(size_t channels, size_t length, size_t sample_rate, size_t format);
+
+            /**
+             * Release the storage
+             */
+            void            destroy();
+
+            /**
+             * Encode the floating-point data to the channel
+             *
+             * @param channel number of channel
+             * @param offset offset in the channel in samples
+             * @param src floating-point data to encode
+             * @param count number of samples to encode
+             */
+            void            write(size_t channel, size_t offset, const float *src, size_t count);
+
+            /**
+             * Decode the data of the channel to the floating-point format
+             *
+             * @param dst buffer to store floating-point data
+             * @param channel number of channel
+             * @param offset offset in the channel in samples
+             * @param count number of samples to decode
+             */
+            void            read(float *dst, size_t channel, size_t offset, size_t count) const;
+
+            /**
+             * Encode the whole floating-point sample
+             *
+             * @param src sample to encode
+             * @param format storage format
+             * @return status of operation
+             */
+            status_t        encode(const dspu::Sample *src, size_t format);
+
+            /**
+             * Decode the whole data to the floating-point sample
+             *
+             * @param dst sample to store floating-point data
+             * @return status of operation
+             */
+            status_t        decode(dspu::Sample *dst) const;
+
+        public:
+            /**
+             * Get the size of one sample of the storage format
+             *
+             * @param format storage format
+             * @return size of one sample in bytes
+             */
+            static size_t   sample_size(size_t format);
+
+        public:
+            inline bool     valid() const               { return pData != NULL; }
+            inline size_t   format() const              { return nFormat;       }
+            inline size_t   channels() const            { return nChannels;     }
+            inline size_t   length() const              { return nLength;       }
+            inline size_t   sample_rate() const         { return nSampleRate;   }
+            inline wsize_t  clipped() const             { return nClipped;      }
+            inline wsize_t  bytes() const               { return wsize_t(nStride) * nChannels; }
+    };
+}
+
+#endif /* PRIVATE_COMPACTSAMPLE_H_ */
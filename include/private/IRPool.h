@@ -0,0 +1,105 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of far-screamer
+ * Created on: 18 окт. 2026 г.
+ *
+ * far-screamer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * far-screamer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with far-screamer. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef PRIVATE_IRPOOL_H_
+#define PRIVATE_IRPOOL_H_
+
+#include <lsp-plug.in/common/status.h>
+#include <lsp-plug.in/runtime/LSPString.h>
+#include <lsp-plug.in/lltl/parray.h>
+#include <lsp-plug.in/ipc/Mutex.h>
+#include <lsp-plug.in/dsp-units/sampling/Sample.h>
+#include <far-screamer/config.h>
+
+namespace far_screamer
+{
+    using namespace lsp;
+
+    /**
+     * Thread-safe pool of prepared impulse responses. The entries are keyed by
+     * the IR file name, its size and modification time, the sample rate and all
+     * parameters applied to the IR (cuts, fades and filters), so several jobs
+     * sharing the same IR load and prepare it only once, and the IR file edited
+     * on disk is loaded again. Unreferenced entries are evicted in the least
+     * recently used order when the pool exceeds its capacity or the memory
+     * limit.
+     */
+    class IRPool
+    {
+        private:
+            IRPool & operator = (const IRPool &);
+            IRPool(const IRPool &);
+
+        protected:
+            typedef struct entry_t
+            {
+                LSPString       sKey;       // Key of the entry
+                dspu::Sample    sIR;        // Prepared impulse response
+                size_t          nLatency;   // Latency introduced by the IR filters
+                size_t          nRefs;      // Number of references
+                size_t          nAccess;    // Last access time
+            } entry_t;
+
+        protected:
+            ipc::Mutex                  sMutex;     // Mutex for the pool
+            lltl::parray<entry_t>       vEntries;   // List of entries
+            size_t                      nCapacity;  // Maximum number of unreferenced entries
+            wsize_t                     nMemLimit;  // Maximum amount of memory used by entries, 0 for unlimited
+            size_t                      nTick;      // Access counter
+
+        protected:
+            static bool         make_key(LSPString *key, const config_t *cfg);
+            entry_t            *find_entry(const LSPString *key);
+            wsize_t             memory_used() const;
+            void                evict();
+
+        public:
+            explicit IRPool(size_t capacity, wsize_t mem_limit);
+            ~IRPool();
+
+        public:
+            /**
+             * Obtain the prepared impulse response for the configuration, load
+             * and prepare it if it is not present in the pool
+             *
+             * @param ir pointer to store the prepared impulse response
+             * @param latency pointer to store the latency of the impulse response
+             * @param cfg configuration, the sample rate should be set
+             * @param cached pointer to store the flag that the IR was taken from the pool, may be NULL
+             * @return status of operation
+             */
+            status_t            acquire(const dspu::Sample **ir, size_t *latency, const config_t *cfg, bool *cached);
+
+            /**
+             * Release the impulse response previously obtained by acquire()
+             *
+             * @param ir impulse response to release
+             */
+            void                release(const dspu::Sample *ir);
+
+            /**
+             * Drop all unreferenced entries
+             */
+            void                flush();
+    };
+}
+
+#endif /* PRIVATE_IRPOOL_H_ */
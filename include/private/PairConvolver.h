@@ -0,0 +1,130 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of far-screamer
+ * Created on: 18 окт. 2026 г.
+ *
+ * far-screamer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * far-screamer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with far-screamer. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef PRIVATE_PAIRCONVOLVER_H_
+#define PRIVATE_PAIRCONVOLVER_H_
+
+#include <lsp-plug.in/common/types.h>
+
+namespace far_screamer
+{
+    using namespace lsp;
+
+    /**
+     * Convolver of two real channels with two real impulse responses of the same length.
+     * Both channels are packed into the real and imaginary parts of one complex signal,
+     * so each block of data requires only one direct and one reverse FFT for both channels.
+     * The convolution is performed by uniformly partitioned overlap-save method and
+     * introduces the latency of one block. The data of the convolver is allocated from
+     * the arena of the current thread and is released when the caller rewinds the arena.
+     */
+    class PairConvolver
+    {
+        private:
+            PairConvolver & operator = (const PairConvolver &);
+            PairConvolver(const PairConvolver &);
+
+        protected:
+            size_t      nRank;          // FFT rank
+            size_t      nBlock;         // Block size, half of the FFT size
+            size_t      nStride;        // Stride between spectrum data of partitions
+            size_t      nParts;         // Number of IR partitions
+            size_t      nFrame;         // Number of samples in the current block
+            size_t      nHead;          // Position of the latest input spectrum in the delay line
+
+            float      *vInRe;          // Input frame, the first channel
+            float      *vInIm;          // Input frame, the second channel
+            float      *vOutRe;         // Output block, the first channel
+            float      *vOutIm;         // Output block, the second channel
+            float      *vFftRe;         // FFT buffer, real part
+            float      *vFftIm;         // FFT buffer, imaginary part
+            float      *vAcc;           // Accumulated spectrum of both channels
+            float      *vIR;            // Spectrum of IR partitions of both channels
+            float      *vFDL;           // Frequency-domain delay line of input spectrum of both channels
+
+        protected:
+            static size_t   select_rank(size_t length, size_t rank);
+            static size_t   data_size(size_t length, size_t rank);
+
+        protected:
+            void        unpack(float *x0re, float *x0im, float *x1re, float *x1im);
+            void        process_block();
+
+        public:
+            explicit PairConvolver();
+            ~PairConvolver();
+
+        public:
+            /**
+             * Initialize convolver
+             *
+             * @param ir0 impulse response for the first channel, may be NULL
+             * @param ir1 impulse response for the second channel, may be NULL
+             * @param length length of both impulse responses
+             * @param rank the maximum FFT rank
+             * @return true on success
+             */
+            bool        init(const float *ir0, const float *ir1, size_t length, size_t rank);
+
+            /**
+             * Estimate the amount of memory allocated by the convolver
+             *
+             * @param length length of both impulse responses
+             * @param rank the maximum FFT rank
+             * @return the amount of memory in bytes
+             */
+            static size_t   footprint(size_t length, size_t rank);
+
+            /**
+             * Compute the partitioning of the impulse response used by the convolver
+             *
+             * @param block pointer to store the size of the partition and the processing block
+             * @param parts pointer to store the number of partitions
+             * @param length length of both impulse responses
+             * @param rank the maximum FFT rank
+             */
+            static void     partition(size_t *block, size_t *parts, size_t length, size_t rank);
+
+            /**
+             * Destroy convolver
+             */
+            void        destroy();
+
+            /**
+             * Get the latency of the convolver
+             * @return latency of the convolver in samples
+             */
+            inline size_t latency() const   { return nBlock; }
+
+            /**
+             * Process both channels, the data of each channel may be processed in-place
+             *
+             * @param dst0 destination buffer of the first channel, may be NULL
+             * @param dst1 destination buffer of the second channel, may be NULL
+             * @param src0 source buffer of the first channel, NULL means silence
+             * @param src1 source buffer of the second channel, NULL means silence
+             * @param count number of samples to process
+             */
+            void        process(float *dst0, float *dst1, const float *src0, const float *src1, size_t count);
+    };
+}
+
+#endif /* PRIVATE_PAIRCONVOLVER_H_ */
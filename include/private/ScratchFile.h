@@ -0,0 +1,124 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of far-screamer
+ * Created on: 18 окт. 2026 г.
+ *
+ * far-screamer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * far-screamer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with far-screamer. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef PRIVATE_SCRATCHFILE_H_
+#define PRIVATE_SCRATCHFILE_H_
+
+#include <lsp-plug.in/common/types.h>
+#include <lsp-plug.in/common/status.h>
+#include <lsp-plug.in/io/Path.h>
+
+namespace far_screamer
+{
+    using namespace lsp;
+
+    /**
+     * Planar multi-channel audio data stored in the memory-mapped scratch file.
+     * The file is unlinked right after creation, so the storage is returned to the
+     * file system when the object is closed or the process terminates. The named file
+     * can be kept instead to continue the processing after restart. Channels are
+     * aligned to the page boundary and are expected to be accessed sequentially, the
+     * page cache of the operating system holds only the recently touched parts of data.
+     */
+    class ScratchFile
+    {
+        private:
+            ScratchFile & operator = (const ScratchFile &);
+            ScratchFile(const ScratchFile &);
+
+        protected:
+            status_t        map_file(int fd, const io::Path *path, size_t channels, size_t length, bool keep);
+
+        protected:
+            uint8_t        *pData;          // Mapped data
+            size_t          nMapped;        // Size of the mapping in bytes
+            size_t          nStride;        // Distance between channels in bytes
+            size_t          nChannels;      // Number of channels
+            size_t          nLength;        // Number of samples per channel
+            int             hFD;            // File descriptor
+
+        public:
+            explicit ScratchFile();
+            ~ScratchFile();
+
+        public:
+            /**
+             * Create the scratch file in the specified directory and map it to the memory,
+             * the data is initially filled with zeros
+             *
+             * @param dir directory to store the scratch file
+             * @param channels number of channels
+             * @param length number of samples per channel
+             * @return status of operation
+             */
+            status_t        open(const io::Path *dir, size_t channels, size_t length);
+
+            /**
+             * Open the named file which is kept after close and map it to the memory
+             *
+             * @param path path to the file
+             * @param channels number of channels
+             * @param length number of samples per channel
+             * @param keep keep the data of the existing file, otherwise the data is filled with zeros
+             * @return status of operation, STATUS_CORRUPTED if the size of the existing file does not match
+             */
+            status_t        open_file(const io::Path *path, size_t channels, size_t length, bool keep);
+
+            /**
+             * Unmap and close the scratch file, the unnamed scratch file is removed
+             */
+            void            close();
+
+            /**
+             * Write modified data of the mapping to the file and wait for completion
+             *
+             * @return status of operation
+             */
+            status_t        sync();
+
+            /**
+             * Hint the system that the range of the channel will be accessed soon
+             *
+             * @param channel number of channel
+             * @param offset offset of the range in samples
+             * @param count number of samples
+             */
+            void            prefetch(size_t channel, size_t offset, size_t count) const;
+
+            /**
+             * Hint the system that the range of the channel will not be accessed soon,
+             * so the pages can be dropped from the memory, the data is kept in the file
+             *
+             * @param channel number of channel
+             * @param offset offset of the range in samples
+             * @param count number of samples
+             */
+            void            release(size_t channel, size_t offset, size_t count) const;
+
+        public:
+            inline size_t   channels() const            { return nChannels; }
+            inline size_t   length() const              { return nLength;   }
+            inline float   *channel(size_t i)           { return reinterpret_cast<float *>(&pData[i * nStride]); }
+            inline const float *channel(size_t i) const { return reinterpret_cast<const float *>(&pData[i * nStride]); }
+    };
+}
+
+#endif /* PRIVATE_SCRATCHFILE_H_ */
@@ -0,0 +1,120 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of far-screamer
+ * Created on: 18 окт. 2026 г.
+ *
+ * far-screamer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * far-screamer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with far-screamer. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef PRIVATE_WORKERPOOL_H_
+#define PRIVATE_WORKERPOOL_H_
+
+#include <lsp-plug.in/common/types.h>
+#include <lsp-plug.in/common/status.h>
+#include <lsp-plug.in/lltl/darray.h>
+
+#ifdef PLATFORM_UNIX_COMPATIBLE
+    #include <pthread.h>
+#endif /* PLATFORM_UNIX_COMPATIBLE */
+
+namespace far_screamer
+{
+    using namespace lsp;
+
+    /**
+     * Install handlers of SIGINT and SIGTERM which request the daemon to stop
+     */
+    void install_stop_handlers();
+
+    /**
+     * Check that the stop of the daemon has been requested
+     * @return true if the stop has been requested
+     */
+    bool stop_requested();
+
+    /**
+     * Fixed-size pool of worker threads processing the FIFO queue of tasks.
+     * Each worker initializes its own DSP context and does not receive
+     * the stop signals, so they interrupt the blocking calls of the main thread.
+     */
+    class WorkerPool
+    {
+        private:
+            WorkerPool & operator = (const WorkerPool &);
+            WorkerPool(const WorkerPool &);
+
+        public:
+            typedef void (* handler_t)(void *task, void *arg);
+
+        protected:
+            typedef struct node_t
+            {
+                void               *pTask;      // Task to process
+                node_t             *pNext;      // Next task in the queue
+            } node_t;
+
+        protected:
+        #ifdef PLATFORM_UNIX_COMPATIBLE
+            pthread_mutex_t             sMutex;     // Mutex for the queue
+            pthread_cond_t              sCond;      // Condition to wake up workers
+            lltl::darray<pthread_t>     vThreads;   // Worker threads
+        #endif /* PLATFORM_UNIX_COMPATIBLE */
+            node_t                     *pHead;      // Head of the queue
+            node_t                     *pTail;      // Tail of the queue
+            bool                        bShutdown;  // Shutdown flag
+            handler_t                   pHandler;   // Task handler
+            void                       *pArg;       // Argument of the task handler
+
+        protected:
+            static void        *thread_main(void *arg);
+
+        public:
+            explicit WorkerPool();
+            ~WorkerPool();
+
+        public:
+            /**
+             * Start worker threads
+             *
+             * @param workers number of workers, 0 means the number of available CPUs
+             * @param handler the handler of tasks
+             * @param arg the argument passed to the handler
+             * @return status of operation
+             */
+            status_t            start(size_t workers, handler_t handler, void *arg);
+
+            /**
+             * Submit task to the queue
+             *
+             * @param task task to submit
+             * @return true on success
+             */
+            bool                submit(void *task);
+
+            /**
+             * Stop worker threads after processing all pending tasks
+             */
+            void                stop();
+
+            /**
+             * Get number of worker threads
+             * @return number of worker threads
+             */
+            size_t              workers() const;
+    };
+}
+
+#endif /* PRIVATE_WORKERPOOL_H_ */
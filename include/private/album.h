@@ -0,0 +1,46 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of far-screamer
+ * Created on: 18 окт. 2026 г.
+ *
+ * far-screamer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * far-screamer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with far-screamer. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef PRIVATE_ALBUM_H_
+#define PRIVATE_ALBUM_H_
+
+#include <lsp-plug.in/common/status.h>
+#include <far-screamer/config.h>
+
+namespace far_screamer
+{
+    using namespace lsp;
+
+    /**
+     * Render consecutive input files of the gapless album with one prepared impulse
+     * response. The part of each output after the end of its input file (the reverb
+     * tail and the delayed dry signal) is mixed into the head of the next output, so
+     * the concatenation of output files is the output of the concatenated input. Output
+     * files have the names of input files with the .wav extension and are written to
+     * the output directory.
+     *
+     * @param cfg configuration
+     * @return status of operation
+     */
+    status_t render_album(config_t *cfg);
+}
+
+#endif /* PRIVATE_ALBUM_H_ */
@@ -0,0 +1,51 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of far-screamer
+ * Created on: 18 окт. 2026 г.
+ *
+ * far-screamer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * far-screamer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with far-screamer. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef PRIVATE_ANALYSIS_H_
+#define PRIVATE_ANALYSIS_H_
+
+#include <lsp-plug.in/common/types.h>
+#include <lsp-plug.in/lltl/darray.h>
+
+namespace far_screamer
+{
+    using namespace lsp;
+
+    typedef struct tap_t
+    {
+        size_t      offset;     // Offset of the tap (in samples)
+        float       gain;       // Gain of the tap
+    } tap_t;
+
+    /**
+     * Detect the sparse head of the impulse response which consists of a small set of discrete
+     * reflections and can be rendered as a tapped delay line instead of convolution
+     *
+     * @param taps list to store the taps of the sparse head
+     * @param ir impulse response data
+     * @param length length of the impulse response
+     * @param threshold the threshold relative to the IR peak (1.0f = 0 dB) below which samples are considered to be silent
+     * @return the offset of the dense part of the impulse response, zero if there is no sparse head
+     */
+    size_t find_sparse_head(lltl::darray<tap_t> *taps, const float *ir, size_t length, float threshold);
+}
+
+#endif /* PRIVATE_ANALYSIS_H_ */
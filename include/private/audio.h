@@ -23,24 +23,73 @@
 #define PRIVATE_AUDIO_H_
 
 #include <lsp-plug.in/common/status.h>
+#include <lsp-plug.in/io/Path.h>
 #include <lsp-plug.in/runtime/LSPString.h>
 #include <lsp-plug.in/dsp-units/sampling/Sample.h>
 #include <lsp-plug.in/dsp-units/filters/Equalizer.h>
 #include <lsp-plug.in/expr/Resolver.h>
+#include <lsp-plug.in/lltl/darray.h>
+#include <private/CompactSample.h>
 
 namespace far_screamer
 {
     using namespace lsp;
 
+    /**
+     * Information about the audio file
+     */
+    typedef struct audio_info_t
+    {
+        size_t      channels;       // Number of channels
+        size_t      length;         // Number of samples per channel
+        size_t      sample_rate;    // Sample rate
+    } audio_info_t;
+
+    /**
+     * Range of frames of the audio file to load
+     */
+    typedef struct audio_range_t
+    {
+        size_t      offset;         // First frame to load
+        ssize_t     length;         // Number of frames to load, negative to load all frames till the end of the file
+    } audio_range_t;
+
+    /**
+     * Read the information about the audio file from its header without decoding audio data
+     *
+     * @param info structure to store the information
+     * @param name name of the file
+     * @return status of operation
+     */
+    status_t read_audio_info(audio_info_t *info, const LSPString *name);
+
     /**
      * Load audio file
      *
      * @param sample sample to store audio data
      * @param srate desired sample rate
      * @param name name of the file
+     * @param channels ordered list of channels of the file to load, NULL or empty list to load all channels
+     * @param range range of frames at the desired sample rate to load, NULL to load the whole file
      * @return status of operation
      */
-    status_t load_audio_file(dspu::Sample *sample, ssize_t srate, const LSPString *name);
+    status_t load_audio_file(dspu::Sample *sample, ssize_t srate, const LSPString *name,
+        const lltl::darray<size_t> *channels, const audio_range_t *range);
+
+    /**
+     * Load audio file to the compact storage. The file is decoded by blocks directly
+     * to the compact storage if resampling is not required
+     *
+     * @param sample sample to store audio data
+     * @param srate desired sample rate
+     * @param format compact storage format
+     * @param name name of the file
+     * @param channels ordered list of channels of the file to load, NULL or empty list to load all channels
+     * @param range range of frames at the desired sample rate to load, NULL to load the whole file
+     * @return status of operation
+     */
+    status_t load_compact_file(CompactSample *sample, ssize_t srate, size_t format, const LSPString *name,
+        const lltl::darray<size_t> *channels, const audio_range_t *range);
 
     /**
      * Save audio file
@@ -51,6 +100,40 @@ namespace far_screamer
      */
     status_t save_audio_file(dspu::Sample *sample, const LSPString *fname);
 
+    /**
+     * Generate the unique name of the temporary file located in the same directory
+     * as the specified file, the temporary file can be atomically renamed to the
+     * specified file after it has been completely written
+     *
+     * @param tmp path to store the name of the temporary file
+     * @param path path to the file
+     * @return status of operation
+     */
+    status_t make_temp_path(io::Path *tmp, const io::Path *path);
+
+    /**
+     * Prepare writing of the output file: create the parent directory and
+     * generate the name of the temporary file to write the data to
+     *
+     * @param path pointer to store the path to the output file
+     * @param tmp pointer to store the path to the temporary file
+     * @param fname name of the output file
+     * @return status of operation
+     */
+    status_t open_output_file(io::Path *path, io::Path *tmp, const LSPString *fname);
+
+    /**
+     * Atomically replace the output file with the written temporary file
+     *
+     * @param tmp path to the temporary file, removed on error
+     * @param path path to the output file
+     * @param channels number of channels written
+     * @param length number of samples per channel written
+     * @param sample_rate sample rate of the written data
+     * @return status of operation
+     */
+    status_t commit_output_file(io::Path *tmp, const io::Path *path, size_t channels, size_t length, size_t sample_rate);
+
     /**
      * Convolve the specified channel of input audio file with specified channel of the impulse response
      * and add result to specified channel of the output file
@@ -63,14 +146,117 @@ namespace far_screamer
      * @param ir the number of channel in the impulse response
      * @param predelay the predelay in samples of the convolved data
      * @param gain the overall gain of convolution (1.0f = 0 dB)
+     * @param sparse the threshold of the sparse IR head detection relative to IR peak, non-positive value disables detection
+     * @param threshold the threshold of the convolution tail, non-positive value disables tail truncation
+     * @param window the number of samples the tail should stay below threshold to stop computation
+     * @param block the size of the block for streaming convolution, 0 to convolve the whole channel at once
+     * @param conv_length pointer to store the actual length of the convolved data, may be NULL
      * @return status of operation
      */
     status_t convolve(
         dspu::Sample *dst, const dspu::Sample *src, const dspu::Sample *ir,
         size_t dst_ch, size_t src_ch, size_t ir_ch,
-        size_t predelay, float gain
+        size_t predelay, float gain, float sparse,
+        float threshold, size_t window, size_t block, size_t *conv_length
     );
 
+    /**
+     * Convolve the raw channel data with the impulse response and add result to the destination
+     * buffer which should have space for at least src_length + ir_length samples
+     *
+     * @param dst destination buffer to add convolution data
+     * @param src source data
+     * @param src_length number of samples of source data
+     * @param ir impulse response
+     * @param ir_length the length of impulse response
+     * @param gain the overall gain of convolution (1.0f = 0 dB)
+     * @param sparse the threshold of the sparse IR head detection relative to IR peak, non-positive value disables detection
+     * @param threshold the threshold of the convolution tail, non-positive value disables tail truncation
+     * @param window the number of samples the tail should stay below threshold to stop computation
+     * @param block the size of the block for streaming convolution, 0 to convolve the whole channel at once
+     * @param conv_length pointer to store the actual length of the convolved data, may be NULL
+     * @return status of operation
+     */
+    status_t convolve_channel(
+        float *dst, const float *src, size_t src_length, const float *ir, size_t ir_length,
+        float gain, float sparse, float threshold, size_t window, size_t block, size_t *conv_length
+    );
+
+    /**
+     * Convolve two channels of input audio file with two impulse responses of the same length
+     * and add result to the specified channels of the output file. Both channels are processed
+     * at once by the packed complex FFT.
+     *
+     * @param dst destination sample to add convolution data
+     * @param src source sample to use for convolution
+     * @param ir0 impulse response for the first channel with the gain applied
+     * @param ir1 impulse response for the second channel with the gain applied
+     * @param ir_length the length of both impulse responses
+     * @param dst_ch0 the number of destination channel for the first channel
+     * @param dst_ch1 the number of destination channel for the second channel
+     * @param src_ch0 the number of source channel for the first channel
+     * @param src_ch1 the number of source channel for the second channel
+     * @param predelay the predelay in samples of the convolved data
+     * @param threshold the threshold of the convolution tail, non-positive value disables tail truncation
+     * @param window the number of samples the tail should stay below threshold to stop computation
+     * @param block the size of the block for streaming convolution, 0 to convolve the whole channel at once
+     * @param conv_length pointer to store the actual length of the convolved data, may be NULL
+     * @return status of operation
+     */
+    status_t convolve_pair(
+        dspu::Sample *dst, const dspu::Sample *src,
+        const float *ir0, const float *ir1, size_t ir_length,
+        size_t dst_ch0, size_t dst_ch1, size_t src_ch0, size_t src_ch1,
+        size_t predelay, float threshold, size_t window, size_t block, size_t *conv_length
+    );
+
+    /**
+     * Convolve two raw channels with two impulse responses of the same length and add result
+     * to the destination buffers which should have space for at least src_length + ir_length samples
+     *
+     * @param dst0 destination buffer for the first channel
+     * @param dst1 destination buffer for the second channel
+     * @param src0 source data of the first channel
+     * @param src1 source data of the second channel
+     * @param src_length number of samples of source data
+     * @param ir0 impulse response for the first channel with the gain applied
+     * @param ir1 impulse response for the second channel with the gain applied
+     * @param ir_length the length of both impulse responses
+     * @param threshold the threshold of the convolution tail, non-positive value disables tail truncation
+     * @param window the number of samples the tail should stay below threshold to stop computation
+     * @param block the size of the block for streaming convolution, 0 to convolve the whole channel at once
+     * @param conv_length pointer to store the actual length of the convolved data, may be NULL
+     * @return status of operation
+     */
+    status_t convolve_channel_pair(
+        float *dst0, float *dst1, const float *src0, const float *src1, size_t src_length,
+        const float *ir0, const float *ir1, size_t ir_length,
+        float threshold, size_t window, size_t block, size_t *conv_length
+    );
+
+    /**
+     * Detect the length of the sample after which all channels stay below the threshold
+     * for the specified window
+     *
+     * @param src sample to analyze
+     * @param from the minimum position to start the analysis from
+     * @param threshold the threshold of the signal (absolute value)
+     * @param window the number of samples the signal should stay below threshold
+     * @return the detected length of the sample
+     */
+    size_t detect_tail_length(const dspu::Sample *src, size_t from, float threshold, size_t window);
+
+    /**
+     * Find the position after the last sample of the channel which is above the threshold
+     *
+     * @param buf channel data
+     * @param length the length of channel data
+     * @param from the minimum position to start the analysis from
+     * @param threshold the threshold of the signal (absolute value)
+     * @return the position after the last loud sample, or from if there is no such sample
+     */
+    size_t detect_channel_tail(const float *buf, size_t length, size_t from, float threshold);
+
 
     /**
      * Add latency to the sample
@@ -109,6 +295,14 @@ namespace far_screamer
      */
     status_t cut_sample(dspu::Sample *dst, size_t head_cut, size_t tail_cut, size_t fade_in, size_t fade_out);
 
+    /**
+     * Keep only the range of samples
+     * @param dst sample to crop
+     * @param offset the first sample to keep
+     * @param length maximum number of samples to keep
+     */
+    void crop_sample(dspu::Sample *dst, size_t offset, size_t length);
+
     /**
      * Normalize sample to the specified gain
      * @param dst sample to normalize
@@ -117,6 +311,15 @@ namespace far_screamer
      * @return status of operation
      */
     status_t normalize(dspu::Sample *dst, float gain, size_t mode);
+
+    /**
+     * Compute the gain to apply for normalization of the signal with the specified peak
+     * @param peak the peak of the signal
+     * @param gain the maximum peak gain
+     * @param mode the normalization mode
+     * @return the gain to apply, 1.0f if no normalization is required
+     */
+    float normalize_gain(float peak, float gain, size_t mode);
 }
 
 
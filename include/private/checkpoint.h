@@ -0,0 +1,111 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of far-screamer
+ * Created on: 18 окт. 2026 г.
+ *
+ * far-screamer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * far-screamer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with far-screamer. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef PRIVATE_CHECKPOINT_H_
+#define PRIVATE_CHECKPOINT_H_
+
+#include <lsp-plug.in/common/types.h>
+#include <lsp-plug.in/common/status.h>
+#include <lsp-plug.in/io/Path.h>
+#include <far-screamer/config.h>
+#include <private/ScratchFile.h>
+
+namespace far_screamer
+{
+    using namespace lsp;
+
+    /**
+     * The state of the checkpointed render. The output accumulated so far lives in the
+     * partial output file, samples before the pending offset are final, the pending
+     * range contains overlapping tails of the convolution which are stored in the
+     * checkpoint, and the range up to the limit may be modified until the next checkpoint.
+     */
+    typedef struct checkpoint_t
+    {
+        uint64_t        job;        // Signature of the job
+        size_t          position;   // Number of processed frames of the input
+        size_t          pending;    // Offset of output samples which are not final
+        size_t          tail;       // End of output samples accumulated so far
+        size_t          limit;      // End of output samples which may be modified until the next checkpoint
+        size_t          wet_end;    // End of the wet signal rendered so far
+    } checkpoint_t;
+
+    /**
+     * Get the length of input segments processed between checkpoints
+     *
+     * @param cfg configuration
+     * @param srate sample rate of the input
+     * @return length of the segment in samples, 0 if checkpoints are disabled
+     */
+    size_t checkpoint_segment(const config_t *cfg, size_t srate);
+
+    /**
+     * Get paths of the checkpoint and the partial output stored alongside the output file
+     *
+     * @param state path to store the path of the checkpoint
+     * @param data path to store the path of the partial output
+     * @param cfg configuration
+     * @return status of operation
+     */
+    status_t checkpoint_paths(io::Path *state, io::Path *data, const config_t *cfg);
+
+    /**
+     * Load the checkpoint and restore the pending range of the partial output,
+     * samples modified after the checkpoint has been stored are cleared
+     *
+     * @param cp checkpoint to load
+     * @param out partial output
+     * @param path path to the checkpoint
+     * @param job signature of the job, the checkpoint of another job is not loaded
+     * @return status of operation, STATUS_NOT_FOUND if there is no checkpoint,
+     *   STATUS_CORRUPTED if the checkpoint does not match the job
+     */
+    status_t load_checkpoint(checkpoint_t *cp, ScratchFile *out, const io::Path *path, uint64_t job);
+
+    /**
+     * Write the partial output to the disk and atomically replace the checkpoint
+     *
+     * @param cp checkpoint to store
+     * @param out partial output
+     * @param path path to the checkpoint
+     * @return status of operation
+     */
+    status_t save_checkpoint(const checkpoint_t *cp, ScratchFile *out, const io::Path *path);
+
+    /**
+     * Stop the checkpointed render after the specified number of segments, the render
+     * returns STATUS_CANCELLED and can be resumed later. Used by tests to simulate
+     * interruption of the render.
+     *
+     * @param segments number of segments rendered in one run, 0 for unlimited
+     */
+    void limit_checkpoints(size_t segments);
+
+    /**
+     * Check that the checkpointed render should be stopped
+     *
+     * @param segments number of segments rendered in the current run
+     * @return true if the render should be stopped
+     */
+    bool checkpoint_limit_reached(size_t segments);
+}
+
+#endif /* PRIVATE_CHECKPOINT_H_ */
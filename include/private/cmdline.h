@@ -23,7 +23,7 @@
 #define PRIVATE_CMDLINE_H_
 
 #include <lsp-plug.in/common/status.h>
-#include <private/config.h>
+#include <far-screamer/config.h>
 
 namespace far_screamer
 {
@@ -46,6 +46,31 @@ namespace far_screamer
      * @return status of operation
      */
     status_t parse_cmdline(config_t *cfg, int argc, const char **argv);
+
+    /**
+     * Check that all mandatory parameters are present in the configuration
+     * @param cfg configuration
+     * @return status of operation
+     */
+    status_t check_mandatory(const config_t *cfg);
+
+    /**
+     * Parse floating-point value
+     * @param dst pointer to store the value
+     * @param val text representation of the value
+     * @param parameter name of the parameter for error reporting
+     * @return status of operation
+     */
+    status_t parse_cmdline_float(float *dst, const char *val, const char *parameter);
+
+    /**
+     * Parse time in seconds, optionally prefixed with minutes and hours: [[hh:]mm:]ss[.sss]
+     * @param dst pointer to store the time (in seconds)
+     * @param val text representation of the time
+     * @param parameter name of the parameter for error reporting
+     * @return status of operation
+     */
+    status_t parse_cmdline_time(double *dst, const char *val, const char *parameter);
 }
 
 
@@ -0,0 +1,66 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of far-screamer
+ * Created on: 18 окт. 2026 г.
+ *
+ * far-screamer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * far-screamer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with far-screamer. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef PRIVATE_CUES_H_
+#define PRIVATE_CUES_H_
+
+#include <lsp-plug.in/common/status.h>
+#include <lsp-plug.in/lltl/parray.h>
+#include <lsp-plug.in/runtime/LSPString.h>
+#include <far-screamer/config.h>
+
+namespace far_screamer
+{
+    using namespace lsp;
+
+    /**
+     * Render the input file with the impulse response switched at cues of the cue list.
+     * The IR file of the configuration is active from the start of the input, each cue
+     * activates its own IR file with the wet gain of the cue. Each IR convolves only the
+     * part of the input between its cue and the next one, weighted by linear crossfades
+     * centered at cues, and reverb tails of the previous IR ring out naturally. Weights of
+     * parts sum to one, so the cost of the render is proportional to the length of the input
+     * rather than to the length of the input multiplied by the number of IR files.
+     *
+     * @param cfg configuration
+     * @param fp fingerprint of the job stored alongside the output file in incremental mode, may be NULL
+     * @return status of operation
+     */
+    status_t render_cues(config_t *cfg, const LSPString *fp);
+
+    /**
+     * Get names of IR files of the cue list in the order of cues
+     *
+     * @param files list to store names of files
+     * @param cfg configuration
+     * @return status of operation
+     */
+    status_t cue_files(lltl::parray<LSPString> *files, const config_t *cfg);
+
+    /**
+     * Destroy names of IR files obtained by cue_files()
+     *
+     * @param files list of names of files
+     */
+    void destroy_cue_files(lltl::parray<LSPString> *files);
+}
+
+#endif /* PRIVATE_CUES_H_ */
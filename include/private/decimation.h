@@ -0,0 +1,73 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of far-screamer
+ * Created on: 18 окт. 2026 г.
+ *
+ * far-screamer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * far-screamer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with far-screamer. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef PRIVATE_DECIMATION_H_
+#define PRIVATE_DECIMATION_H_
+
+#include <lsp-plug.in/common/status.h>
+#include <lsp-plug.in/dsp-units/sampling/Sample.h>
+#include <lsp-plug.in/dsp-units/filters/common.h>
+
+namespace far_screamer
+{
+    using namespace lsp;
+
+    /**
+     * Compute the decimation factor for the signal band-limited by the low-pass filter
+     *
+     * @param srate the sample rate of the signal
+     * @param lpf the parameters of the low-pass filter
+     * @return the decimation factor, 1 if decimation is not possible
+     */
+    size_t decimation_factor(size_t srate, const dspu::filter_params_t *lpf);
+
+    /**
+     * Apply the anti-aliasing filter to the sample and decimate it
+     *
+     * @param dst destination sample to store decimated data
+     * @param src source sample to decimate
+     * @param factor decimation factor
+     * @param used flags of channels to decimate, other channels are filled with zeros, NULL to decimate all channels
+     * @return status of operation
+     */
+    status_t decimate_sample(dspu::Sample *dst, const dspu::Sample *src, size_t factor, const bool *used);
+
+    /**
+     * Interpolate the channel of the decimated sample back to the original sample rate
+     * and add it to the channel of the destination sample
+     *
+     * @param dst destination sample to add interpolated data
+     * @param src source decimated sample
+     * @param dst_ch the number of destination channel
+     * @param src_ch the number of source channel
+     * @param offset the offset in the destination channel to add data
+     * @param factor decimation factor
+     * @param gain the gain of the interpolated signal (1.0f = 0 dB)
+     * @return status of operation
+     */
+    status_t interpolate_channel(
+        dspu::Sample *dst, const dspu::Sample *src,
+        size_t dst_ch, size_t src_ch,
+        size_t offset, size_t factor, float gain
+    );
+}
+
+#endif /* PRIVATE_DECIMATION_H_ */
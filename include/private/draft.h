@@ -0,0 +1,96 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of far-screamer
+ * Created on: 18 окт. 2026 г.
+ *
+ * far-screamer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * far-screamer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with far-screamer. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef PRIVATE_DRAFT_H_
+#define PRIVATE_DRAFT_H_
+
+#include <lsp-plug.in/common/status.h>
+#include <lsp-plug.in/lltl/darray.h>
+#include <lsp-plug.in/dsp-units/sampling/Sample.h>
+#include <far-screamer/config.h>
+
+namespace far_screamer
+{
+    using namespace lsp;
+
+    /**
+     * Output channel of the draft render which is identical to another output channel
+     */
+    typedef struct draft_copy_t
+    {
+        size_t          dst;        // Number of the output channel to restore
+        size_t          src;        // Number of the rendered output channel
+    } draft_copy_t;
+
+    /**
+     * Output channels of the draft render which are rendered once and copied
+     */
+    typedef struct draft_t
+    {
+        size_t                          channels;   // Number of channels of the whole output
+        lltl::darray<draft_copy_t>      copies;     // Channels to restore after rendering
+    } draft_t;
+
+    /**
+     * Compute the decimation factor of the wet signal path in the draft mode
+     *
+     * @param cfg configuration
+     * @param srate sample rate of the processed signal
+     * @return the decimation factor, 1 if the draft mode is disabled
+     */
+    size_t draft_factor(const config_t *cfg, size_t srate);
+
+    /**
+     * Apply the draft settings to the prepared impulse response: truncate the tail
+     * which contains the negligible part of the energy, replace nearly identical
+     * channels with their mono sum, and output the estimated deviation of the wet
+     * signal from the full render
+     *
+     * @param ir prepared impulse response
+     * @param cfg configuration
+     * @return status of operation
+     */
+    status_t draft_impulse_response(dspu::Sample *ir, const config_t *cfg);
+
+    /**
+     * Find output channels which are rendered from the same input channels with the
+     * same impulse response and gains, and remove the mapping of duplicates, so each
+     * of such channels is rendered once
+     *
+     * @param d draft state to store channels to restore
+     * @param cfg configuration
+     * @param in_channels number of input channels
+     * @param ir prepared impulse response
+     * @return status of operation
+     */
+    status_t draft_paths(draft_t *d, config_t *cfg, size_t in_channels, const dspu::Sample *ir);
+
+    /**
+     * Restore output channels which have been rendered once
+     *
+     * @param out rendered output
+     * @param d draft state
+     * @return status of operation
+     */
+    status_t restore_paths(dspu::Sample *out, const draft_t *d);
+}
+
+#endif /* PRIVATE_DRAFT_H_ */
@@ -0,0 +1,60 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of far-screamer
+ * Created on: 18 окт. 2026 г.
+ *
+ * far-screamer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * far-screamer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with far-screamer. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef PRIVATE_DRYRUN_H_
+#define PRIVATE_DRYRUN_H_
+
+#include <lsp-plug.in/common/status.h>
+#include <far-screamer/config.h>
+#include <private/audio.h>
+#include <private/planner.h>
+
+namespace far_screamer
+{
+    using namespace lsp;
+
+    /**
+     * Output the plan of the job without processing audio data. Only headers of the
+     * input and IR files are read, the mapping is expanded the same way as for the
+     * processing. The plan contains the list of convolutions with the partitioning of
+     * the impulse response, the estimated number of floating-point operations, the peak
+     * memory footprint, the size of the output file and the processing time estimated
+     * by the short calibration benchmark of the convolver.
+     *
+     * @param cfg configuration
+     * @return status of operation
+     */
+    status_t dry_run(config_t *cfg);
+
+    /**
+     * Plan the job from headers of the input and IR files the same way as the dry run
+     * does, so the memory footprint of the job is known before audio data is decoded.
+     * The configuration is not modified.
+     *
+     * @param plan plan to store the selected strategy and its memory footprint
+     * @param in information about the input file
+     * @param cfg configuration
+     * @return status of operation
+     */
+    status_t plan_job(plan_t *plan, audio_info_t *in, const config_t *cfg);
+}
+
+#endif /* PRIVATE_DRYRUN_H_ */
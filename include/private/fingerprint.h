@@ -0,0 +1,68 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of far-screamer
+ * Created on: 18 окт. 2026 г.
+ *
+ * far-screamer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * far-screamer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with far-screamer. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef PRIVATE_FINGERPRINT_H_
+#define PRIVATE_FINGERPRINT_H_
+
+#include <lsp-plug.in/common/status.h>
+#include <lsp-plug.in/runtime/LSPString.h>
+#include <far-screamer/config.h>
+
+namespace far_screamer
+{
+    using namespace lsp;
+
+    /**
+     * Compute the fingerprint of the job: the hash of the input file, the IR file
+     * and all processing parameters of the configuration, and compare it with the
+     * fingerprint stored alongside the output file. Content hashes of the input
+     * and IR files are reused from the stored fingerprint if size and modification
+     * time of files did not change.
+     *
+     * @param fp string to store the fingerprint of the job
+     * @param up_to_date pointer to store the flag that the output file exists and is up to date
+     * @param cfg configuration
+     * @return status of operation
+     */
+    status_t check_fingerprint(LSPString *fp, bool *up_to_date, const config_t *cfg);
+
+    /**
+     * Store the fingerprint alongside the output file
+     *
+     * @param fp fingerprint of the job
+     * @param cfg configuration
+     * @return status of operation
+     */
+    status_t save_fingerprint(const LSPString *fp, const config_t *cfg);
+
+    /**
+     * Compute the signature of the job which identifies the input and IR files by
+     * their size and modification time, and all processing parameters. Unlike the
+     * fingerprint, the signature does not require reading contents of files.
+     *
+     * @param sig pointer to store the signature
+     * @param cfg configuration
+     * @return status of operation
+     */
+    status_t job_signature(uint64_t *sig, const config_t *cfg);
+}
+
+#endif /* PRIVATE_FINGERPRINT_H_ */
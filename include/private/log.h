@@ -0,0 +1,65 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of far-screamer
+ * Created on: 18 окт. 2026 г.
+ *
+ * far-screamer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * far-screamer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with far-screamer. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef PRIVATE_LOG_H_
+#define PRIVATE_LOG_H_
+
+#include <far-screamer/types.h>
+
+#if defined(__GNUC__) || defined(__clang__)
+    #define LOG_FORMAT(fmt_idx, arg_idx)    __attribute__((format(printf, fmt_idx, arg_idx)))
+#else
+    #define LOG_FORMAT(fmt_idx, arg_idx)
+#endif
+
+namespace far_screamer
+{
+    /**
+     * Set callbacks of the current thread which receive log messages and progress
+     *
+     * @param cb callbacks, NULL to output messages to the standard output and error
+     * @return previously set callbacks of the current thread
+     */
+    const callbacks_t *set_callbacks(const callbacks_t *cb);
+
+    /**
+     * Output the information message, the message is formatted like by printf()
+     *
+     * @param fmt format of the message
+     */
+    void log_info(const char *fmt, ...) LOG_FORMAT(1, 2);
+
+    /**
+     * Output the error message, the message is formatted like by printf()
+     *
+     * @param fmt format of the message
+     */
+    void log_error(const char *fmt, ...) LOG_FORMAT(1, 2);
+
+    /**
+     * Report the progress of the convolution
+     *
+     * @param progress part of the convolution completed, from 0 to 1
+     */
+    void log_progress(float progress);
+}
+
+#endif /* PRIVATE_LOG_H_ */
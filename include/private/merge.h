@@ -0,0 +1,54 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of far-screamer
+ * Created on: 18 окт. 2026 г.
+ *
+ * far-screamer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * far-screamer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with far-screamer. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef PRIVATE_MERGE_H_
+#define PRIVATE_MERGE_H_
+
+#include <lsp-plug.in/common/status.h>
+#include <far-screamer/config.h>
+
+namespace far_screamer
+{
+    using namespace lsp;
+
+    /**
+     * Merge shards of the output rendered by separate processes into the output file.
+     * Shards are consecutive parts of the output which are concatenated in the order
+     * of the configuration, the normalization is computed for the whole output, so
+     * the result is identical to the output rendered by a single process. Shards should
+     * be shards 0 .. N-1 of the same job, that is checked by their shard info files.
+     *
+     * @param cfg configuration
+     * @return status of operation
+     */
+    status_t merge_shards(const config_t *cfg);
+
+    /**
+     * Store the shard info file alongside the output file of the shard: the index of the shard,
+     * the number of shards and the signature of the job. Does nothing if the output is not a shard.
+     *
+     * @param cfg configuration
+     * @return status of operation
+     */
+    status_t save_shard_info(const config_t *cfg);
+}
+
+#endif /* PRIVATE_MERGE_H_ */
@@ -0,0 +1,73 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of far-screamer
+ * Created on: 18 окт. 2026 г.
+ *
+ * far-screamer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * far-screamer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with far-screamer. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef PRIVATE_MULTIRATE_H_
+#define PRIVATE_MULTIRATE_H_
+
+#include <lsp-plug.in/common/status.h>
+#include <lsp-plug.in/dsp-units/sampling/Sample.h>
+
+namespace far_screamer
+{
+    using namespace lsp;
+
+    /**
+     * Split the impulse response into the early part processed at the original sample rate
+     * and the late part processed at the decimated sample rate. Both parts are crossfaded
+     * around the split point, so their sum is equal to the original impulse response.
+     *
+     * @param early the early part of the impulse response
+     * @param late the late part of the impulse response
+     * @param offset the offset of the late part relative to the beginning of the impulse response
+     * @param ir the impulse response to split
+     * @param split the split point (in samples)
+     * @param factor decimation factor of the late part
+     * @return status of operation
+     */
+    status_t split_impulse_response(
+        dspu::Sample *early, dspu::Sample *late, size_t *offset,
+        const dspu::Sample *ir, size_t split, size_t factor
+    );
+
+    /**
+     * Estimate the error introduced by processing the late part of the impulse response
+     * at the decimated sample rate
+     *
+     * @param error the maximum over all channels ratio of error energy to the energy of the impulse response
+     * @param ir the impulse response
+     * @param split the split point (in samples)
+     * @param factor decimation factor of the late part
+     * @return status of operation
+     */
+    status_t multirate_error(float *error, const dspu::Sample *ir, size_t split, size_t factor);
+
+    /**
+     * Output the accuracy report of multirate processing for several split points
+     *
+     * @param ir the impulse response
+     * @param split the selected split point (in samples)
+     * @param factor decimation factor of the late part
+     * @return status of operation
+     */
+    status_t multirate_report(const dspu::Sample *ir, size_t split, size_t factor);
+}
+
+#endif /* PRIVATE_MULTIRATE_H_ */
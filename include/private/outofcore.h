@@ -0,0 +1,49 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of far-screamer
+ * Created on: 18 окт. 2026 г.
+ *
+ * far-screamer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * far-screamer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with far-screamer. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef PRIVATE_OUTOFCORE_H_
+#define PRIVATE_OUTOFCORE_H_
+
+#include <lsp-plug.in/common/status.h>
+#include <lsp-plug.in/runtime/LSPString.h>
+#include <far-screamer/config.h>
+
+namespace far_screamer
+{
+    using namespace lsp;
+
+    /**
+     * Render the output file out of core. The input, the wet accumulation and the
+     * output live in memory-mapped scratch files in the scratch directory, so the
+     * length of the input is limited by the free space of the file system instead
+     * of the amount of RAM. The input is decoded, convolved and encoded by blocks
+     * with sequential access to the scratch files, only the prepared impulse response
+     * is kept in memory. The input is not resampled, and the wet signal is rendered
+     * by the direct convolution.
+     *
+     * @param cfg configuration
+     * @param fp fingerprint of the job to store alongside the output file in incremental mode
+     * @return status of operation
+     */
+    status_t render_out_of_core(config_t *cfg, const LSPString *fp);
+}
+
+#endif /* PRIVATE_OUTOFCORE_H_ */
@@ -0,0 +1,117 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of far-screamer
+ * Created on: 18 окт. 2026 г.
+ *
+ * far-screamer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * far-screamer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with far-screamer. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef PRIVATE_PIPELINE_H_
+#define PRIVATE_PIPELINE_H_
+
+#include <lsp-plug.in/common/status.h>
+#include <lsp-plug.in/dsp-units/sampling/Sample.h>
+#include <private/CompactSample.h>
+
+namespace far_screamer
+{
+    using namespace lsp;
+
+    /**
+     * Channel layouts which have specialized processing pipelines
+     */
+    enum layout_t
+    {
+        LAYOUT_GENERIC,         // Arbitrary mapping
+        LAYOUT_1X1,             // Mono input, mono IR
+        LAYOUT_1XN,             // Mono input, multichannel IR, each IR channel produces an output channel
+        LAYOUT_NX1,             // Multichannel input, mono IR, all input channels are mixed to mono output
+        LAYOUT_2X2,             // Stereo input, stereo IR
+        LAYOUT_2X4              // Stereo input, TrueReverb IR
+    };
+
+    /**
+     * Parameters of the processing pipeline
+     */
+    typedef struct render_t
+    {
+        size_t      latency;    // Latency of the dry signal
+        size_t      predelay;   // Pre-delay of the wet signal
+        float       dry;        // Gain of the dry signal
+        float       wet;        // Gain of the wet signal
+        float       mid;        // Gain of the middle part of the output
+        float       side;       // Gain of the side part of the output
+        float       threshold;  // Threshold of the convolution tail, non-positive value disables tail truncation
+        size_t      window;     // Number of samples the tail should stay below threshold to stop computation
+    } render_t;
+
+    /**
+     * Check that the layout has the specialized pipeline for the specified number of channels
+     *
+     * @param layout channel layout
+     * @param channels the number of input channels for LAYOUT_NX1 or IR channels for LAYOUT_1XN
+     * @return true if there is specialized pipeline
+     */
+    bool layout_supported(layout_t layout, size_t channels);
+
+    /**
+     * Estimate the amount of memory allocated by the specialized pipeline in addition
+     * to the input, the impulse response and the output samples
+     *
+     * @param out_channels number of output channels
+     * @param in_channels number of input channels decoded from the compact input, 0 for floating-point input
+     * @param ir_length length of the impulse response
+     * @return the amount of memory in bytes
+     */
+    size_t layout_footprint(size_t out_channels, size_t in_channels, size_t ir_length);
+
+    /**
+     * Render the output using the specialized pipeline: the dry signal, the wet signal
+     * and the mid/side balance are mixed by blocks of data. The output sample should be
+     * allocated to hold the whole output data.
+     *
+     * @param wet_end pointer to store the end of the wet signal in the output sample
+     * @param out output sample
+     * @param in input sample
+     * @param ir impulse response
+     * @param layout channel layout
+     * @param params pipeline parameters
+     * @return status of operation
+     */
+    status_t render_layout(
+        size_t *wet_end, dspu::Sample *out, const dspu::Sample *in, const dspu::Sample *ir,
+        layout_t layout, const render_t *params
+    );
+
+    /**
+     * Render the output using the specialized pipeline from the compact input,
+     * the input is decoded by blocks of data
+     *
+     * @param wet_end pointer to store the end of the wet signal in the output sample
+     * @param out output sample
+     * @param in compact input sample
+     * @param ir impulse response
+     * @param layout channel layout
+     * @param params pipeline parameters
+     * @return status of operation
+     */
+    status_t render_layout(
+        size_t *wet_end, dspu::Sample *out, const CompactSample *in, const dspu::Sample *ir,
+        layout_t layout, const render_t *params
+    );
+}
+
+#endif /* PRIVATE_PIPELINE_H_ */
@@ -0,0 +1,122 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of far-screamer
+ * Created on: 18 окт. 2026 г.
+ *
+ * far-screamer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * far-screamer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with far-screamer. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef PRIVATE_PLANNER_H_
+#define PRIVATE_PLANNER_H_
+
+#include <lsp-plug.in/common/types.h>
+
+namespace far_screamer
+{
+    using namespace lsp;
+
+    /**
+     * Processing strategy of the wet signal
+     */
+    enum strategy_t
+    {
+        STRATEGY_PIPELINE,      // Specialized pipeline for the typical channel layout
+        STRATEGY_IN_MEMORY,     // Convolution of the whole channel into the temporary buffer
+        STRATEGY_STREAMING      // Convolution by blocks of data directly into the output
+    };
+
+    /**
+     * Dimensions and processing settings of the job
+     */
+    typedef struct workload_t
+    {
+        size_t      in_channels;    // Number of input channels
+        size_t      in_length;      // Length of the input
+        size_t      in_sample;      // Size of the input sample in memory in bytes
+        size_t      ir_channels;    // Number of IR channels
+        size_t      ir_length;      // Length of the impulse response
+        size_t      out_channels;   // Number of output channels
+        size_t      out_length;     // Length of the output
+        size_t      mappings;       // Number of mappings
+        size_t      factor;         // Decimation factor of the wet signal path, 1 if disabled
+        ssize_t     split;          // Split point for the multirate processing, negative if disabled
+        size_t      mr_factor;      // Decimation factor of the late IR part for the multirate processing
+        bool        sparse;         // Sparse IR head detection is enabled
+        bool        pipeline;       // The specialized pipeline is available for the channel layout
+        bool        stems;          // The wet stem cache is enabled
+    } workload_t;
+
+    /**
+     * Processing plan of the job
+     */
+    typedef struct plan_t
+    {
+        strategy_t  strategy;       // Processing strategy of the wet signal
+        size_t      block;          // Block size for the streaming convolution, 0 for the whole channel
+        bool        stems;          // Use the wet stem cache
+        bool        fits;           // The plan fits into the memory budget
+        wsize_t     footprint;      // Estimated peak memory footprint in bytes
+        wsize_t     reserved;       // Amount of memory reserved from the budget in bytes
+    } plan_t;
+
+    /**
+     * Initialize the plan with the default strategy
+     *
+     * @param plan plan to initialize
+     */
+    void init_plan(plan_t *plan);
+
+    /**
+     * Estimate the memory footprint of each strategy and select the fastest one that fits
+     * into the memory budget. If no strategy fits, the one with the lowest footprint is
+     * selected. Strategies are tried in the following order: the wet stem cache, the
+     * specialized pipeline or in-memory convolution, streaming convolution with decreasing
+     * block size.
+     *
+     * @param plan plan to store the selected strategy
+     * @param w the workload of the job
+     * @param budget the memory budget in bytes, 0 for unlimited
+     */
+    void make_plan(plan_t *plan, const workload_t *w, wsize_t budget);
+
+    /**
+     * Output the selected plan
+     *
+     * @param plan the plan to output
+     * @param budget the memory budget in bytes
+     */
+    void print_plan(const plan_t *plan, wsize_t budget);
+
+    /**
+     * Reserve the estimated footprint of the plan from the memory budget shared by all
+     * jobs of the process. The call blocks while other jobs hold too much of the budget,
+     * so the number of jobs processed in parallel is reduced to fit into the budget.
+     * The job is never blocked if no other jobs hold the budget.
+     *
+     * @param plan the plan to reserve memory for
+     * @param budget the memory budget in bytes, 0 for unlimited
+     */
+    void reserve_memory(plan_t *plan, wsize_t budget);
+
+    /**
+     * Return memory reserved by the plan to the budget
+     *
+     * @param plan the plan to release memory for
+     */
+    void release_memory(plan_t *plan);
+}
+
+#endif /* PRIVATE_PLANNER_H_ */
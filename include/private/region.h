@@ -0,0 +1,99 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of far-screamer
+ * Created on: 18 окт. 2026 г.
+ *
+ * far-screamer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * far-screamer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with far-screamer. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef PRIVATE_REGION_H_
+#define PRIVATE_REGION_H_
+
+#include <lsp-plug.in/common/status.h>
+#include <lsp-plug.in/dsp-units/sampling/Sample.h>
+#include <private/audio.h>
+#include <far-screamer/config.h>
+#include <private/planner.h>
+
+namespace far_screamer
+{
+    using namespace lsp;
+
+    /**
+     * The region of the output file to render. The input is decoded from the aligned
+     * position ahead of the region which covers the length of the impulse response,
+     * so all samples of the region are computed from the same input data by the same
+     * processing blocks as the samples of the whole output file.
+     */
+    typedef struct region_t
+    {
+        audio_range_t   input;      // Range of the input file to decode, includes the pre-roll
+        size_t          in_length;  // Length of the whole input at the processing sample rate
+        size_t          head;       // Number of rendered samples ahead of the region
+        ssize_t         length;     // Length of the region, negative for the rest of the output
+    } region_t;
+
+    /**
+     * Check that the configuration requests rendering of the region
+     *
+     * @param cfg configuration
+     * @return true if only the region of the output file should be rendered
+     */
+    bool region_enabled(const config_t *cfg);
+
+    /**
+     * Set the sample rate of the configuration to the sample rate of the input file
+     * if it is not specified. The pre-roll of the region depends on the prepared
+     * impulse response, so the sample rate should be known before the input is loaded.
+     *
+     * @param cfg configuration
+     * @return status of operation
+     */
+    status_t region_sample_rate(config_t *cfg);
+
+    /**
+     * Compute the range of the input file to decode for the region of the configuration
+     *
+     * @param region region to initialize
+     * @param cfg configuration, the sample rate should be set
+     * @param ir_length length of the prepared impulse response
+     * @param latency latency of the prepared impulse response
+     * @param verbose output the region and the range of the input
+     * @return status of operation
+     */
+    status_t init_region(region_t *region, const config_t *cfg, size_t ir_length, size_t latency, bool verbose);
+
+    /**
+     * Make the workload of the whole output from the workload of the region, the
+     * processing strategy is selected for the whole output to produce the same samples
+     *
+     * @param dst workload of the whole output
+     * @param w workload of the region
+     * @param region region of the output
+     */
+    void whole_workload(workload_t *dst, const workload_t *w, const region_t *region);
+
+    /**
+     * Drop samples of the rendered output outside of the region
+     *
+     * @param out rendered output
+     * @param region region of the output
+     * @return status of operation
+     */
+    status_t crop_region(dspu::Sample *out, const region_t *region);
+}
+
+#endif /* PRIVATE_REGION_H_ */
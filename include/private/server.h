@@ -0,0 +1,48 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of far-screamer
+ * Created on: 18 окт. 2026 г.
+ *
+ * far-screamer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * far-screamer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with far-screamer. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef PRIVATE_SERVER_H_
+#define PRIVATE_SERVER_H_
+
+#include <lsp-plug.in/common/status.h>
+#include <far-screamer/config.h>
+
+namespace far_screamer
+{
+    using namespace lsp;
+
+    /**
+     * Run the tool as a daemon serving convolution jobs on the UNIX socket specified
+     * in the configuration. Each job is a single line of command-line arguments
+     * which override the arguments passed to the daemon. Jobs are processed by the
+     * pool of worker threads, prepared impulse responses are shared between jobs.
+     * For each job the daemon responds with a single line containing the status
+     * and the timing of the job. The daemon stops on SIGINT or SIGTERM.
+     *
+     * @param cfg configuration of the daemon
+     * @param argc number of command line arguments of the daemon
+     * @param argv command line arguments of the daemon
+     * @return status of operation
+     */
+    status_t serve(const config_t *cfg, int argc, const char **argv);
+}
+
+#endif /* PRIVATE_SERVER_H_ */
@@ -0,0 +1,59 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of far-screamer
+ * Created on: 18 окт. 2026 г.
+ *
+ * far-screamer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * far-screamer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with far-screamer. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef PRIVATE_STEMS_H_
+#define PRIVATE_STEMS_H_
+
+#include <lsp-plug.in/common/status.h>
+#include <lsp-plug.in/dsp-units/sampling/Sample.h>
+#include <far-screamer/config.h>
+
+namespace far_screamer
+{
+    using namespace lsp;
+
+    /**
+     * Add the wet signal to the output by mixing the wet stems. The wet stem is the
+     * result of convolution of one input channel with one IR channel at unit gain.
+     * Stems are stored in the cache directory under the key computed from the contents
+     * of the input channel, the prepared IR channel and the parameters of the wet signal
+     * path, so the change of gains, mid/side balance or normalization does not require
+     * the convolution to be performed again. Missing stems are rendered and stored in the
+     * cache.
+     *
+     * @param wet_end pointer to store the end of the wet signal in the output
+     * @param out output sample
+     * @param in input sample
+     * @param ir prepared impulse response
+     * @param cfg configuration
+     * @param predelay pre-delay of the wet signal in samples
+     * @param factor decimation factor of the wet signal path, 1 if decimation is disabled
+     * @param split split point of the impulse response for multirate processing, negative if disabled
+     * @param sparse the threshold for detection of the sparse IR head, 0 to disable
+     * @param block the size of the block for streaming convolution, 0 to convolve the whole channel at once
+     * @return status of operation
+     */
+    status_t mix_wet_stems(
+        size_t *wet_end, dspu::Sample *out, const dspu::Sample *in, const dspu::Sample *ir,
+        const config_t *cfg, size_t predelay, size_t factor, ssize_t split, float sparse, size_t block);
+}
+
+#endif /* PRIVATE_STEMS_H_ */
@@ -22,8 +22,294 @@
 #ifndef PRIVATE_TOOL_H_
 #define PRIVATE_TOOL_H_
 
+#include <lsp-plug.in/common/status.h>
+#include <lsp-plug.in/lltl/darray.h>
+#include <lsp-plug.in/runtime/LSPString.h>
+#include <lsp-plug.in/dsp-units/sampling/Sample.h>
+#include <far-screamer/config.h>
+#include <private/IRPool.h>
+#include <private/pipeline.h>
+#include <private/planner.h>
+#include <private/region.h>
+
 namespace far_screamer
 {
+    using namespace lsp;
+
+    /**
+     * Route of the wet signal from the input channel to the output channel,
+     * all IR channels of the route are summed and convolved at once
+     */
+    typedef struct route_t
+    {
+        size_t      in;         // Number of the input channel
+        size_t      out;        // Number of the output channel
+    } route_t;
+
+    /**
+     * Check that the mapping routes the input channel to the output channel
+     *
+     * @param cfg configuration
+     * @param oc number of the output channel
+     * @param ic number of the input channel
+     * @return true if there is a mapping between channels
+     */
+    bool contains_mapping(const config_t *cfg, size_t oc, size_t ic);
+
+    /**
+     * Find the route between channels
+     *
+     * @param routes list of routes
+     * @param in number of the input channel
+     * @param out number of the output channel
+     * @return pointer to the route or NULL if there is no such route
+     */
+    route_t *find_route(lltl::darray<route_t> *routes, size_t in, size_t out);
+
+    /**
+     * Sum all IR channels of the route with the gains of the mapping
+     *
+     * @param dst destination buffer of the IR length
+     * @param ir impulse response
+     * @param cfg configuration
+     * @param r route
+     * @param k additional gain of the wet signal
+     */
+    void mix_route_ir(float *dst, const dspu::Sample *ir, const config_t *cfg, const route_t *r, float k);
+
+    /**
+     * Convolve the input with the impulse response according to the mapping and add
+     * the wet signal to the output at the original sample rate
+     *
+     * @param wet_end pointer to store the end of the wet signal in the output
+     * @param out output sample
+     * @param in input sample
+     * @param ir impulse response
+     * @param cfg configuration
+     * @param predelay pre-delay of the wet signal in samples
+     * @param k additional gain of the wet signal
+     * @param sparse the threshold for detection of the sparse IR head, 0 to disable
+     * @param tail_thresh the threshold for early stop of the convolution, 0 to disable
+     * @param tail_window the window for early stop of the convolution in samples
+     * @param block the size of the block for streaming convolution, 0 to convolve the whole channel at once
+     * @return status of operation
+     */
+    status_t convolve_direct(
+        size_t *wet_end, dspu::Sample *out, const dspu::Sample *in, const dspu::Sample *ir,
+        const config_t *cfg, size_t predelay, float k,
+        float sparse, float tail_thresh, size_t tail_window, size_t block);
+
+    /**
+     * Convolve the input with the impulse response according to the mapping and add
+     * the wet signal to the output at the sample rate decimated by the specified factor
+     *
+     * @param wet_end pointer to store the end of the wet signal in the output
+     * @param out output sample
+     * @param in input sample
+     * @param ir impulse response
+     * @param cfg configuration
+     * @param predelay pre-delay of the wet signal in samples
+     * @param factor decimation factor
+     * @param sparse the threshold for detection of the sparse IR head, 0 to disable
+     * @param tail_thresh the threshold for early stop of the convolution, 0 to disable
+     * @param tail_window the window for early stop of the convolution in samples
+     * @param block the size of the block for streaming convolution, 0 to convolve the whole channel at once
+     * @return status of operation
+     */
+    status_t convolve_decimated(
+        size_t *wet_end, dspu::Sample *out, const dspu::Sample *in, const dspu::Sample *ir,
+        const config_t *cfg, size_t predelay, size_t factor,
+        float sparse, float tail_thresh, size_t tail_window, size_t block);
+
+    /**
+     * Convolve the input with the early part of the impulse response at the original
+     * sample rate and with the late part at the decimated sample rate
+     *
+     * @param wet_end pointer to store the end of the wet signal in the output
+     * @param out output sample
+     * @param in input sample
+     * @param ir impulse response
+     * @param cfg configuration
+     * @param predelay pre-delay of the wet signal in samples
+     * @param split the split point of the impulse response in samples
+     * @param factor decimation factor of the late part
+     * @param sparse the threshold for detection of the sparse IR head, 0 to disable
+     * @param tail_thresh the threshold for early stop of the convolution, 0 to disable
+     * @param tail_window the window for early stop of the convolution in samples
+     * @param block the size of the block for streaming convolution, 0 to convolve the whole channel at once
+     * @return status of operation
+     */
+    status_t convolve_multirate(
+        size_t *wet_end, dspu::Sample *out, const dspu::Sample *in, const dspu::Sample *ir,
+        const config_t *cfg, size_t predelay, size_t split, size_t factor,
+        float sparse, float tail_thresh, size_t tail_window, size_t block);
+
+    /**
+     * Compute the latency introduced by the IR filters without processing the impulse response
+     *
+     * @param latency pointer to store the latency in samples
+     * @param cfg configuration
+     * @return status of operation
+     */
+    status_t filter_latency(size_t *latency, const config_t *cfg);
+
+    /**
+     * Generate the mapping for typical configurations of the input and IR files
+     * if the mapping is not explicitly specified, and detect the channel layout
+     *
+     * @param layout pointer to store the channel layout
+     * @param cfg configuration
+     * @param in_channels number of input channels
+     * @param ir_channels number of IR channels
+     * @param verbose output the information about the applied convolution schema
+     * @return status of operation
+     */
+    status_t expand_mapping(layout_t *layout, config_t *cfg, size_t in_channels, size_t ir_channels, bool verbose);
+
+    /**
+     * Expand the mapping and describe the workload of the job for the planner
+     *
+     * @param w pointer to store the workload
+     * @param layout pointer to store the channel layout
+     * @param cfg configuration
+     * @param in_channels number of input channels
+     * @param in_length length of the input
+     * @param ir_channels number of IR channels
+     * @param ir_length length of the prepared impulse response
+     * @param latency latency of the impulse response
+     * @param verbose output the information about the selected processing method
+     * @return status of operation
+     */
+    status_t make_workload(
+        workload_t *w, layout_t *layout, config_t *cfg,
+        size_t in_channels, size_t in_length, size_t ir_channels, size_t ir_length,
+        size_t latency, bool verbose);
+
+    /**
+     * Check that the output file is up to date when the incremental mode is enabled
+     *
+     * @param fp string to store the fingerprint of the job
+     * @param up_to_date pointer to store the flag that the output is up to date
+     * @param cfg configuration
+     * @return status of operation
+     */
+    status_t check_output(LSPString *fp, bool *up_to_date, const config_t *cfg);
+
+    /**
+     * Select channels of the input or impulse response file referenced by the mapping
+     * and renumber the mapping in the order of selected channels, so only these channels
+     * are loaded. The list stays empty if all channels should be loaded: the mapping is
+     * generated automatically, uses all channels or refers to missing channels.
+     *
+     * @param list list to store the ordered channels of the file to load
+     * @param cfg configuration
+     * @param ir select channels of the impulse response file instead of the input file
+     * @param verbose output the selected channels
+     * @return status of operation
+     */
+    status_t select_channels(lltl::darray<size_t> *list, config_t *cfg, bool ir, bool verbose);
+
+    /**
+     * Load the input file, the sample rate of the configuration is updated
+     * to match the sample rate of the loaded file. If the compact storage is
+     * enabled, the input file is loaded to the compact sample only. Only the
+     * channels referenced by the mapping are loaded.
+     *
+     * @param in the sample to store the input file
+     * @param cin the compact sample to store the input file
+     * @param cfg configuration
+     * @param range range of the input file to load, NULL to load the whole file
+     * @return status of operation
+     */
+    status_t load_input(dspu::Sample *in, CompactSample *cin, config_t *cfg, const audio_range_t *range);
+
+    /**
+     * Load the impulse response file at the sample rate of the configuration,
+     * apply cuts, fades and filters to it
+     *
+     * @param ir the sample to store the prepared impulse response
+     * @param latency pointer to store the latency introduced by filters
+     * @param cfg configuration
+     * @param channels ordered list of channels of the file to load, NULL or empty list to load all channels
+     * @return status of operation
+     */
+    status_t prepare_ir(dspu::Sample *ir, size_t *latency, const config_t *cfg, const lltl::darray<size_t> *channels);
+
+    /**
+     * Convolve the input with the prepared impulse response, identical output
+     * channels of the draft render are rendered once
+     *
+     * @param out output sample
+     * @param in input sample
+     * @param cin compact input sample, used instead of the input sample if it is valid
+     * @param ir prepared impulse response
+     * @param latency latency of the impulse response
+     * @param cfg configuration
+     * @param region region of the output, NULL for the whole output
+     * @param plan plan of the job to store, the reserved memory should be released after use
+     * @return status of operation
+     */
+    status_t render_sample(
+        dspu::Sample *out, const dspu::Sample *in, const CompactSample *cin, const dspu::Sample *ir,
+        size_t latency, config_t *cfg, const region_t *region, plan_t *plan);
+
+    /**
+     * Apply trimming, cropping of the region and normalization to the output
+     *
+     * @param out output sample
+     * @param in_length length of the input
+     * @param cfg configuration
+     * @param region region of the output to keep, NULL to keep the whole output
+     * @return status of operation
+     */
+    status_t finish_output(dspu::Sample *out, size_t in_length, const config_t *cfg, const region_t *region);
+
+    /**
+     * Plan the job from headers of the input and IR files and reserve its estimated memory
+     * footprint from the budget before audio data is decoded, so the call blocks while other
+     * jobs hold too much of the budget. If no plan fits into the budget and the input is not
+     * resampled, the scratch directory of the configuration is set to the directory of the
+     * output file and no memory is reserved: the job should be rendered out of core.
+     * The compact storage of the input is disabled if the selected strategy is not the
+     * specialized pipeline, as other strategies decode the whole input before processing.
+     *
+     * @param plan plan to initialize and reserve memory for, should be released after use
+     * @param cfg configuration
+     * @return status of operation
+     */
+    status_t reserve_job(plan_t *plan, config_t *cfg);
+
+    /**
+     * Convolve the input with the prepared impulse response, apply trimming,
+     * normalization and save the result to the output file
+     *
+     * @param in input sample
+     * @param cin compact input sample, used instead of the input sample if it is valid
+     * @param ir prepared impulse response
+     * @param latency latency of the impulse response
+     * @param cfg configuration
+     * @param region region of the output to keep, NULL to keep the whole output
+     * @param fp fingerprint of the job to store alongside the output file in incremental mode
+     * @param plan plan of the job with the memory reserved by reserve_job(), released after use
+     * @return status of operation
+     */
+    status_t render_output(
+        const dspu::Sample *in, const CompactSample *cin, const dspu::Sample *ir,
+        size_t latency, config_t *cfg, const region_t *region, const LSPString *fp, plan_t *plan);
+
+    /**
+     * Render the output file of the job, the prepared impulse response is taken
+     * from the pool. The output file is not rendered if it is up to date.
+     *
+     * @param cfg configuration of the job
+     * @param pool pool of prepared impulse responses
+     * @param ir_time pointer to store the time (in milliseconds) of obtaining the IR from the pool
+     * @param cached pointer to store the flag that the IR was taken from the pool
+     * @param skipped pointer to store the flag that the output file is up to date
+     * @return status of operation
+     */
+    status_t render_job(config_t *cfg, IRPool *pool, double *ir_time, bool *cached, bool *skipped);
+
     int main(int argc, const char **argv);
 }
 
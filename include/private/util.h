@@ -0,0 +1,55 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of far-screamer
+ * Created on: 18 окт. 2026 г.
+ *
+ * far-screamer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * far-screamer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with far-screamer. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef PRIVATE_UTIL_H_
+#define PRIVATE_UTIL_H_
+
+#include <lsp-plug.in/common/types.h>
+
+#include <time.h>
+
+namespace far_screamer
+{
+    /**
+     * Get the value of the monotonic clock
+     *
+     * @return time in milliseconds
+     */
+    inline double time_ms()
+    {
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return ts.tv_sec * 1000.0 + ts.tv_nsec * 1e-6;
+    }
+
+    /**
+     * Convert the amount of memory to mebibytes for reporting
+     *
+     * @param bytes amount of memory in bytes
+     * @return amount of memory in mebibytes
+     */
+    inline double mib(wsize_t bytes)
+    {
+        return double(bytes) / double(1 << 20);
+    }
+}
+
+#endif /* PRIVATE_UTIL_H_ */
@@ -0,0 +1,47 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of far-screamer
+ * Created on: 18 окт. 2026 г.
+ *
+ * far-screamer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * far-screamer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with far-screamer. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef PRIVATE_WATCH_H_
+#define PRIVATE_WATCH_H_
+
+#include <lsp-plug.in/common/status.h>
+#include <far-screamer/config.h>
+
+namespace far_screamer
+{
+    using namespace lsp;
+
+    /**
+     * Watch the directory specified in the configuration and process each file
+     * which has been completely written or moved into the directory. The result
+     * is stored to the output directory with the same file name. Files are processed
+     * by the pool of worker threads, the prepared impulse response stays resident
+     * in memory. Watching stops on SIGINT or SIGTERM.
+     *
+     * @param cfg configuration
+     * @param argc number of command line arguments
+     * @param argv command line arguments used to configure processing of each file
+     * @return status of operation
+     */
+    status_t watch(const config_t *cfg, int argc, const char **argv);
+}
+
+#endif /* PRIVATE_WATCH_H_ */
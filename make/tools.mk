@@ -133,6 +133,12 @@ CXXFLAGS           := \
   -pipe \
   -Wall
 
+# Position-independent code allows to link objects into the shared library
+ifneq ($(PLATFORM),Windows)
+  CFLAGS          += -fPIC
+  CXXFLAGS        += -fPIC
+endif
+
 INCLUDE            :=
 LDFLAGS            := $(LDFLAGS_EXT) -r
 EXE_FLAGS          := $(EXE_FLAGS_EXT) $(FLAG_RELRO) -Wl,--gc-sections
@@ -0,0 +1,256 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of far-screamer
+ * Created on: 18 окт. 2026 г.
+ *
+ * far-screamer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * far-screamer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with far-screamer. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <lsp-plug.in/common/types.h>
+
+#include <private/Arena.h>
+
+#include <stdlib.h>
+
+#ifdef PLATFORM_UNIX_COMPATIBLE
+    #include <pthread.h>
+    #include <sys/mman.h>
+#endif /* PLATFORM_UNIX_COMPATIBLE */
+
+#define ARENA_ALIGN             0x40        // Alignment of allocations, suitable for any SIMD extension
+#define ARENA_PAGE_SIZE         0x200000    // Size granularity and alignment of chunks, matches the huge page size
+
+namespace far_screamer
+{
+    static inline size_t align_up(size_t value, size_t align)
+    {
+        return (value + align - 1) & ~(align - 1);
+    }
+
+    Arena::Arena()
+    {
+        pHead       = NULL;
+        pCurr       = NULL;
+        nUsed       = 0;
+        nPeak       = 0;
+        nHint       = 0;
+        nTotal      = 0;
+    }
+
+    Arena::~Arena()
+    {
+        destroy();
+    }
+
+    Arena::chunk_t *Arena::alloc_chunk(size_t size)
+    {
+        chunk_t *c      = static_cast<chunk_t *>(malloc(sizeof(chunk_t)));
+        if (c == NULL)
+            return NULL;
+
+        size            = align_up(size, ARENA_PAGE_SIZE);
+        size_t mapped   = size + ARENA_PAGE_SIZE;
+
+#ifdef PLATFORM_UNIX_COMPATIBLE
+        // Map the region with the margin and unmap the head and the tail to align
+        // the chunk to the huge page boundary
+        void *ptr       = mmap(NULL, mapped, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (ptr == MAP_FAILED)
+        {
+            free(c);
+            return NULL;
+        }
+
+        uint8_t *data   = reinterpret_cast<uint8_t *>(align_up(reinterpret_cast<uintptr_t>(ptr), ARENA_PAGE_SIZE));
+        size_t head     = data - static_cast<uint8_t *>(ptr);
+        size_t tail     = mapped - head - size;
+        if (head > 0)
+            munmap(ptr, head);
+        if (tail > 0)
+            munmap(&data[size], tail);
+
+        c->mapping      = data;
+        c->mapped       = size;
+    #ifdef MADV_HUGEPAGE
+        madvise(data, size, MADV_HUGEPAGE);
+    #endif /* MADV_HUGEPAGE */
+#else
+        void *ptr       = malloc(mapped);
+        if (ptr == NULL)
+        {
+            free(c);
+            return NULL;
+        }
+
+        uint8_t *data   = reinterpret_cast<uint8_t *>(align_up(reinterpret_cast<uintptr_t>(ptr), ARENA_PAGE_SIZE));
+        c->mapping      = ptr;
+        c->mapped       = mapped;
+#endif /* PLATFORM_UNIX_COMPATIBLE */
+
+        c->next         = NULL;
+        c->data         = data;
+        c->size         = size;
+        c->base         = 0;
+
+        return c;
+    }
+
+    void Arena::free_chunk(chunk_t *c)
+    {
+#ifdef PLATFORM_UNIX_COMPATIBLE
+        munmap(c->mapping, c->mapped);
+#else
+        free(c->mapping);
+#endif /* PLATFORM_UNIX_COMPATIBLE */
+        free(c);
+    }
+
+    void Arena::free_chunks(chunk_t *c)
+    {
+        while (c != NULL)
+        {
+            chunk_t *next   = c->next;
+            free_chunk(c);
+            c               = next;
+        }
+    }
+
+    void *Arena::allocate(size_t size)
+    {
+        size            = align_up(lsp_max(size, size_t(1)), ARENA_ALIGN);
+        size_t offset   = (pCurr != NULL) ? nUsed - pCurr->base : 0;
+
+        if ((pCurr == NULL) || (offset + size > pCurr->size))
+        {
+            // Move to the next chunk, chunks after the current one are not used
+            // and are replaced if the next chunk is too small
+            chunk_t *next   = (pCurr != NULL) ? pCurr->next : pHead;
+            if ((next == NULL) || (size > next->size))
+            {
+                free_chunks(next);
+                if (pCurr != NULL)
+                    pCurr->next     = NULL;
+                else
+                    pHead           = NULL;
+
+                if ((next = alloc_chunk(lsp_max(size, nHint))) == NULL)
+                    return NULL;
+                nHint           = 0;
+
+                if (pCurr != NULL)
+                {
+                    next->base      = pCurr->base + pCurr->size;
+                    pCurr->next     = next;
+                }
+                else
+                    pHead           = next;
+            }
+
+            pCurr           = next;
+            offset          = 0;
+        }
+
+        void *ptr       = &pCurr->data[offset];
+        nUsed           = pCurr->base + offset + size;
+        nPeak           = lsp_max(nPeak, nUsed);
+        nTotal         += size;
+
+        return ptr;
+    }
+
+    void Arena::rewind(size_t mark)
+    {
+        if (mark >= nUsed)
+            return;
+
+        chunk_t *c      = pHead;
+        while (c->base + c->size < mark)
+            c               = c->next;
+
+        pCurr           = c;
+        nUsed           = mark;
+    }
+
+    void Arena::reset()
+    {
+        // Replace several chunks by one chunk of the peak size
+        if ((pHead != NULL) && (pHead->next != NULL))
+        {
+            nHint           = nPeak;
+            free_chunks(pHead);
+            pHead           = NULL;
+        }
+
+        pCurr           = pHead;
+        nUsed           = 0;
+        nPeak           = 0;
+        nTotal          = 0;
+    }
+
+    void Arena::destroy()
+    {
+        free_chunks(pHead);
+
+        pHead           = NULL;
+        pCurr           = NULL;
+        nUsed           = 0;
+        nPeak           = 0;
+        nHint           = 0;
+        nTotal          = 0;
+    }
+
+    size_t Arena::reserved() const
+    {
+        size_t size     = 0;
+        for (const chunk_t *c = pHead; c != NULL; c = c->next)
+            size           += c->size;
+        return size;
+    }
+
+#ifdef PLATFORM_UNIX_COMPATIBLE
+    static pthread_key_t    arena_key;
+    static pthread_once_t   arena_once  = PTHREAD_ONCE_INIT;
+
+    static void destroy_arena(void *ptr)
+    {
+        delete static_cast<Arena *>(ptr);
+    }
+
+    static void create_arena_key()
+    {
+        pthread_key_create(&arena_key, destroy_arena);
+    }
+
+    Arena *thread_arena()
+    {
+        // The arena is created on the first use and destroyed when the thread exits
+        pthread_once(&arena_once, create_arena_key);
+        Arena *arena    = static_cast<Arena *>(pthread_getspecific(arena_key));
+        if (arena == NULL)
+        {
+            arena           = new Arena();
+            pthread_setspecific(arena_key, arena);
+        }
+        return arena;
+    }
+#else
+    Arena *thread_arena()
+    {
+        static Arena arena;
+        return &arena;
+    }
+#endif /* PLATFORM_UNIX_COMPATIBLE */
+}
@@ -0,0 +1,386 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of far-screamer
+ * Created on: 18 окт. 2026 г.
+ *
+ * far-screamer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * far-screamer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with far-screamer. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <lsp-plug.in/common/types.h>
+#include <lsp-plug.in/stdlib/string.h>
+
+#include <private/AsyncFile.h>
+
+#include <stdlib.h>
+
+#ifdef PLATFORM_UNIX_COMPATIBLE
+    #include <errno.h>
+    #include <unistd.h>
+#endif /* PLATFORM_UNIX_COMPATIBLE */
+
+#ifdef PLATFORM_WINDOWS
+    #include <io.h>
+#endif /* PLATFORM_WINDOWS */
+
+#ifdef PLATFORM_LINUX
+    #ifdef __has_include
+        #if __has_include(<linux/io_uring.h>)
+            #define USE_IO_URING
+            #include <linux/io_uring.h>
+            #include <sys/mman.h>
+            #include <sys/syscall.h>
+        #endif
+    #endif /* __has_include */
+#endif /* PLATFORM_LINUX */
+
+namespace far_screamer
+{
+    AsyncFile::AsyncFile()
+    {
+        hFD             = -1;
+        pRing           = NULL;
+        nPending        = 0;
+    #ifdef PLATFORM_UNIX_COMPATIBLE
+        pthread_mutex_init(&sMutex, NULL);
+        pthread_cond_init(&sCond, NULL);
+    #endif /* PLATFORM_UNIX_COMPATIBLE */
+    }
+
+    AsyncFile::~AsyncFile()
+    {
+        close();
+    #ifdef PLATFORM_UNIX_COMPATIBLE
+        pthread_cond_destroy(&sCond);
+        pthread_mutex_destroy(&sMutex);
+    #endif /* PLATFORM_UNIX_COMPATIBLE */
+    }
+
+#ifdef USE_IO_URING
+    struct AsyncFile::uring_t
+    {
+        int                 fd;         // File descriptor of the io_uring
+        uint8_t            *sq_ptr;     // Mapped submission queue
+        size_t              sq_size;    // Size of the mapped submission queue
+        uint8_t            *cq_ptr;     // Mapped completion queue
+        size_t              cq_size;    // Size of the mapped completion queue
+        io_uring_sqe       *sqes;       // Mapped submission queue entries
+        size_t              sqes_size;  // Size of the mapped submission queue entries
+        unsigned           *sq_tail;
+        unsigned           *sq_mask;
+        unsigned           *sq_array;
+        unsigned           *cq_head;
+        unsigned           *cq_tail;
+        unsigned           *cq_mask;
+        io_uring_cqe       *cqes;
+    };
+
+    static inline void *map_ring(size_t size, int fd, off_t offset)
+    {
+        void *ptr = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, offset);
+        return (ptr != MAP_FAILED) ? ptr : NULL;
+    }
+
+    static inline int enter_ring(int fd, unsigned to_submit, unsigned min_complete, unsigned flags)
+    {
+        return syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, NULL, 0);
+    }
+
+    status_t AsyncFile::open_ring(size_t depth)
+    {
+        io_uring_params p;
+        memset(&p, 0, sizeof(p));
+
+        int fd          = syscall(__NR_io_uring_setup, unsigned(depth), &p);
+        if (fd < 0)
+            return STATUS_NOT_SUPPORTED;    // Old kernel or disabled by the system policy
+
+        uring_t *r      = static_cast<uring_t *>(malloc(sizeof(uring_t)));
+        if (r == NULL)
+        {
+            ::close(fd);
+            return STATUS_NO_MEM;
+        }
+        memset(r, 0, sizeof(uring_t));
+        r->fd           = fd;
+        pRing           = r;
+
+        // Map the queues of the ring, they may share one mapping
+        r->sq_size      = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+        r->cq_size      = p.cq_off.cqes + p.cq_entries * sizeof(io_uring_cqe);
+        if (p.features & IORING_FEAT_SINGLE_MMAP)
+            r->sq_size      = r->cq_size = lsp_max(r->sq_size, r->cq_size);
+        r->sqes_size    = p.sq_entries * sizeof(io_uring_sqe);
+
+        r->sq_ptr       = static_cast<uint8_t *>(map_ring(r->sq_size, fd, IORING_OFF_SQ_RING));
+        r->cq_ptr       = (p.features & IORING_FEAT_SINGLE_MMAP) ? r->sq_ptr :
+                          static_cast<uint8_t *>(map_ring(r->cq_size, fd, IORING_OFF_CQ_RING));
+        r->sqes         = static_cast<io_uring_sqe *>(map_ring(r->sqes_size, fd, IORING_OFF_SQES));
+        if ((r->sq_ptr == NULL) || (r->cq_ptr == NULL) || (r->sqes == NULL))
+        {
+            close_ring();
+            return STATUS_NOT_SUPPORTED;
+        }
+
+        r->sq_tail      = reinterpret_cast<unsigned *>(&r->sq_ptr[p.sq_off.tail]);
+        r->sq_mask      = reinterpret_cast<unsigned *>(&r->sq_ptr[p.sq_off.ring_mask]);
+        r->sq_array     = reinterpret_cast<unsigned *>(&r->sq_ptr[p.sq_off.array]);
+        r->cq_head      = reinterpret_cast<unsigned *>(&r->cq_ptr[p.cq_off.head]);
+        r->cq_tail      = reinterpret_cast<unsigned *>(&r->cq_ptr[p.cq_off.tail]);
+        r->cq_mask      = reinterpret_cast<unsigned *>(&r->cq_ptr[p.cq_off.ring_mask]);
+        r->cqes         = reinterpret_cast<io_uring_cqe *>(&r->cq_ptr[p.cq_off.cqes]);
+
+        return STATUS_OK;
+    }
+
+    status_t AsyncFile::submit_ring(request_t *req)
+    {
+        uring_t *r      = pRing;
+        unsigned tail   = *r->sq_tail;
+        unsigned index  = tail & *r->sq_mask;
+
+        req->iov.iov_base   = req->buf;
+        req->iov.iov_len    = req->size;
+
+        io_uring_sqe *sqe   = &r->sqes[index];
+        memset(sqe, 0, sizeof(io_uring_sqe));
+        sqe->opcode     = (req->write) ? IORING_OP_WRITEV : IORING_OP_READV;
+        sqe->fd         = hFD;
+        sqe->addr       = uintptr_t(&req->iov);
+        sqe->len        = 1;
+        sqe->off        = req->offset;
+        sqe->user_data  = uintptr_t(req);
+
+        r->sq_array[index]  = index;
+        __atomic_store_n(r->sq_tail, tail + 1, __ATOMIC_RELEASE);
+
+        int res;
+        while (((res = enter_ring(r->fd, 1, 0, 0)) < 0) && (errno == EINTR)) { }
+        if (res < 0)
+        {
+            // Withdraw the entry which has not been consumed by the kernel
+            __atomic_store_n(r->sq_tail, tail, __ATOMIC_RELEASE);
+            return STATUS_IO_ERROR;
+        }
+
+        ++nPending;
+        return STATUS_OK;
+    }
+
+    status_t AsyncFile::reap_ring()
+    {
+        uring_t *r      = pRing;
+        unsigned head   = *r->cq_head;
+        unsigned tail;
+
+        // Wait for at least one completion
+        while ((tail = __atomic_load_n(r->cq_tail, __ATOMIC_ACQUIRE)) == head)
+        {
+            if ((enter_ring(r->fd, 0, 1, IORING_ENTER_GETEVENTS) < 0) && (errno != EINTR))
+                return STATUS_IO_ERROR;
+        }
+
+        for ( ; head != tail; ++head)
+        {
+            const io_uring_cqe *cqe = &r->cqes[head & *r->cq_mask];
+            request_t *req  = reinterpret_cast<request_t *>(uintptr_t(cqe->user_data));
+            --nPending;
+            complete(req, (cqe->res >= 0) ? ssize_t(cqe->res) : -ssize_t(STATUS_IO_ERROR));
+        }
+        __atomic_store_n(r->cq_head, head, __ATOMIC_RELEASE);
+
+        return STATUS_OK;
+    }
+
+    void AsyncFile::close_ring()
+    {
+        uring_t *r      = pRing;
+        if (r == NULL)
+            return;
+
+        while ((nPending > 0) && (reap_ring() == STATUS_OK)) { }
+
+        if (r->sqes != NULL)
+            munmap(r->sqes, r->sqes_size);
+        if ((r->cq_ptr != NULL) && (r->cq_ptr != r->sq_ptr))
+            munmap(r->cq_ptr, r->cq_size);
+        if (r->sq_ptr != NULL)
+            munmap(r->sq_ptr, r->sq_size);
+        ::close(r->fd);
+        free(r);
+
+        pRing           = NULL;
+        nPending        = 0;
+    }
+#else
+    status_t AsyncFile::open_ring(size_t /* depth */)
+    {
+        return STATUS_NOT_SUPPORTED;
+    }
+
+    status_t AsyncFile::submit_ring(request_t * /* req */)
+    {
+        return STATUS_NOT_SUPPORTED;
+    }
+
+    status_t AsyncFile::reap_ring()
+    {
+        return STATUS_NOT_SUPPORTED;
+    }
+
+    void AsyncFile::close_ring()
+    {
+    }
+#endif /* USE_IO_URING */
+
+    void AsyncFile::transfer(request_t *req)
+    {
+        // Continue the transfer after the partial completion
+        uint8_t *buf    = static_cast<uint8_t *>(req->buf);
+        size_t done     = (req->result > 0) ? req->result : 0;
+
+        while (done < req->size)
+        {
+        #ifdef PLATFORM_UNIX_COMPATIBLE
+            ssize_t n       = (req->write) ?
+                pwrite(hFD, &buf[done], req->size - done, off_t(req->offset + done)) :
+                pread(hFD, &buf[done], req->size - done, off_t(req->offset + done));
+            if ((n < 0) && (errno == EINTR))
+                continue;
+        #else
+            ssize_t n       = -1;
+            if (_lseeki64(hFD, req->offset + done, SEEK_SET) >= 0)
+                n               = (req->write) ?
+                    _write(hFD, &buf[done], unsigned(req->size - done)) :
+                    _read(hFD, &buf[done], unsigned(req->size - done));
+        #endif /* PLATFORM_UNIX_COMPATIBLE */
+            if (n < 0)
+            {
+                req->result     = (done > 0) ? ssize_t(done) : -ssize_t(STATUS_IO_ERROR);
+                return;
+            }
+            else if (n == 0) // End of file
+                break;
+            done           += n;
+        }
+
+        req->result     = done;
+    }
+
+    void AsyncFile::complete(request_t *req, ssize_t result)
+    {
+        req->result     = result;
+        if ((result > 0) && (size_t(result) < req->size))
+            transfer(req);
+        req->pending    = false;
+    }
+
+    void AsyncFile::process_request(void *task, void *arg)
+    {
+        AsyncFile *self = static_cast<AsyncFile *>(arg);
+        request_t *req  = static_cast<request_t *>(task);
+
+        self->transfer(req);
+
+    #ifdef PLATFORM_UNIX_COMPATIBLE
+        pthread_mutex_lock(&self->sMutex);
+        req->pending    = false;
+        pthread_cond_broadcast(&self->sCond);
+        pthread_mutex_unlock(&self->sMutex);
+    #endif /* PLATFORM_UNIX_COMPATIBLE */
+    }
+
+    status_t AsyncFile::open(int fd, size_t depth)
+    {
+        if (hFD >= 0)
+            return STATUS_OPENED;
+        hFD             = fd;
+
+        // Prefer the io_uring, serve requests by the pool of threads otherwise
+        status_t res    = open_ring(depth);
+        if (res == STATUS_OK)
+            return res;
+        else if (res == STATUS_NO_MEM)
+        {
+            hFD             = -1;
+            return res;
+        }
+
+        // Requests are served synchronously if threads are not supported
+        if (sPool.start(depth, process_request, this) != STATUS_OK)
+            sPool.stop();
+
+        return STATUS_OK;
+    }
+
+    void AsyncFile::close()
+    {
+        close_ring();
+        sPool.stop();
+        hFD             = -1;
+    }
+
+    status_t AsyncFile::submit(request_t *req)
+    {
+        if (hFD < 0)
+            return STATUS_CLOSED;
+
+        req->result     = 0;
+        req->pending    = true;
+
+        if (pRing != NULL)
+        {
+            status_t res    = submit_ring(req);
+            if (res != STATUS_OK)
+                req->pending    = false;
+            return res;
+        }
+        else if (sPool.workers() > 0)
+        {
+            if (sPool.submit(req))
+                return STATUS_OK;
+            req->pending    = false;
+            return STATUS_NO_MEM;
+        }
+
+        transfer(req);
+        req->pending    = false;
+        return STATUS_OK;
+    }
+
+    status_t AsyncFile::wait(request_t *req)
+    {
+        if (pRing != NULL)
+        {
+            while (req->pending)
+            {
+                status_t res    = reap_ring();
+                if (res != STATUS_OK)
+                    return res;
+            }
+        }
+    #ifdef PLATFORM_UNIX_COMPATIBLE
+        else
+        {
+            pthread_mutex_lock(&sMutex);
+            while (req->pending)
+                pthread_cond_wait(&sCond, &sMutex);
+            pthread_mutex_unlock(&sMutex);
+        }
+    #endif /* PLATFORM_UNIX_COMPATIBLE */
+
+        return (req->result < 0) ? status_t(-req->result) : STATUS_OK;
+    }
+}
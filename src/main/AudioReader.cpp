@@ -0,0 +1,539 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of far-screamer
+ * Created on: 18 окт. 2026 г.
+ *
+ * far-screamer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * far-screamer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with far-screamer. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <lsp-plug.in/common/types.h>
+#include <lsp-plug.in/stdlib/string.h>
+
+#include <private/AudioReader.h>
+
+#include <stdlib.h>
+
+#define READER_BUF_SIZE         0x100000    // Size of the block of raw data in bytes
+#define STREAM_BLOCK_SIZE       0x1000      // Number of frames decoded by the fallback stream at once
+#define WAV_FMT_SIZE            40          // Size of the extensible format chunk
+#define RIFF_DS64_SIZE          28          // Size of the RF64 ds64 chunk
+#define W64_HEADER_SIZE         40          // Size of the Wave64 file header
+#define W64_CHUNK_SIZE          24          // Size of the Wave64 chunk header
+#define WAVE_FORMAT_PCM         0x0001
+#define WAVE_FORMAT_IEEE_FLOAT  0x0003
+#define WAVE_FORMAT_EXTENSIBLE  0xfffe
+
+namespace far_screamer
+{
+    typedef struct wav_header_t
+    {
+        uint8_t     fmt[WAV_FMT_SIZE];  // Contents of the format chunk
+        size_t      fmt_size;           // Size of the format chunk
+        wsize_t     data_offset;        // Offset of audio data in the file
+        wsize_t     data_size;          // Size of audio data in bytes
+    } wav_header_t;
+
+    // Wave64 GUIDs of chunks
+    static const uint8_t w64_riff[] = { 'r', 'i', 'f', 'f', 0x2e, 0x91, 0xcf, 0x11, 0xa5, 0xd6, 0x28, 0xdb, 0x04, 0xc1, 0x00, 0x00 };
+    static const uint8_t w64_wave[] = { 'w', 'a', 'v', 'e', 0xf3, 0xac, 0xd3, 0x11, 0x8c, 0xd1, 0x00, 0xc0, 0x4f, 0x8e, 0xdb, 0x8a };
+    static const uint8_t w64_fmt[]  = { 'f', 'm', 't', ' ', 0xf3, 0xac, 0xd3, 0x11, 0x8c, 0xd1, 0x00, 0xc0, 0x4f, 0x8e, 0xdb, 0x8a };
+    static const uint8_t w64_data[] = { 'd', 'a', 't', 'a', 0xf3, 0xac, 0xd3, 0x11, 0x8c, 0xd1, 0x00, 0xc0, 0x4f, 0x8e, 0xdb, 0x8a };
+
+    // The tail of the sub-format GUID of the extensible format that follows the format tag
+    static const uint8_t ks_format_tail[] = { 0x00, 0x00, 0x00, 0x00, 0x10, 0x00, 0x80, 0x00, 0x00, 0xaa, 0x00, 0x38, 0x9b, 0x71 };
+
+    static inline uint32_t get_u16(const uint8_t *p)
+    {
+        return uint32_t(p[0]) | (uint32_t(p[1]) << 8);
+    }
+
+    static inline uint32_t get_u24(const uint8_t *p)
+    {
+        return uint32_t(p[0]) | (uint32_t(p[1]) << 8) | (uint32_t(p[2]) << 16);
+    }
+
+    static inline uint32_t get_u32(const uint8_t *p)
+    {
+        return uint32_t(p[0]) | (uint32_t(p[1]) << 8) | (uint32_t(p[2]) << 16) | (uint32_t(p[3]) << 24);
+    }
+
+    static inline uint64_t get_u64(const uint8_t *p)
+    {
+        return uint64_t(get_u32(p)) | (uint64_t(get_u32(&p[4])) << 32);
+    }
+
+    // Decoders of little-endian samples, the source is the interleaved data with the specified stride
+    static void decode_pcm16(float *dst, const uint8_t *src, size_t stride, size_t count)
+    {
+        for (size_t i=0; i<count; ++i, src += stride)
+            dst[i]      = float(int16_t(get_u16(src))) * (1.0f / 32768.0f);
+    }
+
+    static void decode_pcm24(float *dst, const uint8_t *src, size_t stride, size_t count)
+    {
+        for (size_t i=0; i<count; ++i, src += stride)
+            dst[i]      = float(int32_t(get_u24(src) ^ 0x800000) - 0x800000) * (1.0f / 8388608.0f);
+    }
+
+    static void decode_pcm32(float *dst, const uint8_t *src, size_t stride, size_t count)
+    {
+        for (size_t i=0; i<count; ++i, src += stride)
+            dst[i]      = float(int32_t(get_u32(src))) * (1.0f / 2147483648.0f);
+    }
+
+    static void decode_float32(float *dst, const uint8_t *src, size_t stride, size_t count)
+    {
+        for (size_t i=0; i<count; ++i, src += stride)
+        {
+            uint32_t v  = get_u32(src);
+            memcpy(&dst[i], &v, sizeof(float));
+        }
+    }
+
+    static int seek_file(FILE *fd, wsize_t offset)
+    {
+    #ifdef PLATFORM_WINDOWS
+        return _fseeki64(fd, offset, SEEK_SET);
+    #else
+        return fseeko(fd, off_t(offset), SEEK_SET);
+    #endif /* PLATFORM_WINDOWS */
+    }
+
+    static bool read_at(FILE *fd, wsize_t offset, void *buf, size_t count)
+    {
+        return (seek_file(fd, offset) == 0) && (fread(buf, 1, count, fd) == count);
+    }
+
+    static status_t read_riff(wav_header_t *h, FILE *fd, wsize_t fsize, bool rf64)
+    {
+        uint8_t chunk[RIFF_DS64_SIZE];
+        wsize_t ds64_data   = 0;
+        bool has_ds64 = false, has_fmt = false, has_data = false;
+
+        for (wsize_t pos = 12; pos + 8 <= fsize; )
+        {
+            if (!read_at(fd, pos, chunk, 8))
+                return STATUS_UNSUPPORTED_FORMAT;
+            wsize_t size        = get_u32(&chunk[4]);
+
+            if (!memcmp(chunk, "ds64", 4))
+            {
+                if ((size < RIFF_DS64_SIZE) || (!read_at(fd, pos + 8, chunk, RIFF_DS64_SIZE)))
+                    return STATUS_UNSUPPORTED_FORMAT;
+                ds64_data           = get_u64(&chunk[8]);
+                has_ds64            = true;
+            }
+            else if (!memcmp(chunk, "fmt ", 4))
+            {
+                h->fmt_size         = lsp_min(size, wsize_t(WAV_FMT_SIZE));
+                if (!read_at(fd, pos + 8, h->fmt, h->fmt_size))
+                    return STATUS_UNSUPPORTED_FORMAT;
+                has_fmt             = true;
+            }
+            else if (!memcmp(chunk, "data", 4))
+            {
+                // The size of data is stored in the ds64 chunk of RF64 files and is not
+                // updated by some streaming writers, the data lasts till the end of file then
+                h->data_offset      = pos + 8;
+                if (size == 0xffffffff)
+                    size                = ((rf64) && (has_ds64)) ? ds64_data : fsize - h->data_offset;
+                h->data_size        = lsp_min(size, fsize - h->data_offset);
+                has_data            = true;
+            }
+
+            if ((has_fmt) && (has_data))
+                return STATUS_OK;
+            pos                += 8 + size + (size & 1);
+        }
+
+        return STATUS_UNSUPPORTED_FORMAT;
+    }
+
+    static status_t read_w64(wav_header_t *h, FILE *fd, wsize_t fsize)
+    {
+        uint8_t chunk[W64_CHUNK_SIZE];
+        bool has_fmt = false, has_data = false;
+
+        for (wsize_t pos = W64_HEADER_SIZE; pos + W64_CHUNK_SIZE <= fsize; )
+        {
+            if (!read_at(fd, pos, chunk, W64_CHUNK_SIZE))
+                return STATUS_UNSUPPORTED_FORMAT;
+            wsize_t size        = get_u64(&chunk[16]);  // The size includes the header of the chunk
+            if (size < W64_CHUNK_SIZE)
+                return STATUS_UNSUPPORTED_FORMAT;
+
+            if (!memcmp(chunk, w64_fmt, sizeof(w64_fmt)))
+            {
+                h->fmt_size         = lsp_min(size - W64_CHUNK_SIZE, wsize_t(WAV_FMT_SIZE));
+                if (!read_at(fd, pos + W64_CHUNK_SIZE, h->fmt, h->fmt_size))
+                    return STATUS_UNSUPPORTED_FORMAT;
+                has_fmt             = true;
+            }
+            else if (!memcmp(chunk, w64_data, sizeof(w64_data)))
+            {
+                h->data_offset      = pos + W64_CHUNK_SIZE;
+                h->data_size        = lsp_min(size - W64_CHUNK_SIZE, fsize - h->data_offset);
+                has_data            = true;
+            }
+
+            if ((has_fmt) && (has_data))
+                return STATUS_OK;
+            pos                += (size + 7) & ~wsize_t(7);
+        }
+
+        return STATUS_UNSUPPORTED_FORMAT;
+    }
+
+    static status_t parse_format(AudioReader::decode_t *decode, size_t *block_align, audio_info_t *info, const wav_header_t *h)
+    {
+        const uint8_t *fmt  = h->fmt;
+        if (h->fmt_size < 16)
+            return STATUS_UNSUPPORTED_FORMAT;
+
+        size_t tag          = get_u16(&fmt[0]);
+        size_t channels     = get_u16(&fmt[2]);
+        size_t srate        = get_u32(&fmt[4]);
+        size_t align        = get_u16(&fmt[12]);
+        size_t bits         = get_u16(&fmt[14]);
+
+        if (tag == WAVE_FORMAT_EXTENSIBLE)
+        {
+            if ((h->fmt_size < WAV_FMT_SIZE) || (memcmp(&fmt[26], ks_format_tail, sizeof(ks_format_tail))))
+                return STATUS_UNSUPPORTED_FORMAT;
+            tag                 = get_u16(&fmt[24]);
+        }
+        if ((channels <= 0) || (srate <= 0) || (align != channels * (bits >> 3)))
+            return STATUS_UNSUPPORTED_FORMAT;
+
+        if ((tag == WAVE_FORMAT_PCM) && (bits == 16))
+            *decode             = decode_pcm16;
+        else if ((tag == WAVE_FORMAT_PCM) && (bits == 24))
+            *decode             = decode_pcm24;
+        else if ((tag == WAVE_FORMAT_PCM) && (bits == 32))
+            *decode             = decode_pcm32;
+        else if ((tag == WAVE_FORMAT_IEEE_FLOAT) && (bits == 32))
+            *decode             = decode_float32;
+        else
+            return STATUS_UNSUPPORTED_FORMAT;
+
+        *block_align        = align;
+        info->channels      = channels;
+        info->length        = h->data_size / align;
+        info->sample_rate   = srate;
+
+        return STATUS_OK;
+    }
+
+    AudioReader::AudioReader()
+    {
+        sInfo.channels      = 0;
+        sInfo.length        = 0;
+        sInfo.sample_rate   = 0;
+        pFD                 = NULL;
+        pDecode             = NULL;
+        pBuf                = NULL;
+        nBlockAlign         = 0;
+        nBufFrames          = 0;
+        nFrames             = 0;
+        nSlot               = 0;
+        nPos                = 0;
+        nAvail              = 0;
+        nNextOffset         = 0;
+        nDataEnd            = 0;
+        bStarted            = false;
+        bOpened             = false;
+    }
+
+    AudioReader::~AudioReader()
+    {
+        close();
+    }
+
+    status_t AudioReader::open_native(const io::Path *path)
+    {
+        status_t res;
+        io::fattr_t attr;
+        if ((res = path->stat(&attr)) != STATUS_OK)
+            return res;
+
+        FILE *fd            = fopen(path->as_native(), "rb");
+        if (fd == NULL)
+            return STATUS_IO_ERROR;
+
+        // Detect the container and find the format and data chunks
+        wav_header_t h;
+        uint8_t hdr[W64_HEADER_SIZE];
+        size_t n            = fread(hdr, 1, sizeof(hdr), fd);
+        if ((n >= 12) && ((!memcmp(hdr, "RIFF", 4)) || (!memcmp(hdr, "RF64", 4))) && (!memcmp(&hdr[8], "WAVE", 4)))
+            res                 = read_riff(&h, fd, attr.size, !memcmp(hdr, "RF64", 4));
+        else if ((n >= W64_HEADER_SIZE) && (!memcmp(hdr, w64_riff, sizeof(w64_riff))) && (!memcmp(&hdr[24], w64_wave, sizeof(w64_wave))))
+            res                 = read_w64(&h, fd, attr.size);
+        else
+            res                 = STATUS_UNSUPPORTED_FORMAT;
+
+        if (res == STATUS_OK)
+            res                 = parse_format(&pDecode, &nBlockAlign, &sInfo, &h);
+        if (res != STATUS_OK)
+        {
+            fclose(fd);
+            return res;
+        }
+
+        // Blocks are read only when decoding starts, so probing of the header stays cheap
+        pFD                 = fd;
+        nBufFrames          = lsp_max(size_t(READER_BUF_SIZE) / nBlockAlign, size_t(1));
+        nFrames             = sInfo.length;
+        nNextOffset         = h.data_offset;
+        nDataEnd            = h.data_offset + wsize_t(sInfo.length) * nBlockAlign;
+
+        return STATUS_OK;
+    }
+
+    status_t AudioReader::submit_block(AsyncFile::request_t *req)
+    {
+        req->offset         = nNextOffset;
+        req->size           = lsp_min(wsize_t(nBufFrames * nBlockAlign), nDataEnd - nNextOffset);
+        if (req->size <= 0)
+        {
+            req->result         = 0;
+            req->pending        = false;
+            return STATUS_OK;
+        }
+
+        nNextOffset        += req->size;
+        return sAsync.submit(req);
+    }
+
+    status_t AudioReader::start_native()
+    {
+        status_t res;
+        size_t bytes        = nBufFrames * nBlockAlign;
+
+        pBuf                = static_cast<uint8_t *>(malloc(bytes * ASYNC_QUEUE_DEPTH));
+        if (pBuf == NULL)
+            return STATUS_NO_MEM;
+        if ((res = sAsync.open(fileno(pFD), ASYNC_QUEUE_DEPTH)) != STATUS_OK)
+            return res;
+        bStarted            = true;
+
+        // Put all blocks in flight
+        for (size_t i=0; i<ASYNC_QUEUE_DEPTH; ++i)
+        {
+            AsyncFile::request_t *req = &vReq[i];
+            req->buf            = &pBuf[i * bytes];
+            req->write          = false;
+            if ((res = submit_block(req)) != STATUS_OK)
+                return res;
+        }
+
+        return STATUS_OK;
+    }
+
+    status_t AudioReader::open_stream(const io::Path *path)
+    {
+        status_t res;
+        mm::audio_stream_t fmt;
+
+        if ((res = sStream.open(path)) != STATUS_OK)
+            return res;
+        if ((res = sStream.info(&fmt)) == STATUS_OK)
+        {
+            pBuf                = static_cast<uint8_t *>(malloc(STREAM_BLOCK_SIZE * fmt.channels * sizeof(float)));
+            if (pBuf == NULL)
+                res                 = STATUS_NO_MEM;
+        }
+        if (res != STATUS_OK)
+        {
+            sStream.close();
+            return res;
+        }
+
+        sInfo.channels      = fmt.channels;
+        sInfo.length        = fmt.frames;
+        sInfo.sample_rate   = fmt.srate;
+        nBufFrames          = STREAM_BLOCK_SIZE;
+
+        return STATUS_OK;
+    }
+
+    status_t AudioReader::open(const io::Path *path)
+    {
+        if (bOpened)
+            return STATUS_OPENED;
+
+        // Prefer the built-in codec, the library decodes all other formats
+        status_t res        = open_native(path);
+        if ((res != STATUS_OK) && (res != STATUS_NO_MEM))
+            res                 = open_stream(path);
+
+        bOpened             = (res == STATUS_OK);
+        return res;
+    }
+
+    void AudioReader::close()
+    {
+        sAsync.close();
+        if (pFD != NULL)
+        {
+            fclose(pFD);
+            pFD                 = NULL;
+        }
+        else if (bOpened)
+            sStream.close();
+
+        if (pBuf != NULL)
+        {
+            free(pBuf);
+            pBuf                = NULL;
+        }
+
+        pDecode             = NULL;
+        nFrames             = 0;
+        nSlot               = 0;
+        nPos                = 0;
+        nAvail              = 0;
+        bStarted            = false;
+        bOpened             = false;
+    }
+
+    ssize_t AudioReader::read_native(float * const *dst, size_t frames)
+    {
+        status_t res;
+        size_t channels     = sInfo.channels;
+        size_t bytes        = nBlockAlign / channels;
+        size_t done         = 0;
+
+        if ((!bStarted) && ((res = start_native()) != STATUS_OK))
+            return -res;
+
+        while ((done < frames) && (nFrames > 0))
+        {
+            AsyncFile::request_t *req = &vReq[nSlot];
+            if (nAvail <= 0)
+            {
+                // Wait for the next block
+                if ((res = sAsync.wait(req)) != STATUS_OK)
+                    return (done > 0) ? ssize_t(done) : -ssize_t(res);
+                nPos                = 0;
+                nAvail              = req->result / nBlockAlign;
+                if (nAvail <= 0)
+                {
+                    // The file may be truncated
+                    nFrames             = 0;
+                    break;
+                }
+            }
+
+            // Convert the data channel by channel
+            size_t to_do        = lsp_min(lsp_min(frames - done, nFrames), nAvail);
+            const uint8_t *src  = &static_cast<const uint8_t *>(req->buf)[nPos * nBlockAlign];
+            for (size_t i=0; i<channels; ++i)
+            {
+                if (dst[i] != NULL)
+                    pDecode(&dst[i][done], &src[i * bytes], nBlockAlign, to_do);
+            }
+            done               += to_do;
+            nFrames            -= to_do;
+            nPos               += to_do;
+            nAvail             -= to_do;
+
+            // Reuse the buffer of the consumed block for the block ahead
+            if (nAvail <= 0)
+            {
+                if ((res = submit_block(req)) != STATUS_OK)
+                    return (done > 0) ? ssize_t(done) : -ssize_t(res);
+                nSlot               = (nSlot + 1) % ASYNC_QUEUE_DEPTH;
+            }
+        }
+
+        return done;
+    }
+
+    ssize_t AudioReader::read_stream(float * const *dst, size_t frames)
+    {
+        size_t channels     = sInfo.channels;
+        float *buf          = reinterpret_cast<float *>(pBuf);
+        size_t done         = 0;
+
+        while (done < frames)
+        {
+            ssize_t read        = sStream.read(buf, lsp_min(frames - done, nBufFrames));
+            if (read <= 0)
+            {
+                // The stream may be shorter than the header says
+                if ((read == 0) || (read == -STATUS_EOF) || (done > 0))
+                    break;
+                return read;
+            }
+
+            for (size_t i=0; i<channels; ++i)
+            {
+                if (dst[i] == NULL)
+                    continue;
+                float *dptr         = &dst[i][done];
+                for (ssize_t j=0; j<read; ++j)
+                    dptr[j]             = buf[j * channels + i];
+            }
+            done               += read;
+        }
+
+        return done;
+    }
+
+    status_t AudioReader::skip(size_t frames)
+    {
+        if (!bOpened)
+            return STATUS_CLOSED;
+
+        // Move the position of the first block to read
+        if ((pFD != NULL) && (!bStarted))
+        {
+            frames              = lsp_min(frames, nFrames);
+            nNextOffset        += wsize_t(frames) * nBlockAlign;
+            nFrames            -= frames;
+            return STATUS_OK;
+        }
+
+        // Decode frames and drop the data
+        float **table       = static_cast<float **>(malloc(sInfo.channels * sizeof(float *)));
+        if (table == NULL)
+            return STATUS_NO_MEM;
+        for (size_t i=0; i<sInfo.channels; ++i)
+            table[i]            = NULL;
+
+        status_t res        = STATUS_OK;
+        while (frames > 0)
+        {
+            ssize_t read        = this->read(table, frames);
+            if (read <= 0)
+            {
+                res                 = (read < 0) ? status_t(-read) : STATUS_OK;
+                break;
+            }
+            frames             -= read;
+        }
+
+        free(table);
+        return res;
+    }
+
+    ssize_t AudioReader::read(float * const *dst, size_t frames)
+    {
+        if (!bOpened)
+            return -STATUS_CLOSED;
+        return (pFD != NULL) ? read_native(dst, frames) : read_stream(dst, frames);
+    }
+}
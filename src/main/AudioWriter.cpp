@@ -0,0 +1,285 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of far-screamer
+ * Created on: 18 окт. 2026 г.
+ *
+ * far-screamer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * far-screamer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with far-screamer. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <lsp-plug.in/common/types.h>
+#include <lsp-plug.in/stdlib/string.h>
+
+#include <private/AudioWriter.h>
+
+#include <stdlib.h>
+
+#ifdef PLATFORM_LINUX
+    #include <errno.h>
+    #include <fcntl.h>
+#endif /* PLATFORM_LINUX */
+
+#define WRITER_BUF_SIZE         0x100000    // Size of the block written to the file at once
+#define WAV_HEADER_SIZE         92          // Size of all chunks before audio data
+#define WAV_SAMPLE_SIZE         sizeof(float)
+#define WAVE_FORMAT_IEEE_FLOAT  0x0003
+
+namespace far_screamer
+{
+    static inline uint8_t *put_u16(uint8_t *p, uint32_t v)
+    {
+        p[0]    = uint8_t(v);
+        p[1]    = uint8_t(v >> 8);
+        return &p[2];
+    }
+
+    static inline uint8_t *put_u32(uint8_t *p, uint32_t v)
+    {
+        p[0]    = uint8_t(v);
+        p[1]    = uint8_t(v >> 8);
+        p[2]    = uint8_t(v >> 16);
+        p[3]    = uint8_t(v >> 24);
+        return &p[4];
+    }
+
+    static inline uint8_t *put_u64(uint8_t *p, uint64_t v)
+    {
+        p       = put_u32(p, uint32_t(v));
+        return put_u32(p, uint32_t(v >> 32));
+    }
+
+    static inline uint8_t *put_id(uint8_t *p, const char *id)
+    {
+        memcpy(p, id, 4);
+        return &p[4];
+    }
+
+    // Encoder of little-endian samples, the destination is the interleaved data with the specified stride
+    static void encode_float32(uint8_t *dst, const float *src, size_t stride, size_t count)
+    {
+        for (size_t i=0; i<count; ++i, dst += stride)
+        {
+            uint32_t v;
+            memcpy(&v, &src[i], sizeof(float));
+            put_u32(dst, v);
+        }
+    }
+
+    /**
+     * Make the header of the file. The JUNK chunk reserves space for the ds64 chunk,
+     * so the offset of data does not depend on the size of the file
+     */
+    static void make_header(uint8_t *hdr, size_t channels, size_t length, size_t sample_rate, bool force_rf64)
+    {
+        uint64_t data_size  = uint64_t(length) * channels * WAV_SAMPLE_SIZE;
+        uint64_t riff_size  = data_size + WAV_HEADER_SIZE - 8;
+        bool rf64           = (force_rf64) || (riff_size > 0xffffffffULL);
+        uint8_t *p          = hdr;
+
+        p   = put_id(p, (rf64) ? "RF64" : "RIFF");
+        p   = put_u32(p, (rf64) ? 0xffffffff : uint32_t(riff_size));
+        p   = put_id(p, "WAVE");
+
+        p   = put_id(p, (rf64) ? "ds64" : "JUNK");
+        p   = put_u32(p, 28);
+        p   = put_u64(p, (rf64) ? riff_size : 0);
+        p   = put_u64(p, (rf64) ? data_size : 0);
+        p   = put_u64(p, (rf64) ? length : 0);
+        p   = put_u32(p, 0);                                    // No table of chunk sizes
+
+        p   = put_id(p, "fmt ");
+        p   = put_u32(p, 16);
+        p   = put_u16(p, WAVE_FORMAT_IEEE_FLOAT);
+        p   = put_u16(p, channels);
+        p   = put_u32(p, sample_rate);
+        p   = put_u32(p, sample_rate * channels * WAV_SAMPLE_SIZE);
+        p   = put_u16(p, channels * WAV_SAMPLE_SIZE);
+        p   = put_u16(p, WAV_SAMPLE_SIZE * 8);
+
+        p   = put_id(p, "fact");
+        p   = put_u32(p, 4);
+        p   = put_u32(p, (rf64) ? 0xffffffff : uint32_t(length));
+
+        p   = put_id(p, "data");
+        put_u32(p, (rf64) ? 0xffffffff : uint32_t(data_size));
+    }
+
+    AudioWriter::AudioWriter()
+    {
+        pFD             = NULL;
+        pBuf            = NULL;
+        nSlot           = 0;
+        nFill           = 0;
+        nOffset         = 0;
+        nChannels       = 0;
+        nLength         = 0;
+        nWritten        = 0;
+    }
+
+    AudioWriter::~AudioWriter()
+    {
+        close();
+    }
+
+    status_t AudioWriter::open(const io::Path *path, size_t channels, size_t length, size_t sample_rate, bool rf64)
+    {
+        if (pFD != NULL)
+            return STATUS_OPENED;
+        if ((channels <= 0) || (channels > 0xffff) || (sample_rate <= 0))
+            return STATUS_BAD_ARGUMENTS;
+
+        // Each buffer may hold one frame more than the block
+        size_t frame        = channels * WAV_SAMPLE_SIZE;
+        size_t bytes        = WRITER_BUF_SIZE + frame;
+        pBuf                = static_cast<uint8_t *>(malloc(bytes * ASYNC_QUEUE_DEPTH));
+        if (pBuf == NULL)
+            return STATUS_NO_MEM;
+        for (size_t i=0; i<ASYNC_QUEUE_DEPTH; ++i)
+        {
+            AsyncFile::request_t *req = &vReq[i];
+            req->buf            = &pBuf[i * bytes];
+            req->size           = 0;
+            req->offset         = 0;
+            req->result         = 0;
+            req->write          = true;
+            req->pending        = false;
+        }
+
+        pFD                 = fopen(path->as_native(), "wb");
+        if (pFD == NULL)
+        {
+            free(pBuf);
+            pBuf                = NULL;
+            return STATUS_IO_ERROR;
+        }
+
+    #ifdef PLATFORM_LINUX
+        // Preallocate the space for the whole file, fail early if there is not enough space
+        wsize_t size        = wsize_t(length) * frame + WAV_HEADER_SIZE;
+        if ((fallocate(fileno(pFD), 0, 0, off_t(size)) != 0) && (errno == ENOSPC))
+        {
+            close();
+            return STATUS_IO_ERROR;
+        }
+    #endif /* PLATFORM_LINUX */
+
+        status_t res        = sAsync.open(fileno(pFD), ASYNC_QUEUE_DEPTH);
+        if (res != STATUS_OK)
+        {
+            close();
+            return res;
+        }
+
+        make_header(pBuf, channels, length, sample_rate, rf64);
+        nSlot               = 0;
+        nFill               = WAV_HEADER_SIZE;
+        nOffset             = 0;
+        nChannels           = channels;
+        nLength             = length;
+        nWritten            = 0;
+
+        return STATUS_OK;
+    }
+
+    status_t AudioWriter::complete(AsyncFile::request_t *req)
+    {
+        status_t res        = sAsync.wait(req);
+        if ((res == STATUS_OK) && (req->result != ssize_t(req->size)))
+            res                 = STATUS_IO_ERROR;  // No space left on the device
+        return res;
+    }
+
+    status_t AudioWriter::flush(size_t bytes)
+    {
+        status_t res;
+        AsyncFile::request_t *req   = &vReq[nSlot];
+        AsyncFile::request_t *next  = &vReq[(nSlot + 1) % ASYNC_QUEUE_DEPTH];
+
+        // Put the block in flight
+        req->size           = bytes;
+        req->offset         = nOffset;
+        if ((res = sAsync.submit(req)) != STATUS_OK)
+            return res;
+        nOffset            += bytes;
+
+        // Move the rest of data to the next buffer once it is written
+        if ((res = complete(next)) != STATUS_OK)
+            return res;
+        nFill              -= bytes;
+        if (nFill > 0)
+            memcpy(next->buf, &static_cast<uint8_t *>(req->buf)[bytes], nFill);
+        nSlot               = (nSlot + 1) % ASYNC_QUEUE_DEPTH;
+
+        return STATUS_OK;
+    }
+
+    ssize_t AudioWriter::write(const float * const *src, size_t frames)
+    {
+        if (pFD == NULL)
+            return -STATUS_CLOSED;
+
+        size_t frame        = nChannels * WAV_SAMPLE_SIZE;
+        frames              = lsp_min(frames, nLength - nWritten);
+
+        for (size_t done = 0; done < frames; )
+        {
+            // Encode frames till the block is full, the last frame may cross its boundary
+            size_t to_do        = lsp_min(frames - done, (WRITER_BUF_SIZE - nFill) / frame + 1);
+            uint8_t *dst        = &static_cast<uint8_t *>(vReq[nSlot].buf)[nFill];
+            for (size_t i=0; i<nChannels; ++i)
+                encode_float32(&dst[i * WAV_SAMPLE_SIZE], &src[i][done], frame, to_do);
+            nFill              += to_do * frame;
+            nWritten           += to_do;
+            done               += to_do;
+
+            if (nFill >= WRITER_BUF_SIZE)
+            {
+                status_t res        = flush(WRITER_BUF_SIZE);
+                if (res != STATUS_OK)
+                    return -res;
+            }
+        }
+
+        return frames;
+    }
+
+    status_t AudioWriter::close()
+    {
+        if (pFD == NULL)
+            return STATUS_OK;
+
+        // Write the rest of data and wait for all blocks in flight
+        status_t res        = (nFill > 0) ? flush(nFill) : STATUS_OK;
+        for (size_t i=0; i<ASYNC_QUEUE_DEPTH; ++i)
+        {
+            status_t wres       = complete(&vReq[i]);
+            if (res == STATUS_OK)
+                res                 = wres;
+        }
+        sAsync.close();
+
+        if ((res == STATUS_OK) && (nWritten < nLength))
+            res                 = STATUS_BAD_STATE;
+        if ((fclose(pFD) != 0) && (res == STATUS_OK))
+            res                 = STATUS_IO_ERROR;
+
+        free(pBuf);
+        pFD                 = NULL;
+        pBuf                = NULL;
+        nFill               = 0;
+
+        return res;
+    }
+}
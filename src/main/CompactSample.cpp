@@ -0,0 +1,268 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of far-screamer
+ * Created on: 18 окт. 2026 г.
+ *
+ * far-screamer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * far-screamer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with far-screamer. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <lsp-plug.in/common/types.h>
+#include <lsp-plug.in/stdlib/math.h>
+#include <lsp-plug.in/stdlib/stdio.h>
+#include <lsp-plug.in/stdlib/string.h>
+
+#include <private/CompactSample.h>
+#include <far-screamer/config.h>
+
+#include <stdlib.h>
+
+#define INT16_SCALE             32768.0f
+#define INT24_SCALE             8388608.0f
+
+namespace far_screamer
+{
+    /*
+     * Conversion routines are written as plain loops without branches
+     * in the integer paths, so the compiler is able to vectorize them
+     */
+    static size_t encode_int16(int16_t *dst, const float *src, size_t count)
+    {
+        size_t clipped  = 0;
+        for (size_t i=0; i<count; ++i)
+        {
+            float v         = src[i] * INT16_SCALE;
+            clipped        += (v < -INT16_SCALE) || (v > INT16_SCALE - 1.0f);
+            dst[i]          = int16_t(lrintf(lsp_limit(v, -INT16_SCALE, INT16_SCALE - 1.0f)));
+        }
+        return clipped;
+    }
+
+    static void decode_int16(float *dst, const int16_t *src, size_t count)
+    {
+        for (size_t i=0; i<count; ++i)
+            dst[i]          = float(src[i]) * (1.0f / INT16_SCALE);
+    }
+
+    static size_t encode_int24(uint8_t *dst, const float *src, size_t count)
+    {
+        size_t clipped  = 0;
+        for (size_t i=0; i<count; ++i, dst += 3)
+        {
+            float v         = src[i] * INT24_SCALE;
+            clipped        += (v < -INT24_SCALE) || (v > INT24_SCALE - 1.0f);
+            uint32_t s      = uint32_t(int32_t(lrintf(lsp_limit(v, -INT24_SCALE, INT24_SCALE - 1.0f))));
+            dst[0]          = uint8_t(s);
+            dst[1]          = uint8_t(s >> 8);
+            dst[2]          = uint8_t(s >> 16);
+        }
+        return clipped;
+    }
+
+    static void decode_int24(float *dst, const uint8_t *src, size_t count)
+    {
+        for (size_t i=0; i<count; ++i, src += 3)
+        {
+            int32_t s       = int32_t(uint32_t(src[0]) | (uint32_t(src[1]) << 8) | (uint32_t(src[2]) << 16));
+            dst[i]          = float((s ^ 0x800000) - 0x800000) * (1.0f / INT24_SCALE);
+        }
+    }
+
+    static inline uint16_t float_to_half(float v)
+    {
+        uint32_t x;
+        memcpy(&x, &v, sizeof(x));
+        uint32_t sign   = (x >> 16) & 0x8000;
+        uint32_t abs    = x & 0x7fffffff;
+
+        if (abs >= 0x7f800000)                  // Infinity and NaN
+            return sign | 0x7c00 | ((abs > 0x7f800000) ? 0x200 : 0);
+        if (abs >= 0x477ff000)                  // Overflow, rounds to infinity
+            return sign | 0x7c00;
+        if (abs < 0x38800000)                   // Subnormal numbers and zero
+        {
+            float a;
+            memcpy(&a, &abs, sizeof(a));
+            return sign | uint16_t(lrintf(a * 16777216.0f));
+        }
+
+        // Rebias the exponent and round the mantissa to the nearest even
+        abs            += 0xc8000fff + ((abs >> 13) & 1);
+        return sign | uint16_t(abs >> 13);
+    }
+
+    static inline float half_to_float(uint16_t h)
+    {
+        uint32_t sign   = uint32_t(h & 0x8000) << 16;
+        uint32_t exp    = (h >> 10) & 0x1f;
+        uint32_t mant   = h & 0x3ff;
+        uint32_t x;
+
+        if (exp == 0)                           // Subnormal numbers and zero
+        {
+            float v         = float(mant) * (1.0f / 16777216.0f);
+            return (sign) ? -v : v;
+        }
+        else if (exp == 0x1f)                   // Infinity and NaN
+            x               = sign | 0x7f800000 | (mant << 13);
+        else
+            x               = sign | ((exp + 112) << 23) | (mant << 13);
+
+        float v;
+        memcpy(&v, &x, sizeof(v));
+        return v;
+    }
+
+    static void encode_half(uint16_t *dst, const float *src, size_t count)
+    {
+        for (size_t i=0; i<count; ++i)
+            dst[i]          = float_to_half(src[i]);
+    }
+
+    static void decode_half(float *dst, const uint16_t *src, size_t count)
+    {
+        for (size_t i=0; i<count; ++i)
+            dst[i]          = half_to_float(src[i]);
+    }
+
+    CompactSample::CompactSample()
+    {
+        pData       = NULL;
+        nFormat     = COMPACT_NONE;
+        nStride     = 0;
+        nChannels   = 0;
+        nLength     = 0;
+        nSampleRate = 0;
+        nClipped    = 0;
+    }
+
+    CompactSample::~CompactSample()
+    {
+        destroy();
+    }
+
+    size_t CompactSample::sample_size(size_t format)
+    {
+        switch (format)
+        {
+            case COMPACT_INT16: return sizeof(int16_t);
+            case COMPACT_INT24: return 3;
+            case COMPACT_HALF:  return sizeof(uint16_t);
+            default: break;
+        }
+        return sizeof(float);
+    }
+
+    status_t CompactSample::init(size_t channels, size_t length, size_t sample_rate, size_t format)
+    {
+        if ((format != COMPACT_INT16) && (format != COMPACT_INT24) && (format != COMPACT_HALF))
+            return STATUS_BAD_ARGUMENTS;
+
+        // Channels are aligned to keep conversion of each channel aligned
+        size_t stride   = lsp_max(length, size_t(1)) * sample_size(format);
+        stride          = ((stride + DEFAULT_ALIGN - 1) / DEFAULT_ALIGN) * DEFAULT_ALIGN;
+        uint8_t *data   = static_cast<uint8_t *>(malloc(stride * lsp_max(channels, size_t(1))));
+        if (data == NULL)
+            return STATUS_NO_MEM;
+        memset(data, 0, stride * lsp_max(channels, size_t(1)));   // All formats encode silence as zeros
+
+        destroy();
+        pData       = data;
+        nFormat     = format;
+        nStride     = stride;
+        nChannels   = channels;
+        nLength     = length;
+        nSampleRate = sample_rate;
+        nClipped    = 0;
+
+        return STATUS_OK;
+    }
+
+    void CompactSample::destroy()
+    {
+        if (pData != NULL)
+        {
+            free(pData);
+            pData       = NULL;
+        }
+
+        nStride     = 0;
+        nChannels   = 0;
+        nLength     = 0;
+        nClipped    = 0;
+    }
+
+    void CompactSample::write(size_t channel, size_t offset, const float *src, size_t count)
+    {
+        uint8_t *ptr    = &pData[channel * nStride + offset * sample_size(nFormat)];
+        switch (nFormat)
+        {
+            case COMPACT_INT16:
+                nClipped       += encode_int16(reinterpret_cast<int16_t *>(ptr), src, count);
+                break;
+            case COMPACT_INT24:
+                nClipped       += encode_int24(ptr, src, count);
+                break;
+            case COMPACT_HALF:
+                encode_half(reinterpret_cast<uint16_t *>(ptr), src, count);
+                break;
+            default:
+                break;
+        }
+    }
+
+    void CompactSample::read(float *dst, size_t channel, size_t offset, size_t count) const
+    {
+        const uint8_t *ptr  = &pData[channel * nStride + offset * sample_size(nFormat)];
+        switch (nFormat)
+        {
+            case COMPACT_INT16:
+                decode_int16(dst, reinterpret_cast<const int16_t *>(ptr), count);
+                break;
+            case COMPACT_INT24:
+                decode_int24(dst, ptr, count);
+                break;
+            case COMPACT_HALF:
+                decode_half(dst, reinterpret_cast<const uint16_t *>(ptr), count);
+                break;
+            default:
+                break;
+        }
+    }
+
+    status_t CompactSample::encode(const dspu::Sample *src, size_t format)
+    {
+        status_t res = init(src->channels(), src->length(), src->sample_rate(), format);
+        if (res != STATUS_OK)
+            return res;
+
+        for (size_t i=0; i<nChannels; ++i)
+            write(i, 0, src->channel(i), nLength);
+
+        return STATUS_OK;
+    }
+
+    status_t CompactSample::decode(dspu::Sample *dst) const
+    {
+        if (!dst->init(nChannels, nLength, nLength))
+            return STATUS_NO_MEM;
+        dst->set_sample_rate(nSampleRate);
+
+        for (size_t i=0; i<nChannels; ++i)
+            read(dst->channel(i), i, 0, nLength);
+
+        return STATUS_OK;
+    }
+}
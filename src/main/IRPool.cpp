@@ -0,0 +1,206 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of far-screamer
+ * Created on: 18 окт. 2026 г.
+ *
+ * far-screamer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * far-screamer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with far-screamer. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <lsp-plug.in/stdlib/stdio.h>
+#include <lsp-plug.in/io/Path.h>
+
+#include <private/IRPool.h>
+#include <private/tool.h>
+
+namespace far_screamer
+{
+    IRPool::IRPool(size_t capacity, wsize_t mem_limit)
+    {
+        nCapacity       = capacity;
+        nMemLimit       = mem_limit;
+        nTick           = 0;
+    }
+
+    IRPool::~IRPool()
+    {
+        for (size_t i=0, n=vEntries.size(); i<n; ++i)
+            delete vEntries.uget(i);
+        vEntries.flush();
+    }
+
+    bool IRPool::make_key(LSPString *key, const config_t *cfg)
+    {
+        const dspu::filter_params_t *lpf = &cfg->sLPF;
+        const dspu::filter_params_t *hpf = &cfg->sHPF;
+
+        key->fmt_ascii(
+            "%d:%.9g:%.9g:%.9g:%.9g:"
+            "%d:%.9g:%.9g:%.9g:%d:%.9g:"
+            "%d:%.9g:%.9g:%.9g:%d:%.9g:%d:",
+            int(cfg->nSampleRate), cfg->fHeadCut, cfg->fTailCut, cfg->fFadeIn, cfg->fFadeOut,
+            int(lpf->nType), lpf->fFreq, lpf->fFreq2, lpf->fGain, int(lpf->nSlope), lpf->fQuality,
+            int(hpf->nType), hpf->fFreq, hpf->fFreq2, hpf->fGain, int(hpf->nSlope), hpf->fQuality,
+            int(cfg->bDraft));
+
+        // The file modified on disk gets a new key, the stale entry is evicted as unused.
+        // If the file is not accessible, loading of the IR reports the error
+        io::Path path;
+        io::fattr_t attr;
+        if ((path.set(&cfg->sIRFile) == STATUS_OK) && (path.stat(&attr) == STATUS_OK))
+        {
+            if (key->fmt_append_ascii("%llu:%llu:", (unsigned long long)attr.size, (unsigned long long)attr.mtime) <= 0)
+                return false;
+        }
+
+        return key->append(&cfg->sIRFile);
+    }
+
+    IRPool::entry_t *IRPool::find_entry(const LSPString *key)
+    {
+        for (size_t i=0, n=vEntries.size(); i<n; ++i)
+        {
+            entry_t *e = vEntries.uget(i);
+            if (e->sKey.equals(key))
+                return e;
+        }
+        return NULL;
+    }
+
+    wsize_t IRPool::memory_used() const
+    {
+        wsize_t used    = 0;
+        for (size_t i=0, n=vEntries.size(); i<n; ++i)
+        {
+            const entry_t *e = vEntries.uget(i);
+            used           += wsize_t(e->sIR.channels()) * e->sIR.length() * sizeof(float);
+        }
+        return used;
+    }
+
+    void IRPool::evict()
+    {
+        while ((vEntries.size() > nCapacity) || ((nMemLimit > 0) && (memory_used() > nMemLimit)))
+        {
+            // Find the least recently used entry which is not referenced
+            ssize_t idx = -1;
+            for (size_t i=0, n=vEntries.size(); i<n; ++i)
+            {
+                entry_t *e = vEntries.uget(i);
+                if (e->nRefs > 0)
+                    continue;
+                if ((idx < 0) || (e->nAccess < vEntries.uget(idx)->nAccess))
+                    idx = i;
+            }
+            if (idx < 0)
+                return;
+
+            delete vEntries.uget(idx);
+            vEntries.remove(idx);
+        }
+    }
+
+    status_t IRPool::acquire(const dspu::Sample **ir, size_t *latency, const config_t *cfg, bool *cached)
+    {
+        LSPString key;
+        if (!make_key(&key, cfg))
+            return STATUS_NO_MEM;
+
+        // Lookup the pool first
+        sMutex.lock();
+        entry_t *e = find_entry(&key);
+        if (e != NULL)
+        {
+            ++e->nRefs;
+            e->nAccess      = ++nTick;
+            *ir             = &e->sIR;
+            *latency        = e->nLatency;
+            sMutex.unlock();
+
+            if (cached != NULL)
+                *cached         = true;
+            return STATUS_OK;
+        }
+        sMutex.unlock();
+
+        // Prepare the IR outside of the lock, so other jobs are not blocked
+        entry_t *ne = new entry_t;
+        if (ne == NULL)
+            return STATUS_NO_MEM;
+        ne->sKey.swap(&key);
+        ne->nLatency    = 0;
+        ne->nRefs       = 1;
+        ne->nAccess     = 0;
+
+        status_t res = prepare_ir(&ne->sIR, &ne->nLatency, cfg, NULL);  // The IR is shared by jobs with different mappings
+        if (res != STATUS_OK)
+        {
+            delete ne;
+            return res;
+        }
+
+        // Another job could prepare the same IR at the same time, prefer the existing entry
+        sMutex.lock();
+        if ((e = find_entry(&ne->sKey)) != NULL)
+        {
+            delete ne;
+            ++e->nRefs;
+        }
+        else if (vEntries.add(ne))
+            e               = ne;
+        else
+        {
+            sMutex.unlock();
+            delete ne;
+            return STATUS_NO_MEM;
+        }
+
+        e->nAccess      = ++nTick;
+        *ir             = &e->sIR;
+        *latency        = e->nLatency;
+        evict();
+        sMutex.unlock();
+
+        if (cached != NULL)
+            *cached         = false;
+        return STATUS_OK;
+    }
+
+    void IRPool::release(const dspu::Sample *ir)
+    {
+        sMutex.lock();
+        for (size_t i=0, n=vEntries.size(); i<n; ++i)
+        {
+            entry_t *e = vEntries.uget(i);
+            if (&e->sIR != ir)
+                continue;
+            if (e->nRefs > 0)
+                --e->nRefs;
+            break;
+        }
+        evict();
+        sMutex.unlock();
+    }
+
+    void IRPool::flush()
+    {
+        sMutex.lock();
+        size_t capacity = nCapacity;
+        nCapacity       = 0;
+        evict();
+        nCapacity       = capacity;
+        sMutex.unlock();
+    }
+}
@@ -0,0 +1,303 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of far-screamer
+ * Created on: 18 окт. 2026 г.
+ *
+ * far-screamer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * far-screamer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with far-screamer. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <private/PairConvolver.h>
+#include <private/Arena.h>
+#include <lsp-plug.in/common/alloc.h>
+#include <lsp-plug.in/dsp/dsp.h>
+
+#define PAIR_MIN_RANK           6           /* Minimum FFT rank */
+#define PAIR_MAX_RANK           20          /* Maximum FFT rank */
+
+namespace far_screamer
+{
+    using namespace lsp;
+
+    PairConvolver::PairConvolver()
+    {
+        nRank       = 0;
+        nBlock      = 0;
+        nStride     = 0;
+        nParts      = 0;
+        nFrame      = 0;
+        nHead       = 0;
+
+        vInRe       = NULL;
+        vInIm       = NULL;
+        vOutRe      = NULL;
+        vOutIm      = NULL;
+        vFftRe      = NULL;
+        vFftIm      = NULL;
+        vAcc        = NULL;
+        vIR         = NULL;
+        vFDL        = NULL;
+    }
+
+    PairConvolver::~PairConvolver()
+    {
+        destroy();
+    }
+
+    void PairConvolver::destroy()
+    {
+        nRank       = 0;
+        nBlock      = 0;
+        nStride     = 0;
+        nParts      = 0;
+        nFrame      = 0;
+        nHead       = 0;
+
+        vInRe       = NULL;
+        vInIm       = NULL;
+        vOutRe      = NULL;
+        vOutIm      = NULL;
+        vFftRe      = NULL;
+        vFftIm      = NULL;
+        vAcc        = NULL;
+        vIR         = NULL;
+        vFDL        = NULL;
+    }
+
+    size_t PairConvolver::select_rank(size_t length, size_t rank)
+    {
+        // Do not use blocks much larger than the impulse response
+        rank        = lsp_limit(rank, size_t(PAIR_MIN_RANK), size_t(PAIR_MAX_RANK));
+        while ((rank > PAIR_MIN_RANK) && ((size_t(1) << (rank - 2)) >= length))
+            --rank;
+        return rank;
+    }
+
+    size_t PairConvolver::data_size(size_t length, size_t rank)
+    {
+        size_t fft_size = size_t(1) << rank;
+        size_t block    = fft_size >> 1;
+        size_t stride   = block + 4;    // Bins 0 .. block, padded to keep alignment
+        size_t parts    = lsp_max((length + block - 1) / block, size_t(1));
+        return fft_size * 4 + block * 2 + stride * 4 + parts * stride * 8;
+    }
+
+    size_t PairConvolver::footprint(size_t length, size_t rank)
+    {
+        return data_size(length, select_rank(length, rank)) * sizeof(float) + DEFAULT_ALIGN;
+    }
+
+    void PairConvolver::partition(size_t *block, size_t *parts, size_t length, size_t rank)
+    {
+        size_t fft_size = size_t(1) << select_rank(length, rank);
+        *block          = fft_size >> 1;
+        *parts          = lsp_max((length + *block - 1) / *block, size_t(1));
+    }
+
+    bool PairConvolver::init(const float *ir0, const float *ir1, size_t length, size_t rank)
+    {
+        destroy();
+
+        rank            = select_rank(length, rank);
+        size_t fft_size = size_t(1) << rank;
+        size_t block    = fft_size >> 1;
+        size_t stride   = block + 4;    // Bins 0 .. block, padded to keep alignment
+        size_t parts    = lsp_max((length + block - 1) / block, size_t(1));
+        size_t to_alloc = data_size(length, rank);
+
+        float *ptr      = thread_arena()->alloc<float>(to_alloc);
+        if (ptr == NULL)
+            return false;
+        dsp::fill_zero(ptr, to_alloc);
+
+        nRank       = rank;
+        nBlock      = block;
+        nStride     = stride;
+        nParts      = parts;
+        nFrame      = 0;
+        nHead       = 0;
+
+        vInRe       = ptr;
+        ptr        += fft_size;
+        vInIm       = ptr;
+        ptr        += fft_size;
+        vFftRe      = ptr;
+        ptr        += fft_size;
+        vFftIm      = ptr;
+        ptr        += fft_size;
+        vOutRe      = ptr;
+        ptr        += block;
+        vOutIm      = ptr;
+        ptr        += block;
+        vAcc        = ptr;
+        ptr        += stride * 4;
+        vIR         = ptr;
+        ptr        += parts * stride * 4;
+        vFDL        = ptr;
+
+        // Estimate the normalization of the reverse FFT: the spectrum of both channels is
+        // unpacked without halving, so the product of spectra should be divided by 4
+        vFftRe[0]       = 1.0f;
+        dsp::reverse_fft(vInRe, vInIm, vFftRe, vFftIm, rank);
+        float k         = 0.25f / (vInRe[0] * fft_size);
+
+        // Compute the spectrum of each partition of the impulse response
+        for (size_t i=0; i<parts; ++i)
+        {
+            size_t offset   = i * block;
+            size_t count    = (offset < length) ? lsp_min(length - offset, block) : 0;
+
+            dsp::fill_zero(vInRe, fft_size);
+            dsp::fill_zero(vInIm, fft_size);
+            if (ir0 != NULL)
+                dsp::copy(vInRe, &ir0[offset], count);
+            if (ir1 != NULL)
+                dsp::copy(vInIm, &ir1[offset], count);
+
+            float *h        = &vIR[i * stride * 4];
+            dsp::direct_fft(vFftRe, vFftIm, vInRe, vInIm, rank);
+            unpack(h, &h[stride], &h[stride * 2], &h[stride * 3]);
+            dsp::mul_k2(h, k, stride * 4);
+        }
+
+        dsp::fill_zero(vInRe, fft_size);
+        dsp::fill_zero(vInIm, fft_size);
+
+        return true;
+    }
+
+    void PairConvolver::unpack(float *x0re, float *x0im, float *x1re, float *x1im)
+    {
+        // Split the spectrum of the packed signal into spectra of real channels:
+        //   X0[k] = Z[k] + conj(Z[N-k]), X1[k] = -i * (Z[k] - conj(Z[N-k]))
+        size_t mask     = (nBlock << 1) - 1;
+        for (size_t k=0; k<=nBlock; ++k)
+        {
+            size_t j        = (-k) & mask;
+            float zr        = vFftRe[k];
+            float zi        = vFftIm[k];
+            float cr        = vFftRe[j];
+            float ci        = vFftIm[j];
+
+            x0re[k]         = zr + cr;
+            x0im[k]         = zi - ci;
+            x1re[k]         = zi + ci;
+            x1im[k]         = cr - zr;
+        }
+    }
+
+    void PairConvolver::process_block()
+    {
+        size_t block    = nBlock;
+        size_t stride   = nStride;
+
+        // Put the spectrum of the input frame to the delay line
+        float *x        = &vFDL[nHead * stride * 4];
+        dsp::direct_fft(vFftRe, vFftIm, vInRe, vInIm, nRank);
+        unpack(x, &x[stride], &x[stride * 2], &x[stride * 3]);
+
+        // Accumulate the products of input spectra and IR partitions
+        float *y0re     = vAcc;
+        float *y0im     = &vAcc[stride];
+        float *y1re     = &vAcc[stride * 2];
+        float *y1im     = &vAcc[stride * 3];
+        dsp::fill_zero(vAcc, stride * 4);
+
+        // The FFT buffer is free until the reverse FFT and holds the product of spectra,
+        // padding bins of partitions are zero and keep the vector kernels aligned
+        for (size_t i=0; i<nParts; ++i)
+        {
+            const float *xs = &vFDL[((nHead + nParts - i) % nParts) * stride * 4];
+            const float *h  = &vIR[i * stride * 4];
+
+            dsp::complex_mul3(vFftRe, vFftIm, xs, &xs[stride], h, &h[stride], stride);
+            dsp::add2(y0re, vFftRe, stride);
+            dsp::add2(y0im, vFftIm, stride);
+            dsp::complex_mul3(vFftRe, vFftIm, &xs[stride * 2], &xs[stride * 3], &h[stride * 2], &h[stride * 3], stride);
+            dsp::add2(y1re, vFftRe, stride);
+            dsp::add2(y1im, vFftIm, stride);
+        }
+
+        // Pack the spectra of both channels back: W[k] = Y0[k] + i*Y1[k],
+        // the upper half of the spectrum is restored from the Hermitian symmetry
+        size_t fft_size = block << 1;
+        for (size_t k=0; k<=block; ++k)
+        {
+            vFftRe[k]       = y0re[k] - y1im[k];
+            vFftIm[k]       = y0im[k] + y1re[k];
+        }
+        for (size_t k=1; k<block; ++k)
+        {
+            vFftRe[fft_size - k]    = y0re[k] + y1im[k];
+            vFftIm[fft_size - k]    = y1re[k] - y0im[k];
+        }
+        dsp::reverse_fft(vFftRe, vFftIm, vFftRe, vFftIm, nRank);
+
+        // The second half of the frame contains the valid output data
+        dsp::copy(vOutRe, &vFftRe[block], block);
+        dsp::copy(vOutIm, &vFftIm[block], block);
+
+        // Shift the input frame
+        dsp::copy(vInRe, &vInRe[block], block);
+        dsp::copy(vInIm, &vInIm[block], block);
+        nHead           = (nHead + 1) % nParts;
+    }
+
+    void PairConvolver::process(float *dst0, float *dst1, const float *src0, const float *src1, size_t count)
+    {
+        while (count > 0)
+        {
+            size_t to_do    = lsp_min(count, nBlock - nFrame);
+
+            // Append input data to the frame
+            if (src0 != NULL)
+            {
+                dsp::copy(&vInRe[nBlock + nFrame], src0, to_do);
+                src0           += to_do;
+            }
+            else
+                dsp::fill_zero(&vInRe[nBlock + nFrame], to_do);
+
+            if (src1 != NULL)
+            {
+                dsp::copy(&vInIm[nBlock + nFrame], src1, to_do);
+                src1           += to_do;
+            }
+            else
+                dsp::fill_zero(&vInIm[nBlock + nFrame], to_do);
+
+            // Emit output data of the previous block
+            if (dst0 != NULL)
+            {
+                dsp::copy(dst0, &vOutRe[nFrame], to_do);
+                dst0           += to_do;
+            }
+            if (dst1 != NULL)
+            {
+                dsp::copy(dst1, &vOutIm[nFrame], to_do);
+                dst1           += to_do;
+            }
+
+            nFrame         += to_do;
+            count          -= to_do;
+
+            if (nFrame >= nBlock)
+            {
+                process_block();
+                nFrame          = 0;
+            }
+        }
+    }
+}
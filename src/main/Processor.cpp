@@ -0,0 +1,243 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of far-screamer
+ * Created on: 18 окт. 2026 г.
+ *
+ * far-screamer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * far-screamer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with far-screamer. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <lsp-plug.in/common/types.h>
+#include <lsp-plug.in/dsp/dsp.h>
+
+#include <far-screamer/Processor.h>
+#include <private/Arena.h>
+#include <private/CompactSample.h>
+#include <private/IRPool.h>
+#include <private/planner.h>
+#include <private/region.h>
+#include <private/tool.h>
+#include <private/log.h>
+
+#define PROCESSOR_IR_POOL_SIZE      4
+#define PROCESSOR_IR_POOL_SHARE     4           /* Unused prepared IRs are limited by the quarter of the memory budget */
+
+namespace far_screamer
+{
+    static bool supports_buffers(const config_t *cfg)
+    {
+        return (cfg->sScratchDir.is_empty()) &&
+            (cfg->sCueList.is_empty()) &&
+            (!region_enabled(cfg));
+    }
+
+    static status_t prepare_pool(IRPool *pool, const config_t *cfg)
+    {
+        const dspu::Sample *ir = NULL;
+        size_t latency = 0;
+
+        status_t res = pool->acquire(&ir, &latency, cfg, NULL);
+        if (res == STATUS_OK)
+            pool->release(ir);
+
+        return res;
+    }
+
+    static status_t render_buffer(dspu::Sample *out, const dspu::Sample *in, const config_t *settings, IRPool *pool)
+    {
+        status_t res;
+        config_t cfg;
+        dspu::Sample tmp;
+        CompactSample cin;
+        plan_t plan;
+
+        if ((res = cfg.copy(settings)) != STATUS_OK)
+            return res;
+        if (!supports_buffers(&cfg))
+        {
+            log_error("Out-of-core, cue list and region rendering is not supported for buffers\n");
+            return STATUS_NOT_SUPPORTED;
+        }
+        if (in->sample_rate() <= 0)
+        {
+            log_error("Sample rate of the input buffer is not set\n");
+            return STATUS_BAD_ARGUMENTS;
+        }
+
+        // Convert the input to the sample rate of the configuration
+        if ((cfg.nSampleRate > 0) && (size_t(cfg.nSampleRate) != in->sample_rate()))
+        {
+            log_info("  resampling input buffer from %d to %d Hz\n", int(in->sample_rate()), int(cfg.nSampleRate));
+            if ((res = tmp.copy(in)) != STATUS_OK)
+                return res;
+            if ((res = tmp.resample(cfg.nSampleRate)) != STATUS_OK)
+                return res;
+            in              = &tmp;
+        }
+        cfg.nSampleRate = in->sample_rate();
+
+        // Obtain the prepared IR from the pool
+        const dspu::Sample *ir = NULL;
+        size_t latency = 0;
+        if ((res = pool->acquire(&ir, &latency, &cfg, NULL)) != STATUS_OK)
+            return res;
+
+        // Convolve the buffer, trim and normalize the output
+        init_plan(&plan);
+        res = render_sample(out, in, &cin, ir, latency, &cfg, NULL, &plan);
+        if (res == STATUS_OK)
+            res = finish_output(out, in->length(), &cfg, NULL);
+        if (res == STATUS_OK)
+            out->set_sample_rate(cfg.nSampleRate);
+        release_memory(&plan);
+        pool->release(ir);
+
+        return res;
+    }
+
+    static status_t render_file(const LSPString *out, const LSPString *in, const config_t *settings, IRPool *pool)
+    {
+        status_t res;
+        config_t cfg;
+        double ir_time = 0.0;
+        bool cached = false, skipped = false;
+
+        if ((res = cfg.copy(settings)) != STATUS_OK)
+            return res;
+        if ((!cfg.sInFile.set(in)) || (!cfg.sOutFile.set(out)))
+            return STATUS_NO_MEM;
+
+        return render_job(&cfg, pool, &ir_time, &cached, &skipped);
+    }
+
+    static void release_arena()
+    {
+        // The thread belongs to the application, the scratch memory is not kept between calls
+        Arena *arena = thread_arena();
+        if (arena->mark() == 0)
+            arena->destroy();
+    }
+
+    Processor::Processor()
+    {
+        pConfig         = NULL;
+        pPool           = NULL;
+        bCallbacks      = false;
+    }
+
+    Processor::~Processor()
+    {
+        destroy();
+    }
+
+    status_t Processor::init(const config_t *cfg, const callbacks_t *cb)
+    {
+        status_t res;
+
+        if (cfg == NULL)
+            return STATUS_BAD_ARGUMENTS;
+        if (pConfig != NULL)
+            return STATUS_BAD_STATE;
+
+        const callbacks_t *prev = set_callbacks(cb);
+        if ((!cfg->sServe.is_empty()) || (!cfg->sWatchDir.is_empty()) ||
+            (!cfg->sMerge.is_empty()) || (!cfg->sAlbum.is_empty()) || (cfg->nPlan != PLAN_NONE))
+        {
+            log_error("Server, watch, merge, album and plan modes are not supported by the processor\n");
+            set_callbacks(prev);
+            return STATUS_NOT_SUPPORTED;
+        }
+
+        dsp::init();
+
+        // Keep own copy of the configuration and callbacks
+        bCallbacks      = cb != NULL;
+        if (bCallbacks)
+            sCallbacks      = *cb;
+        pConfig         = new config_t();
+        pPool           = new IRPool(PROCESSOR_IR_POOL_SIZE, cfg->nMaxMemory / PROCESSOR_IR_POOL_SHARE);
+        if ((pConfig == NULL) || (pPool == NULL))
+            res             = STATUS_NO_MEM;
+        else
+            res             = pConfig->copy(cfg);
+
+        // Prepare the IR in advance when the sample rate is known
+        if ((res == STATUS_OK) && (pConfig->nSampleRate > 0) && (supports_buffers(pConfig)))
+        {
+            dsp::context_t ctx;
+            dsp::start(&ctx);
+            res             = prepare_pool(pPool, pConfig);
+            dsp::finish(&ctx);
+            release_arena();
+        }
+
+        set_callbacks(prev);
+        if (res != STATUS_OK)
+            destroy();
+
+        return res;
+    }
+
+    void Processor::destroy()
+    {
+        if (pPool != NULL)
+        {
+            delete pPool;
+            pPool           = NULL;
+        }
+        if (pConfig != NULL)
+        {
+            delete pConfig;
+            pConfig         = NULL;
+        }
+        bCallbacks      = false;
+    }
+
+    status_t Processor::process(dspu::Sample *out, const dspu::Sample *in, const callbacks_t *cb)
+    {
+        if ((out == NULL) || (in == NULL))
+            return STATUS_BAD_ARGUMENTS;
+        if (pConfig == NULL)
+            return STATUS_BAD_STATE;
+
+        const callbacks_t *prev = set_callbacks((cb != NULL) ? cb : (bCallbacks) ? &sCallbacks : NULL);
+        dsp::context_t ctx;
+        dsp::start(&ctx);
+        status_t res = render_buffer(out, in, pConfig, pPool);
+        dsp::finish(&ctx);
+        release_arena();
+        set_callbacks(prev);
+
+        return res;
+    }
+
+    status_t Processor::process(const LSPString *out, const LSPString *in, const callbacks_t *cb)
+    {
+        if ((out == NULL) || (in == NULL))
+            return STATUS_BAD_ARGUMENTS;
+        if (pConfig == NULL)
+            return STATUS_BAD_STATE;
+
+        const callbacks_t *prev = set_callbacks((cb != NULL) ? cb : (bCallbacks) ? &sCallbacks : NULL);
+        dsp::context_t ctx;
+        dsp::start(&ctx);
+        status_t res = render_file(out, in, pConfig, pPool);
+        dsp::finish(&ctx);
+        release_arena();
+        set_callbacks(prev);
+
+        return res;
+    }
+}
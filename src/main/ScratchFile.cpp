@@ -0,0 +1,242 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of far-screamer
+ * Created on: 18 окт. 2026 г.
+ *
+ * far-screamer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * far-screamer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with far-screamer. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <lsp-plug.in/common/types.h>
+#include <lsp-plug.in/ipc/Mutex.h>
+#include <lsp-plug.in/stdlib/stdio.h>
+
+#include <private/ScratchFile.h>
+#include <private/log.h>
+
+#ifdef PLATFORM_UNIX_COMPATIBLE
+    #include <errno.h>
+    #include <fcntl.h>
+    #include <unistd.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+#endif /* PLATFORM_UNIX_COMPATIBLE */
+
+namespace far_screamer
+{
+    static ipc::Mutex   scratch_lock;
+    static size_t       scratch_counter = 0;
+
+    ScratchFile::ScratchFile()
+    {
+        pData       = NULL;
+        nMapped     = 0;
+        nStride     = 0;
+        nChannels   = 0;
+        nLength     = 0;
+        hFD         = -1;
+    }
+
+    ScratchFile::~ScratchFile()
+    {
+        close();
+    }
+
+#ifdef PLATFORM_UNIX_COMPATIBLE
+    status_t ScratchFile::open(const io::Path *dir, size_t channels, size_t length)
+    {
+        status_t res;
+        io::Path path;
+        char name[64];
+
+        close();
+
+        // Generate the unique name of the scratch file
+        scratch_lock.lock();
+        size_t serial   = ++scratch_counter;
+        scratch_lock.unlock();
+        snprintf(name, sizeof(name), ".far-screamer-%d-%d.scratch", int(getpid()), int(serial));
+        if ((res = path.set(dir, name)) != STATUS_OK)
+            return res;
+
+        // Create the file and unlink it immediately, the storage is released on close
+        int fd = ::open(path.as_native(), O_RDWR | O_CREAT | O_EXCL, 0600);
+        if (fd < 0)
+        {
+            log_error("  could not create scratch file '%s', error code: %d\n", path.as_native(), int(errno));
+            return STATUS_IO_ERROR;
+        }
+        unlink(path.as_native());
+
+        return map_file(fd, dir, channels, length, false);
+    }
+
+    status_t ScratchFile::open_file(const io::Path *path, size_t channels, size_t length, bool keep)
+    {
+        close();
+
+        int fd = ::open(path->as_native(), O_RDWR | O_CREAT, 0600);
+        if (fd < 0)
+        {
+            log_error("  could not open scratch file '%s', error code: %d\n", path->as_native(), int(errno));
+            return STATUS_IO_ERROR;
+        }
+
+        return map_file(fd, path, channels, length, keep);
+    }
+
+    status_t ScratchFile::map_file(int fd, const io::Path *path, size_t channels, size_t length, bool keep)
+    {
+        // Each channel starts at the page boundary
+        size_t page     = sysconf(_SC_PAGESIZE);
+        size_t stride   = ((lsp_max(length, size_t(1)) * sizeof(float) + page - 1) / page) * page;
+        size_t size     = stride * lsp_max(channels, size_t(1));
+
+        // The kept data should have the same layout, the new data is filled with zeros
+        if (keep)
+        {
+            struct stat st;
+            if ((fstat(fd, &st) != 0) || (size_t(st.st_size) != size))
+            {
+                ::close(fd);
+                return STATUS_CORRUPTED;
+            }
+        }
+        else if ((ftruncate(fd, 0) != 0) || (ftruncate(fd, off_t(size)) != 0))
+        {
+            log_error("  could not allocate %.1f MiB for scratch file in '%s'\n",
+                double(size) / double(1 << 20), path->as_native());
+            ::close(fd);
+            return STATUS_NO_MEM;
+        }
+
+        void *ptr       = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (ptr == MAP_FAILED)
+        {
+            log_error("  could not map scratch file to memory, error code: %d\n", int(errno));
+            ::close(fd);
+            return STATUS_NO_MEM;
+        }
+    #ifdef MADV_SEQUENTIAL
+        madvise(ptr, size, MADV_SEQUENTIAL);
+    #endif /* MADV_SEQUENTIAL */
+
+        pData           = static_cast<uint8_t *>(ptr);
+        nMapped         = size;
+        nStride         = stride;
+        nChannels       = channels;
+        nLength         = length;
+        hFD             = fd;
+
+        return STATUS_OK;
+    }
+
+    void ScratchFile::close()
+    {
+        if (pData != NULL)
+        {
+            munmap(pData, nMapped);
+            pData       = NULL;
+        }
+        if (hFD >= 0)
+        {
+            ::close(hFD);
+            hFD         = -1;
+        }
+
+        nMapped     = 0;
+        nStride     = 0;
+        nChannels   = 0;
+        nLength     = 0;
+    }
+
+    status_t ScratchFile::sync()
+    {
+        if (pData == NULL)
+            return STATUS_OK;
+        return (msync(pData, nMapped, MS_SYNC) == 0) ? STATUS_OK : STATUS_IO_ERROR;
+    }
+
+    static void advise_range(uint8_t *data, size_t offset, size_t count, int advice)
+    {
+        // The range should be aligned to the page boundary
+        size_t page     = sysconf(_SC_PAGESIZE);
+        size_t head     = (offset / page) * page;
+        size_t tail     = offset + count;
+        if (tail > head)
+            madvise(&data[head], tail - head, advice);
+    }
+
+    void ScratchFile::prefetch(size_t channel, size_t offset, size_t count) const
+    {
+        if ((pData == NULL) || (channel >= nChannels))
+            return;
+
+        offset          = lsp_min(offset, nLength);
+        count           = lsp_min(count, nLength - offset);
+        advise_range(&pData[channel * nStride], offset * sizeof(float), count * sizeof(float), MADV_WILLNEED);
+    }
+
+    void ScratchFile::release(size_t channel, size_t offset, size_t count) const
+    {
+        if ((pData == NULL) || (channel >= nChannels))
+            return;
+
+        // Only whole pages inside of the range can be dropped, the file mapping
+        // is shared, so the dirty pages are kept in the page cache and the file
+        offset          = lsp_min(offset, nLength);
+        count           = lsp_min(count, nLength - offset);
+        size_t page     = sysconf(_SC_PAGESIZE) / sizeof(float);
+        size_t head     = ((offset + page - 1) / page) * page;
+        size_t tail     = ((offset + count) / page) * page;
+        if (tail > head)
+            madvise(&pData[channel * nStride + head * sizeof(float)], (tail - head) * sizeof(float), MADV_DONTNEED);
+    }
+#else
+    status_t ScratchFile::open(const io::Path *dir, size_t channels, size_t length)
+    {
+        log_error("  scratch files are not supported on this platform\n");
+        return STATUS_NOT_SUPPORTED;
+    }
+
+    status_t ScratchFile::open_file(const io::Path *path, size_t channels, size_t length, bool keep)
+    {
+        log_error("  scratch files are not supported on this platform\n");
+        return STATUS_NOT_SUPPORTED;
+    }
+
+    status_t ScratchFile::map_file(int fd, const io::Path *path, size_t channels, size_t length, bool keep)
+    {
+        return STATUS_NOT_SUPPORTED;
+    }
+
+    void ScratchFile::close()
+    {
+    }
+
+    status_t ScratchFile::sync()
+    {
+        return STATUS_OK;
+    }
+
+    void ScratchFile::prefetch(size_t channel, size_t offset, size_t count) const
+    {
+    }
+
+    void ScratchFile::release(size_t channel, size_t offset, size_t count) const
+    {
+    }
+#endif /* PLATFORM_UNIX_COMPATIBLE */
+}
@@ -0,0 +1,240 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of far-screamer
+ * Created on: 18 окт. 2026 г.
+ *
+ * far-screamer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * far-screamer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with far-screamer. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <lsp-plug.in/dsp/dsp.h>
+#include <lsp-plug.in/stdlib/string.h>
+
+#include <private/WorkerPool.h>
+
+#ifdef PLATFORM_UNIX_COMPATIBLE
+    #include <signal.h>
+    #include <unistd.h>
+#endif /* PLATFORM_UNIX_COMPATIBLE */
+
+namespace far_screamer
+{
+#ifdef PLATFORM_UNIX_COMPATIBLE
+    static volatile sig_atomic_t stop_flag = 0;
+
+    static void on_stop_signal(int /* signum */)
+    {
+        stop_flag       = 1;
+    }
+
+    void install_stop_handlers()
+    {
+        struct sigaction sa;
+        memset(&sa, 0, sizeof(sa));
+        sa.sa_handler   = on_stop_signal;
+        sigemptyset(&sa.sa_mask);
+        sigaction(SIGINT, &sa, NULL);
+        sigaction(SIGTERM, &sa, NULL);
+        signal(SIGPIPE, SIG_IGN);
+    }
+
+    bool stop_requested()
+    {
+        return stop_flag;
+    }
+
+    WorkerPool::WorkerPool()
+    {
+        pthread_mutex_init(&sMutex, NULL);
+        pthread_cond_init(&sCond, NULL);
+        pHead           = NULL;
+        pTail           = NULL;
+        bShutdown       = false;
+        pHandler        = NULL;
+        pArg            = NULL;
+    }
+
+    WorkerPool::~WorkerPool()
+    {
+        stop();
+        pthread_cond_destroy(&sCond);
+        pthread_mutex_destroy(&sMutex);
+    }
+
+    void *WorkerPool::thread_main(void *arg)
+    {
+        WorkerPool *self = static_cast<WorkerPool *>(arg);
+
+        dsp::context_t ctx;
+        dsp::start(&ctx);
+
+        while (true)
+        {
+            // Fetch the next task, the queue is drained before shutdown
+            pthread_mutex_lock(&self->sMutex);
+            while ((self->pHead == NULL) && (!self->bShutdown))
+                pthread_cond_wait(&self->sCond, &self->sMutex);
+            node_t *node = self->pHead;
+            if (node != NULL)
+            {
+                self->pHead     = node->pNext;
+                if (self->pHead == NULL)
+                    self->pTail     = NULL;
+            }
+            pthread_mutex_unlock(&self->sMutex);
+
+            if (node == NULL)
+                break;
+
+            self->pHandler(node->pTask, self->pArg);
+            delete node;
+        }
+
+        dsp::finish(&ctx);
+
+        return NULL;
+    }
+
+    status_t WorkerPool::start(size_t workers, handler_t handler, void *arg)
+    {
+        if (vThreads.size() > 0)
+            return STATUS_BAD_STATE;
+
+        if (workers <= 0)
+        {
+            long cpus       = sysconf(_SC_NPROCESSORS_ONLN);
+            workers         = (cpus > 0) ? cpus : 1;
+        }
+
+        pHandler        = handler;
+        pArg            = arg;
+        bShutdown       = false;
+
+        // Workers inherit the blocked stop signals
+        sigset_t stop_set, old_set;
+        sigemptyset(&stop_set);
+        sigaddset(&stop_set, SIGINT);
+        sigaddset(&stop_set, SIGTERM);
+        pthread_sigmask(SIG_BLOCK, &stop_set, &old_set);
+
+        status_t res = STATUS_OK;
+        for (size_t i=0; i<workers; ++i)
+        {
+            pthread_t *t = vThreads.add();
+            if (t == NULL)
+            {
+                res     = STATUS_NO_MEM;
+                break;
+            }
+            if (pthread_create(t, NULL, thread_main, this) != 0)
+            {
+                vThreads.pop();
+                res     = STATUS_UNKNOWN_ERR;
+                break;
+            }
+        }
+
+        pthread_sigmask(SIG_SETMASK, &old_set, NULL);
+
+        if (res != STATUS_OK)
+            stop();
+
+        return res;
+    }
+
+    bool WorkerPool::submit(void *task)
+    {
+        node_t *node    = new node_t;
+        if (node == NULL)
+            return false;
+        node->pTask     = task;
+        node->pNext     = NULL;
+
+        pthread_mutex_lock(&sMutex);
+        if (pTail != NULL)
+            pTail->pNext    = node;
+        else
+            pHead           = node;
+        pTail           = node;
+        pthread_cond_signal(&sCond);
+        pthread_mutex_unlock(&sMutex);
+
+        return true;
+    }
+
+    void WorkerPool::stop()
+    {
+        pthread_mutex_lock(&sMutex);
+        bShutdown       = true;
+        pthread_cond_broadcast(&sCond);
+        pthread_mutex_unlock(&sMutex);
+
+        for (size_t i=0, n=vThreads.size(); i<n; ++i)
+            pthread_join(*vThreads.uget(i), NULL);
+        vThreads.flush();
+    }
+
+    size_t WorkerPool::workers() const
+    {
+        return vThreads.size();
+    }
+#else
+    void install_stop_handlers()
+    {
+    }
+
+    bool stop_requested()
+    {
+        return false;
+    }
+
+    WorkerPool::WorkerPool()
+    {
+        pHead           = NULL;
+        pTail           = NULL;
+        bShutdown       = false;
+        pHandler        = NULL;
+        pArg            = NULL;
+    }
+
+    WorkerPool::~WorkerPool()
+    {
+    }
+
+    void *WorkerPool::thread_main(void *arg)
+    {
+        return NULL;
+    }
+
+    status_t WorkerPool::start(size_t workers, handler_t handler, void *arg)
+    {
+        return STATUS_NOT_SUPPORTED;
+    }
+
+    bool WorkerPool::submit(void *task)
+    {
+        return false;
+    }
+
+    void WorkerPool::stop()
+    {
+    }
+
+    size_t WorkerPool::workers() const
+    {
+        return 0;
+    }
+#endif /* PLATFORM_UNIX_COMPATIBLE */
+}
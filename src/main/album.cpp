@@ -0,0 +1,173 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of far-screamer
+ * Created on: 18 окт. 2026 г.
+ *
+ * far-screamer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * far-screamer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with far-screamer. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <lsp-plug.in/common/types.h>
+#include <lsp-plug.in/dsp/dsp.h>
+#include <lsp-plug.in/io/Path.h>
+#include <lsp-plug.in/lltl/darray.h>
+#include <lsp-plug.in/stdlib/stdio.h>
+
+#include <private/album.h>
+#include <private/audio.h>
+#include <private/CompactSample.h>
+#include <private/tool.h>
+#include <private/log.h>
+
+namespace far_screamer
+{
+    static status_t carry_tail(dspu::Sample *out, dspu::Sample *carry, size_t length, bool last)
+    {
+        size_t channels     = out->channels();
+        if ((carry->length() > 0) && (carry->channels() != channels))
+        {
+            log_error("  output has %d channels, the tail of the previous file has %d channels\n",
+                int(channels), int(carry->channels()));
+            return STATUS_BAD_FORMAT;
+        }
+
+        // Mix the tail carried from previous files into the head of the output
+        dspu::Sample mix;
+        size_t total        = lsp_max(out->length(), carry->length());
+        if (!mix.init(channels, total, total))
+        {
+            log_error("Not enough memory for output data\n");
+            return STATUS_NO_MEM;
+        }
+        for (size_t i=0; i<channels; ++i)
+        {
+            float *dst          = mix.channel(i);
+            dsp::copy(dst, out->channel(i), out->length());
+            dsp::fill_zero(&dst[out->length()], total - out->length());
+            if (carry->length() > 0)
+                dsp::add2(dst, carry->channel(i), carry->length());
+        }
+
+        // The part of the output after the end of the input is carried to the next file
+        if (last)
+            carry->set_length(0);
+        else
+        {
+            status_t res        = carry->copy(&mix);
+            if (res != STATUS_OK)
+            {
+                log_error("Not enough memory for output data\n");
+                return res;
+            }
+            crop_sample(carry, length, total);
+            mix.set_length(length);
+        }
+
+        out->swap(&mix);
+        return STATUS_OK;
+    }
+
+    status_t render_album(config_t *cfg)
+    {
+        status_t res;
+        io::Path dir;
+        dspu::Sample ir, carry;
+        lltl::darray<mapping_t> mapping;
+        size_t latency      = 0;
+
+        if ((res = dir.set(&cfg->sOutDir)) != STATUS_OK)
+            return res;
+        if ((res = dir.mkdir(true)) != STATUS_OK)
+        {
+            log_error("Could not create directory '%s', error code: %d\n", dir.as_native(), int(res));
+            return res;
+        }
+
+        // All files are processed at the sample rate of the first file, the IR is prepared once.
+        // IR channels are selected on the mapping of the configuration which is the same for all files
+        if (cfg->nSampleRate <= 0)
+        {
+            audio_info_t info;
+            if ((res = read_audio_info(&info, cfg->sAlbum.uget(0))) != STATUS_OK)
+                return res;
+            cfg->nSampleRate    = info.sample_rate;
+        }
+        lltl::darray<size_t> ir_channels;
+        if ((res = select_channels(&ir_channels, cfg, true, true)) != STATUS_OK)
+            return res;
+        if ((res = prepare_ir(&ir, &latency, cfg, &ir_channels)) != STATUS_OK)
+            return res;
+
+        // The mapping is generated for each file, keep the mapping of the configuration
+        // with IR channels referring to loaded channels of the IR
+        for (size_t i=0, n=cfg->sMapping.size(); i<n; ++i)
+            if (mapping.add(cfg->sMapping.uget(i)) == NULL)
+            {
+                log_error("Not enough memory for routing data\n");
+                return STATUS_NO_MEM;
+            }
+
+        for (size_t i=0, n=cfg->sAlbum.size(); i<n; ++i)
+        {
+            dspu::Sample in, out;
+            CompactSample cin;
+            plan_t plan;
+            io::Path path;
+            LSPString name;
+            bool last           = (i + 1) >= n;
+
+            // The output file has the name of the input file, the output is always written as WAV
+            if ((res = path.set(cfg->sAlbum.uget(i))) != STATUS_OK)
+                return res;
+            if ((res = path.get_last_noext(&name)) != STATUS_OK)
+                return res;
+            if (!name.append_ascii(".wav"))
+                return STATUS_NO_MEM;
+            if ((res = path.set(&dir, &name)) != STATUS_OK)
+                return res;
+            if ((!cfg->sInFile.set(cfg->sAlbum.uget(i))) || (!cfg->sOutFile.set(path.as_string())))
+                return STATUS_NO_MEM;
+            cfg->sMapping.clear();
+            for (size_t j=0, m=mapping.size(); j<m; ++j)
+                if (cfg->sMapping.add(mapping.uget(j)) == NULL)
+                    return STATUS_NO_MEM;
+            log_info("  rendering file %d of %d of the album\n", int(i + 1), int(n));
+
+            if ((res = load_input(&in, &cin, cfg, NULL)) != STATUS_OK)
+                return res;
+
+            size_t in_length    = (cin.valid()) ? cin.length() : in.length();
+            size_t sample_rate  = (cin.valid()) ? cin.sample_rate() : in.sample_rate();
+            init_plan(&plan);
+            res = render_sample(&out, &in, &cin, &ir, latency, cfg, NULL, &plan);
+            if (res == STATUS_OK)
+                res = carry_tail(&out, &carry, in_length, last);
+
+            // Trim the last file if option is specified
+            if ((res == STATUS_OK) && (last) && (cfg->bTrim))
+                out.set_length(in_length);
+            if (res == STATUS_OK)
+            {
+                out.set_sample_rate(sample_rate);
+                res = save_audio_file(&out, &cfg->sOutFile);
+            }
+            release_memory(&plan);
+            if (res != STATUS_OK)
+                return res;
+        }
+
+        return STATUS_OK;
+    }
+}
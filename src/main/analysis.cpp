@@ -0,0 +1,76 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of far-screamer
+ * Created on: 18 окт. 2026 г.
+ *
+ * far-screamer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * far-screamer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with far-screamer. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <private/analysis.h>
+#include <lsp-plug.in/stdlib/math.h>
+#include <lsp-plug.in/dsp/dsp.h>
+
+#define SPARSE_MAX_TAPS         32          /* Maximum number of taps in the sparse head */
+#define SPARSE_WINDOW           32          /* The window to estimate the density of reflections */
+#define SPARSE_MAX_DENSITY      2           /* Maximum number of reflections in the window */
+#define SPARSE_MIN_OFFSET       256         /* Minimum offset of the dense part to take effect */
+
+namespace far_screamer
+{
+    using namespace lsp;
+
+    size_t find_sparse_head(lltl::darray<tap_t> *taps, const float *ir, size_t length, float threshold)
+    {
+        taps->clear();
+
+        float peak      = dsp::abs_max(ir, length);
+        if (peak <= 0.0f)
+            return 0;
+        threshold      *= peak;
+
+        // Seek for the start of the dense part
+        size_t offset   = 0;
+        for ( ; offset < length; ++offset)
+        {
+            if (fabsf(ir[offset]) <= threshold)
+                continue;
+
+            // Estimate the density of reflections starting at current position
+            size_t density  = 0;
+            for (size_t i=offset, n=lsp_min(offset + SPARSE_WINDOW, length); i<n; ++i)
+                if (fabsf(ir[i]) > threshold)
+                    ++density;
+            if ((density > SPARSE_MAX_DENSITY) || (taps->size() >= SPARSE_MAX_TAPS))
+                break;
+
+            // Add the reflection to the list of taps
+            tap_t *t        = taps->add();
+            if (t == NULL)
+                break;
+            t->offset       = offset;
+            t->gain         = ir[offset];
+        }
+
+        // Check that the sparse head is long enough
+        if (offset < SPARSE_MIN_OFFSET)
+        {
+            taps->clear();
+            return 0;
+        }
+
+        return offset;
+    }
+}
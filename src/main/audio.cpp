@@ -20,14 +20,32 @@
  */
 
 #include <private/audio.h>
-#include <private/config.h>
+#include <private/analysis.h>
+#include <private/AudioReader.h>
+#include <private/AudioWriter.h>
+#include <private/PairConvolver.h>
+#include <private/Arena.h>
+#include <private/CompactSample.h>
+#include <private/log.h>
+#include <far-screamer/config.h>
 #include <lsp-plug.in/stdlib/stdio.h>
+#include <lsp-plug.in/stdlib/math.h>
 #include <lsp-plug.in/common/alloc.h>
 #include <lsp-plug.in/dsp/dsp.h>
 #include <lsp-plug.in/expr/Expression.h>
 #include <lsp-plug.in/dsp-units/misc/windows.h>
 #include <lsp-plug.in/dsp-units/misc/fade.h>
 #include <lsp-plug.in/dsp-units/util/Convolver.h>
+#include <lsp-plug.in/ipc/Mutex.h>
+
+#ifdef PLATFORM_WINDOWS
+    #include <process.h>
+#else
+    #include <unistd.h>
+#endif /* PLATFORM_WINDOWS */
+
+#define TAIL_BLOCK_SIZE         0x1000
+#define COMPACT_BLOCK_SIZE      0x1000
 
 namespace far_screamer
 {
@@ -41,9 +59,9 @@ namespace far_screamer
         size_t ms;
     } duration_t;
 
-    void calc_duration(duration_t *d, const dspu::Sample *sample)
+    void calc_duration(duration_t *d, size_t samples, size_t sample_rate)
     {
-        uint64_t duration = (uint64_t(sample->samples()) * 1000) / sample->sample_rate();
+        uint64_t duration = (uint64_t(samples) * 1000) / sample_rate;
         d->ms = duration % 1000;
         duration /= 1000;
         d->s = duration % 60;
@@ -52,7 +70,133 @@ namespace far_screamer
         d->h = duration / 60;
     }
 
-    status_t load_audio_file(dspu::Sample *sample, ssize_t srate, const LSPString *name)
+    static ipc::Mutex   temp_lock;
+    static size_t       temp_counter = 0;
+
+    status_t make_temp_path(io::Path *tmp, const io::Path *path)
+    {
+        status_t res;
+        LSPString name, ext, last;
+
+        temp_lock.lock();
+        size_t serial = ++temp_counter;
+        temp_lock.unlock();
+
+    #ifdef PLATFORM_WINDOWS
+        int pid = _getpid();
+    #else
+        int pid = getpid();
+    #endif /* PLATFORM_WINDOWS */
+
+        // Keep the extension as it defines the format of the file
+        if ((res = path->get_last_noext(&name)) != STATUS_OK)
+            return res;
+        if ((res = path->get_ext(&ext)) != STATUS_OK)
+            return res;
+        if (last.fmt_ascii(".%s.%d-%d.part", name.get_native(), pid, int(serial)) <= 0)
+            return STATUS_NO_MEM;
+        if ((!ext.is_empty()) && ((!last.append('.')) || (!last.append(&ext))))
+            return STATUS_NO_MEM;
+
+        if ((res = tmp->set(path)) != STATUS_OK)
+            return res;
+        return tmp->set_last(&last);
+    }
+
+    status_t read_audio_info(audio_info_t *info, const LSPString *name)
+    {
+        status_t res;
+        io::Path path;
+        AudioReader rd;
+
+        if ((res = path.set(name)) == STATUS_OK)
+            res = rd.open(&path);
+        if (res != STATUS_OK)
+        {
+            log_error("  could not read file '%s', error code: %d\n", name->get_native(), int(res));
+            return res;
+        }
+
+        *info               = *rd.info();
+        rd.close();
+
+        return STATUS_OK;
+    }
+
+    static inline size_t selected_channels(size_t file_channels, const lltl::darray<size_t> *channels)
+    {
+        return ((channels != NULL) && (!channels->is_empty())) ? channels->size() : file_channels;
+    }
+
+    static inline size_t selected_channel(size_t i, const lltl::darray<size_t> *channels)
+    {
+        return ((channels != NULL) && (!channels->is_empty())) ? *channels->uget(i) : i;
+    }
+
+    static inline size_t range_length(size_t length, const audio_range_t *range)
+    {
+        if (range == NULL)
+            return length;
+        size_t avail        = (range->offset < length) ? length - range->offset : 0;
+        return (range->length >= 0) ? lsp_min(avail, size_t(range->length)) : avail;
+    }
+
+    /**
+     * Make the table of decoding buffers indexed by channels of the file,
+     * channels which are not selected have NULL buffers and are not decoded
+     */
+    static status_t bind_channels(float **table, float * const *bufs, size_t file_channels, const lltl::darray<size_t> *channels)
+    {
+        for (size_t i=0; i<file_channels; ++i)
+            table[i]            = NULL;
+        for (size_t i=0, n=selected_channels(file_channels, channels); i<n; ++i)
+        {
+            size_t ch           = selected_channel(i, channels);
+            if (ch >= file_channels)
+                return STATUS_BAD_ARGUMENTS;
+            table[ch]           = bufs[i];
+        }
+
+        return STATUS_OK;
+    }
+
+    static status_t decode_sample(dspu::Sample *dst, AudioReader *rd, const lltl::darray<size_t> *channels, const audio_range_t *range)
+    {
+        status_t res;
+        size_t count        = selected_channels(rd->channels(), channels);
+        size_t length       = range_length(rd->length(), range);
+        if (!dst->init(count, length, length))
+            return STATUS_NO_MEM;
+        if ((range != NULL) && ((res = rd->skip(range->offset)) != STATUS_OK))
+            return res;
+        dst->set_sample_rate(rd->sample_rate());
+
+        // Decode all frames directly to channels of the sample
+        Arena *arena        = thread_arena();
+        size_t mark         = arena->mark();
+        float **bufs        = arena->alloc<float *>(count);
+        float **table       = arena->alloc<float *>(rd->channels());
+        if ((bufs == NULL) || (table == NULL))
+        {
+            arena->rewind(mark);
+            return STATUS_NO_MEM;
+        }
+        for (size_t i=0; i<count; ++i)
+            bufs[i]             = dst->channel(i);
+
+        ssize_t read        = -STATUS_BAD_ARGUMENTS;
+        if ((res = bind_channels(table, bufs, rd->channels(), channels)) == STATUS_OK)
+            read                = rd->read(table, length);
+        arena->rewind(mark);
+        if (read < 0)
+            return status_t(-read);
+        dst->set_length(read);
+
+        return STATUS_OK;
+    }
+
+    status_t load_audio_file(dspu::Sample *sample, ssize_t srate, const LSPString *name,
+        const lltl::darray<size_t> *channels, const audio_range_t *range)
     {
         status_t res;
         io::Path path;
@@ -60,20 +204,30 @@ namespace far_screamer
         // Generate file name
         if ((res = path.set(name)) != STATUS_OK)
         {
-            fprintf(stderr, "  could not read file '%s', error code: %d\n", name->get_native(), int(res));
+            log_error("  could not read file '%s', error code: %d\n", name->get_native(), int(res));
             return res;
         }
 
-        // Load sample from file
-        if ((res = sample->load(&path)) != STATUS_OK)
+        // Decode only the selected channels, WAV files are decoded by the built-in codec and other
+        // formats by the stream of the library. The range is decoded directly only if the file
+        // does not need resampling
+        AudioReader rd;
+        bool direct     = false;
+        if ((res = rd.open(&path)) == STATUS_OK)
+        {
+            direct          = (srate <= 0) || (size_t(srate) == rd.sample_rate());
+            res             = decode_sample(sample, &rd, channels, (direct) ? range : NULL);
+        }
+        rd.close();
+        if (res != STATUS_OK)
         {
-            fprintf(stderr, "  could not read file '%s', error code: %d\n", path.as_native(), int(res));
+            log_error("  could not read file '%s', error code: %d\n", path.as_native(), int(res));
             return res;
         }
 
         duration_t d;
-        calc_duration(&d, sample);
-        fprintf(stdout, "  loaded file: '%s', channels: %d, samples: %d, sample rate: %d, duration: %02d:%02d:%02d.%03d\n",
+        calc_duration(&d, sample->samples(), sample->sample_rate());
+        log_info("  loaded file: '%s', channels: %d, samples: %d, sample rate: %d, duration: %02d:%02d:%02d.%03d\n",
                 path.as_native(),
                 int(sample->channels()), int(sample->length()), int(sample->sample_rate()),
                 int(d.h), int(d.m), int(d.s), int(d.ms)
@@ -84,131 +238,528 @@ namespace far_screamer
         {
             if ((res = sample->resample(srate)) != STATUS_OK)
             {
-                fprintf(stderr, "  could not resample file '%s' to sample rate %d, error code: %d\n",
+                log_error("  could not resample file '%s' to sample rate %d, error code: %d\n",
                         path.as_native(), int(srate), int(res)
                 );
                 return res;
             }
         }
 
+        // Cut the range of the resampled data
+        if ((range != NULL) && (!direct))
+            crop_sample(sample, range->offset, range_length(sample->length(), range));
+
         return STATUS_OK;
     }
 
-    status_t save_audio_file(dspu::Sample *sample, const LSPString *fname)
+    static status_t decode_compact(CompactSample *dst, AudioReader *rd, size_t format,
+        const lltl::darray<size_t> *channels, const audio_range_t *range)
+    {
+        const audio_info_t *info = rd->info();
+        size_t count        = selected_channels(info->channels, channels);
+        size_t length       = range_length(info->length, range);
+        status_t res        = dst->init(count, length, info->sample_rate, format);
+        if (res != STATUS_OK)
+            return res;
+        if ((range != NULL) && ((res = rd->skip(range->offset)) != STATUS_OK))
+            return res;
+
+        // Decode frames by blocks to planar buffers and encode them channel by channel
+        Arena *arena        = thread_arena();
+        size_t mark         = arena->mark();
+        float *buf          = arena->alloc<float>(COMPACT_BLOCK_SIZE * count);
+        float **bufs        = arena->alloc<float *>(count);
+        float **table       = arena->alloc<float *>(info->channels);
+        if ((buf == NULL) || (bufs == NULL) || (table == NULL))
+        {
+            arena->rewind(mark);
+            return STATUS_NO_MEM;
+        }
+        for (size_t i=0; i<count; ++i)
+            bufs[i]             = &buf[COMPACT_BLOCK_SIZE * i];
+        if ((res = bind_channels(table, bufs, info->channels, channels)) != STATUS_OK)
+        {
+            arena->rewind(mark);
+            return res;
+        }
+
+        for (size_t offset = 0; offset < length; )
+        {
+            ssize_t read        = rd->read(table, lsp_min(length - offset, size_t(COMPACT_BLOCK_SIZE)));
+            if (read <= 0)
+            {
+                // The stream may be shorter than the header says
+                if (read < 0)
+                    res                 = status_t(-read);
+                break;
+            }
+
+            for (size_t i=0; i<count; ++i)
+                dst->write(i, offset, bufs[i], read);
+            offset             += read;
+        }
+
+        arena->rewind(mark);
+        return res;
+    }
+
+    status_t load_compact_file(CompactSample *sample, ssize_t srate, size_t format, const LSPString *name,
+        const lltl::darray<size_t> *channels, const audio_range_t *range)
+    {
+        status_t res;
+        io::Path path;
+        audio_info_t info;
+        AudioReader rd;
+
+        if ((res = read_audio_info(&info, name)) != STATUS_OK)
+            return res;
+
+        if ((srate > 0) && (size_t(srate) != info.sample_rate))
+        {
+            // Resample the floating-point data and encode it
+            dspu::Sample tmp;
+            if ((res = load_audio_file(&tmp, srate, name, channels, range)) != STATUS_OK)
+                return res;
+            res = sample->encode(&tmp, format);
+        }
+        else
+        {
+            // Decode the file directly to the compact storage
+            if ((res = path.set(name)) == STATUS_OK)
+            {
+                if ((res = rd.open(&path)) == STATUS_OK)
+                {
+                    res = decode_compact(sample, &rd, format, channels, range);
+                    rd.close();
+                }
+            }
+            if (res != STATUS_OK)
+            {
+                log_error("  could not read file '%s', error code: %d\n", name->get_native(), int(res));
+                return res;
+            }
+
+            duration_t d;
+            calc_duration(&d, sample->length(), sample->sample_rate());
+            log_info("  loaded file: '%s', channels: %d, samples: %d, sample rate: %d, duration: %02d:%02d:%02d.%03d\n",
+                    path.as_native(),
+                    int(sample->channels()), int(sample->length()), int(sample->sample_rate()),
+                    int(d.h), int(d.m), int(d.s), int(d.ms)
+            );
+        }
+        if (res != STATUS_OK)
+        {
+            log_error("  not enough memory for compact storage of file '%s'\n", name->get_native());
+            return res;
+        }
+
+        log_info("  keeping input in compact storage: %.1f MiB\n", double(sample->bytes()) / double(1 << 20));
+        if (sample->clipped() > 0)
+            log_error("  %lld samples of the input are out of range and were clipped by the compact storage\n",
+                (long long)(sample->clipped()));
+
+        return STATUS_OK;
+    }
+
+    status_t open_output_file(io::Path *path, io::Path *tmp, const LSPString *fname)
     {
         status_t res;
-        expr::Expression x;
-        io::Path path, dir;
+        io::Path dir;
 
         // Generate file name
-        if ((res = path.set(fname)) != STATUS_OK)
+        if ((res = path->set(fname)) != STATUS_OK)
         {
-            fprintf(stderr, "  could not write file '%s', error code: %d\n", fname->get_native(), int(res));
+            log_error("  could not write file '%s', error code: %d\n", fname->get_native(), int(res));
             return res;
         }
 
         // Create parent directory recursively
-        res = path.get_parent(&dir);
+        res = path->get_parent(&dir);
         if (res == STATUS_OK)
         {
             if ((res = dir.mkdir(true)) != STATUS_OK)
             {
-                fprintf(stderr, "  could not create directory '%s', error code: %d\n", dir.as_native(), int(res));
+                log_error("  could not create directory '%s', error code: %d\n", dir.as_native(), int(res));
                 return res;
             }
         }
         else if (res != STATUS_NOT_FOUND)
         {
-            fprintf(stderr, "  could not obtain parent directory for file '%s', error code: %d\n", fname->get_native(), int(res));
+            log_error("  could not obtain parent directory for file '%s', error code: %d\n", fname->get_native(), int(res));
             return res;
         }
 
-        // Load sample from file
-        if ((res = sample->save(&path)) < 0)
+        // The output is written to the temporary file
+        if ((res = make_temp_path(tmp, path)) != STATUS_OK)
         {
-            fprintf(stderr, "  could not write file '%s', error code: %d\n", path.as_native(), int(-res));
-            return -res;
+            log_error("  could not generate temporary file name for '%s', error code: %d\n", path->as_native(), int(res));
+            return res;
+        }
+
+        return STATUS_OK;
+    }
+
+    status_t commit_output_file(io::Path *tmp, const io::Path *path, size_t channels, size_t length, size_t sample_rate)
+    {
+        status_t res;
+        if ((res = tmp->rename(path)) != STATUS_OK)
+        {
+            log_error("  could not rename file '%s' to '%s', error code: %d\n", tmp->as_native(), path->as_native(), int(res));
+            tmp->remove();
+            return res;
         }
 
         duration_t d;
-        calc_duration(&d, sample);
-        fprintf(stdout, "  saved file: '%s', channels: %d, samples: %d, sample rate: %d, duration: %02d:%02d:%02d.%03d\n",
-                path.as_native(),
-                int(sample->channels()), int(sample->length()), int(sample->sample_rate()),
+        calc_duration(&d, length, sample_rate);
+        log_info("  saved file: '%s', channels: %d, samples: %d, sample rate: %d, duration: %02d:%02d:%02d.%03d\n",
+                path->as_native(),
+                int(channels), int(length), int(sample_rate),
                 int(d.h), int(d.m), int(d.s), int(d.ms)
         );
 
         return STATUS_OK;
     }
 
+    static status_t write_sample(dspu::Sample *sample, const io::Path *path)
+    {
+        status_t res;
+        AudioWriter wr;
+        size_t channels     = sample->channels();
+        size_t length       = sample->length();
+
+        if ((res = wr.open(path, channels, length, sample->sample_rate())) != STATUS_OK)
+            return res;
+
+        Arena *arena        = thread_arena();
+        size_t mark         = arena->mark();
+        const float **ptr   = arena->alloc<const float *>(channels);
+        if (ptr == NULL)
+        {
+            wr.close();
+            return STATUS_NO_MEM;
+        }
+        for (size_t i=0; i<channels; ++i)
+            ptr[i]              = sample->channel(i);
+
+        ssize_t written     = wr.write(ptr, length);
+        arena->rewind(mark);
+        res                 = wr.close();
+
+        return (written < 0) ? status_t(-written) : res;
+    }
+
+    status_t save_audio_file(dspu::Sample *sample, const LSPString *fname)
+    {
+        status_t res;
+        io::Path path, tmp;
+
+        // Save sample to the temporary file and atomically replace the output file
+        if ((res = open_output_file(&path, &tmp, fname)) != STATUS_OK)
+            return res;
+
+        if ((res = write_sample(sample, &tmp)) != STATUS_OK)
+        {
+            log_error("  could not write file '%s', error code: %d\n", tmp.as_native(), int(res));
+            tmp.remove();
+            return res;
+        }
+
+        return commit_output_file(&tmp, &path, sample->channels(), sample->length(), sample->sample_rate());
+    }
+
+    static inline size_t buffer_length(size_t length, size_t block)
+    {
+        // In streaming mode the buffer holds one block of data, but not less than the tail block
+        return ((block > 0) && (block < length)) ? lsp_max(block, size_t(TAIL_BLOCK_SIZE)) : length;
+    }
+
+    status_t convolve_channel(
+        float *dst, const float *src, size_t src_length, const float *ir, size_t ir_length,
+        float gain, float sparse, float threshold, size_t window, size_t block, size_t *conv_length
+    )
+    {
+        dspu::Convolver cv;
+        size_t dry_length   = src_length;
+        size_t length       = dry_length + ir_length;
+
+        // Allocate buffer for convolution, the whole wet signal or one block in streaming mode
+        size_t buf_length   = buffer_length(length, block);
+        Arena *arena        = thread_arena();
+        size_t mark         = arena->mark();
+        float *buf          = arena->alloc<float>(buf_length);
+        if (buf == NULL)
+        {
+            log_error("Not enough memory to allocate temporary buffer\n");
+            return STATUS_NO_MEM;
+        }
+
+        // Analyze the sparse head of the impulse response
+        lltl::darray<tap_t> taps;
+        size_t dense        = (sparse > 0.0f) ? find_sparse_head(&taps, ir, ir_length, sparse) : 0;
+        size_t dense_length = ir_length - dense;
+        if (dense > 0)
+            log_info("  rendering %d taps of the sparse IR head, dense part starts at sample %d\n",
+                int(taps.size()), int(dense));
+
+        if ((dense_length > 0) && (!cv.init(&ir[dense], dense_length, CONV_RANK, 0)))
+        {
+            arena->rewind(mark);
+            log_error("Not enough memory to initialize convolver\n");
+            return STATUS_NO_MEM;
+        }
+
+        // Render the sparse head as a tapped delay line
+        for (size_t i=0, n=taps.size(); i<n; ++i)
+        {
+            const tap_t *t      = taps.uget(i);
+            dsp::fmadd_k3(&dst[t->offset], src, t->gain * gain, dry_length);
+        }
+
+        // Perform the main convolution of the dense part
+        size_t tail         = dense + dry_length;
+        if (dense_length > 0)
+        {
+            for (size_t offset = 0; offset < dry_length; )
+            {
+                size_t to_do    = lsp_min(dry_length - offset, buf_length);
+                cv.process(buf, &src[offset], to_do);
+                dsp::fmadd_k3(&dst[dense + offset], buf, gain, to_do);
+                offset         += to_do;
+            }
+        }
+
+        // The tail of convolution
+        if (dense_length <= 0)
+            length              = tail;
+        else
+        {
+            // Compute the tail by blocks and stop when it stays below threshold for the whole window
+            size_t step     = (threshold > 0.0f) ? lsp_min(buf_length, size_t(TAIL_BLOCK_SIZE)) : buf_length;
+            size_t quiet    = 0;
+            for (size_t offset = tail; offset < length; )
+            {
+                size_t to_do    = lsp_min(length - offset, step);
+                dsp::fill_zero(buf, to_do);
+                cv.process(buf, buf, to_do);
+                dsp::fmadd_k3(&dst[offset], buf, gain, to_do);
+                offset         += to_do;
+                if (threshold <= 0.0f)
+                    continue;
+
+                float peak      = dsp::abs_max(buf, to_do) * gain;
+                quiet           = (peak < threshold) ? quiet + to_do : 0;
+                if (quiet >= window)
+                {
+                    length          = offset;
+                    break;
+                }
+            }
+        }
+
+        // Free temporary buffer
+        arena->rewind(mark);
+        if (conv_length != NULL)
+            *conv_length    = length;
+
+        return STATUS_OK;
+    }
+
     status_t convolve(
         dspu::Sample *dst, const dspu::Sample *src, const dspu::Sample *ir,
         size_t dst_ch, size_t src_ch, size_t ir_ch,
-        size_t predelay, float gain
+        size_t predelay, float gain, float sparse,
+        float threshold, size_t window, size_t block, size_t *conv_length
     )
     {
-        dspu::Sample out;
-        dspu::Convolver cv;
-
         // Check channel numbers
         if (src_ch >= src->channels())
         {
-            fprintf(stderr, "Invalid channel number for input file: %d\n", int(src_ch));
+            log_error("Invalid channel number for input file: %d\n", int(src_ch));
             return STATUS_BAD_ARGUMENTS;
         }
         if (ir_ch >= ir->channels())
         {
-            fprintf(stderr, "Invalid channel number for impulse response file: %d\n", int(ir_ch));
+            log_error("Invalid channel number for impulse response file: %d\n", int(ir_ch));
             return STATUS_BAD_ARGUMENTS;
         }
 
-        // Allocate necessary buffers
         size_t dry_length   = src->length();
         size_t wet_length   = dry_length + ir->length(); // The length of wet (processed) signal
         size_t length       = lsp_max(dry_length, wet_length);
 
         // Allocate the necessary space for the output sample
         size_t num_ch       = lsp_max(dst_ch + 1, dst->channels());
-        if ((num_ch != dst->channels()) || (length > dst->length()))
+        if ((num_ch != dst->channels()) || (predelay + length > dst->length()))
         {
-            status_t res = dst->resize(num_ch, length, length);
-            if (res != STATUS_OK)
+            if (!dst->resize(num_ch, predelay + length, predelay + length))
             {
-                fprintf(stderr, "Not enough memory to resize the output audio data\n");
-                return res;
+                log_error("Not enough memory to resize the output audio data\n");
+                return STATUS_NO_MEM;
             }
         }
 
-        // Allocate buffer for convolution tail
-        uint8_t *ptr;
-        float *buf          = alloc_aligned<float>(ptr, length);
-        if (buf == NULL)
+        return convolve_channel(
+            &dst->channel(dst_ch)[predelay], src->channel(src_ch), dry_length,
+            ir->channel(ir_ch), ir->length(),
+            gain, sparse, threshold, window, block, conv_length);
+    }
+
+    static inline void emit_pair(
+        float *dst0, float *dst1, const float *buf0, const float *buf1,
+        size_t offset, size_t count, size_t latency)
+    {
+        // The first samples of the convolver output are the latency and are skipped
+        size_t from         = lsp_max(offset, latency);
+        size_t end          = offset + count;
+        if (from >= end)
+            return;
+
+        dsp::add2(&dst0[from - latency], &buf0[from - offset], end - from);
+        dsp::add2(&dst1[from - latency], &buf1[from - offset], end - from);
+    }
+
+    status_t convolve_channel_pair(
+        float *dst0, float *dst1, const float *src0, const float *src1, size_t src_length,
+        const float *ir0, const float *ir1, size_t ir_length,
+        float threshold, size_t window, size_t block, size_t *conv_length
+    )
+    {
+        PairConvolver cv;
+        size_t dry_length   = src_length;
+        size_t length       = dry_length + ir_length;
+
+        // Data of the convolver and buffers are released together
+        Arena *arena        = thread_arena();
+        size_t mark         = arena->mark();
+        if (!cv.init(ir0, ir1, ir_length, CONV_RANK))
         {
-            fprintf(stderr, "Not enough memory to allocate temporary buffer\n");
+            arena->rewind(mark);
+            log_error("Not enough memory to initialize convolver\n");
             return STATUS_NO_MEM;
         }
 
-        // Perform convolution
-        if (!cv.init(ir->channel(ir_ch), ir->length(), 16, 0))
+        // Allocate buffers for both channels, the convolver introduces latency
+        size_t latency      = cv.latency();
+        size_t total        = length + latency;
+        size_t buf_length   = buffer_length(total, block);
+        float *buf0         = arena->alloc<float>(buf_length * 2);
+        if (buf0 == NULL)
         {
-            free_aligned(ptr);
-            fprintf(stderr, "Not enough memory to initialize convolver\n");
+            arena->rewind(mark);
+            log_error("Not enough memory to allocate temporary buffer\n");
             return STATUS_NO_MEM;
         }
-        dsp::fill_zero(buf, length); // Fill head of buffer with zeros
-        cv.process(&buf[0], src->channel(src_ch), dry_length); // The main convolution
-        cv.process(&buf[dry_length], &buf[dry_length], ir->length()); // The tail of convolution
+        float *buf1         = &buf0[buf_length];
 
-        // Apply convolution to the output sample
-        float *dptr = dst->channel(dst_ch);
-        dsp::fmadd_k3(&dptr[predelay], buf, gain, length);
+        // The main convolution
+        for (size_t offset = 0; offset < dry_length; )
+        {
+            size_t to_do    = lsp_min(dry_length - offset, buf_length);
+            cv.process(buf0, buf1, &src0[offset], &src1[offset], to_do);
+            emit_pair(dst0, dst1, buf0, buf1, offset, to_do, latency);
+            offset         += to_do;
+        }
 
-        // Free temporary buffer
-        free_aligned(ptr);
+        // The tail of convolution, compute it by blocks and stop when it stays below threshold for the whole window
+        size_t step         = (threshold > 0.0f) ? lsp_min(buf_length, size_t(TAIL_BLOCK_SIZE)) : buf_length;
+        size_t quiet        = 0;
+        for (size_t offset = dry_length; offset < total; )
+        {
+            size_t to_do    = lsp_min(total - offset, step);
+            cv.process(buf0, buf1, NULL, NULL, to_do);
+            emit_pair(dst0, dst1, buf0, buf1, offset, to_do, latency);
+
+            size_t from     = lsp_max(offset, latency);
+            offset         += to_do;
+            if ((threshold <= 0.0f) || (from >= offset))
+                continue;
+
+            size_t head     = from + to_do - offset;
+            float peak      = lsp_max(dsp::abs_max(&buf0[head], offset - from), dsp::abs_max(&buf1[head], offset - from));
+            quiet           = (peak < threshold) ? quiet + offset - from : 0;
+            if (quiet >= window)
+            {
+                total           = offset;
+                break;
+            }
+        }
+
+        // Free temporary buffers
+        arena->rewind(mark);
+        if (conv_length != NULL)
+            *conv_length    = total - latency;
 
         return STATUS_OK;
     }
 
+    status_t convolve_pair(
+        dspu::Sample *dst, const dspu::Sample *src,
+        const float *ir0, const float *ir1, size_t ir_length,
+        size_t dst_ch0, size_t dst_ch1, size_t src_ch0, size_t src_ch1,
+        size_t predelay, float threshold, size_t window, size_t block, size_t *conv_length
+    )
+    {
+        // Check channel numbers
+        if ((src_ch0 >= src->channels()) || (src_ch1 >= src->channels()))
+        {
+            log_error("Invalid channel number for input file: %d\n", int(lsp_max(src_ch0, src_ch1)));
+            return STATUS_BAD_ARGUMENTS;
+        }
+
+        // Allocate the necessary space for the output sample
+        size_t dry_length   = src->length();
+        size_t length       = dry_length + ir_length;
+        size_t num_ch       = lsp_max(lsp_max(dst_ch0, dst_ch1) + 1, dst->channels());
+        if ((num_ch != dst->channels()) || (predelay + length > dst->length()))
+        {
+            if (!dst->resize(num_ch, predelay + length, predelay + length))
+            {
+                log_error("Not enough memory to resize the output audio data\n");
+                return STATUS_NO_MEM;
+            }
+        }
+
+        return convolve_channel_pair(
+            &dst->channel(dst_ch0)[predelay], &dst->channel(dst_ch1)[predelay],
+            src->channel(src_ch0), src->channel(src_ch1), dry_length,
+            ir0, ir1, ir_length, threshold, window, block, conv_length);
+    }
+
+    size_t detect_channel_tail(const float *buf, size_t length, size_t from, float threshold)
+    {
+        for (size_t end = length; end > from; )
+        {
+            size_t to_do        = lsp_min(end - from, TAIL_BLOCK_SIZE);
+            size_t offset       = end - to_do;
+            if (dsp::abs_max(&buf[offset], to_do) < threshold)
+            {
+                end                 = offset;
+                continue;
+            }
+
+            // Find the exact position of the loud sample in the block
+            for (end = offset + to_do; end > offset; --end)
+                if (fabsf(buf[end - 1]) >= threshold)
+                    break;
+            return end;
+        }
+
+        return from;
+    }
+
+    size_t detect_tail_length(const dspu::Sample *src, size_t from, float threshold, size_t window)
+    {
+        size_t length       = src->length();
+        size_t tail         = from;
+
+        // Find the last sample above the threshold among all channels
+        for (size_t i=0, n=src->channels(); i<n; ++i)
+            tail                = detect_channel_tail(src->channel(i), length, tail, threshold);
+
+        // Leave the window after the last loud sample
+        return (length > tail) ? lsp_min(tail + window, length) : length;
+    }
+
     status_t adjust_latency_gain(dspu::Sample *dst, const dspu::Sample *src, size_t latency, float gain)
     {
         size_t channels     = src->channels();
@@ -224,7 +775,7 @@ namespace far_screamer
             status_t res = dst->resize(channels, new_length, new_length);
             if (res != STATUS_OK)
             {
-                fprintf(stderr, "Could not resize audio sample to %d channels, %d samples\n",
+                log_error("Could not resize audio sample to %d channels, %d samples\n",
                         int(channels), int(new_length));
                 return res;
             }
@@ -257,7 +808,7 @@ namespace far_screamer
             status_t res = dst->resize(channels, new_length, new_length);
             if (res != STATUS_OK)
             {
-                fprintf(stderr, "Could not resize audio sample to %d channels, %d samples\n",
+                log_error("Could not resize audio sample to %d channels, %d samples\n",
                         int(channels), int(new_length));
                 return res;
             }
@@ -278,12 +829,12 @@ namespace far_screamer
     {
         if (dst->channels() == 1)
         {
-            printf("  mono output has no side part, adjusting only mono part\n");
+            log_info("  mono output has no side part, adjusting only mono part\n");
             dsp::mul_k2(dst->channel(0), mid, dst->length());
         }
         else if (dst->channels() == 2)
         {
-            printf("  adjusting Mid/Side balance for stereo output signal\n");
+            log_info("  adjusting Mid/Side balance for stereo output signal\n");
 
             float *a = dst->channel(0);
             float *b = dst->channel(1);
@@ -295,7 +846,7 @@ namespace far_screamer
         }
         else
         {
-            printf("  unsupported mid/side balancing for %d output channels, skipping", int(dst->channels()));
+            log_info("  unsupported mid/side balancing for %d output channels, skipping\n", int(dst->channels()));
         }
     }
 
@@ -304,7 +855,7 @@ namespace far_screamer
         ssize_t new_length = dst->length() - (head_cut + tail_cut);
         if (new_length <= 0)
         {
-            printf("  empty output sample after cutting head and tail, can not proceed\n");
+            log_info("  empty output sample after cutting head and tail, can not proceed\n");
             return STATUS_UNDERFLOW;
         }
 
@@ -325,44 +876,65 @@ namespace far_screamer
         return STATUS_OK;
     }
 
-    status_t normalize(dspu::Sample *dst, float gain, size_t mode)
+    void crop_sample(dspu::Sample *dst, size_t offset, size_t length)
     {
-        if (mode == NORM_NONE)
-            return STATUS_OK;
-
-        float peak  = 0.0f;
-        for (size_t i=0, n=dst->channels(); i<n; ++i)
+        offset          = lsp_min(offset, dst->length());
+        length          = lsp_min(length, dst->length() - offset);
+        if (offset > 0)
         {
-            float cpeak = dsp::abs_max(dst->channel(i), dst->length());
-            peak        = lsp_max(peak, cpeak);
+            for (size_t i=0, n=dst->channels(); i<n; ++i)
+            {
+                float *channel  = dst->channel(i);
+                dsp::move(channel, &channel[offset], length);
+            }
         }
 
-        // No peak detected?
-        if (peak < 1e-6)
-            return STATUS_OK;
+        dst->set_length(length);
+    }
+
+    float normalize_gain(float peak, float gain, size_t mode)
+    {
+        // No normalization or no peak detected?
+        if ((mode == NORM_NONE) || (peak < 1e-6))
+            return 1.0f;
 
         switch (mode)
         {
             case NORM_BELOW:
                 if (peak >= gain)
-                    return STATUS_OK;
+                    return 1.0f;
                 break;
             case NORM_ABOVE:
                 if (peak <= gain)
-                    return STATUS_OK;
+                    return 1.0f;
                 break;
             default:
                 break;
         }
 
+        return gain / peak;
+    }
+
+    status_t normalize(dspu::Sample *dst, float gain, size_t mode)
+    {
+        if (mode == NORM_NONE)
+            return STATUS_OK;
+
+        float peak  = 0.0f;
+        for (size_t i=0, n=dst->channels(); i<n; ++i)
+        {
+            float cpeak = dsp::abs_max(dst->channel(i), dst->length());
+            peak        = lsp_max(peak, cpeak);
+        }
+
         // Adjust gain
-        float k = gain / peak;
+        float k     = normalize_gain(peak, gain, mode);
+        if (k == 1.0f)
+            return STATUS_OK;
+
         for (size_t i=0, n=dst->channels(); i<n; ++i)
             dsp::mul_k2(dst->channel(i), k, dst->length());
 
         return STATUS_OK;
     }
 }
-
-
-
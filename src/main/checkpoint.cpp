@@ -0,0 +1,202 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of far-screamer
+ * Created on: 18 окт. 2026 г.
+ *
+ * far-screamer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * far-screamer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with far-screamer. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <lsp-plug.in/common/types.h>
+#include <lsp-plug.in/dsp/dsp.h>
+#include <lsp-plug.in/dsp-units/units.h>
+#include <lsp-plug.in/stdlib/stdio.h>
+#include <lsp-plug.in/stdlib/string.h>
+
+#include <private/checkpoint.h>
+#include <private/audio.h>
+#include <private/log.h>
+
+#ifdef PLATFORM_UNIX_COMPATIBLE
+    #include <unistd.h>
+#endif /* PLATFORM_UNIX_COMPATIBLE */
+
+#define CHECKPOINT_VERSION      1           // Should be incremented when the format of checkpoints changes
+#define CHECKPOINT_SIGNATURE    "FSCHKPT\0"
+#define CHECKPOINT_EXT          ".checkpoint"
+#define PARTIAL_EXT             ".partial"
+#define CHECKPOINT_BLOCK        0x10000     // Number of samples cleared at once
+#define CHECKPOINT_ALIGN        0x10000     // Segments are aligned to blocks of the out-of-core render
+
+namespace far_screamer
+{
+    typedef struct checkpoint_header_t
+    {
+        char        signature[8];   // Signature of the file
+        uint32_t    version;        // Version of the checkpoint format
+        uint32_t    channels;       // Number of channels of the output
+        uint64_t    length;         // Length of the output
+        uint64_t    job;            // Signature of the job
+        uint64_t    position;       // Number of processed frames of the input
+        uint64_t    pending;        // Offset of output samples which are not final
+        uint64_t    tail;           // End of output samples accumulated so far
+        uint64_t    limit;          // End of output samples which may be modified after the checkpoint
+        uint64_t    wet_end;        // End of the wet signal rendered so far
+    } checkpoint_header_t;
+
+    static size_t checkpoint_limit     = 0;    // Number of segments rendered in one run, 0 for unlimited
+
+    size_t checkpoint_segment(const config_t *cfg, size_t srate)
+    {
+        if ((cfg->sScratchDir.is_empty()) || (cfg->fCheckpoint <= 0.0f))
+            return 0;
+
+        size_t segment      = dspu::seconds_to_samples(srate, cfg->fCheckpoint);
+        return lsp_max((segment + CHECKPOINT_ALIGN - 1) / CHECKPOINT_ALIGN, size_t(1)) * CHECKPOINT_ALIGN;
+    }
+
+    status_t checkpoint_paths(io::Path *state, io::Path *data, const config_t *cfg)
+    {
+        status_t res;
+        if ((res = state->set(&cfg->sOutFile)) != STATUS_OK)
+            return res;
+        if ((res = state->concat(CHECKPOINT_EXT)) != STATUS_OK)
+            return res;
+        if ((res = data->set(&cfg->sOutFile)) != STATUS_OK)
+            return res;
+        return data->concat(PARTIAL_EXT);
+    }
+
+    static bool valid_header(const checkpoint_header_t *hdr, const ScratchFile *out, uint64_t job)
+    {
+        return (!memcmp(hdr->signature, CHECKPOINT_SIGNATURE, sizeof(hdr->signature))) &&
+               (hdr->version == CHECKPOINT_VERSION) &&
+               (hdr->job == job) &&
+               (hdr->channels == out->channels()) &&
+               (hdr->length == out->length()) &&
+               (hdr->pending <= hdr->tail) &&
+               (hdr->tail <= hdr->limit) &&
+               (hdr->limit <= hdr->length);
+    }
+
+    status_t load_checkpoint(checkpoint_t *cp, ScratchFile *out, const io::Path *path, uint64_t job)
+    {
+        FILE *fd = fopen(path->as_native(), "rb");
+        if (fd == NULL)
+            return STATUS_NOT_FOUND;
+
+        // Restore tails of the convolution which overlap the next input frames
+        checkpoint_header_t hdr;
+        bool ok = (fread(&hdr, sizeof(checkpoint_header_t), 1, fd) == 1) && (valid_header(&hdr, out, job));
+        size_t count    = (ok) ? hdr.tail - hdr.pending : 0;
+        for (size_t i=0, n=out->channels(); (ok) && (i<n); ++i)
+        {
+            ok              = fread(&out->channel(i)[hdr.pending], sizeof(float), count, fd) == count;
+            out->release(i, hdr.pending, count);
+        }
+        fclose(fd);
+        if (!ok)
+            return STATUS_CORRUPTED;
+
+        // Drop samples accumulated after the checkpoint has been stored
+        for (size_t i=0, n=out->channels(); i<n; ++i)
+        {
+            float *dst      = out->channel(i);
+            for (size_t offset = hdr.tail; offset < hdr.limit; )
+            {
+                size_t to_do    = lsp_min(size_t(hdr.limit - offset), size_t(CHECKPOINT_BLOCK));
+                dsp::fill_zero(&dst[offset], to_do);
+                out->release(i, offset, to_do);
+                offset         += to_do;
+            }
+        }
+
+        cp->job         = hdr.job;
+        cp->position    = hdr.position;
+        cp->pending     = hdr.pending;
+        cp->tail        = hdr.tail;
+        cp->limit       = hdr.limit;
+        cp->wet_end     = hdr.wet_end;
+
+        return STATUS_OK;
+    }
+
+    status_t save_checkpoint(const checkpoint_t *cp, ScratchFile *out, const io::Path *path)
+    {
+        status_t res;
+        io::Path tmp;
+
+        // Final samples of the output should reach the disk before the checkpoint
+        if ((res = out->sync()) != STATUS_OK)
+        {
+            log_error("  could not write partial output to the disk\n");
+            return res;
+        }
+        if ((res = make_temp_path(&tmp, path)) != STATUS_OK)
+            return res;
+
+        FILE *fd = fopen(tmp.as_native(), "wb");
+        if (fd == NULL)
+        {
+            log_error("  could not write file '%s'\n", tmp.as_native());
+            return STATUS_IO_ERROR;
+        }
+
+        checkpoint_header_t hdr;
+        memset(&hdr, 0, sizeof(checkpoint_header_t));
+        memcpy(hdr.signature, CHECKPOINT_SIGNATURE, sizeof(hdr.signature));
+        hdr.version     = CHECKPOINT_VERSION;
+        hdr.channels    = uint32_t(out->channels());
+        hdr.length      = out->length();
+        hdr.job         = cp->job;
+        hdr.position    = cp->position;
+        hdr.pending     = cp->pending;
+        hdr.tail        = cp->tail;
+        hdr.limit       = cp->limit;
+        hdr.wet_end     = cp->wet_end;
+
+        size_t count    = cp->tail - cp->pending;
+        bool ok = fwrite(&hdr, sizeof(checkpoint_header_t), 1, fd) == 1;
+        for (size_t i=0, n=out->channels(); (ok) && (i<n); ++i)
+            ok              = fwrite(&out->channel(i)[cp->pending], sizeof(float), count, fd) == count;
+        if (fflush(fd) != 0)
+            ok              = false;
+    #ifdef PLATFORM_UNIX_COMPATIBLE
+        if ((ok) && (fsync(fileno(fd)) != 0))
+            ok              = false;
+    #endif /* PLATFORM_UNIX_COMPATIBLE */
+        if (fclose(fd) != 0)
+            ok              = false;
+
+        // Replace the previous checkpoint atomically
+        res = (ok) ? tmp.rename(path) : STATUS_IO_ERROR;
+        if (res != STATUS_OK)
+        {
+            log_error("  could not write file '%s'\n", path->as_native());
+            tmp.remove();
+        }
+        return res;
+    }
+
+    void limit_checkpoints(size_t segments)
+    {
+        checkpoint_limit    = segments;
+    }
+
+    bool checkpoint_limit_reached(size_t segments)
+    {
+        return (checkpoint_limit > 0) && (segments >= checkpoint_limit);
+    }
+}
@@ -25,8 +25,12 @@
 #include <lsp-plug.in/io/InStringSequence.h>
 #include <lsp-plug.in/expr/Tokenizer.h>
 
-#include <private/config.h>
+#include <far-screamer/config.h>
 #include <private/cmdline.h>
+#include <private/log.h>
+
+#include <errno.h>
+#include <stdlib.h>
 
 namespace far_screamer
 {
@@ -48,25 +52,52 @@ namespace far_screamer
 
     static const option_t options[] =
     {
-        { "-dg",  "--dry-gain",         false,     "Dry gain (in dB) - the amount of unprocessed signal"    },
-        { "-fi",  "--fade-in",          false,     "Fade in of the IR file (in milliseconds)"               },
-        { "-fo",  "--fade-out",         false,     "Fade out of the IR file (in milliseconds)"              },
-        { "-hc",  "--head-cut",         false,     "Head cut of the IR file (in milliseconds)"              },
-        { "-hp",  "--hi-pass",          false,     "High-pass filter parameters (--help for details)"       },
-        { "-if",  "--in-file",          false,     "Input file"                                             },
-        { "-ir",  "--ir-file",          false,     "Impulse response file"                                  },
-        { "-lp",  "--low-pass",         false,     "Low-pass filter parameters (--help for details)"        },
-        { "-m",   "--mapping",          false,     "IR convolution mapping in format: out:in:ir[:gain]"     },
-        { "-mb",  "--mid-balance",      false,     "The amount of Middle part (in dB) in stereo signal"     },
-        { "-n",   "--normalize",        false,     "Set normalization mode"                                 },
-        { "-ng",  "--norm-gain",        false,     "Set normalization peak gain (in dB)"                    },
-        { "-of",  "--out-file",         false,     "Output file"                                            },
-        { "-pd",  "--predelay",         false,     "The amount of pre-delay added to the signal (in ms)"    },
-        { "-sb",  "--side-balance",     false,     "The amount of Side part (in dB) in stereo signal"       },
-        { "-sr",  "--srate",            false,     "Sample rate of output file"                             },
-        { "-tc",  "--tail-cut",         false,     "Tail cut of the IR file (in milliseconds)"              },
-        { "-tl",  "--trim-length",      true,      "Trim length of output file to match the input file"     },
-        { "-wg",  "--wet-gain",         false,     "Wet gain (in dB) - the amount of processed signal"      },
+        { "-al",  "--album",            false,     "Input file of the gapless album (repeatable)"            },
+        { "-cf",  "--cue-fade",         false,     "Crossfade window (in ms) between IRs of the cue list"    },
+        { "-ci",  "--compact-input",    false,     "Compact storage of the input (int16, int24, half)"       },
+        { "-ck",  "--checkpoint",       false,     "Checkpoint interval (in seconds) of the out-of-core mode" },
+        { "-cl",  "--cue-list",         false,     "Cue list file switching the IR over time"                },
+        { "-dc",  "--decimate",         true,      "Decimate the wet signal band-limited by low-pass filter" },
+        { "-dg",  "--dry-gain",         false,     "Dry gain (in dB) - the amount of unprocessed signal"     },
+        { "-dr",  "--draft",            true,      "Fast draft render with reduced fidelity"                 },
+        { "-fi",  "--fade-in",          false,     "Fade in of the IR file (in milliseconds)"                },
+        { "-fo",  "--fade-out",         false,     "Fade out of the IR file (in milliseconds)"               },
+        { "-hc",  "--head-cut",         false,     "Head cut of the IR file (in milliseconds)"               },
+        { "-hp",  "--hi-pass",          false,     "High-pass filter parameters (--help for details)"        },
+        { "-ic",  "--incremental",      true,      "Skip processing if the output file is up to date"        },
+        { "-if",  "--in-file",          false,     "Input file"                                              },
+        { "-ir",  "--ir-file",          false,     "Impulse response file"                                   },
+        { "-lp",  "--low-pass",         false,     "Low-pass filter parameters (--help for details)"         },
+        { "-m",   "--mapping",          false,     "IR convolution mapping in format: out:in:ir[:gain]"      },
+        { "-mb",  "--mid-balance",      false,     "The amount of Middle part (in dB) in stereo signal"      },
+        { "-mf",  "--multirate-factor", false,     "Decimation factor of the late IR part (2 .. 8)"          },
+        { "-mg",  "--merge",            false,     "Shard file to merge into the output file (repeatable)"   },
+        { "-mm",  "--max-memory",       false,     "Memory budget (in bytes, K, M, G suffixes supported)"    },
+        { "-ms",  "--multirate-split",  false,     "Split point (in ms) of the IR for multirate processing"  },
+        { "-n",   "--normalize",        false,     "Set normalization mode"                                  },
+        { "-ng",  "--norm-gain",        false,     "Set normalization peak gain (in dB)"                     },
+        { "-oc",  "--out-of-core",      false,     "Directory for scratch files of the out-of-core mode"     },
+        { "-od",  "--out-dir",          false,     "Output directory of the watch and album modes"           },
+        { "-of",  "--out-file",         false,     "Output file"                                             },
+        { "-pd",  "--predelay",         false,     "The amount of pre-delay added to the signal (in ms)"     },
+        { "-pl",  "--plan",             false,     "Print the job plan without processing (text, json)"      },
+        { "-re",  "--end",              false,     "End of the rendered region (seconds or hh:mm:ss.sss)"    },
+        { "-rs",  "--start",            false,     "Start of the rendered region (seconds or hh:mm:ss.sss)"  },
+        { "-ru",  "--resume",           true,      "Resume the out-of-core mode from the last checkpoint"    },
+        { "-sb",  "--side-balance",     false,     "The amount of Side part (in dB) in stereo signal"        },
+        { "-sh",  "--shard",            false,     "Render the shard of the output (index/count)"            },
+        { "-sr",  "--srate",            false,     "Sample rate of output file"                              },
+        { "-st",  "--sparse-threshold", false,     "Threshold (in dB) of the sparse IR head detection"       },
+        { "-sv",  "--serve",            false,     "Serve convolution jobs on the specified UNIX socket"     },
+        { "-tc",  "--tail-cut",         false,     "Tail cut of the IR file (in milliseconds)"               },
+        { "-tl",  "--trim-length",      true,      "Trim length of output file to match the input file"      },
+        { "-tt",  "--tail-threshold",   false,     "Threshold (in dB) of the output tail to truncate"        },
+        { "-tw",  "--tail-window",      false,     "Time (in ms) the tail stays below threshold"             },
+        { "-wc",  "--wet-cache",        false,     "Directory to cache wet stems for fast re-mixing"         },
+        { "-wd",  "--watch",            false,     "Watch the directory and process new input files"         },
+        { "-wg",  "--wet-gain",         false,     "Wet gain (in dB) - the amount of processed signal"       },
+        { "-wk",  "--workers",          false,     "Number of worker threads of the daemon (0 - all CPUs)"   },
+        { "-wl",  "--wet-cache-limit",  false,     "Size limit of the wet stem cache (0 - unlimited)"        },
 
         { NULL, NULL, false, NULL }
     };
@@ -80,6 +111,21 @@ namespace far_screamer
         { NULL,     0           }
     };
 
+    const cfg_flag_t plan_flags[] =
+    {
+        { "text",   PLAN_TEXT   },
+        { "json",   PLAN_JSON   },
+        { NULL,     0           }
+    };
+
+    const cfg_flag_t compact_flags[] =
+    {
+        { "int16",  COMPACT_INT16   },
+        { "int24",  COMPACT_INT24   },
+        { "half",   COMPACT_HALF    },
+        { NULL,     0               }
+    };
+
     status_t print_usage(const char *name, bool fail)
     {
         LSPString buf, fmt;
@@ -129,13 +175,13 @@ namespace far_screamer
         {
             case expr::TT_IVALUE: ivalue = t.int_value(); break;
             default:
-                fprintf(stderr, "Bad '%s' value\n", parameter);
+                log_error("Bad '%s' value\n", parameter);
                 return STATUS_INVALID_VALUE;
         }
 
         if (t.get_token(expr::TF_GET) != expr::TT_EOF)
         {
-            fprintf(stderr, "Bad '%s' value\n", parameter);
+            log_error("Bad '%s' value\n", parameter);
             return STATUS_INVALID_VALUE;
         }
 
@@ -149,7 +195,7 @@ namespace far_screamer
         LSPString in;
         if (!in.set_native(val))
         {
-            fprintf(stderr, "Out of memory\n");
+            log_error("Out of memory\n");
             return STATUS_NO_MEM;
         }
 
@@ -162,13 +208,13 @@ namespace far_screamer
             case expr::TT_IVALUE: fvalue = t.int_value(); break;
             case expr::TT_FVALUE: fvalue = t.float_value(); break;
             default:
-                fprintf(stderr, "Bad '%s' value\n", parameter);
+                log_error("Bad '%s' value\n", parameter);
                 return STATUS_INVALID_VALUE;
         }
 
         if (t.get_token(expr::TF_GET) != expr::TT_EOF)
         {
-            fprintf(stderr, "Bad '%s' value\n", parameter);
+            log_error("Bad '%s' value\n", parameter);
             return STATUS_INVALID_VALUE;
         }
 
@@ -177,12 +223,112 @@ namespace far_screamer
         return STATUS_OK;
     }
 
+    status_t parse_cmdline_size(wsize_t *dst, const char *val, const char *parameter)
+    {
+        char *end = NULL;
+        errno = 0;
+        double value = strtod(val, &end);
+        if ((errno != 0) || (end == val) || (!(value >= 0.0)))
+        {
+            log_error("Bad '%s' value\n", parameter);
+            return STATUS_INVALID_VALUE;
+        }
+
+        // Apply binary multiplier
+        while (*end == ' ')
+            ++end;
+        switch (*end)
+        {
+            case 'k': case 'K': value *= double(1ULL << 10); ++end; break;
+            case 'm': case 'M': value *= double(1ULL << 20); ++end; break;
+            case 'g': case 'G': value *= double(1ULL << 30); ++end; break;
+            case 't': case 'T': value *= double(1ULL << 40); ++end; break;
+            default: break;
+        }
+        if ((*end == 'b') || (*end == 'B'))
+            ++end;
+
+        if (*end != '\0')
+        {
+            log_error("Bad '%s' value\n", parameter);
+            return STATUS_INVALID_VALUE;
+        }
+
+        *dst = wsize_t(value);
+
+        return STATUS_OK;
+    }
+
+    status_t parse_cmdline_time(double *dst, const char *val, const char *parameter)
+    {
+        double value = 0.0;
+        const char *p = val;
+
+        // The time is specified in seconds, optionally prefixed with minutes and hours: [[hh:]mm:]ss[.sss]
+        for (size_t fields = 0; ; ++fields)
+        {
+            char *end = NULL;
+            errno = 0;
+            double part = strtod(p, &end);
+            if ((errno != 0) || (end == p) || (!(part >= 0.0)) || (fields > 2))
+            {
+                log_error("Bad '%s' value\n", parameter);
+                return STATUS_INVALID_VALUE;
+            }
+
+            value   = value * 60.0 + part;
+            if (*end == '\0')
+                break;
+            if ((*end != ':') || (part != double(size_t(part))))
+            {
+                log_error("Bad '%s' value\n", parameter);
+                return STATUS_INVALID_VALUE;
+            }
+            p       = end + 1;
+        }
+
+        *dst = value;
+
+        return STATUS_OK;
+    }
+
+    status_t parse_cmdline_shard(config_t *cfg, const char *val, const char *parameter)
+    {
+        // The shard is specified as the zero-based index and the number of shards: i/N
+        char *end = NULL;
+        errno = 0;
+        long index = strtol(val, &end, 10);
+        if ((errno != 0) || (end == val) || (*end != '/'))
+        {
+            log_error("Bad '%s' value\n", parameter);
+            return STATUS_INVALID_VALUE;
+        }
+
+        const char *p = end + 1;
+        long count = strtol(p, &end, 10);
+        if ((errno != 0) || (end == p) || (*end != '\0'))
+        {
+            log_error("Bad '%s' value\n", parameter);
+            return STATUS_INVALID_VALUE;
+        }
+        if ((count < 1) || (index < 0) || (index >= count))
+        {
+            log_error("Invalid %s %ld/%ld, the index should be in range 0 .. %ld\n", parameter, index, count, count - 1);
+            return STATUS_INVALID_VALUE;
+        }
+
+        cfg->nShard     = index;
+        cfg->nShards    = count;
+
+        return STATUS_OK;
+    }
+
     status_t parse_cmdline_bool(bool *dst, const char *val, const char *parameter)
     {
         LSPString in;
         if (!in.set_native(val))
         {
-            fprintf(stderr, "Out of memory\n");
+            log_error("Out of memory\n");
             return STATUS_NO_MEM;
         }
 
@@ -197,13 +343,13 @@ namespace far_screamer
             case expr::TT_TRUE: bvalue = true; break;
             case expr::TT_FALSE: bvalue = false; break;
             default:
-                fprintf(stderr, "Bad '%s' value\n", parameter);
+                log_error("Bad '%s' value\n", parameter);
                 return STATUS_INVALID_VALUE;
         }
 
         if (t.get_token(expr::TF_GET) != expr::TT_EOF)
         {
-            fprintf(stderr, "Bad '%s' value\n", parameter);
+            log_error("Bad '%s' value\n", parameter);
             return STATUS_INVALID_VALUE;
         }
 
@@ -217,7 +363,7 @@ namespace far_screamer
         LSPString in;
         if (!in.set_native(val))
         {
-            fprintf(stderr, "Out of memory\n");
+            log_error("Out of memory\n");
             return STATUS_NO_MEM;
         }
 
@@ -230,19 +376,19 @@ namespace far_screamer
             case expr::TT_BAREWORD:
                 if ((flag = find_config_flag(t.text_value(), flags)) == NULL)
                 {
-                    fprintf(stderr, "Bad '%s' value\n", parameter);
+                    log_error("Bad '%s' value\n", parameter);
                     return STATUS_BAD_FORMAT;
                 }
                 break;
 
             default:
-                fprintf(stderr, "Bad '%s' value\n", parameter);
+                log_error("Bad '%s' value\n", parameter);
                 return STATUS_BAD_FORMAT;
         }
 
         if (t.get_token(expr::TF_GET) != expr::TT_EOF)
         {
-            fprintf(stderr, "Bad '%s' value\n", parameter);
+            log_error("Bad '%s' value\n", parameter);
             return STATUS_INVALID_VALUE;
         }
 
@@ -256,7 +402,7 @@ namespace far_screamer
         LSPString in;
         if (!in.set_native(val))
         {
-            fprintf(stderr, "Out of memory\n");
+            log_error("Out of memory\n");
             return STATUS_NO_MEM;
         }
 
@@ -268,35 +414,35 @@ namespace far_screamer
         {
             case expr::TT_IVALUE: dst->out = t.int_value(); break;
             default:
-                fprintf(stderr, "Bad '%s' value\n", parameter);
+                log_error("Bad '%s' value\n", parameter);
                 return STATUS_INVALID_VALUE;
         }
 
         // 'in'
         if (t.get_token(expr::TF_GET) != expr::TT_COLON)
         {
-            fprintf(stderr, "Bad '%s' value\n", parameter);
+            log_error("Bad '%s' value\n", parameter);
             return STATUS_INVALID_VALUE;
         }
         switch (t.get_token(expr::TF_GET))
         {
             case expr::TT_IVALUE: dst->in = t.int_value(); break;
             default:
-                fprintf(stderr, "Bad '%s' value\n", parameter);
+                log_error("Bad '%s' value\n", parameter);
                 return STATUS_INVALID_VALUE;
         }
 
         // 'ir'
         if (t.get_token(expr::TF_GET) != expr::TT_COLON)
         {
-            fprintf(stderr, "Bad '%s' value\n", parameter);
+            log_error("Bad '%s' value\n", parameter);
             return STATUS_INVALID_VALUE;
         }
         switch (t.get_token(expr::TF_GET))
         {
             case expr::TT_IVALUE: dst->ir = t.int_value(); break;
             default:
-                fprintf(stderr, "Bad '%s' value\n", parameter);
+                log_error("Bad '%s' value\n", parameter);
                 return STATUS_INVALID_VALUE;
         }
 
@@ -309,7 +455,7 @@ namespace far_screamer
             case expr::TT_COLON:
                 break;
             default:
-                fprintf(stderr, "Bad '%s' value\n", parameter);
+                log_error("Bad '%s' value\n", parameter);
                 return STATUS_INVALID_VALUE;
         }
         switch (t.get_token(expr::TF_GET))
@@ -317,7 +463,7 @@ namespace far_screamer
             case expr::TT_IVALUE: dst->gain = t.int_value(); break;
             case expr::TT_FVALUE: dst->gain = t.float_value(); break;
             default:
-                fprintf(stderr, "Bad '%s' value\n", parameter);
+                log_error("Bad '%s' value\n", parameter);
                 return STATUS_INVALID_VALUE;
         }
 
@@ -341,7 +487,7 @@ namespace far_screamer
         LSPString in;
         if (!in.set_native(val))
         {
-            fprintf(stderr, "Out of memory\n");
+            log_error("Out of memory\n");
             return STATUS_NO_MEM;
         }
 
@@ -391,21 +537,21 @@ namespace far_screamer
                 }
                 else
                 {
-                    fprintf(stderr, "Unknown filter type: %s\n", ft->get_native());
+                    log_error("Unknown filter type: %s\n", ft->get_native());
                     return STATUS_BAD_FORMAT;
                 }
 
                 break;
             }
             default:
-                fprintf(stderr, "Bad '%s' value\n", parameter);
+                log_error("Bad '%s' value\n", parameter);
                 return STATUS_INVALID_VALUE;
         }
 
         // 'slope'
         if (t.get_token(expr::TF_GET) != expr::TT_COLON)
         {
-            fprintf(stderr, "Bad '%s' value\n", parameter);
+            log_error("Bad '%s' value\n", parameter);
             return STATUS_INVALID_VALUE;
         }
         switch (t.get_token(expr::TF_GET))
@@ -415,21 +561,21 @@ namespace far_screamer
                 ssize_t slope = t.int_value();
                 if ((slope <= 0) || (slope > 4))
                 {
-                    fprintf(stderr, "Invalid slope value: %ld\n", long(slope));
+                    log_error("Invalid slope value: %ld\n", long(slope));
                     return STATUS_BAD_FORMAT;
                 }
                 fp->nSlope *= slope;
                 break;
             }
             default:
-                fprintf(stderr, "Bad '%s' value\n", parameter);
+                log_error("Bad '%s' value\n", parameter);
                 return STATUS_INVALID_VALUE;
         }
 
         // 'freq'
         if (t.get_token(expr::TF_GET) != expr::TT_COLON)
         {
-            fprintf(stderr, "Bad '%s' value\n", parameter);
+            log_error("Bad '%s' value\n", parameter);
             return STATUS_INVALID_VALUE;
         }
         switch (t.get_token(expr::TF_GET))
@@ -437,12 +583,12 @@ namespace far_screamer
             case expr::TT_IVALUE: fp->fFreq = t.int_value(); break;
             case expr::TT_FVALUE: fp->fFreq = t.float_value(); break;
             default:
-                fprintf(stderr, "Bad '%s' value\n", parameter);
+                log_error("Bad '%s' value\n", parameter);
                 return STATUS_INVALID_VALUE;
         }
         if ((fp->fFreq < 10.0f) || (fp->fFreq > 24000.0f))
         {
-            fprintf(stderr, "Invalid cut-off frequency %d for %s\n", int(fp->fFreq), parameter);
+            log_error("Invalid cut-off frequency %d for %s\n", int(fp->fFreq), parameter);
             return STATUS_INVALID_VALUE;
         }
 
@@ -455,7 +601,7 @@ namespace far_screamer
             case expr::TT_COLON:
                 break;
             default:
-                fprintf(stderr, "Bad '%s' value\n", parameter);
+                log_error("Bad '%s' value\n", parameter);
                 return STATUS_INVALID_VALUE;
         }
         switch (t.get_token(expr::TF_GET))
@@ -463,12 +609,12 @@ namespace far_screamer
             case expr::TT_IVALUE: fp->fQuality = t.int_value(); break;
             case expr::TT_FVALUE: fp->fQuality = t.float_value(); break;
             default:
-                fprintf(stderr, "Bad '%s' value\n", parameter);
+                log_error("Bad '%s' value\n", parameter);
                 return STATUS_INVALID_VALUE;
         }
         if ((fp->fQuality < 0.0f) || (fp->fQuality > 100.0f))
         {
-            fprintf(stderr, "Invalid quality factor %f for %s\n", fp->fQuality, parameter);
+            log_error("Invalid quality factor %f for %s\n", fp->fQuality, parameter);
             return STATUS_INVALID_VALUE;
         }
 
@@ -500,7 +646,7 @@ namespace far_screamer
                 return print_usage(cmd, false);
             else if ((opt[0] != '-') || (opt[1] != '-'))
             {
-                fprintf(stderr, "Invalid argument: %s\n", opt);
+                log_error("Invalid argument: %s\n", opt);
                 return STATUS_BAD_ARGUMENTS;
             }
             else
@@ -512,7 +658,7 @@ namespace far_screamer
             {
                 if (i >= argc)
                 {
-                    fprintf(stderr, "Not defined value for option: %s\n", opt);
+                    log_error("Not defined value for option: %s\n", opt);
                     return STATUS_BAD_ARGUMENTS;
                 }
 
@@ -522,7 +668,7 @@ namespace far_screamer
                 mapping_t *m = cfg->sMapping.add();
                 if (m == NULL)
                 {
-                    fprintf(stderr, "Not enough memory\n");
+                    log_error("Not enough memory\n");
                     return STATUS_NO_MEM;
                 }
 
@@ -532,6 +678,33 @@ namespace far_screamer
 
                 found       = true;
             }
+            else if ((!strcmp(xopt, "--merge")) || (!strcmp(xopt, "--album")))
+            {
+                if (i >= argc)
+                {
+                    log_error("Not defined value for option: %s\n", opt);
+                    return STATUS_BAD_ARGUMENTS;
+                }
+
+                val = argv[i++];
+
+                // Add file to the list of merged shards or album files
+                lltl::parray<LSPString> *list = (!strcmp(xopt, "--merge")) ? &cfg->sMerge : &cfg->sAlbum;
+                LSPString *name = new LSPString();
+                if ((name == NULL) || (!list->add(name)))
+                {
+                    delete name;
+                    log_error("Not enough memory\n");
+                    return STATUS_NO_MEM;
+                }
+                if (!name->set_native(val))
+                {
+                    log_error("Not enough memory\n");
+                    return STATUS_NO_MEM;
+                }
+
+                found       = true;
+            }
             else
             {
                 for (const option_t *p = far_screamer::options; p->s_short != NULL; ++p)
@@ -539,7 +712,7 @@ namespace far_screamer
                     {
                         if ((!p->s_flag) && (i >= argc))
                         {
-                            fprintf(stderr, "Not defined value for option: %s\n", opt);
+                            log_error("Not defined value for option: %s\n", opt);
                             return STATUS_BAD_ARGUMENTS;
                         }
 
@@ -547,14 +720,14 @@ namespace far_screamer
                         val = (p->s_flag) ? NULL : argv[i++];
                         if (options.exists(xopt))
                         {
-                            fprintf(stderr, "Duplicate option: %s\n", opt);
+                            log_error("Duplicate option: %s\n", opt);
                             return STATUS_BAD_ARGUMENTS;
                         }
 
                         // Try to create option
                         if (!options.create(xopt, const_cast<char *>(val)))
                         {
-                            fprintf(stderr, "Not enough memory\n");
+                            log_error("Not enough memory\n");
                             return STATUS_NO_MEM;
                         }
 
@@ -565,7 +738,7 @@ namespace far_screamer
 
             if (!found)
             {
-                fprintf(stderr, "Invalid option: %s\n", opt);
+                log_error("Invalid option: %s\n", opt);
                 return STATUS_BAD_ARGUMENTS;
             }
         }
@@ -634,6 +807,37 @@ namespace far_screamer
         }
         if (options.contains("--trim-length"))
             cfg->bTrim  = true;
+        if (options.contains("--decimate"))
+            cfg->bDecimate  = true;
+        if (options.contains("--draft"))
+            cfg->bDraft     = true;
+        if (options.contains("--incremental"))
+            cfg->bIncremental   = true;
+        if ((val = options.get("--sparse-threshold")) != NULL)
+        {
+            if ((res = parse_cmdline_float(&cfg->fSparse, val, "sparse threshold")) != STATUS_OK)
+                return res;
+        }
+        if ((val = options.get("--multirate-split")) != NULL)
+        {
+            if ((res = parse_cmdline_float(&cfg->fMultirateSplit, val, "multirate split")) != STATUS_OK)
+                return res;
+        }
+        if ((val = options.get("--multirate-factor")) != NULL)
+        {
+            if ((res = parse_cmdline_int(&cfg->nMultirateFactor, val, "multirate factor")) != STATUS_OK)
+                return res;
+        }
+        if ((val = options.get("--tail-threshold")) != NULL)
+        {
+            if ((res = parse_cmdline_float(&cfg->fTailThreshold, val, "tail threshold")) != STATUS_OK)
+                return res;
+        }
+        if ((val = options.get("--tail-window")) != NULL)
+        {
+            if ((res = parse_cmdline_float(&cfg->fTailWindow, val, "tail window")) != STATUS_OK)
+                return res;
+        }
         if ((val = options.get("--norm-gain")) != NULL)
         {
             if ((res = parse_cmdline_float(&cfg->fNormGain, val, "norm-gain")) != STATUS_OK)
@@ -644,30 +848,214 @@ namespace far_screamer
             if ((res = parse_cmdline_enum(&cfg->nNormalize, "normalize", val, normalize_flags)) != STATUS_OK)
                 return res;
         }
-
-
-        // Mandatory parameters
-        if ((val = options.get("--in-file")) != NULL)
-            cfg->sInFile.set_native(val);
-        else
+        if ((val = options.get("--workers")) != NULL)
+        {
+            if ((res = parse_cmdline_int(&cfg->nWorkers, val, "number of workers")) != STATUS_OK)
+                return res;
+        }
+        if ((val = options.get("--max-memory")) != NULL)
+        {
+            if ((res = parse_cmdline_size(&cfg->nMaxMemory, val, "max memory")) != STATUS_OK)
+                return res;
+        }
+        if ((val = options.get("--wet-cache-limit")) != NULL)
         {
-            fprintf(stderr, "Input file name required\n");
+            if ((res = parse_cmdline_size(&cfg->nWetCacheLimit, val, "wet cache limit")) != STATUS_OK)
+                return res;
+        }
+        if ((val = options.get("--plan")) != NULL)
+        {
+            if ((res = parse_cmdline_enum(&cfg->nPlan, "plan", val, plan_flags)) != STATUS_OK)
+                return res;
+        }
+        if ((val = options.get("--compact-input")) != NULL)
+        {
+            if ((res = parse_cmdline_enum(&cfg->nCompact, "compact input", val, compact_flags)) != STATUS_OK)
+                return res;
+        }
+        if ((val = options.get("--start")) != NULL)
+        {
+            if ((res = parse_cmdline_time(&cfg->fStart, val, "start")) != STATUS_OK)
+                return res;
+        }
+        if ((val = options.get("--end")) != NULL)
+        {
+            if ((res = parse_cmdline_time(&cfg->fEnd, val, "end")) != STATUS_OK)
+                return res;
+        }
+        if ((cfg->fEnd >= 0.0) && (cfg->fEnd <= cfg->fStart))
+        {
+            log_error("The end of the region should be after the start\n");
             return STATUS_BAD_ARGUMENTS;
         }
+        if ((val = options.get("--checkpoint")) != NULL)
+        {
+            if ((res = parse_cmdline_float(&cfg->fCheckpoint, val, "checkpoint interval")) != STATUS_OK)
+                return res;
+        }
+        if (options.contains("--resume"))
+            cfg->bResume    = true;
+        if ((val = options.get("--shard")) != NULL)
+        {
+            if ((res = parse_cmdline_shard(cfg, val, "shard")) != STATUS_OK)
+                return res;
+            if ((cfg->fStart > 0.0) || (cfg->fEnd >= 0.0))
+            {
+                log_error("The shard can not be combined with the region\n");
+                return STATUS_BAD_ARGUMENTS;
+            }
+        }
+        if ((val = options.get("--cue-fade")) != NULL)
+        {
+            if ((res = parse_cmdline_float(&cfg->fCueFade, val, "cue fade")) != STATUS_OK)
+                return res;
+            if (cfg->fCueFade < 0.0f)
+            {
+                log_error("The crossfade window of the cue list should not be negative\n");
+                return STATUS_BAD_ARGUMENTS;
+            }
+        }
 
+        // File names
+        if ((val = options.get("--in-file")) != NULL)
+            cfg->sInFile.set_native(val);
         if ((val = options.get("--out-file")) != NULL)
             cfg->sOutFile.set_native(val);
-        else
+        if ((val = options.get("--ir-file")) != NULL)
+            cfg->sIRFile.set_native(val);
+        if ((val = options.get("--serve")) != NULL)
+            cfg->sServe.set_native(val);
+        if ((val = options.get("--watch")) != NULL)
+            cfg->sWatchDir.set_native(val);
+        if ((val = options.get("--out-dir")) != NULL)
+            cfg->sOutDir.set_native(val);
+        if ((val = options.get("--wet-cache")) != NULL)
+            cfg->sWetCache.set_native(val);
+        if ((val = options.get("--out-of-core")) != NULL)
+            cfg->sScratchDir.set_native(val);
+        if ((val = options.get("--cue-list")) != NULL)
+            cfg->sCueList.set_native(val);
+
+        // Checkpoints are stored by the out-of-core render only
+        if ((cfg->fCheckpoint > 0.0f) && (cfg->sScratchDir.is_empty()))
+        {
+            log_error("Checkpoints are available only in the out-of-core mode\n");
+            return STATUS_BAD_ARGUMENTS;
+        }
+        if ((cfg->bResume) && (cfg->fCheckpoint <= 0.0f))
         {
-            fprintf(stderr, "Output file name required\n");
+            log_error("Resuming requires the checkpoint interval to be specified\n");
             return STATUS_BAD_ARGUMENTS;
         }
 
-        if ((val = options.get("--ir-file")) != NULL)
-            cfg->sIRFile.set_native(val);
-        else
+        // The cue list switches the IR over the timeline of the single input file
+        if (!cfg->sCueList.is_empty())
+        {
+            if ((!cfg->sServe.is_empty()) || (!cfg->sWatchDir.is_empty()) ||
+                (!cfg->sMerge.is_empty()) || (!cfg->sAlbum.is_empty()))
+            {
+                log_error("The cue list can be applied only to the single input file\n");
+                return STATUS_BAD_ARGUMENTS;
+            }
+            if (!cfg->sScratchDir.is_empty())
+            {
+                log_error("The cue list is not available in the out-of-core mode\n");
+                return STATUS_BAD_ARGUMENTS;
+            }
+            if ((cfg->fStart > 0.0) || (cfg->fEnd >= 0.0) || (cfg->nShards > 0))
+            {
+                log_error("The cue list can not be combined with the region or the shard\n");
+                return STATUS_BAD_ARGUMENTS;
+            }
+        }
+
+        // In daemon mode the file names are supplied by each job
+        if (!cfg->sServe.is_empty())
+        {
+            if (!cfg->sWatchDir.is_empty())
+            {
+                log_error("Daemon mode can not be combined with the watch mode\n");
+                return STATUS_BAD_ARGUMENTS;
+            }
+            return STATUS_OK;
+        }
+
+        // In merge mode the output file is formed from shard files
+        if (!cfg->sMerge.is_empty())
+        {
+            if (cfg->sOutFile.is_empty())
+            {
+                log_error("Output file name required\n");
+                return STATUS_BAD_ARGUMENTS;
+            }
+            return STATUS_OK;
+        }
+
+        // In album mode the output files are written to the output directory
+        if (!cfg->sAlbum.is_empty())
+        {
+            if (cfg->sOutDir.is_empty())
+            {
+                log_error("Output directory required for the album mode\n");
+                return STATUS_BAD_ARGUMENTS;
+            }
+            if (cfg->sIRFile.is_empty())
+            {
+                log_error("Impulse response file name required\n");
+                return STATUS_BAD_ARGUMENTS;
+            }
+            if (!cfg->sScratchDir.is_empty())
+            {
+                log_error("Album mode is not available in the out-of-core mode\n");
+                return STATUS_BAD_ARGUMENTS;
+            }
+            if ((cfg->fStart > 0.0) || (cfg->fEnd >= 0.0) || (cfg->nShards > 0))
+            {
+                log_error("Album mode can not be combined with the region or the shard\n");
+                return STATUS_BAD_ARGUMENTS;
+            }
+            if (cfg->nNormalize != NORM_NONE)
+            {
+                log_error("Normalization can not be applied to the album, the gain would change at file boundaries\n");
+                return STATUS_BAD_ARGUMENTS;
+            }
+            return STATUS_OK;
+        }
+
+        // In watch mode the input and output files are taken from directories
+        if (!cfg->sWatchDir.is_empty())
+        {
+            if (cfg->sOutDir.is_empty())
+            {
+                log_error("Output directory required for the watch mode\n");
+                return STATUS_BAD_ARGUMENTS;
+            }
+            if (cfg->sIRFile.is_empty())
+            {
+                log_error("Impulse response file name required\n");
+                return STATUS_BAD_ARGUMENTS;
+            }
+            return STATUS_OK;
+        }
+
+        return check_mandatory(cfg);
+    }
+
+    status_t check_mandatory(const config_t *cfg)
+    {
+        if (cfg->sInFile.is_empty())
+        {
+            log_error("Input file name required\n");
+            return STATUS_BAD_ARGUMENTS;
+        }
+        if ((cfg->sOutFile.is_empty()) && (cfg->nPlan == PLAN_NONE))
+        {
+            log_error("Output file name required\n");
+            return STATUS_BAD_ARGUMENTS;
+        }
+        if (cfg->sIRFile.is_empty())
         {
-            fprintf(stderr, "Impulse response file name required\n");
+            log_error("Impulse response file name required\n");
             return STATUS_BAD_ARGUMENTS;
         }
 
@@ -19,7 +19,7 @@
  * along with far-screamer. If not, see <https://www.gnu.org/licenses/>.
  */
 
-#include <private/config.h>
+#include <far-screamer/config.h>
 
 namespace far_screamer
 {
@@ -38,6 +38,26 @@ namespace far_screamer
         nNormalize          = NORM_NONE;    // No normalization by default
         fNormGain           = 0.0f;         // 0 dB gain by default
         bTrim               = false;
+        bDecimate           = false;
+        bDraft              = false;
+        bIncremental        = false;
+        fTailThreshold      = -1000.0f;     // No tail truncation by default
+        fTailWindow         = 100.0f;       // 100 ms window by default
+        fSparse             = -1000.0f;     // No sparse IR head detection by default
+        fMultirateSplit     = -1.0f;        // No multirate processing by default
+        nMultirateFactor    = 4;            // Decimate late part of the IR by 4 by default
+        nWorkers            = 0;            // Use all available CPUs by default
+        nMaxMemory          = 0;            // No memory budget by default
+        nWetCacheLimit      = wsize_t(4) << 30; // Keep up to 4 GiB of wet stems by default
+        nPlan               = PLAN_NONE;    // Process the job by default
+        nCompact            = COMPACT_NONE; // Keep the input as floating-point data by default
+        fStart              = 0.0;          // Render the whole output by default
+        fEnd                = -1.0;
+        fCheckpoint         = -1.0f;        // No checkpoints by default
+        bResume             = false;
+        nShard              = 0;            // Render the whole output by default
+        nShards             = 0;
+        fCueFade            = 50.0f;        // 50 ms crossfade between IRs of the cue list by default
 
         sLPF.nType          = dspu::FLT_NONE;
         sLPF.fFreq          = 0;
@@ -74,6 +94,26 @@ namespace far_screamer
         nNormalize          = NORM_NONE;
         fNormGain           = 0.0f;
         bTrim               = false;
+        bDecimate           = false;
+        bDraft              = false;
+        bIncremental        = false;
+        fTailThreshold      = -1000.0f;
+        fTailWindow         = 100.0f;
+        fSparse             = -1000.0f;
+        fMultirateSplit     = -1.0f;
+        nMultirateFactor    = 4;
+        nWorkers            = 0;
+        nMaxMemory          = 0;
+        nWetCacheLimit      = wsize_t(4) << 30;
+        nPlan               = PLAN_NONE;
+        nCompact            = COMPACT_NONE;
+        fStart              = 0.0;
+        fEnd                = -1.0;
+        fCheckpoint         = -1.0f;
+        bResume             = false;
+        nShard              = 0;
+        nShards             = 0;
+        fCueFade            = 50.0f;
 
         sLPF.nType          = dspu::FLT_NONE;
         sLPF.fFreq          = 0;
@@ -92,9 +132,87 @@ namespace far_screamer
         sInFile.clear();
         sOutFile.clear();
         sIRFile.clear();
+        sServe.clear();
+        sWatchDir.clear();
+        sOutDir.clear();
+        sWetCache.clear();
+        sScratchDir.clear();
+        sCueList.clear();
         sMapping.flush();
+
+        for (size_t i=0, n=sMerge.size(); i<n; ++i)
+            delete sMerge.uget(i);
+        sMerge.flush();
+
+        for (size_t i=0, n=sAlbum.size(); i<n; ++i)
+            delete sAlbum.uget(i);
+        sAlbum.flush();
     }
-}
 
+    static bool copy_list(lltl::parray<LSPString> *dst, const lltl::parray<LSPString> *src)
+    {
+        for (size_t i=0, n=src->size(); i<n; ++i)
+        {
+            LSPString *s = src->uget(i)->copy();
+            if ((s == NULL) || (!dst->add(s)))
+            {
+                delete s;
+                return false;
+            }
+        }
+        return true;
+    }
 
+    status_t config_t::copy(const config_t *src)
+    {
+        clear();
+
+        nSampleRate         = src->nSampleRate;
+        fDry                = src->fDry;
+        fWet                = src->fWet;
+        fMid                = src->fMid;
+        fSide               = src->fSide;
+        fPreDelay           = src->fPreDelay;
+        fFadeIn             = src->fFadeIn;
+        fFadeOut            = src->fFadeOut;
+        fHeadCut            = src->fHeadCut;
+        fTailCut            = src->fTailCut;
+        nNormalize          = src->nNormalize;
+        fNormGain           = src->fNormGain;
+        bTrim               = src->bTrim;
+        bDecimate           = src->bDecimate;
+        bDraft              = src->bDraft;
+        bIncremental        = src->bIncremental;
+        fTailThreshold      = src->fTailThreshold;
+        fTailWindow         = src->fTailWindow;
+        fSparse             = src->fSparse;
+        fMultirateSplit     = src->fMultirateSplit;
+        nMultirateFactor    = src->nMultirateFactor;
+        nWorkers            = src->nWorkers;
+        nMaxMemory          = src->nMaxMemory;
+        nWetCacheLimit      = src->nWetCacheLimit;
+        nPlan               = src->nPlan;
+        nCompact            = src->nCompact;
+        fStart              = src->fStart;
+        fEnd                = src->fEnd;
+        fCheckpoint         = src->fCheckpoint;
+        bResume             = src->bResume;
+        nShard              = src->nShard;
+        nShards             = src->nShards;
+        fCueFade            = src->fCueFade;
+        sLPF                = src->sLPF;
+        sHPF                = src->sHPF;
+
+        if ((!sInFile.set(&src->sInFile)) || (!sOutFile.set(&src->sOutFile)) || (!sIRFile.set(&src->sIRFile)) ||
+            (!sServe.set(&src->sServe)) || (!sWatchDir.set(&src->sWatchDir)) || (!sOutDir.set(&src->sOutDir)) ||
+            (!sWetCache.set(&src->sWetCache)) || (!sScratchDir.set(&src->sScratchDir)) || (!sCueList.set(&src->sCueList)))
+            return STATUS_NO_MEM;
+        for (size_t i=0, n=src->sMapping.size(); i<n; ++i)
+            if (sMapping.add(src->sMapping.uget(i)) == NULL)
+                return STATUS_NO_MEM;
+        if ((!copy_list(&sMerge, &src->sMerge)) || (!copy_list(&sAlbum, &src->sAlbum)))
+            return STATUS_NO_MEM;
 
+        return STATUS_OK;
+    }
+}
@@ -0,0 +1,409 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of far-screamer
+ * Created on: 18 окт. 2026 г.
+ *
+ * far-screamer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * far-screamer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with far-screamer. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <lsp-plug.in/common/types.h>
+#include <lsp-plug.in/dsp/dsp.h>
+#include <lsp-plug.in/dsp-units/units.h>
+#include <lsp-plug.in/lltl/darray.h>
+#include <lsp-plug.in/lltl/parray.h>
+#include <lsp-plug.in/stdlib/stdio.h>
+#include <lsp-plug.in/stdlib/string.h>
+
+#include <private/audio.h>
+#include <private/cmdline.h>
+#include <private/CompactSample.h>
+#include <private/cues.h>
+#include <private/fingerprint.h>
+#include <private/planner.h>
+#include <private/tool.h>
+#include <private/log.h>
+
+#define CUE_LINE_SIZE           0x1000
+
+namespace far_screamer
+{
+    typedef struct cue_t
+    {
+        ssize_t         start;      // Start of the crossfade to the IR (in samples of the input)
+        float           gain;       // Wet gain of the IR (in dB)
+        LSPString       file;       // Impulse response file
+    } cue_t;
+
+    typedef struct cue_parser_t
+    {
+        lltl::parray<cue_t>    *cues;       // List of cues
+        size_t                  sample_rate;// Sample rate of the input
+        ssize_t                 fade;       // Length of the crossfade (in samples)
+    } cue_parser_t;
+
+    typedef status_t (*cue_handler_t)(void *arg, const char *time, const char *gain, const char *file, size_t index);
+
+    static void destroy_cues(lltl::parray<cue_t> *cues)
+    {
+        for (size_t i=0, n=cues->size(); i<n; ++i)
+            delete cues->uget(i);
+        cues->flush();
+    }
+
+    static cue_t *add_cue(lltl::parray<cue_t> *cues, ssize_t start, float gain)
+    {
+        cue_t *c = new cue_t;
+        if ((c == NULL) || (!cues->add(c)))
+        {
+            delete c;
+            return NULL;
+        }
+
+        c->start        = start;
+        c->gain         = gain;
+        return c;
+    }
+
+    static char *next_field(char *p)
+    {
+        // Terminate the field and skip spaces after it
+        p  += strcspn(p, " \t");
+        if (*p != '\0')
+            *(p++)  = '\0';
+        return p + strspn(p, " \t");
+    }
+
+    static status_t split_cue(char **fields, char *line, size_t index)
+    {
+        // Skip empty lines and comments
+        char *p         = line + strspn(line, " \t");
+        char *end       = p + strlen(p);
+        while ((end > p) && (strchr(" \t\r\n", end[-1]) != NULL))
+            --end;
+        *end            = '\0';
+        if ((*p == '\0') || (*p == '#'))
+            return STATUS_SKIP;
+
+        // The cue is the time, the wet gain (in dB) and the IR file, the name of the file may contain spaces
+        fields[0]       = p;
+        fields[1]       = next_field(fields[0]);
+        fields[2]       = next_field(fields[1]);
+        if (*fields[2] == '\0')
+        {
+            log_error("Bad cue at line %d of the cue list, expected: time gain file\n", int(index));
+            return STATUS_BAD_FORMAT;
+        }
+
+        return STATUS_OK;
+    }
+
+    static status_t read_cue_list(const config_t *cfg, cue_handler_t handler, void *arg)
+    {
+        status_t res = STATUS_OK;
+        char line[CUE_LINE_SIZE];
+        char *fields[3];
+
+        FILE *fd = fopen(cfg->sCueList.get_native(), "rb");
+        if (fd == NULL)
+        {
+            log_error("Could not open cue list file '%s'\n", cfg->sCueList.get_native());
+            return STATUS_NOT_FOUND;
+        }
+
+        for (size_t index=1; (res == STATUS_OK) && (fgets(line, sizeof(line), fd) != NULL); ++index)
+        {
+            if ((strchr(line, '\n') == NULL) && (!feof(fd)))
+            {
+                log_error("Line %d of the cue list is too long\n", int(index));
+                res = STATUS_BAD_FORMAT;
+            }
+            else if ((res = split_cue(fields, line, index)) == STATUS_OK)
+                res = handler(arg, fields[0], fields[1], fields[2], index);
+            else if (res == STATUS_SKIP)
+                res = STATUS_OK;
+        }
+        fclose(fd);
+
+        return res;
+    }
+
+    static status_t parse_cue(void *arg, const char *s_time, const char *s_gain, const char *s_file, size_t index)
+    {
+        status_t res;
+        char param[64];
+        double time;
+        float gain;
+        cue_parser_t *parser    = static_cast<cue_parser_t *>(arg);
+        lltl::parray<cue_t> *cues = parser->cues;
+        size_t sample_rate      = parser->sample_rate;
+        ssize_t fade            = parser->fade;
+
+        snprintf(param, sizeof(param), "time of the cue at line %d", int(index));
+        if ((res = parse_cmdline_time(&time, s_time, param)) != STATUS_OK)
+            return res;
+        snprintf(param, sizeof(param), "gain of the cue at line %d", int(index));
+        if ((res = parse_cmdline_float(&gain, s_gain, param)) != STATUS_OK)
+            return res;
+
+        // The crossfade is centered at the cue, the cue at the start of the input
+        // replaces the IR file of the configuration
+        cue_t *c        = cues->last();
+        ssize_t start   = ssize_t(time * sample_rate + 0.5) - fade / 2;
+        if ((time > 0.0) || (cues->size() > 1))
+        {
+            if (start <= c->start)
+            {
+                log_error("The cue at line %d of the cue list is not after the previous cue\n", int(index));
+                return STATUS_BAD_FORMAT;
+            }
+            if ((c = add_cue(cues, start, gain)) == NULL)
+            {
+                log_error("Not enough memory\n");
+                return STATUS_NO_MEM;
+            }
+        }
+        else
+            c->gain         = gain;
+
+        if (!c->file.set_native(s_file))
+        {
+            log_error("Not enough memory\n");
+            return STATUS_NO_MEM;
+        }
+
+        return STATUS_OK;
+    }
+
+    static status_t load_cues(lltl::parray<cue_t> *cues, const config_t *cfg, size_t sample_rate, ssize_t fade)
+    {
+        // The IR file of the configuration is active from the start of the input
+        cue_t *c = add_cue(cues, -fade, 0.0f);
+        if ((c == NULL) || (!c->file.set(&cfg->sIRFile)))
+        {
+            log_error("Not enough memory\n");
+            return STATUS_NO_MEM;
+        }
+
+        cue_parser_t parser;
+        parser.cues         = cues;
+        parser.sample_rate  = sample_rate;
+        parser.fade         = fade;
+
+        return read_cue_list(cfg, parse_cue, &parser);
+    }
+
+    static status_t add_cue_file(void *arg, const char * /* s_time */, const char * /* s_gain */, const char *s_file, size_t /* index */)
+    {
+        lltl::parray<LSPString> *files = static_cast<lltl::parray<LSPString> *>(arg);
+        LSPString *file = new LSPString();
+        if ((file == NULL) || (!file->set_native(s_file)) || (!files->add(file)))
+        {
+            delete file;
+            log_error("Not enough memory\n");
+            return STATUS_NO_MEM;
+        }
+        return STATUS_OK;
+    }
+
+    status_t cue_files(lltl::parray<LSPString> *files, const config_t *cfg)
+    {
+        status_t res = read_cue_list(cfg, add_cue_file, files);
+        if (res != STATUS_OK)
+            destroy_cue_files(files);
+        return res;
+    }
+
+    void destroy_cue_files(lltl::parray<LSPString> *files)
+    {
+        for (size_t i=0, n=files->size(); i<n; ++i)
+            delete files->uget(i);
+        files->flush();
+    }
+
+    static float cue_ramp(const cue_t *c, ssize_t t, ssize_t fade)
+    {
+        // The share of the IR of the cue grows linearly from 0 to 1 over the crossfade
+        if (t < c->start)
+            return 0.0f;
+        if (t >= c->start + fade)
+            return 1.0f;
+        return (float(t - c->start) + 0.5f) / float(fade);
+    }
+
+    static status_t cut_cue(
+        dspu::Sample *dst, const dspu::Sample *in, const CompactSample *cin,
+        const cue_t *c, const cue_t *next, size_t first, size_t last, ssize_t fade)
+    {
+        size_t channels     = (cin->valid()) ? cin->channels() : in->channels();
+        size_t length       = last - first;
+        if (!dst->init(channels, length, length))
+        {
+            log_error("Not enough memory for input data\n");
+            return STATUS_NO_MEM;
+        }
+        dst->set_sample_rate((cin->valid()) ? cin->sample_rate() : in->sample_rate());
+
+        // The weight is below one only over the crossfades of the cue and the next cue,
+        // weights of adjacent cues sum to one at each sample
+        ssize_t head        = lsp_limit(c->start + fade - ssize_t(first), 0, ssize_t(length));
+        ssize_t tail        = (next != NULL) ? lsp_limit(next->start - ssize_t(first), head, ssize_t(length)) : length;
+        for (size_t i=0; i<channels; ++i)
+        {
+            float *buf          = dst->channel(i);
+            if (cin->valid())
+                cin->read(buf, i, first, length);
+            else
+                dsp::copy(buf, &in->channel(i)[first], length);
+
+            for (ssize_t j=0; j<head; ++j)
+                buf[j]             *= cue_ramp(c, first + j, fade) - ((next != NULL) ? cue_ramp(next, first + j, fade) : 0.0f);
+            for (ssize_t j=tail; j<ssize_t(length); ++j)
+                buf[j]             *= cue_ramp(c, first + j, fade) - cue_ramp(next, first + j, fade);
+        }
+
+        return STATUS_OK;
+    }
+
+    static status_t mix_cue(dspu::Sample *out, const dspu::Sample *part, size_t offset)
+    {
+        if ((out->channels() > 0) && (out->channels() != part->channels()))
+        {
+            log_error("  output has %d channels, the output of the cue has %d channels\n",
+                int(out->channels()), int(part->channels()));
+            return STATUS_BAD_FORMAT;
+        }
+
+        // Extend the output and add the output of the cue at its offset
+        size_t length       = lsp_max(out->length(), offset + part->length());
+        if ((length > out->length()) && (!out->resize(part->channels(), length, length)))
+        {
+            log_error("Not enough memory for output data\n");
+            return STATUS_NO_MEM;
+        }
+        for (size_t i=0, n=part->channels(); i<n; ++i)
+            dsp::add2(&out->channel(i)[offset], part->channel(i), part->length());
+
+        return STATUS_OK;
+    }
+
+    static status_t render_cue(
+        dspu::Sample *out, const dspu::Sample *in, const CompactSample *cin,
+        const cue_t *c, const cue_t *next, size_t first, size_t last, ssize_t fade, config_t *cfg)
+    {
+        status_t res;
+        dspu::Sample ir, part, wet;
+        CompactSample none;
+        lltl::darray<size_t> ir_channels;
+        plan_t plan;
+        size_t latency      = 0;
+
+        // Prepare the IR of the cue
+        if ((res = select_channels(&ir_channels, cfg, true, true)) != STATUS_OK)
+            return res;
+        if ((res = prepare_ir(&ir, &latency, cfg, &ir_channels)) != STATUS_OK)
+            return res;
+
+        // Convolve only the part of the input where the IR of the cue is active
+        if ((res = cut_cue(&part, in, cin, c, next, first, last, fade)) != STATUS_OK)
+            return res;
+        init_plan(&plan);
+        res = render_sample(&wet, &part, &none, &ir, latency, cfg, NULL, &plan);
+        release_memory(&plan);
+        if (res != STATUS_OK)
+            return res;
+
+        return mix_cue(out, &wet, first);
+    }
+
+    status_t render_cues(config_t *cfg, const LSPString *fp)
+    {
+        status_t res;
+        dspu::Sample in, out;
+        CompactSample cin;
+        lltl::parray<cue_t> cues;
+        lltl::darray<mapping_t> mapping;
+        LSPString ir_file;
+        float wet           = cfg->fWet;
+
+        // Load the input file, cues refer to its timeline
+        if ((res = load_input(&in, &cin, cfg, NULL)) != STATUS_OK)
+            return res;
+        size_t in_length    = (cin.valid()) ? cin.length() : in.length();
+        size_t sample_rate  = (cin.valid()) ? cin.sample_rate() : in.sample_rate();
+        ssize_t fade        = dspu::millis_to_samples(sample_rate, cfg->fCueFade);
+        if ((res = load_cues(&cues, cfg, sample_rate, fade)) != STATUS_OK)
+        {
+            destroy_cues(&cues);
+            return res;
+        }
+
+        // Channels of each IR file are selected by the mapping, keep the mapping of the configuration
+        if (!ir_file.set(&cfg->sIRFile))
+            res = STATUS_NO_MEM;
+        for (size_t i=0, n=cfg->sMapping.size(); (res == STATUS_OK) && (i<n); ++i)
+            if (mapping.add(cfg->sMapping.uget(i)) == NULL)
+                res = STATUS_NO_MEM;
+        if (res != STATUS_OK)
+            log_error("Not enough memory\n");
+
+        for (size_t i=0, n=cues.size(); (res == STATUS_OK) && (i<n); ++i)
+        {
+            const cue_t *c      = cues.uget(i);
+            const cue_t *next   = ((i + 1) < n) ? cues.uget(i + 1) : NULL;
+            size_t first        = lsp_max(c->start, 0);
+            size_t last         = (next != NULL) ? lsp_min(next->start + fade, ssize_t(in_length)) : in_length;
+            if (first >= last)
+            {
+                log_info("  cue of IR file '%s' is after the end of the input, skipped\n", c->file.get_native());
+                continue;
+            }
+            log_info("  rendering input from %.3f to %.3f s with IR file '%s'\n",
+                double(first) / sample_rate, double(last) / sample_rate, c->file.get_native());
+
+            // Each cue has its own IR file and wet gain
+            cfg->sMapping.clear();
+            for (size_t j=0, m=mapping.size(); (res == STATUS_OK) && (j<m); ++j)
+                if (cfg->sMapping.add(mapping.uget(j)) == NULL)
+                    res = STATUS_NO_MEM;
+            if ((res != STATUS_OK) || (!cfg->sIRFile.set(&c->file)))
+            {
+                log_error("Not enough memory\n");
+                res = STATUS_NO_MEM;
+                break;
+            }
+            cfg->fWet           = wet + c->gain;
+            res                 = render_cue(&out, &in, &cin, c, next, first, last, fade, cfg);
+        }
+        destroy_cues(&cues);
+
+        // Restore the configuration
+        cfg->fWet           = wet;
+        cfg->sIRFile.swap(&ir_file);
+        cfg->sMapping.swap(&mapping);
+        if (res != STATUS_OK)
+            return res;
+
+        // Trim and normalize the output, export the processed audio file
+        if ((res = finish_output(&out, in_length, cfg, NULL)) != STATUS_OK)
+            return res;
+        out.set_sample_rate(sample_rate);
+        if ((res = save_audio_file(&out, &cfg->sOutFile)) != STATUS_OK)
+            return res;
+
+        // Store fingerprint of the output file
+        return ((cfg->bIncremental) && (fp != NULL)) ? save_fingerprint(fp, cfg) : STATUS_OK;
+    }
+}
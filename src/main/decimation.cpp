@@ -0,0 +1,214 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of far-screamer
+ * Created on: 18 окт. 2026 г.
+ *
+ * far-screamer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * far-screamer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with far-screamer. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <far-screamer/config.h>
+#include <private/decimation.h>
+#include <private/Arena.h>
+#include <private/log.h>
+#include <lsp-plug.in/stdlib/stdio.h>
+#include <lsp-plug.in/stdlib/math.h>
+#include <lsp-plug.in/dsp/dsp.h>
+#include <lsp-plug.in/dsp-units/misc/windows.h>
+#include <lsp-plug.in/dsp-units/util/Convolver.h>
+
+#define DECIMATION_MAX          8           /* Maximum decimation factor */
+#define DECIMATION_PASSBAND     0.35f       /* Maximum cut-off frequency relative to original sample rate multiplied by factor */
+#define DECIMATION_CUTOFF       0.85f       /* Cut-off frequency of anti-aliasing filter relative to the new Nyquist frequency */
+#define DECIMATION_TAPS         64          /* Number of taps of the anti-aliasing filter per one unit of decimation factor */
+
+namespace far_screamer
+{
+    using namespace lsp;
+
+    size_t decimation_factor(size_t srate, const dspu::filter_params_t *lpf)
+    {
+        switch (lpf->nType)
+        {
+            case dspu::FLT_BT_RLC_LOPASS:
+            case dspu::FLT_MT_RLC_LOPASS:
+            case dspu::FLT_BT_BWC_LOPASS:
+            case dspu::FLT_MT_BWC_LOPASS:
+            case dspu::FLT_BT_LRX_LOPASS:
+            case dspu::FLT_MT_LRX_LOPASS:
+            case dspu::FLT_DR_APO_LOPASS:
+                break;
+            default:
+                return 1;
+        }
+
+        // Find the maximum power-of-two factor which keeps the pass band below the new Nyquist frequency
+        size_t factor = 1;
+        while ((factor < DECIMATION_MAX) && (lpf->fFreq * (factor * 2) <= srate * DECIMATION_PASSBAND))
+            factor     *= 2;
+
+        return factor;
+    }
+
+    static float *create_kernel(Arena *arena, size_t *length, size_t factor)
+    {
+        // Create windowed sinc kernel
+        size_t count    = DECIMATION_TAPS * factor + 1;
+        ssize_t center  = count >> 1;
+        float *k        = arena->alloc<float>(count);
+        if (k == NULL)
+            return NULL;
+
+        dspu::windows::blackman(k, count);
+        float fc        = (0.5f * DECIMATION_CUTOFF) / factor;
+        for (ssize_t i=0; i<ssize_t(count); ++i)
+        {
+            float x         = 2.0f * M_PI * fc * (i - center);
+            k[i]           *= (i == center) ? 1.0f : sinf(x) / x;
+        }
+
+        // Normalize the gain of the kernel
+        dsp::mul_k2(k, 1.0f / dsp::h_sum(k, count), count);
+        *length         = count;
+
+        return k;
+    }
+
+    status_t decimate_sample(dspu::Sample *dst, const dspu::Sample *src, size_t factor, const bool *used)
+    {
+        size_t channels     = src->channels();
+        size_t length       = src->length();
+        size_t new_length   = (length + factor - 1) / factor;
+
+        if (!dst->init(channels, new_length, new_length))
+        {
+            log_error("Could not allocate decimated audio sample of %d channels, %d samples\n",
+                    int(channels), int(new_length));
+            return STATUS_NO_MEM;
+        }
+        dst->set_sample_rate(src->sample_rate() / factor);
+
+        // Create the anti-aliasing filter
+        size_t k_len;
+        Arena *arena    = thread_arena();
+        size_t mark     = arena->mark();
+        float *kernel   = create_kernel(arena, &k_len, factor);
+        if (kernel == NULL)
+        {
+            log_error("Not enough memory to allocate anti-aliasing filter\n");
+            return STATUS_NO_MEM;
+        }
+
+        // Allocate buffer for filtered data, the filter has latency of half of the kernel
+        size_t latency  = k_len >> 1;
+        size_t buf_len  = length + latency;
+        float *buf      = arena->alloc<float>(buf_len);
+        if (buf == NULL)
+        {
+            arena->rewind(mark);
+            log_error("Not enough memory to allocate temporary buffer\n");
+            return STATUS_NO_MEM;
+        }
+
+        for (size_t i=0; i<channels; ++i)
+        {
+            // Channels not referenced by the mapping are not convolved
+            if ((used != NULL) && (!used[i]))
+            {
+                dsp::fill_zero(dst->channel(i), new_length);
+                continue;
+            }
+
+            dspu::Convolver cv;
+            if (!cv.init(kernel, k_len, CONV_RANK, 0))
+            {
+                arena->rewind(mark);
+                log_error("Not enough memory to initialize convolver\n");
+                return STATUS_NO_MEM;
+            }
+
+            // Apply anti-aliasing filter and take each factor'th sample
+            dsp::copy(buf, src->channel(i), length);
+            dsp::fill_zero(&buf[length], latency);
+            cv.process(buf, buf, buf_len);
+
+            float *dptr     = dst->channel(i);
+            const float *s  = &buf[latency];
+            for (size_t j=0; j<new_length; ++j, s += factor)
+                dptr[j]         = *s;
+        }
+
+        arena->rewind(mark);
+
+        return STATUS_OK;
+    }
+
+    status_t interpolate_channel(
+        dspu::Sample *dst, const dspu::Sample *src,
+        size_t dst_ch, size_t src_ch,
+        size_t offset, size_t factor, float gain
+    )
+    {
+        if (offset >= dst->length())
+            return STATUS_OK;
+
+        // Create the interpolation filter
+        size_t k_len;
+        Arena *arena    = thread_arena();
+        size_t mark     = arena->mark();
+        float *kernel   = create_kernel(arena, &k_len, factor);
+        if (kernel == NULL)
+        {
+            log_error("Not enough memory to allocate interpolation filter\n");
+            return STATUS_NO_MEM;
+        }
+
+        // Allocate buffer for interpolated data, the filter has latency of half of the kernel
+        size_t length   = src->length();
+        size_t latency  = k_len >> 1;
+        size_t buf_len  = length * factor + latency;
+        float *buf      = arena->alloc<float>(buf_len);
+        if (buf == NULL)
+        {
+            arena->rewind(mark);
+            log_error("Not enough memory to allocate temporary buffer\n");
+            return STATUS_NO_MEM;
+        }
+
+        dspu::Convolver cv;
+        if (!cv.init(kernel, k_len, CONV_RANK, 0))
+        {
+            arena->rewind(mark);
+            log_error("Not enough memory to initialize convolver\n");
+            return STATUS_NO_MEM;
+        }
+
+        // Insert zeros between samples and apply the interpolation filter
+        const float *sptr   = src->channel(src_ch);
+        dsp::fill_zero(buf, buf_len);
+        for (size_t i=0; i<length; ++i)
+            buf[i * factor]     = sptr[i];
+        cv.process(buf, buf, buf_len);
+
+        // Add data to the output, zero stuffing requires the gain to be multiplied by the factor
+        float *dptr         = dst->channel(dst_ch);
+        size_t count        = lsp_min(length * factor, dst->length() - offset);
+        dsp::fmadd_k3(&dptr[offset], &buf[latency], gain * factor, count);
+
+        arena->rewind(mark);
+
+        return STATUS_OK;
+    }
+}
@@ -0,0 +1,419 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of far-screamer
+ * Created on: 18 окт. 2026 г.
+ *
+ * far-screamer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * far-screamer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with far-screamer. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <lsp-plug.in/dsp/dsp.h>
+#include <lsp-plug.in/dsp-units/units.h>
+#include <lsp-plug.in/stdlib/stdio.h>
+#include <lsp-plug.in/stdlib/string.h>
+
+#include <private/draft.h>
+#include <private/Arena.h>
+#include <private/audio.h>
+#include <private/decimation.h>
+#include <private/tool.h>
+#include <private/log.h>
+
+#define DRAFT_MIN_SRATE         22050       /* Minimum sample rate of the decimated wet signal */
+#define DRAFT_MAX_FACTOR        8           /* Maximum decimation factor of the wet signal */
+#define DRAFT_TAIL_ENERGY       1e-5f       /* Energy of the truncated IR tail relative to the whole IR (-50 dB) */
+#define DRAFT_FADE_OUT          20.0f       /* Fade out of the truncated IR (in milliseconds) */
+#define DRAFT_MONO_ERROR        1e-3f       /* Maximum error of mono-summed IR channels (-30 dB) */
+
+namespace far_screamer
+{
+    using namespace lsp;
+
+    size_t draft_factor(const config_t *cfg, size_t srate)
+    {
+        if (!cfg->bDraft)
+            return 1;
+
+        size_t factor = 1;
+        while ((factor < DRAFT_MAX_FACTOR) && (srate >= DRAFT_MIN_SRATE * factor * 2))
+            factor     *= 2;
+
+        return factor;
+    }
+
+    /**
+     * Compute the maximum over all channels ratio of the error energy to the energy of the reference,
+     * samples of the reference beyond the end of the sample are considered to be lost
+     */
+    static float sample_error(const dspu::Sample *s, const dspu::Sample *ref)
+    {
+        float max_err   = 0.0f;
+        size_t length   = lsp_min(s->length(), ref->length());
+
+        for (size_t i=0, n=lsp_min(s->channels(), ref->channels()); i<n; ++i)
+        {
+            const float *a  = s->channel(i);
+            const float *b  = ref->channel(i);
+            float energy    = dsp::h_sqr_sum(b, ref->length());
+            if (energy <= 0.0f)
+                continue;
+
+            float error     = dsp::h_sqr_sum(&b[length], ref->length() - length);
+            for (size_t j=0; j<length; ++j)
+            {
+                float d         = a[j] - b[j];
+                error          += d * d;
+            }
+            max_err         = lsp_max(max_err, error / energy);
+        }
+
+        return max_err;
+    }
+
+    /**
+     * Find the length of the sample which contains all the energy except the tail
+     * below the threshold relative to the energy of the channel
+     */
+    static size_t energy_length(const dspu::Sample *s, float threshold)
+    {
+        size_t length   = 0;
+        for (size_t i=0, n=s->channels(); i<n; ++i)
+        {
+            const float *p  = s->channel(i);
+            float limit     = dsp::h_sqr_sum(p, s->length()) * threshold;
+            float tail      = 0.0f;
+            size_t end      = s->length();
+
+            for ( ; end > length; --end)
+            {
+                float v         = p[end - 1];
+                if ((tail + v * v) > limit)
+                    break;
+                tail           += v * v;
+            }
+            length          = end;
+        }
+
+        return length;
+    }
+
+    static void print_error(const char *text, float error)
+    {
+        if (error > 0.0f)
+            log_info("    %-48s %10.2f dB\n", text, dspu::power_to_db(error));
+        else
+            log_info("    %-48s %10s dB\n", text, "-inf");
+    }
+
+    static status_t truncate_tail(float *error, dspu::Sample *ir)
+    {
+        status_t res;
+        dspu::Sample orig;
+
+        *error          = 0.0f;
+        size_t length   = energy_length(ir, DRAFT_TAIL_ENERGY);
+        if ((length <= 0) || (length >= ir->length()))
+            return STATUS_OK;
+
+        if ((res = orig.copy(ir)) != STATUS_OK)
+        {
+            log_error("Not enough memory for the copy of the impulse response\n");
+            return res;
+        }
+
+        size_t fade     = lsp_min(size_t(dspu::millis_to_samples(ir->sample_rate(), DRAFT_FADE_OUT)), length);
+        if ((res = cut_sample(ir, 0, ir->length() - length, 0, fade)) != STATUS_OK)
+            return res;
+
+        char text[80];
+        snprintf(text, sizeof(text), "impulse response truncated at %.2f ms",
+            dspu::samples_to_millis(ir->sample_rate(), length));
+        *error          = sample_error(ir, &orig);
+        print_error(text, *error);
+
+        return STATUS_OK;
+    }
+
+    static status_t mono_sum(float *error, dspu::Sample *ir)
+    {
+        *error          = 0.0f;
+        size_t channels = ir->channels();
+        size_t length   = ir->length();
+        if (channels < 2)
+            return STATUS_OK;
+
+        Arena *arena    = thread_arena();
+        size_t mark     = arena->mark();
+        float *mono     = arena->alloc<float>(length);
+        if (mono == NULL)
+        {
+            log_error("Not enough memory to allocate temporary buffer\n");
+            return STATUS_NO_MEM;
+        }
+
+        // Compute the mono sum and compare it with each channel
+        dsp::copy(mono, ir->channel(0), length);
+        for (size_t i=1; i<channels; ++i)
+            dsp::add2(mono, ir->channel(i), length);
+        dsp::mul_k2(mono, 1.0f / channels, length);
+
+        float max_err   = 0.0f;
+        for (size_t i=0; i<channels; ++i)
+        {
+            const float *p  = ir->channel(i);
+            float energy    = dsp::h_sqr_sum(p, length);
+            float err       = 0.0f;
+            for (size_t j=0; j<length; ++j)
+            {
+                float d         = mono[j] - p[j];
+                err            += d * d;
+            }
+            if (energy > 0.0f)
+                max_err         = lsp_max(max_err, err / energy);
+        }
+
+        if (max_err > DRAFT_MONO_ERROR)
+        {
+            log_info("    channels of the impulse response differ, keeping them\n");
+            arena->rewind(mark);
+            return STATUS_OK;
+        }
+
+        for (size_t i=0; i<channels; ++i)
+            dsp::copy(ir->channel(i), mono, length);
+        arena->rewind(mark);
+
+        char text[80];
+        snprintf(text, sizeof(text), "%d channels of the impulse response mono-summed", int(channels));
+        *error          = max_err;
+        print_error(text, *error);
+
+        return STATUS_OK;
+    }
+
+    static status_t decimation_error(float *error, const dspu::Sample *ir, size_t factor)
+    {
+        status_t res;
+        dspu::Sample d_ir, r_ir;
+
+        // Pass the impulse response through the decimation and interpolation
+        if ((res = decimate_sample(&d_ir, ir, factor, NULL)) != STATUS_OK)
+            return res;
+        if (!r_ir.init(ir->channels(), ir->length(), ir->length()))
+        {
+            log_error("Not enough memory for interpolated impulse response\n");
+            return STATUS_NO_MEM;
+        }
+        for (size_t i=0, n=ir->channels(); i<n; ++i)
+        {
+            if ((res = interpolate_channel(&r_ir, &d_ir, i, i, 0, factor, 1.0f)) != STATUS_OK)
+                return res;
+        }
+
+        char text[80];
+        snprintf(text, sizeof(text), "wet signal decimated by factor %d", int(factor));
+        *error          = sample_error(&r_ir, ir);
+        print_error(text, *error);
+
+        return STATUS_OK;
+    }
+
+    status_t draft_impulse_response(dspu::Sample *ir, const config_t *cfg)
+    {
+        status_t res;
+        float error, total = 0.0f;
+
+        if (!cfg->bDraft)
+            return STATUS_OK;
+
+        log_info("  draft render accuracy report:\n");
+
+        // Drop the tail which does not contribute to the output
+        if ((res = truncate_tail(&error, ir)) != STATUS_OK)
+            return res;
+        total          += error;
+
+        // Use the same impulse response for nearly identical channels
+        if ((res = mono_sum(&error, ir)) != STATUS_OK)
+            return res;
+        total          += error;
+
+        // Process the wet signal at the reduced sample rate unless it is already decimated further,
+        // the out-of-core mode does not decimate the wet signal
+        size_t srate    = ir->sample_rate();
+        size_t factor   = draft_factor(cfg, srate);
+        size_t dc       = (cfg->bDecimate) ? decimation_factor(srate, &cfg->sLPF) : 1;
+        if ((factor > dc) && (cfg->sScratchDir.is_empty()))
+        {
+            if ((res = decimation_error(&error, ir, factor)) != STATUS_OK)
+                return res;
+            total          += error;
+        }
+
+        print_error("estimated deviation from the full render", total);
+        return STATUS_OK;
+    }
+
+    static bool same_channel(const dspu::Sample *ir, size_t a, size_t b)
+    {
+        if (a == b)
+            return true;
+        return !memcmp(ir->channel(a), ir->channel(b), ir->length() * sizeof(float));
+    }
+
+    static size_t count_paths(const config_t *cfg, size_t out)
+    {
+        size_t count = 0;
+        for (size_t i=0, n=cfg->sMapping.size(); i<n; ++i)
+        {
+            if (cfg->sMapping.uget(i)->out == out)
+                ++count;
+        }
+        return count;
+    }
+
+    static bool has_path(const config_t *cfg, const dspu::Sample *ir, const mapping_t *m, size_t out)
+    {
+        for (size_t i=0, n=cfg->sMapping.size(); i<n; ++i)
+        {
+            const mapping_t *xm = cfg->sMapping.uget(i);
+            if ((xm->out == out) && (xm->in == m->in) && (xm->gain == m->gain) &&
+                (xm->ir < ir->channels()) && (same_channel(ir, xm->ir, m->ir)))
+                return true;
+        }
+        return false;
+    }
+
+    static bool same_paths(const config_t *cfg, const dspu::Sample *ir, size_t a, size_t b)
+    {
+        size_t count = count_paths(cfg, b);
+        if ((count <= 0) || (count != count_paths(cfg, a)))
+            return false;
+
+        for (size_t i=0, n=cfg->sMapping.size(); i<n; ++i)
+        {
+            const mapping_t *m = cfg->sMapping.uget(i);
+            if (m->out != b)
+                continue;
+            if ((m->ir >= ir->channels()) || (!has_path(cfg, ir, m, a)))
+                return false;
+        }
+        return true;
+    }
+
+    static const draft_copy_t *find_copy(const draft_t *d, size_t out)
+    {
+        for (size_t i=0, n=d->copies.size(); i<n; ++i)
+        {
+            const draft_copy_t *c = d->copies.uget(i);
+            if (c->dst == out)
+                return c;
+        }
+        return NULL;
+    }
+
+    status_t draft_paths(draft_t *d, config_t *cfg, size_t in_channels, const dspu::Sample *ir)
+    {
+        status_t res;
+        layout_t layout;
+
+        d->channels     = 0;
+        d->copies.clear();
+        if (!cfg->bDraft)
+            return STATUS_OK;
+
+        // Only the mono input may produce identical outputs with the generated mapping,
+        // keep the generated mapping otherwise to use the specialized pipeline
+        bool generated  = cfg->sMapping.is_empty();
+        if ((generated) && ((in_channels != 1) || (ir->channels() < 2)))
+            return STATUS_OK;
+        if ((res = expand_mapping(&layout, cfg, in_channels, ir->channels(), false)) != STATUS_OK)
+            return res;
+
+        size_t channels = 0;
+        for (size_t i=0, n=cfg->sMapping.size(); i<n; ++i)
+            channels        = lsp_max(channels, cfg->sMapping.uget(i)->out + 1);
+
+        // Find output channels which repeat one of previous channels
+        size_t rendered = 0;
+        for (size_t b=0; b<channels; ++b)
+        {
+            bool found      = false;
+            for (size_t a=0; (a<b) && (!found); ++a)
+            {
+                if ((find_copy(d, a) != NULL) || (!same_paths(cfg, ir, a, b)))
+                    continue;
+
+                draft_copy_t *c = d->copies.add();
+                if (c == NULL)
+                {
+                    log_error("Not enough memory for draft data\n");
+                    return STATUS_NO_MEM;
+                }
+                c->dst          = b;
+                c->src          = a;
+                found           = true;
+            }
+            if (!found)
+                rendered        = b + 1;
+        }
+
+        // The mid/side balance is not applied to the multichannel output, so the number
+        // of rendered channels should keep it
+        if ((d->copies.is_empty()) || ((channels > 2) && (rendered <= 2)))
+        {
+            d->copies.clear();
+            if (generated)
+                cfg->sMapping.clear();
+            return STATUS_OK;
+        }
+
+        // Remove the mapping of repeated channels
+        for (size_t i=cfg->sMapping.size(); i > 0; --i)
+        {
+            if (find_copy(d, cfg->sMapping.uget(i - 1)->out) != NULL)
+                cfg->sMapping.remove(i - 1);
+        }
+        for (size_t i=0, n=d->copies.size(); i<n; ++i)
+        {
+            const draft_copy_t *c = d->copies.uget(i);
+            log_info("  OUT channel %d is identical to OUT channel %d, rendering it once\n", int(c->dst), int(c->src));
+        }
+        d->channels     = channels;
+
+        return STATUS_OK;
+    }
+
+    status_t restore_paths(dspu::Sample *out, const draft_t *d)
+    {
+        if (d->copies.is_empty())
+            return STATUS_OK;
+
+        size_t length   = out->length();
+        if ((out->channels() < d->channels) && (!out->resize(d->channels, out->max_length(), length)))
+        {
+            log_error("Not enough memory for output data\n");
+            return STATUS_NO_MEM;
+        }
+
+        for (size_t i=0, n=d->copies.size(); i<n; ++i)
+        {
+            const draft_copy_t *c = d->copies.uget(i);
+            dsp::copy(out->channel(c->dst), out->channel(c->src), length);
+        }
+
+        return STATUS_OK;
+    }
+}
@@ -0,0 +1,512 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of far-screamer
+ * Created on: 18 окт. 2026 г.
+ *
+ * far-screamer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * far-screamer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with far-screamer. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <lsp-plug.in/common/types.h>
+#include <lsp-plug.in/dsp-units/units.h>
+#include <lsp-plug.in/dsp-units/util/Convolver.h>
+#include <lsp-plug.in/stdlib/math.h>
+#include <lsp-plug.in/stdlib/stdio.h>
+
+#include <private/dryrun.h>
+#include <private/Arena.h>
+#include <private/audio.h>
+#include <private/PairConvolver.h>
+#include <private/tool.h>
+#include <private/log.h>
+#include <private/util.h>
+
+#define CALIBRATION_IR_LENGTH   0x10000     // Length of the impulse response for the calibration
+#define CALIBRATION_BLOCKS      8           // Number of blocks processed by one calibration pass
+#define CALIBRATION_MIN_TIME    50.0        // Minimum duration of the calibration in milliseconds
+#define CALIBRATION_MAX_PASSES  64          // Maximum number of calibration passes
+#define MAX_STAGES              8
+
+namespace far_screamer
+{
+    /**
+     * Set of convolvers with the same settings
+     */
+    typedef struct stage_t
+    {
+        const char *type;           // Type of convolvers
+        bool        pair;           // Convolvers process pairs of channels with PairConvolver
+        size_t      count;          // Number of convolvers
+        size_t      sample_rate;    // Sample rate of the convolution
+        size_t      length;         // Number of samples processed by each convolver
+        size_t      ir_length;      // Length of the impulse response
+        size_t      block;          // Size of the IR partition
+        size_t      parts;          // Number of IR partitions
+        double      flops;          // Estimated number of floating-point operations
+        double      time;           // Estimated convolution time in seconds
+    } stage_t;
+
+    typedef struct estimate_t
+    {
+        audio_info_t    in;         // Information about the input file
+        audio_info_t    ir;         // Information about the IR file
+        workload_t      w;          // Workload of the job
+        plan_t          plan;       // Memory plan of the job
+        stage_t         stages[MAX_STAGES]; // Convolution stages
+        size_t          nstages;    // Number of convolution stages
+        size_t          convolutions;   // Overall number of convolvers
+        size_t          out_length; // Length of the output file
+        wsize_t         out_bytes;  // Estimated size of the output file
+        double          flops;      // Overall number of floating-point operations
+        double          pair_speed;     // Calibrated speed of PairConvolver in operations per second
+        double          single_speed;   // Calibrated speed of dspu::Convolver in operations per second
+        double          time;       // Estimated convolution time in seconds
+    } estimate_t;
+
+    /**
+     * Estimate the number of operations for the uniformly partitioned convolution:
+     * each block requires the direct and the reverse complex FFT of twice the block
+     * size and the complex multiply-add of spectra of all partitions
+     */
+    static double convolution_flops(size_t block, size_t parts, size_t length)
+    {
+        double n        = double(block * 2);
+        double blocks   = double((length + block - 1) / block);
+        double fft      = 5.0 * n * log2(n);
+        double mac      = 8.0 * double(parts) * double(block + 1);
+        return blocks * (fft * 2.0 + mac);
+    }
+
+    static void add_stage(estimate_t *e, bool pair, size_t count, size_t srate, size_t in_length, size_t ir_length)
+    {
+        if ((count <= 0) || (ir_length <= 0) || (e->nstages >= MAX_STAGES))
+            return;
+
+        stage_t *s      = &e->stages[e->nstages++];
+        s->type         = (pair) ? "pair" : "single";
+        s->pair         = pair;
+        s->count        = count;
+        s->sample_rate  = srate;
+        s->length       = in_length + ir_length;
+        s->ir_length    = ir_length;
+        PairConvolver::partition(&s->block, &s->parts, ir_length, CONV_RANK);
+        s->flops        = convolution_flops(s->block, s->parts, s->length) * count;
+        s->time         = 0.0;
+
+        e->convolutions    += count;
+        e->flops           += s->flops;
+    }
+
+    /**
+     * Count convolutions performed by the direct convolution of the mapping,
+     * see convolve_direct() for details
+     */
+    static void add_direct_stages(
+        estimate_t *e, const config_t *cfg, size_t factor,
+        size_t in_length, size_t ir_length, bool sparse, bool stems)
+    {
+        size_t srate    = cfg->nSampleRate / factor;
+        in_length       = (in_length + factor - 1) / factor;
+        ir_length       = (ir_length + factor - 1) / factor;
+
+        // Each wet stem is rendered by the separate convolver
+        size_t singles  = 0, routes = 0;
+        for (size_t i=0, n=cfg->sMapping.size(); i<n; ++i)
+        {
+            const mapping_t *m = cfg->sMapping.uget(i);
+            if ((m->in >= e->in.channels) || (m->ir >= e->ir.channels))
+                continue;
+            if (stems)
+            {
+                ++singles;
+                continue;
+            }
+            if (m->gain + cfg->fWet < MIN_GAIN)
+                continue;
+            if (sparse)
+            {
+                ++singles;
+                continue;
+            }
+
+            // Mappings with the same input and output channels share one convolver
+            bool found = false;
+            for (size_t j=0; (j<i) && (!found); ++j)
+            {
+                const mapping_t *xm = cfg->sMapping.uget(j);
+                found   = (xm->in == m->in) && (xm->out == m->out) &&
+                          (xm->ir < e->ir.channels) && (xm->gain + cfg->fWet >= MIN_GAIN);
+            }
+            if (!found)
+                ++routes;
+        }
+
+        add_stage(e, true, routes >> 1, srate, in_length, ir_length);
+        add_stage(e, false, singles + (routes & 1), srate, in_length, ir_length);
+    }
+
+    static void make_stages(estimate_t *e, const config_t *cfg)
+    {
+        const workload_t *w = &e->w;
+
+        if (e->plan.strategy == STRATEGY_PIPELINE)
+        {
+            add_stage(e, true, (w->out_channels + 1) / 2, cfg->nSampleRate, w->in_length, w->ir_length);
+            return;
+        }
+
+        if (w->factor > 1)
+            add_direct_stages(e, cfg, w->factor, w->in_length, w->ir_length, w->sparse, e->plan.stems);
+        else if (w->split > 0)
+        {
+            add_direct_stages(e, cfg, 1, w->in_length, w->split, w->sparse, e->plan.stems);
+            add_direct_stages(e, cfg, w->mr_factor, w->in_length, w->ir_length - size_t(w->split), false, e->plan.stems);
+        }
+        else
+            add_direct_stages(e, cfg, 1, w->in_length, w->ir_length, w->sparse, e->plan.stems);
+    }
+
+    static double measure_pair(const float *ir, float *data, size_t length)
+    {
+        PairConvolver cv;
+        if (!cv.init(ir, &ir[CALIBRATION_IR_LENGTH], CALIBRATION_IR_LENGTH, CONV_RANK))
+            return -1.0;
+
+        // Run passes until the measured time becomes reliable
+        size_t passes   = 0;
+        double start    = time_ms(), elapsed = 0.0;
+        do
+        {
+            cv.process(data, &data[length], data, &data[length], length);
+            elapsed         = time_ms() - start;
+        } while ((++passes < CALIBRATION_MAX_PASSES) && (elapsed < CALIBRATION_MIN_TIME));
+        cv.destroy();
+
+        return elapsed / passes;
+    }
+
+    static double measure_single(const float *ir, float *data, size_t length)
+    {
+        dspu::Convolver cv;
+        if (!cv.init(ir, CALIBRATION_IR_LENGTH, CONV_RANK, 0))
+            return -1.0;
+
+        // Run passes until the measured time becomes reliable
+        size_t passes   = 0;
+        double start    = time_ms(), elapsed = 0.0;
+        do
+        {
+            cv.process(data, data, length);
+            elapsed         = time_ms() - start;
+        } while ((++passes < CALIBRATION_MAX_PASSES) && (elapsed < CALIBRATION_MIN_TIME));
+        cv.destroy();
+
+        return elapsed / passes;
+    }
+
+    /**
+     * Measure the speed of each type of convolvers on the random signal, the speed is
+     * expressed in operations of the model of the uniformly partitioned convolution
+     */
+    static status_t calibrate(double *pair_speed, double *single_speed)
+    {
+        size_t block, parts;
+        Arena *arena    = thread_arena();
+        size_t mark     = arena->mark();
+
+        PairConvolver::partition(&block, &parts, CALIBRATION_IR_LENGTH, CONV_RANK);
+        size_t length   = block * CALIBRATION_BLOCKS;
+        float *buf      = arena->alloc<float>(CALIBRATION_IR_LENGTH * 2 + length * 2);
+        if (buf == NULL)
+        {
+            log_error("Not enough memory to allocate temporary buffer\n");
+            return STATUS_NO_MEM;
+        }
+        float *ir       = buf;
+        float *data     = &buf[CALIBRATION_IR_LENGTH * 2];
+
+        uint32_t seed   = 1;
+        for (size_t i=0, n=CALIBRATION_IR_LENGTH * 2 + length * 2; i<n; ++i)
+        {
+            seed            = seed * 1664525 + 1013904223;
+            buf[i]          = float(int32_t(seed)) * (1.0f / 2147483648.0f);
+        }
+
+        double pair_time    = measure_pair(ir, data, length);
+        double single_time  = (pair_time >= 0.0) ? measure_single(ir, data, length) : -1.0;
+        arena->rewind(mark);
+        if (single_time < 0.0)
+        {
+            log_error("Not enough memory to initialize convolver\n");
+            return STATUS_NO_MEM;
+        }
+
+        double flops    = convolution_flops(block, parts, length);
+        *pair_speed     = (pair_time > 0.0) ? flops * 1000.0 / pair_time : 0.0;
+        *single_speed   = (single_time > 0.0) ? flops * 1000.0 / single_time : 0.0;
+
+        return STATUS_OK;
+    }
+
+    static status_t estimate_plan(estimate_t *e, region_t *region, bool *partial, size_t *length, config_t *cfg)
+    {
+        status_t res;
+        layout_t layout;
+
+        // Read headers of files
+        if ((res = read_audio_info(&e->in, &cfg->sInFile)) != STATUS_OK)
+            return res;
+        if ((res = read_audio_info(&e->ir, &cfg->sIRFile)) != STATUS_OK)
+            return res;
+
+        // Files are resampled to the sample rate of the configuration or the input file
+        if (cfg->nSampleRate <= 0)
+            cfg->nSampleRate    = e->in.sample_rate;
+        size_t srate    = cfg->nSampleRate;
+        size_t in_length    = (wsize_t(e->in.length) * srate + e->in.sample_rate - 1) / e->in.sample_rate;
+        size_t ir_length    = (wsize_t(e->ir.length) * srate + e->ir.sample_rate - 1) / e->ir.sample_rate;
+
+        // Apply cuts to the impulse response, see apply_fades() for details
+        ssize_t head_cut    = dspu::millis_to_samples(srate, cfg->fHeadCut);
+        ssize_t tail_cut    = dspu::millis_to_samples(srate, cfg->fTailCut);
+        if ((head_cut < 0) || (tail_cut < 0))
+        {
+            log_error("Negative head or tail cut value, can not proceed\n");
+            return STATUS_BAD_ARGUMENTS;
+        }
+        if (size_t(head_cut + tail_cut) >= ir_length)
+        {
+            log_error("Empty impulse response after cutting head and tail, can not proceed\n");
+            return STATUS_UNDERFLOW;
+        }
+        ir_length          -= head_cut + tail_cut;
+
+        // Plan the job the same way as the processing does, only channels used by the mapping are loaded
+        size_t latency      = 0;
+        lltl::darray<size_t> in_channels, ir_channels;
+        if ((res = filter_latency(&latency, cfg)) != STATUS_OK)
+            return res;
+        if ((res = select_channels(&in_channels, cfg, false, false)) != STATUS_OK)
+            return res;
+        if ((res = select_channels(&ir_channels, cfg, true, false)) != STATUS_OK)
+            return res;
+
+        // Only the range of the input is processed for the region of the output
+        *partial            = region_enabled(cfg);
+        if (*partial)
+        {
+            if ((res = init_region(region, cfg, ir_length, latency, false)) != STATUS_OK)
+                return res;
+            in_length          -= lsp_min(in_length, region->input.offset);
+            if (region->input.length >= 0)
+                in_length           = lsp_min(in_length, size_t(region->input.length));
+        }
+
+        size_t in_count     = (in_channels.is_empty()) ? e->in.channels : in_channels.size();
+        size_t ir_count     = (ir_channels.is_empty()) ? e->ir.channels : ir_channels.size();
+        if ((res = make_workload(&e->w, &layout, cfg, in_count, in_length, ir_count, ir_length, latency, false)) != STATUS_OK)
+            return res;
+        if (*partial)
+        {
+            workload_t whole;
+            whole_workload(&whole, &e->w, region);
+            make_plan(&e->plan, &whole, cfg->nMaxMemory);
+        }
+        else
+            make_plan(&e->plan, &e->w, cfg->nMaxMemory);
+
+        *length             = in_length;
+        return STATUS_OK;
+    }
+
+    static status_t estimate(estimate_t *e, config_t *cfg)
+    {
+        status_t res;
+        region_t region;
+        bool partial        = false;
+        size_t in_length    = 0;
+
+        if ((res = estimate_plan(e, &region, &partial, &in_length, cfg)) != STATUS_OK)
+            return res;
+
+        // Estimate the amount of computations
+        e->nstages          = 0;
+        e->convolutions     = 0;
+        e->flops            = 0.0;
+        make_stages(e, cfg);
+
+        // The output file is written in 32-bit floating-point format
+        e->out_length       = (cfg->bTrim) ? in_length : e->w.out_length;
+        if (partial)
+        {
+            e->out_length      -= lsp_min(e->out_length, region.head);
+            if (region.length >= 0)
+                e->out_length       = lsp_min(e->out_length, size_t(region.length));
+        }
+        e->out_bytes        = wsize_t(e->w.out_channels) * e->out_length * sizeof(float);
+
+        // Estimate the convolution time, each stage runs at the speed of its type of convolvers
+        if ((res = calibrate(&e->pair_speed, &e->single_speed)) != STATUS_OK)
+            return res;
+        e->time             = 0.0;
+        for (size_t i=0; i<e->nstages; ++i)
+        {
+            stage_t *s          = &e->stages[i];
+            double speed        = (s->pair) ? e->pair_speed : e->single_speed;
+            s->time             = (speed > 0.0) ? s->flops / speed : 0.0;
+            e->time            += s->time;
+        }
+
+        return STATUS_OK;
+    }
+
+    static const char *strategy_name(const plan_t *plan)
+    {
+        switch (plan->strategy)
+        {
+            case STRATEGY_PIPELINE:     return "pipeline";
+            case STRATEGY_STREAMING:    return "streaming";
+            default:                    break;
+        }
+        return (plan->stems) ? "wet-stems" : "in-memory";
+    }
+
+    static void print_text(const estimate_t *e, const config_t *cfg)
+    {
+        printf("Job plan:\n");
+        printf("  input file '%s': %d channels, %llu samples at %d Hz\n",
+            cfg->sInFile.get_native(), int(e->in.channels), (unsigned long long)wsize_t(e->in.length), int(e->in.sample_rate));
+        printf("  impulse response file '%s': %d channels, %llu samples at %d Hz\n",
+            cfg->sIRFile.get_native(), int(e->ir.channels), (unsigned long long)wsize_t(e->ir.length), int(e->ir.sample_rate));
+        printf("  processing at %d Hz: mappings: %d, convolutions: %d, strategy: %s",
+            int(cfg->nSampleRate), int(e->w.mappings), int(e->convolutions), strategy_name(&e->plan));
+        if (e->plan.strategy == STRATEGY_STREAMING)
+            printf(" by blocks of %d samples", int(e->plan.block));
+        printf("\n");
+
+        for (size_t i=0; i<e->nstages; ++i)
+        {
+            const stage_t *s = &e->stages[i];
+            printf("    %d x %s convolver at %d Hz: length %llu, IR length %llu, partitions: %d x %d samples, %.3f GFLOP, %.2f s\n",
+                int(s->count), s->type, int(s->sample_rate), (unsigned long long)wsize_t(s->length),
+                (unsigned long long)wsize_t(s->ir_length), int(s->parts), int(s->block), s->flops * 1e-9, s->time);
+        }
+
+        printf("  estimated computations: %.3f GFLOP\n", e->flops * 1e-9);
+        printf("  estimated peak memory: %.1f MiB", mib(e->plan.footprint));
+        if (cfg->nMaxMemory > 0)
+            printf(" of %.1f MiB budget%s", mib(cfg->nMaxMemory), (e->plan.fits) ? "" : " (exceeds the budget)");
+        printf("\n");
+        printf("  output: %d channels, %llu samples, %.1f MiB\n",
+            int(e->w.out_channels), (unsigned long long)wsize_t(e->out_length), mib(e->out_bytes));
+        printf("  calibrated speed: pair convolver %.3f GFLOP/s, single convolver %.3f GFLOP/s\n",
+            e->pair_speed * 1e-9, e->single_speed * 1e-9);
+        printf("  estimated convolution time (decoding, resampling and writing are not included): %.2f s\n", e->time);
+    }
+
+    static void print_json_string(const char *s)
+    {
+        putchar('"');
+        for (; *s != '\0'; ++s)
+        {
+            uint8_t c = uint8_t(*s);
+            if ((c == '"') || (c == '\\'))
+                printf("\\%c", c);
+            else if (c < 0x20)
+                printf("\\u%04x", int(c));
+            else
+                putchar(c);
+        }
+        putchar('"');
+    }
+
+    static void print_json_file(const char *key, const LSPString *name, const audio_info_t *info)
+    {
+        printf("  \"%s\": {\"file\": ", key);
+        print_json_string(name->get_native());
+        printf(", \"channels\": %d, \"length\": %llu, \"sample_rate\": %d},\n",
+            int(info->channels), (unsigned long long)wsize_t(info->length), int(info->sample_rate));
+    }
+
+    static void print_json(const estimate_t *e, const config_t *cfg)
+    {
+        printf("{\n");
+        print_json_file("input", &cfg->sInFile, &e->in);
+        print_json_file("ir", &cfg->sIRFile, &e->ir);
+        printf("  \"output\": {\"file\": ");
+        print_json_string(cfg->sOutFile.get_native());
+        printf(", \"channels\": %d, \"length\": %llu, \"bytes\": %llu},\n",
+            int(e->w.out_channels), (unsigned long long)wsize_t(e->out_length), (unsigned long long)(e->out_bytes));
+
+        printf("  \"sample_rate\": %d,\n", int(cfg->nSampleRate));
+        printf("  \"mappings\": %d,\n", int(e->w.mappings));
+        printf("  \"strategy\": \"%s\",\n", strategy_name(&e->plan));
+        printf("  \"block\": %d,\n", int(e->plan.block));
+        printf("  \"convolutions\": %d,\n", int(e->convolutions));
+        printf("  \"stages\": [");
+        for (size_t i=0; i<e->nstages; ++i)
+        {
+            const stage_t *s = &e->stages[i];
+            printf("%s\n    {\"type\": \"%s\", \"count\": %d, \"sample_rate\": %d, \"length\": %llu, "
+                "\"ir_length\": %llu, \"partition\": %d, \"partitions\": %d, \"flops\": %.0f, \"convolution_time\": %.3f}",
+                (i > 0) ? "," : "", s->type, int(s->count), int(s->sample_rate), (unsigned long long)wsize_t(s->length),
+                (unsigned long long)wsize_t(s->ir_length), int(s->block), int(s->parts), s->flops, s->time);
+        }
+        printf("%s],\n", (e->nstages > 0) ? "\n  " : "");
+
+        printf("  \"flops\": %.0f,\n", e->flops);
+        printf("  \"peak_memory\": %llu,\n", (unsigned long long)(e->plan.footprint));
+        printf("  \"memory_budget\": %llu,\n", (unsigned long long)(cfg->nMaxMemory));
+        printf("  \"fits_budget\": %s,\n", (e->plan.fits) ? "true" : "false");
+        printf("  \"flops_per_second\": {\"pair\": %.0f, \"single\": %.0f},\n", e->pair_speed, e->single_speed);
+        printf("  \"convolution_time\": %.3f\n", e->time);
+        printf("}\n");
+    }
+
+    status_t dry_run(config_t *cfg)
+    {
+        estimate_t e;
+        status_t res = estimate(&e, cfg);
+        if (res != STATUS_OK)
+            return res;
+
+        if (cfg->nPlan == PLAN_JSON)
+            print_json(&e, cfg);
+        else
+            print_text(&e, cfg);
+
+        return STATUS_OK;
+    }
+
+    status_t plan_job(plan_t *plan, audio_info_t *in, const config_t *cfg)
+    {
+        // The mapping and the sample rate of the configuration are altered by the estimation
+        config_t tmp;
+        status_t res = tmp.copy(cfg);
+        if (res != STATUS_OK)
+            return res;
+
+        estimate_t e;
+        region_t region;
+        bool partial        = false;
+        size_t in_length    = 0;
+        if ((res = estimate_plan(&e, &region, &partial, &in_length, &tmp)) != STATUS_OK)
+            return res;
+
+        *plan               = e.plan;
+        *in                 = e.in;
+        return STATUS_OK;
+    }
+}
@@ -0,0 +1,410 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of far-screamer
+ * Created on: 18 окт. 2026 г.
+ *
+ * far-screamer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * far-screamer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with far-screamer. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <lsp-plug.in/common/types.h>
+#include <lsp-plug.in/io/Path.h>
+#include <lsp-plug.in/lltl/parray.h>
+#include <lsp-plug.in/stdlib/stdio.h>
+#include <lsp-plug.in/stdlib/string.h>
+
+#include <private/audio.h>
+#include <private/cues.h>
+#include <private/fingerprint.h>
+#include <private/region.h>
+#include <private/log.h>
+
+#include <stdlib.h>
+
+#define FINGERPRINT_VERSION     1           // Should be incremented when processing changes the output
+#define FINGERPRINT_EXT         ".fingerprint"
+#define FINGERPRINT_MAX_SIZE    0x10000
+#define FINGERPRINT_BUF_SIZE    0x10000
+#define FNV_OFFSET_BASIS        uint64_t(0xcbf29ce484222325ULL)
+#define FNV_PRIME               uint64_t(0x100000001b3ULL)
+
+namespace far_screamer
+{
+    typedef struct file_fp_t
+    {
+        unsigned long long  size;       // Size of the file
+        unsigned long long  mtime;      // Modification time of the file
+        unsigned long long  hash;       // Hash of the file contents
+    } file_fp_t;
+
+    static uint64_t hash_bytes(uint64_t hash, const void *data, size_t count)
+    {
+        const uint8_t *p = static_cast<const uint8_t *>(data);
+        for (size_t i=0; i<count; ++i)
+            hash    = (hash ^ p[i]) * FNV_PRIME;
+        return hash;
+    }
+
+    static status_t hash_file(uint64_t *hash, const io::Path *path)
+    {
+        FILE *fd = fopen(path->as_native(), "rb");
+        if (fd == NULL)
+        {
+            log_error("  could not read file '%s'\n", path->as_native());
+            return STATUS_IO_ERROR;
+        }
+
+        uint8_t *buf = static_cast<uint8_t *>(malloc(FINGERPRINT_BUF_SIZE));
+        if (buf == NULL)
+        {
+            fclose(fd);
+            return STATUS_NO_MEM;
+        }
+
+        uint64_t h = FNV_OFFSET_BASIS;
+        size_t n;
+        while ((n = fread(buf, 1, FINGERPRINT_BUF_SIZE, fd)) > 0)
+            h       = hash_bytes(h, buf, n);
+        status_t res = (ferror(fd)) ? STATUS_IO_ERROR : STATUS_OK;
+
+        free(buf);
+        fclose(fd);
+
+        *hash   = h;
+        return res;
+    }
+
+    static status_t fingerprint_path(io::Path *dst, const config_t *cfg)
+    {
+        status_t res = dst->set(&cfg->sOutFile);
+        return (res == STATUS_OK) ? dst->concat(FINGERPRINT_EXT) : res;
+    }
+
+    static bool read_stored(char *buf, size_t size, const io::Path *path)
+    {
+        FILE *fd = fopen(path->as_native(), "rb");
+        if (fd == NULL)
+            return false;
+
+        size_t n = fread(buf, 1, size - 1, fd);
+        fclose(fd);
+        buf[n]  = '\0';
+
+        return n > 0;
+    }
+
+    static const char *find_line(const char *text, const char *key)
+    {
+        size_t len = strlen(key);
+        for (const char *p = text; (p != NULL) && (*p != '\0'); )
+        {
+            if ((!strncmp(p, key, len)) && (p[len] == ' '))
+                return &p[len+1];
+            if ((p = strchr(p, '\n')) != NULL)
+                ++p;
+        }
+        return NULL;
+    }
+
+    static bool parse_file_fp(file_fp_t *fp, const char *text, const char *key)
+    {
+        const char *p = find_line(text, key);
+        return (p != NULL) && (sscanf(p, "%llu %llu %llx", &fp->size, &fp->mtime, &fp->hash) == 3);
+    }
+
+    static bool parse_hash(unsigned long long *hash, const char *text, const char *key)
+    {
+        const char *p = find_line(text, key);
+        return (p != NULL) && (sscanf(p, "%llx", hash) == 1);
+    }
+
+    /**
+     * Compare fingerprints by the contents of files and parameters,
+     * size and modification time of files are used only to cache hashes
+     */
+    static bool same_fingerprint(const char *a, const char *b)
+    {
+        file_fp_t fa, fb;
+        unsigned long long va, vb, ca, cb;
+
+        if ((!parse_hash(&va, a, "version")) || (!parse_hash(&vb, b, "version")) || (va != vb))
+            return false;
+        if ((!parse_file_fp(&fa, a, "input")) || (!parse_file_fp(&fb, b, "input")) || (fa.hash != fb.hash))
+            return false;
+        if ((!parse_file_fp(&fa, a, "ir")) || (!parse_file_fp(&fb, b, "ir")) || (fa.hash != fb.hash))
+            return false;
+        if ((!parse_hash(&ca, a, "config")) || (!parse_hash(&cb, b, "config")) || (ca != cb))
+            return false;
+
+        // The cue list and IR files of cues are compared only for renders with the cue list
+        ca = 0;
+        cb = 0;
+        parse_hash(&ca, a, "cues");
+        parse_hash(&cb, b, "cues");
+        if (ca != cb)
+            return false;
+        if ((ca > 0) && ((!parse_file_fp(&fa, a, "cue_list")) || (!parse_file_fp(&fb, b, "cue_list")) || (fa.hash != fb.hash)))
+            return false;
+        for (size_t i=0; i<ca; ++i)
+        {
+            char key[0x20];
+            snprintf(key, sizeof(key), "cue_ir_%d", int(i));
+            if ((!parse_file_fp(&fa, a, key)) || (!parse_file_fp(&fb, b, key)) || (fa.hash != fb.hash))
+                return false;
+        }
+
+        return true;
+    }
+
+    static status_t file_fingerprint(LSPString *dst, const char *key, const LSPString *name, const char *stored)
+    {
+        status_t res;
+        io::Path path;
+        io::fattr_t attr;
+        file_fp_t fp, old;
+
+        if ((res = path.set(name)) != STATUS_OK)
+            return res;
+        if ((res = path.stat(&attr)) != STATUS_OK)
+        {
+            log_error("  could not access file '%s', error code: %d\n", path.as_native(), int(res));
+            return res;
+        }
+
+        fp.size     = attr.size;
+        fp.mtime    = attr.mtime;
+
+        // Reuse the stored hash if the file did not change, compute it otherwise
+        if ((stored != NULL) &&
+            (parse_file_fp(&old, stored, key)) &&
+            (old.size == fp.size) &&
+            (old.mtime == fp.mtime))
+            fp.hash     = old.hash;
+        else
+        {
+            uint64_t hash;
+            if ((res = hash_file(&hash, &path)) != STATUS_OK)
+                return res;
+            fp.hash     = hash;
+        }
+
+        return (dst->fmt_append_ascii("%s %llu %llu %016llx\n", key, fp.size, fp.mtime, fp.hash) > 0) ?
+            STATUS_OK : STATUS_NO_MEM;
+    }
+
+    static void append_filter(LSPString *dst, const char *name, const dspu::filter_params_t *fp)
+    {
+        dst->fmt_append_ascii(" %s=%d:%d:%.9g:%.9g:%.9g:%.9g",
+            name, int(fp->nType), int(fp->nSlope), fp->fFreq, fp->fFreq2, fp->fGain, fp->fQuality);
+    }
+
+    static status_t config_fingerprint(LSPString *dst, const config_t *cfg)
+    {
+        LSPString params;
+
+        // All parameters which affect the output file
+        params.fmt_ascii(
+            "srate=%d dry=%.9g wet=%.9g mid=%.9g side=%.9g predelay=%.9g "
+            "fade_in=%.9g fade_out=%.9g head_cut=%.9g tail_cut=%.9g "
+            "normalize=%d norm_gain=%.9g trim=%d decimate=%d "
+            "tail_threshold=%.9g tail_window=%.9g sparse=%.9g "
+            "multirate_split=%.9g multirate_factor=%d",
+            int(cfg->nSampleRate), cfg->fDry, cfg->fWet, cfg->fMid, cfg->fSide, cfg->fPreDelay,
+            cfg->fFadeIn, cfg->fFadeOut, cfg->fHeadCut, cfg->fTailCut,
+            int(cfg->nNormalize), cfg->fNormGain, int(cfg->bTrim), int(cfg->bDecimate),
+            cfg->fTailThreshold, cfg->fTailWindow, cfg->fSparse,
+            cfg->fMultirateSplit, int(cfg->nMultirateFactor));
+        if (cfg->nCompact != COMPACT_NONE)
+            params.fmt_append_ascii(" compact=%d", int(cfg->nCompact)); // Lossy storage of the input
+        if (cfg->bDraft)
+            params.fmt_append_ascii(" draft=1"); // Cheaper settings of the draft render
+        if (region_enabled(cfg))
+            params.fmt_append_ascii(" start=%.17g end=%.17g", cfg->fStart, cfg->fEnd); // Region of the output
+        if (cfg->nShards > 0)
+            params.fmt_append_ascii(" shard=%d/%d", int(cfg->nShard), int(cfg->nShards)); // Shard of the output
+        if (!cfg->sCueList.is_empty())
+            params.fmt_append_ascii(" cue_fade=%.9g", cfg->fCueFade); // Crossfades between IR files of cues
+        if ((!cfg->sScratchDir.is_empty()) && (cfg->fCheckpoint > 0.0f))
+            params.fmt_append_ascii(" checkpoint=%.9g", cfg->fCheckpoint); // Segments of the checkpointed render
+        append_filter(&params, "lpf", &cfg->sLPF);
+        append_filter(&params, "hpf", &cfg->sHPF);
+        for (size_t i=0, n=cfg->sMapping.size(); i<n; ++i)
+        {
+            const mapping_t *m = cfg->sMapping.uget(i);
+            params.fmt_append_ascii(" map=%d:%d:%d:%.9g", int(m->out), int(m->in), int(m->ir), m->gain);
+        }
+
+        const char *text = params.get_native();
+        if (text == NULL)
+            return STATUS_NO_MEM;
+        unsigned long long hash = hash_bytes(FNV_OFFSET_BASIS, text, strlen(text));
+
+        return (dst->fmt_append_ascii("config %016llx\n", hash) > 0) ? STATUS_OK : STATUS_NO_MEM;
+    }
+
+    static status_t file_signature(LSPString *dst, const char *key, const LSPString *name)
+    {
+        status_t res;
+        io::Path path;
+        io::fattr_t attr;
+
+        if ((res = path.set(name)) != STATUS_OK)
+            return res;
+        if ((res = path.stat(&attr)) != STATUS_OK)
+        {
+            log_error("  could not access file '%s', error code: %d\n", path.as_native(), int(res));
+            return res;
+        }
+
+        return (dst->fmt_append_ascii("%s %llu %llu\n", key, (unsigned long long)attr.size, (unsigned long long)attr.mtime) > 0) ?
+            STATUS_OK : STATUS_NO_MEM;
+    }
+
+    /**
+     * Append the cue list and IR files of cues, contents of files are hashed
+     * for the fingerprint, the signature uses only size and modification time
+     */
+    static status_t cues_fingerprint(LSPString *dst, const config_t *cfg, bool signature, const char *stored)
+    {
+        status_t res;
+        lltl::parray<LSPString> files;
+
+        if (cfg->sCueList.is_empty())
+            return STATUS_OK;
+        if ((res = cue_files(&files, cfg)) != STATUS_OK)
+            return res;
+
+        if (dst->fmt_append_ascii("cues %x\n", int(files.size())) <= 0)
+            res     = STATUS_NO_MEM;
+        else
+            res     = (signature) ?
+                file_signature(dst, "cue_list", &cfg->sCueList) :
+                file_fingerprint(dst, "cue_list", &cfg->sCueList, stored);
+        for (size_t i=0, n=files.size(); (res == STATUS_OK) && (i<n); ++i)
+        {
+            char key[0x20];
+            snprintf(key, sizeof(key), "cue_ir_%d", int(i));
+            res     = (signature) ?
+                file_signature(dst, key, files.uget(i)) :
+                file_fingerprint(dst, key, files.uget(i), stored);
+        }
+        destroy_cue_files(&files);
+
+        return res;
+    }
+
+    status_t job_signature(uint64_t *sig, const config_t *cfg)
+    {
+        status_t res;
+        LSPString text;
+
+        if (text.fmt_ascii("version %x\n", FINGERPRINT_VERSION) <= 0)
+            return STATUS_NO_MEM;
+        if ((res = file_signature(&text, "input", &cfg->sInFile)) != STATUS_OK)
+            return res;
+        if ((res = file_signature(&text, "ir", &cfg->sIRFile)) != STATUS_OK)
+            return res;
+        if ((res = cues_fingerprint(&text, cfg, true, NULL)) != STATUS_OK)
+            return res;
+        if ((res = config_fingerprint(&text, cfg)) != STATUS_OK)
+            return res;
+
+        const char *p = text.get_native();
+        if (p == NULL)
+            return STATUS_NO_MEM;
+        *sig    = hash_bytes(FNV_OFFSET_BASIS, p, strlen(p));
+        return STATUS_OK;
+    }
+
+    status_t check_fingerprint(LSPString *fp, bool *up_to_date, const config_t *cfg)
+    {
+        status_t res;
+        io::Path path, out;
+        char stored[FINGERPRINT_MAX_SIZE];
+
+        *up_to_date     = false;
+        if ((res = fingerprint_path(&path, cfg)) != STATUS_OK)
+            return res;
+        bool has_stored = read_stored(stored, sizeof(stored), &path);
+
+        // Compute the fingerprint of the job
+        if (fp->fmt_ascii("version %x\n", FINGERPRINT_VERSION) <= 0)
+            return STATUS_NO_MEM;
+        if ((res = file_fingerprint(fp, "input", &cfg->sInFile, (has_stored) ? stored : NULL)) != STATUS_OK)
+            return res;
+        if ((res = file_fingerprint(fp, "ir", &cfg->sIRFile, (has_stored) ? stored : NULL)) != STATUS_OK)
+            return res;
+        if ((res = cues_fingerprint(fp, cfg, false, (has_stored) ? stored : NULL)) != STATUS_OK)
+            return res;
+        if ((res = config_fingerprint(fp, cfg)) != STATUS_OK)
+            return res;
+
+        // The output should exist and match the stored fingerprint
+        if ((res = out.set(&cfg->sOutFile)) != STATUS_OK)
+            return res;
+        *up_to_date     = (has_stored) && (out.exists()) && (same_fingerprint(fp->get_native(), stored));
+
+        // Refresh cached size and modification time of files
+        if ((*up_to_date) && (!fp->equals_ascii(stored)))
+            save_fingerprint(fp, cfg);
+
+        return STATUS_OK;
+    }
+
+    status_t save_fingerprint(const LSPString *fp, const config_t *cfg)
+    {
+        status_t res;
+        io::Path path, tmp;
+
+        if ((res = fingerprint_path(&path, cfg)) != STATUS_OK)
+            return res;
+
+        // The fingerprint is written to the temporary file and renamed, so the interrupted
+        // write never leaves the truncated fingerprint next to the output file
+        if ((res = make_temp_path(&tmp, &path)) != STATUS_OK)
+        {
+            log_error("  could not generate temporary file name for '%s', error code: %d\n", path.as_native(), int(res));
+            return res;
+        }
+
+        FILE *fd = fopen(tmp.as_native(), "wb");
+        if (fd == NULL)
+        {
+            log_error("  could not write file '%s'\n", tmp.as_native());
+            return STATUS_IO_ERROR;
+        }
+
+        const char *text = fp->get_native();
+        size_t len = strlen(text);
+        res = (fwrite(text, 1, len, fd) == len) ? STATUS_OK : STATUS_IO_ERROR;
+        if (fclose(fd) != 0)
+            res     = STATUS_IO_ERROR;
+
+        if (res != STATUS_OK)
+        {
+            log_error("  could not write file '%s'\n", tmp.as_native());
+            tmp.remove();
+            return res;
+        }
+
+        if ((res = tmp.rename(&path)) != STATUS_OK)
+        {
+            log_error("  could not rename file '%s' to '%s', error code: %d\n", tmp.as_native(), path.as_native(), int(res));
+            tmp.remove();
+        }
+
+        return res;
+    }
+}
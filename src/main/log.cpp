@@ -0,0 +1,84 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of far-screamer
+ * Created on: 18 окт. 2026 г.
+ *
+ * far-screamer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * far-screamer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with far-screamer. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <lsp-plug.in/common/types.h>
+#include <lsp-plug.in/stdlib/stdio.h>
+#include <lsp-plug.in/stdlib/string.h>
+
+#include <private/log.h>
+
+#include <stdarg.h>
+
+#define LOG_MESSAGE_SIZE        0x1000
+
+namespace far_screamer
+{
+    static __thread const callbacks_t *callbacks = NULL;
+
+    static void log_message(log_level_t level, const char *fmt, va_list args)
+    {
+        const callbacks_t *cb = callbacks;
+        if ((cb == NULL) || (cb->log == NULL))
+        {
+            vfprintf((level == LOG_ERROR) ? stderr : stdout, fmt, args);
+            return;
+        }
+
+        // Messages are passed to the callback without the trailing line break
+        char buf[LOG_MESSAGE_SIZE];
+        vsnprintf(buf, sizeof(buf), fmt, args);
+        size_t len = strlen(buf);
+        if ((len > 0) && (buf[len - 1] == '\n'))
+            buf[len - 1]    = '\0';
+
+        cb->log(cb->arg, level, buf);
+    }
+
+    const callbacks_t *set_callbacks(const callbacks_t *cb)
+    {
+        const callbacks_t *prev = callbacks;
+        callbacks       = cb;
+        return prev;
+    }
+
+    void log_info(const char *fmt, ...)
+    {
+        va_list args;
+        va_start(args, fmt);
+        log_message(LOG_INFO, fmt, args);
+        va_end(args);
+    }
+
+    void log_error(const char *fmt, ...)
+    {
+        va_list args;
+        va_start(args, fmt);
+        log_message(LOG_ERROR, fmt, args);
+        va_end(args);
+    }
+
+    void log_progress(float progress)
+    {
+        const callbacks_t *cb = callbacks;
+        if ((cb != NULL) && (cb->progress != NULL))
+            cb->progress(cb->arg, lsp_limit(progress, 0.0f, 1.0f));
+    }
+}
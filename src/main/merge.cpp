@@ -0,0 +1,320 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of far-screamer
+ * Created on: 18 окт. 2026 г.
+ *
+ * far-screamer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * far-screamer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with far-screamer. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <lsp-plug.in/common/types.h>
+#include <lsp-plug.in/dsp/dsp.h>
+#include <lsp-plug.in/dsp-units/units.h>
+#include <lsp-plug.in/io/Path.h>
+#include <lsp-plug.in/stdlib/stdio.h>
+#include <lsp-plug.in/stdlib/string.h>
+
+#include <private/Arena.h>
+#include <private/AudioReader.h>
+#include <private/AudioWriter.h>
+#include <private/audio.h>
+#include <private/fingerprint.h>
+#include <private/merge.h>
+#include <private/log.h>
+
+#define MERGE_BLOCK_SIZE        0x10000     // Number of frames processed at once
+#define SHARD_EXT               ".shard"
+#define SHARD_MAX_SIZE          0x100
+
+namespace far_screamer
+{
+    typedef struct shard_info_t
+    {
+        int                 index;      // Index of the shard
+        int                 count;      // Number of shards of the job
+        unsigned long long  job;        // Signature of the job
+    } shard_info_t;
+
+    static status_t shard_path(io::Path *dst, const LSPString *name)
+    {
+        status_t res = dst->set(name);
+        return (res == STATUS_OK) ? dst->concat(SHARD_EXT) : res;
+    }
+
+    static status_t load_shard_info(shard_info_t *info, const LSPString *name)
+    {
+        status_t res;
+        io::Path path;
+        char buf[SHARD_MAX_SIZE];
+
+        if ((res = shard_path(&path, name)) != STATUS_OK)
+            return res;
+
+        FILE *fd = fopen(path.as_native(), "rb");
+        if (fd == NULL)
+        {
+            log_error("Could not read file '%s', the shard should be rendered with the -sh option\n", path.as_native());
+            return STATUS_NOT_FOUND;
+        }
+        size_t n = fread(buf, 1, sizeof(buf) - 1, fd);
+        fclose(fd);
+        buf[n]  = '\0';
+
+        if (sscanf(buf, "shard %d %d %llx", &info->index, &info->count, &info->job) != 3)
+        {
+            log_error("File '%s' is corrupted\n", path.as_native());
+            return STATUS_CORRUPTED;
+        }
+
+        return STATUS_OK;
+    }
+
+    static status_t check_shard_info(const config_t *cfg)
+    {
+        status_t res;
+        shard_info_t info;
+        unsigned long long job  = 0;
+        size_t count            = cfg->sMerge.size();
+
+        // Shards should be rendered for the same job and specified in the order of their indices
+        for (size_t i=0; i<count; ++i)
+        {
+            const LSPString *name = cfg->sMerge.uget(i);
+            if ((res = load_shard_info(&info, name)) != STATUS_OK)
+                return res;
+            if (i == 0)
+                job                 = info.job;
+
+            if (info.count != int(count))
+            {
+                log_error("Shard '%s' is one of %d shards, but %d shards are merged\n",
+                    name->get_native(), info.count, int(count));
+                return STATUS_BAD_ARGUMENTS;
+            }
+            if (info.index != int(i))
+            {
+                log_error("Shard '%s' has index %d, expected index %d\n", name->get_native(), info.index, int(i));
+                return STATUS_BAD_ARGUMENTS;
+            }
+            if (info.job != job)
+            {
+                log_error("Shard '%s' is rendered for another job than shard '%s'\n",
+                    name->get_native(), cfg->sMerge.uget(0)->get_native());
+                return STATUS_BAD_ARGUMENTS;
+            }
+        }
+
+        return STATUS_OK;
+    }
+
+    status_t save_shard_info(const config_t *cfg)
+    {
+        status_t res;
+        io::Path path, tmp;
+        config_t job;
+        uint64_t sig;
+
+        if (cfg->nShards <= 0)
+            return STATUS_OK;
+
+        // All shards of the job have the same signature, checkpoints do not change the output
+        if ((res = job.copy(cfg)) != STATUS_OK)
+            return res;
+        job.nShard          = 0;
+        job.nShards         = 0;
+        job.fCheckpoint     = -1.0f;
+        job.bResume         = false;
+        if ((res = job_signature(&sig, &job)) != STATUS_OK)
+            return res;
+
+        if ((res = shard_path(&path, &cfg->sOutFile)) != STATUS_OK)
+            return res;
+        if ((res = make_temp_path(&tmp, &path)) != STATUS_OK)
+        {
+            log_error("  could not generate temporary file name for '%s', error code: %d\n", path.as_native(), int(res));
+            return res;
+        }
+
+        FILE *fd = fopen(tmp.as_native(), "wb");
+        if (fd == NULL)
+        {
+            log_error("  could not write file '%s'\n", tmp.as_native());
+            return STATUS_IO_ERROR;
+        }
+        res = (fprintf(fd, "shard %d %d %016llx\n", int(cfg->nShard), int(cfg->nShards), (unsigned long long)sig) > 0) ?
+            STATUS_OK : STATUS_IO_ERROR;
+        if (fclose(fd) != 0)
+            res     = STATUS_IO_ERROR;
+
+        if (res == STATUS_OK)
+            res     = tmp.rename(&path);
+        if (res != STATUS_OK)
+        {
+            log_error("  could not write file '%s', error code: %d\n", path.as_native(), int(res));
+            tmp.remove();
+        }
+
+        return res;
+    }
+
+    static status_t open_shard(AudioReader *rd, const LSPString *name)
+    {
+        status_t res;
+        io::Path path;
+
+        if ((res = path.set(name)) == STATUS_OK)
+            res             = rd->open(&path);
+        if (res != STATUS_OK)
+            log_error("  could not read file '%s', error code: %d\n", name->get_native(), int(res));
+
+        return res;
+    }
+
+    static status_t process_shard(const LSPString *name, float **ptr, AudioWriter *wr, float gain, float *peak)
+    {
+        status_t res;
+        AudioReader rd;
+
+        if ((res = open_shard(&rd, name)) != STATUS_OK)
+            return res;
+
+        // Compute the peak level if there is no writer, otherwise apply the gain and encode frames
+        for (size_t offset = 0, length = rd.length(); offset < length; )
+        {
+            size_t to_do    = lsp_min(length - offset, size_t(MERGE_BLOCK_SIZE));
+            ssize_t read    = rd.read(ptr, to_do);
+            if (read <= 0)
+            {
+                // All declared frames of shards form the output
+                res             = (read < 0) ? status_t(-read) : STATUS_CORRUPTED;
+                log_error("  could not read file '%s', error code: %d\n", name->get_native(), int(res));
+                break;
+            }
+
+            if (wr == NULL)
+            {
+                for (size_t i=0; i<rd.channels(); ++i)
+                    *peak           = lsp_max(*peak, dsp::abs_max(ptr[i], read));
+            }
+            else
+            {
+                for (size_t i=0; i<rd.channels(); ++i)
+                    dsp::mul_k2(ptr[i], gain, read);
+                ssize_t written = wr->write(ptr, read);
+                if (written < 0)
+                {
+                    res             = status_t(-written);
+                    break;
+                }
+            }
+            offset         += read;
+        }
+
+        rd.close();
+        return res;
+    }
+
+    status_t merge_shards(const config_t *cfg)
+    {
+        status_t res;
+        io::Path path, tmp;
+        AudioReader rd;
+        AudioWriter wr;
+        size_t channels     = 0;
+        size_t sample_rate  = 0;
+        size_t length       = 0;
+
+        if ((res = check_shard_info(cfg)) != STATUS_OK)
+            return res;
+
+        // All shards should have the same format
+        for (size_t i=0, n=cfg->sMerge.size(); i<n; ++i)
+        {
+            const LSPString *name = cfg->sMerge.uget(i);
+            if ((res = open_shard(&rd, name)) != STATUS_OK)
+                return res;
+            if (i == 0)
+            {
+                channels            = rd.channels();
+                sample_rate         = rd.sample_rate();
+            }
+            else if ((rd.channels() != channels) || (rd.sample_rate() != sample_rate))
+            {
+                log_error("Shard '%s' has %d channels at %d Hz, expected %d channels at %d Hz\n",
+                    name->get_native(), int(rd.channels()), int(rd.sample_rate()), int(channels), int(sample_rate));
+                rd.close();
+                return STATUS_BAD_FORMAT;
+            }
+            length             += rd.length();
+            rd.close();
+        }
+        log_info("  merging %d shards: channels: %d, samples: %d, sample rate: %d\n",
+            int(cfg->sMerge.size()), int(channels), int(length), int(sample_rate));
+
+        Arena *arena        = thread_arena();
+        size_t mark         = arena->mark();
+        float **ptr         = arena->alloc<float *>(channels);
+        float *buf          = arena->alloc<float>(channels * MERGE_BLOCK_SIZE);
+        if ((ptr == NULL) || (buf == NULL))
+        {
+            arena->rewind(mark);
+            log_error("Not enough memory to allocate temporary buffer\n");
+            return STATUS_NO_MEM;
+        }
+        for (size_t i=0; i<channels; ++i)
+            ptr[i]              = &buf[i * MERGE_BLOCK_SIZE];
+
+        // The peak level of the whole output defines the normalization
+        float gain          = 1.0f;
+        if (cfg->nNormalize != NORM_NONE)
+        {
+            float peak          = 0.0f;
+            for (size_t i=0, n=cfg->sMerge.size(); i<n; ++i)
+                if ((res = process_shard(cfg->sMerge.uget(i), ptr, NULL, 1.0f, &peak)) != STATUS_OK)
+                {
+                    arena->rewind(mark);
+                    return res;
+                }
+
+            float norm_gain     = (cfg->fNormGain >= MIN_GAIN) ? dspu::db_to_gain(cfg->fNormGain) : 0.0f;
+            gain                = normalize_gain(peak, norm_gain, cfg->nNormalize);
+        }
+
+        // Encode shards one after another
+        if ((res = open_output_file(&path, &tmp, &cfg->sOutFile)) != STATUS_OK)
+        {
+            arena->rewind(mark);
+            return res;
+        }
+        if ((res = wr.open(&tmp, channels, length, sample_rate)) == STATUS_OK)
+        {
+            for (size_t i=0, n=cfg->sMerge.size(); (res == STATUS_OK) && (i<n); ++i)
+                res                 = process_shard(cfg->sMerge.uget(i), ptr, &wr, gain, NULL);
+            status_t cres       = wr.close();
+            if (res == STATUS_OK)
+                res                 = cres;
+        }
+
+        arena->rewind(mark);
+        if (res != STATUS_OK)
+        {
+            log_error("  could not write file '%s', error code: %d\n", tmp.as_native(), int(res));
+            tmp.remove();
+            return res;
+        }
+
+        return commit_output_file(&tmp, &path, channels, length, sample_rate);
+    }
+}
@@ -0,0 +1,186 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of far-screamer
+ * Created on: 18 окт. 2026 г.
+ *
+ * far-screamer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * far-screamer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with far-screamer. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <private/multirate.h>
+#include <private/decimation.h>
+#include <private/log.h>
+#include <lsp-plug.in/stdlib/stdio.h>
+#include <lsp-plug.in/stdlib/math.h>
+#include <lsp-plug.in/dsp/dsp.h>
+#include <lsp-plug.in/dsp-units/units.h>
+
+#define MULTIRATE_CROSSOVER     64          /* Length of the crossover per one unit of decimation factor */
+#define MULTIRATE_PADDING       64          /* Zero padding before the late part per one unit of decimation factor */
+#define MULTIRATE_REPORT_MIN    25.0f       /* Minimum split point (in milliseconds) in the report */
+
+namespace far_screamer
+{
+    using namespace lsp;
+
+    status_t split_impulse_response(
+        dspu::Sample *early, dspu::Sample *late, size_t *offset,
+        const dspu::Sample *ir, size_t split, size_t factor
+    )
+    {
+        size_t channels = ir->channels();
+        size_t length   = ir->length();
+        if ((split <= 0) || (split >= length))
+        {
+            log_error("Invalid split point of the impulse response: %d samples\n", int(split));
+            return STATUS_BAD_ARGUMENTS;
+        }
+
+        // The late part starts with the crossover, add some zero padding to keep
+        // the response of anti-aliasing filter to the beginning of the late part
+        size_t xover    = lsp_min(split, size_t(MULTIRATE_CROSSOVER * factor));
+        size_t head     = split - xover;
+        size_t pad      = MULTIRATE_PADDING * factor;
+        size_t off      = (head > pad) ? head - pad : 0;
+        off            -= off % factor;
+
+        if (!early->init(channels, split, split))
+        {
+            log_error("Not enough memory for early part of the impulse response\n");
+            return STATUS_NO_MEM;
+        }
+        if (!late->init(channels, length - off, length - off))
+        {
+            log_error("Not enough memory for late part of the impulse response\n");
+            return STATUS_NO_MEM;
+        }
+        early->set_sample_rate(ir->sample_rate());
+        late->set_sample_rate(ir->sample_rate());
+
+        for (size_t i=0; i<channels; ++i)
+        {
+            const float *src    = ir->channel(i);
+            float *e            = early->channel(i);
+            float *l            = late->channel(i);
+
+            dsp::copy(e, src, split);
+            dsp::fill_zero(l, head - off);
+            dsp::copy(&l[head - off], &src[head], length - head);
+
+            // Apply complementary linear crossfade
+            e                  += head;
+            l                  += head - off;
+            for (size_t j=0; j<xover; ++j)
+            {
+                float k             = (j + 0.5f) / xover;
+                e[j]               *= 1.0f - k;
+                l[j]               *= k;
+            }
+        }
+
+        *offset     = off;
+        return STATUS_OK;
+    }
+
+    status_t multirate_error(float *error, const dspu::Sample *ir, size_t split, size_t factor)
+    {
+        status_t res;
+        dspu::Sample early, late, d_late, r_late;
+        size_t offset;
+
+        // Pass the late part through the decimation and interpolation
+        if ((res = split_impulse_response(&early, &late, &offset, ir, split, factor)) != STATUS_OK)
+            return res;
+        if ((res = decimate_sample(&d_late, &late, factor, NULL)) != STATUS_OK)
+            return res;
+        if (!r_late.init(late.channels(), late.length(), late.length()))
+        {
+            log_error("Not enough memory for interpolated impulse response\n");
+            return STATUS_NO_MEM;
+        }
+
+        // Compare the result with the original late part
+        float max_err   = 0.0f;
+        for (size_t i=0, n=late.channels(); i<n; ++i)
+        {
+            if ((res = interpolate_channel(&r_late, &d_late, i, i, 0, factor, 1.0f)) != STATUS_OK)
+                return res;
+
+            float *dptr     = r_late.channel(i);
+            dsp::sub2(dptr, late.channel(i), late.length());
+            float energy    = dsp::h_sqr_sum(ir->channel(i), ir->length());
+            if (energy > 0.0f)
+                max_err         = lsp_max(max_err, dsp::h_sqr_sum(dptr, late.length()) / energy);
+        }
+
+        *error      = max_err;
+        return STATUS_OK;
+    }
+
+    static status_t report_split(const dspu::Sample *ir, size_t split, size_t factor, bool selected)
+    {
+        float error;
+        status_t res = multirate_error(&error, ir, split, factor);
+        if (res != STATUS_OK)
+            return res;
+
+        // Estimate the computational load relative to the full-rate convolution, the cost
+        // of the partitioned FFT convolution is proportional to the sample rate of the input
+        size_t length   = ir->length();
+        float load      = (split + float(length - split) / factor) * 100.0f / length;
+        float ms        = dspu::samples_to_millis(ir->sample_rate(), split);
+
+        if (error > 0.0f)
+            log_info("  %c %10.2f %12.2f %10.2f\n", (selected) ? '*' : ' ', ms, dspu::power_to_db(error), load);
+        else
+            log_info("  %c %10.2f %12s %10.2f\n", (selected) ? '*' : ' ', ms, "-inf", load);
+
+        return STATUS_OK;
+    }
+
+    status_t multirate_report(const dspu::Sample *ir, size_t split, size_t factor)
+    {
+        status_t res;
+        bool shown      = false;
+
+        log_info("  multirate accuracy report for decimation factor %d:\n", int(factor));
+        log_info("    %10s %12s %10s\n", "split (ms)", "error (dB)", "load (%)");
+
+        for (float ms = MULTIRATE_REPORT_MIN; ; ms *= 2.0f)
+        {
+            size_t point    = dspu::millis_to_samples(ir->sample_rate(), ms);
+            if (point >= ir->length())
+                break;
+
+            // Output the selected split point in order
+            if ((!shown) && (split <= point))
+            {
+                if ((res = report_split(ir, split, factor, true)) != STATUS_OK)
+                    return res;
+                shown           = true;
+                if (split == point)
+                    continue;
+            }
+
+            if ((res = report_split(ir, point, factor, false)) != STATUS_OK)
+                return res;
+        }
+
+        if (!shown)
+            return report_split(ir, split, factor, true);
+
+        return STATUS_OK;
+    }
+}
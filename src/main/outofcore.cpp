@@ -0,0 +1,728 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of far-screamer
+ * Created on: 18 окт. 2026 г.
+ *
+ * far-screamer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * far-screamer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with far-screamer. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <lsp-plug.in/common/types.h>
+#include <lsp-plug.in/dsp/dsp.h>
+#include <lsp-plug.in/dsp-units/units.h>
+#include <lsp-plug.in/io/Path.h>
+#include <lsp-plug.in/lltl/darray.h>
+#include <lsp-plug.in/stdlib/stdio.h>
+
+#include <private/Arena.h>
+#include <private/AudioReader.h>
+#include <private/AudioWriter.h>
+#include <private/ScratchFile.h>
+#include <private/audio.h>
+#include <private/checkpoint.h>
+#include <private/fingerprint.h>
+#include <private/merge.h>
+#include <private/outofcore.h>
+#include <private/pipeline.h>
+#include <private/region.h>
+#include <private/tool.h>
+#include <private/log.h>
+#include <private/util.h>
+
+#define OOC_BLOCK_SIZE          0x10000     // Number of frames processed at once
+
+namespace far_screamer
+{
+    static status_t decode_input(ScratchFile *dst, const LSPString *name, const lltl::darray<size_t> *channels, size_t first)
+    {
+        status_t res;
+        io::Path path;
+        AudioReader rd;
+
+        if ((res = path.set(name)) == STATUS_OK)
+            res             = rd.open(&path);
+        if ((res == STATUS_OK) && (first > 0))
+            res             = rd.skip(first);
+        if (res != STATUS_OK)
+        {
+            log_error("  could not read file '%s', error code: %d\n", name->get_native(), int(res));
+            return res;
+        }
+
+        size_t count    = dst->channels();
+        size_t total    = rd.channels();
+        Arena *arena    = thread_arena();
+        size_t mark     = arena->mark();
+        float **ptr     = arena->alloc<float *>(total);
+        if (ptr == NULL)
+        {
+            rd.close();
+            log_error("Not enough memory to allocate temporary buffer\n");
+            return STATUS_NO_MEM;
+        }
+
+        // Decode frames directly to channels of the scratch file, skip channels which are not selected
+        for (size_t i=0; i<total; ++i)
+            ptr[i]          = NULL;
+        for (size_t offset = 0; offset < dst->length(); )
+        {
+            size_t to_do    = lsp_min(dst->length() - offset, size_t(OOC_BLOCK_SIZE));
+            for (size_t i=0; i<count; ++i)
+            {
+                size_t ch       = (channels->is_empty()) ? i : *channels->uget(i);
+                if (ch < total)
+                    ptr[ch]         = &dst->channel(i)[offset];
+            }
+
+            ssize_t read    = rd.read(ptr, to_do);
+            if (read < 0)
+            {
+                log_error("  could not read file '%s', error code: %d\n", name->get_native(), int(-read));
+                res             = status_t(-read);
+                break;
+            }
+            else if (read == 0) // The stream may be shorter than the header says
+                break;
+
+            for (size_t i=0; i<count; ++i)
+                dst->release(i, offset, read);
+            offset         += read;
+        }
+
+        arena->rewind(mark);
+        rd.close();
+
+        return res;
+    }
+
+    static void mix_dry(ScratchFile *out, const ScratchFile *in, const config_t *cfg, size_t latency, float gain)
+    {
+        for (size_t oc=0; oc<out->channels(); ++oc)
+            for (size_t ic=0; ic<in->channels(); ++ic)
+            {
+                if (!contains_mapping(cfg, oc, ic))
+                    continue;
+
+                // Copy 'dry' sound with adjusted gain
+                float *dptr         = &out->channel(oc)[latency];
+                const float *sptr   = in->channel(ic);
+                for (size_t offset = 0; offset < in->length(); offset += OOC_BLOCK_SIZE)
+                {
+                    size_t to_do        = lsp_min(in->length() - offset, size_t(OOC_BLOCK_SIZE));
+                    dsp::fmadd_k3(&dptr[offset], &sptr[offset], gain, to_do);
+                    out->release(oc, latency + offset, to_do);
+                }
+            }
+    }
+
+    static status_t collect_routes(lltl::darray<route_t> *routes, const config_t *cfg, size_t in_channels, const dspu::Sample *ir)
+    {
+        route_t *r;
+
+        // All IR channels convolved with the same input channel to the same output channel are summed
+        for (size_t i=0, n=cfg->sMapping.size(); i<n; ++i)
+        {
+            const mapping_t *m = cfg->sMapping.uget(i);
+            log_info("  convolving IN channel %d with IR channel %d to OUT channel %d at %.2f dB\n",
+                int(m->in), int(m->ir), int(m->out), m->gain
+            );
+
+            float gain = m->gain + cfg->fWet;
+            if (gain < MIN_GAIN)
+                continue;
+            if (m->in >= in_channels)
+            {
+                log_error("Invalid channel number for input file: %d\n", int(m->in));
+                continue;
+            }
+            if (m->ir >= ir->channels())
+            {
+                log_error("Invalid channel number for impulse response file: %d\n", int(m->ir));
+                continue;
+            }
+            if (find_route(routes, m->in, m->out) != NULL)
+                continue;
+            if ((r = routes->add()) == NULL)
+            {
+                log_error("Not enough memory for routing data\n");
+                return STATUS_NO_MEM;
+            }
+            r->in       = m->in;
+            r->out      = m->out;
+        }
+
+        return STATUS_OK;
+    }
+
+    static status_t convolve_routes(
+        size_t *wet_end, ScratchFile *out, const ScratchFile *in, const dspu::Sample *ir,
+        const config_t *cfg, size_t predelay, float tail_thresh, size_t tail_window)
+    {
+        status_t res;
+        lltl::darray<route_t> routes;
+        if ((res = collect_routes(&routes, cfg, in->channels(), ir)) != STATUS_OK)
+            return res;
+
+        size_t num_routes   = routes.size();
+        size_t ir_length    = ir->length();
+        size_t src_length   = in->length();
+        Arena *arena        = thread_arena();
+        size_t mark         = arena->mark();
+        float *ir0          = arena->alloc<float>(ir_length * 2);
+        if (ir0 == NULL)
+        {
+            log_error("Not enough memory to allocate temporary buffer\n");
+            return STATUS_NO_MEM;
+        }
+        float *ir1          = &ir0[ir_length];
+
+        // Process routes by pairs with packed FFT, the remaining route alone
+        for (size_t i=0; (res == STATUS_OK) && (i < num_routes); i += 2)
+        {
+            size_t wet_length   = 0;
+            const route_t *r0   = routes.uget(i);
+            mix_route_ir(ir0, ir, cfg, r0, 1.0f);
+            in->prefetch(r0->in, 0, OOC_BLOCK_SIZE);
+
+            if ((i + 1) < num_routes)
+            {
+                const route_t *r1   = routes.uget(i + 1);
+                log_info("  convolving IN channels %d, %d to OUT channels %d, %d with packed FFT\n",
+                    int(r0->in), int(r1->in), int(r0->out), int(r1->out));
+
+                mix_route_ir(ir1, ir, cfg, r1, 1.0f);
+                in->prefetch(r1->in, 0, OOC_BLOCK_SIZE);
+                res = convolve_channel_pair(
+                    &out->channel(r0->out)[predelay], &out->channel(r1->out)[predelay],
+                    in->channel(r0->in), in->channel(r1->in), src_length,
+                    ir0, ir1, ir_length, tail_thresh, tail_window, OOC_BLOCK_SIZE, &wet_length);
+
+                in->release(r1->in, 0, src_length);
+                out->release(r1->out, 0, out->length());
+            }
+            else
+                res = convolve_channel(
+                    &out->channel(r0->out)[predelay], in->channel(r0->in), src_length,
+                    ir0, ir_length, 1.0f, 0.0f, tail_thresh, tail_window, OOC_BLOCK_SIZE, &wet_length);
+
+            in->release(r0->in, 0, src_length);
+            out->release(r0->out, 0, out->length());
+            if (res == STATUS_OK)
+                *wet_end    = lsp_max(*wet_end, predelay + wet_length);
+            log_progress(float(lsp_min(i + 2, num_routes)) / float(num_routes));
+        }
+
+        arena->rewind(mark);
+        return res;
+    }
+
+    static void report_mid_side(size_t channels)
+    {
+        if (channels == 1)
+            log_info("  mono output has no side part, adjusting only mono part\n");
+        else if (channels == 2)
+            log_info("  adjusting Mid/Side balance for stereo output signal\n");
+        else
+            log_info("  unsupported mid/side balancing for %d output channels, skipping\n", int(channels));
+    }
+
+    static void balance_range(ScratchFile *out, size_t first, size_t end, float mid, float side)
+    {
+        if (out->channels() == 1)
+        {
+            for (size_t offset = first; offset < end; offset += OOC_BLOCK_SIZE)
+            {
+                size_t to_do    = lsp_min(end - offset, size_t(OOC_BLOCK_SIZE));
+                dsp::mul_k2(&out->channel(0)[offset], mid, to_do);
+                out->release(0, offset, to_do);
+            }
+        }
+        else if (out->channels() == 2)
+        {
+            for (size_t offset = first; offset < end; offset += OOC_BLOCK_SIZE)
+            {
+                size_t to_do    = lsp_min(end - offset, size_t(OOC_BLOCK_SIZE));
+                float *a        = &out->channel(0)[offset];
+                float *b        = &out->channel(1)[offset];
+                dsp::lr_to_ms(a, b, a, b, to_do);
+                dsp::mul_k2(a, mid, to_do);
+                dsp::mul_k2(b, side, to_do);
+                dsp::ms_to_lr(a, b, a, b, to_do);
+                out->release(0, offset, to_do);
+                out->release(1, offset, to_do);
+            }
+        }
+    }
+
+    static void balance_mid_side(ScratchFile *out, size_t length, float mid, float side)
+    {
+        report_mid_side(out->channels());
+        balance_range(out, 0, length, mid, side);
+    }
+
+    static float peak_level(ScratchFile *out, size_t length)
+    {
+        float peak      = 0.0f;
+        for (size_t i=0; i<out->channels(); ++i)
+            for (size_t offset = 0; offset < length; offset += OOC_BLOCK_SIZE)
+            {
+                size_t to_do    = lsp_min(length - offset, size_t(OOC_BLOCK_SIZE));
+                peak            = lsp_max(peak, dsp::abs_max(&out->channel(i)[offset], to_do));
+                out->release(i, offset, to_do);
+            }
+
+        return peak;
+    }
+
+    static status_t encode_output(ScratchFile *out, size_t first, size_t length, size_t sample_rate, float gain, const LSPString *name)
+    {
+        status_t res;
+        io::Path path, tmp;
+        AudioWriter wr;
+        size_t channels = out->channels();
+
+        if ((res = open_output_file(&path, &tmp, name)) != STATUS_OK)
+            return res;
+        if ((res = wr.open(&tmp, channels, length, sample_rate)) != STATUS_OK)
+        {
+            log_error("  could not write file '%s', error code: %d\n", tmp.as_native(), int(res));
+            tmp.remove();
+            return res;
+        }
+
+        Arena *arena    = thread_arena();
+        size_t mark     = arena->mark();
+        const float **ptr = arena->alloc<const float *>(channels);
+        float *buf      = arena->alloc<float>(channels * OOC_BLOCK_SIZE);
+        if ((ptr == NULL) || (buf == NULL))
+        {
+            arena->rewind(mark);
+            wr.close();
+            tmp.remove();
+            log_error("Not enough memory to allocate temporary buffer\n");
+            return STATUS_NO_MEM;
+        }
+
+        // Apply the gain to the copy of data, the output may be encoded again after restart
+        for (size_t i=0; i<channels; ++i)
+            ptr[i]          = &buf[i * OOC_BLOCK_SIZE];
+        for (size_t offset = first, end = first + length; offset < end; )
+        {
+            size_t to_do    = lsp_min(end - offset, size_t(OOC_BLOCK_SIZE));
+            for (size_t i=0; i<channels; ++i)
+            {
+                out->prefetch(i, offset + to_do, OOC_BLOCK_SIZE);
+                dsp::mul_k3(&buf[i * OOC_BLOCK_SIZE], &out->channel(i)[offset], gain, to_do);
+            }
+
+            ssize_t written = wr.write(ptr, to_do);
+            for (size_t i=0; i<channels; ++i)
+                out->release(i, offset, to_do);
+            if (written < 0)
+            {
+                res             = status_t(-written);
+                break;
+            }
+            offset         += to_do;
+        }
+
+        arena->rewind(mark);
+        status_t cres   = wr.close();
+        if (res == STATUS_OK)
+            res             = cres;
+        if (res != STATUS_OK)
+        {
+            log_error("  could not write file '%s', error code: %d\n", tmp.as_native(), int(res));
+            tmp.remove();
+            return res;
+        }
+
+        return commit_output_file(&tmp, &path, channels, length, sample_rate);
+    }
+
+    static ssize_t read_segment(AudioReader *rd, float **ptr, dspu::Sample *dst, const lltl::darray<size_t> *channels, size_t count)
+    {
+        size_t total    = rd->channels();
+        size_t offset   = 0;
+
+        // Decode frames directly to channels of the segment, skip channels which are not selected
+        for (size_t i=0; i<total; ++i)
+            ptr[i]          = NULL;
+        while (offset < count)
+        {
+            size_t to_do    = lsp_min(count - offset, size_t(OOC_BLOCK_SIZE));
+            for (size_t i=0; i<dst->channels(); ++i)
+            {
+                size_t ch       = (channels->is_empty()) ? i : *channels->uget(i);
+                if (ch < total)
+                    ptr[ch]         = &dst->channel(i)[offset];
+            }
+
+            ssize_t read    = rd->read(ptr, to_do);
+            if (read < 0)
+                return read;
+            else if (read == 0) // The stream may be shorter than the header says
+                break;
+            offset         += read;
+        }
+
+        for (size_t i=0; i<dst->channels(); ++i)
+            dsp::fill_zero(&dst->channel(i)[offset], count - offset);
+
+        return offset;
+    }
+
+    static status_t open_partial(
+        checkpoint_t *cp, ScratchFile *out, const io::Path *state, const io::Path *data,
+        const config_t *cfg, size_t channels, size_t length)
+    {
+        status_t res;
+        uint64_t job    = 0;
+        if ((res = job_signature(&job, cfg)) != STATUS_OK)
+            return res;
+
+        // Continue from the last checkpoint of the same job
+        if (cfg->bResume)
+        {
+            res             = out->open_file(data, channels, length, true);
+            if (res == STATUS_OK)
+                res             = load_checkpoint(cp, out, state, job);
+            if (res == STATUS_OK)
+            {
+                log_info("  resuming from the checkpoint at input sample %d\n", int(cp->position));
+                return STATUS_OK;
+            }
+            log_info("  no valid checkpoint for the job, rendering from the beginning\n");
+            out->close();
+        }
+
+        // The stale checkpoint should not be loaded after restart of the new render
+        state->remove();
+        cp->job         = job;
+        cp->position    = 0;
+        cp->pending     = 0;
+        cp->tail        = 0;
+        cp->limit       = 0;
+        cp->wet_end     = 0;
+
+        return out->open_file(data, channels, length, false);
+    }
+
+    static status_t render_checkpointed(
+        checkpoint_t *cp, ScratchFile *out, const dspu::Sample *ir, const config_t *cfg, const io::Path *state,
+        const lltl::darray<size_t> *in_channels, size_t channels, size_t first, size_t in_length, const render_t *p)
+    {
+        status_t res;
+        io::Path path;
+        AudioReader rd;
+        dspu::Sample seg;
+        lltl::darray<route_t> routes;
+
+        if ((res = collect_routes(&routes, cfg, channels, ir)) != STATUS_OK)
+            return res;
+
+        // The input is read by segments between checkpoints
+        size_t segment      = lsp_min(checkpoint_segment(cfg, cfg->nSampleRate), lsp_max(in_length, size_t(1)));
+        if ((res = path.set(&cfg->sInFile)) == STATUS_OK)
+            res                 = rd.open(&path);
+        if ((res == STATUS_OK) && (first + cp->position > 0))
+            res                 = rd.skip(first + cp->position);
+        if (res != STATUS_OK)
+        {
+            log_error("  could not read file '%s', error code: %d\n", path.as_native(), int(res));
+            return res;
+        }
+
+        size_t num_routes   = routes.size();
+        size_t ir_length    = ir->length();
+        size_t out_length   = out->length();
+        size_t lead         = lsp_min(p->latency, p->predelay);
+        size_t lag          = lsp_max(p->latency, p->predelay + ir_length);
+        Arena *arena        = thread_arena();
+        size_t mark         = arena->mark();
+        float **ptr         = arena->alloc<float *>(rd.channels());
+        float *irs          = arena->alloc<float>(lsp_max(num_routes, size_t(1)) * ir_length);
+        if ((ptr == NULL) || (irs == NULL) || (!seg.init(channels, segment, segment)))
+        {
+            arena->rewind(mark);
+            rd.close();
+            log_error("Not enough memory to allocate temporary buffer\n");
+            return STATUS_NO_MEM;
+        }
+
+        // Impulse responses of routes do not change between segments
+        for (size_t i=0; i < num_routes; ++i)
+            mix_route_ir(&irs[i * ir_length], ir, cfg, routes.uget(i), 1.0f);
+        for (size_t i=0; i+1 < num_routes; i += 2)
+            log_info("  convolving IN channels %d, %d to OUT channels %d, %d with packed FFT\n",
+                int(routes.uget(i)->in), int(routes.uget(i+1)->in), int(routes.uget(i)->out), int(routes.uget(i+1)->out));
+        log_info("  storing checkpoints every %d input samples to '%s'\n", int(segment), state->as_native());
+
+        for (size_t pos = cp->position, done = 0; pos < in_length; )
+        {
+            size_t count    = lsp_min(in_length - pos, segment);
+            bool last       = (pos + count) >= in_length;
+            ssize_t read    = read_segment(&rd, ptr, &seg, in_channels, count);
+            if (read < 0)
+            {
+                log_error("  could not read file '%s', error code: %d\n", path.as_native(), int(-read));
+                res             = status_t(-read);
+                break;
+            }
+
+            // Form the 'Dry' sound according to the mapping settings
+            for (size_t oc=0; oc<out->channels(); ++oc)
+                for (size_t ic=0; ic<channels; ++ic)
+                {
+                    if (!contains_mapping(cfg, oc, ic))
+                        continue;
+                    float *dptr         = &out->channel(oc)[p->latency + pos];
+                    const float *sptr   = seg.channel(ic);
+                    for (size_t offset = 0; offset < count; offset += OOC_BLOCK_SIZE)
+                    {
+                        size_t to_do        = lsp_min(count - offset, size_t(OOC_BLOCK_SIZE));
+                        dsp::fmadd_k3(&dptr[offset], &sptr[offset], p->dry, to_do);
+                        out->release(oc, p->latency + pos + offset, to_do);
+                    }
+                }
+
+            // Accumulate the wet signal, the tail is truncated only after the last segment
+            float threshold = (last) ? p->threshold : 0.0f;
+            for (size_t i=0; (res == STATUS_OK) && (i < num_routes); i += 2)
+            {
+                size_t wet_length   = 0;
+                const route_t *r0   = routes.uget(i);
+                const float *ir0    = &irs[i * ir_length];
+                if ((i + 1) < num_routes)
+                {
+                    const route_t *r1   = routes.uget(i + 1);
+                    res = convolve_channel_pair(
+                        &out->channel(r0->out)[p->predelay + pos], &out->channel(r1->out)[p->predelay + pos],
+                        seg.channel(r0->in), seg.channel(r1->in), count,
+                        ir0, &ir0[ir_length], ir_length, threshold, p->window, OOC_BLOCK_SIZE, &wet_length);
+                    out->release(r1->out, p->predelay + pos, count + ir_length);
+                }
+                else
+                    res = convolve_channel(
+                        &out->channel(r0->out)[p->predelay + pos], seg.channel(r0->in), count,
+                        ir0, ir_length, 1.0f, 0.0f, threshold, p->window, OOC_BLOCK_SIZE, &wet_length);
+
+                out->release(r0->out, p->predelay + pos, count + ir_length);
+                if (res == STATUS_OK)
+                    cp->wet_end     = lsp_max(cp->wet_end, p->predelay + pos + wet_length);
+            }
+            if (res != STATUS_OK)
+                break;
+
+            // Samples before the next input frames are final, overlapping tails are stored in the checkpoint
+            pos            += count;
+            size_t final    = (last) ? out_length : lsp_min(pos + lead, out_length);
+            balance_range(out, cp->pending, final, p->mid, p->side);
+            cp->position    = pos;
+            cp->pending     = final;
+            cp->tail        = (last) ? out_length : lsp_min(pos + lag, out_length);
+            cp->limit       = ((pos + segment) >= in_length) ? out_length : lsp_min(pos + segment + lag, out_length);
+            if ((res = save_checkpoint(cp, out, state)) != STATUS_OK)
+                break;
+            log_info("  checkpoint at %d of %d input samples\n", int(pos), int(in_length));
+            log_progress(float(pos) / float(in_length));
+
+            if ((!last) && (checkpoint_limit_reached(++done)))
+            {
+                log_info("  stopping after %d segments\n", int(done));
+                res             = STATUS_CANCELLED;
+                break;
+            }
+        }
+
+        arena->rewind(mark);
+        rd.close();
+        if (res != STATUS_OK)
+            return res;
+
+        // The input may be empty or completely processed before restart
+        balance_range(out, cp->pending, out_length, p->mid, p->side);
+        cp->pending     = out_length;
+
+        return STATUS_OK;
+    }
+
+    status_t render_out_of_core(config_t *cfg, const LSPString *fp)
+    {
+        status_t res;
+        io::Path dir;
+        audio_info_t info;
+        dspu::Sample ir;
+        layout_t layout;
+        workload_t w;
+        ScratchFile in, out;
+        region_t region;
+        lltl::darray<size_t> in_channels, ir_channels;
+        size_t latency  = 0;
+
+        if ((res = dir.set(&cfg->sScratchDir)) != STATUS_OK)
+            return res;
+        if (!dir.is_dir())
+        {
+            log_error("Scratch directory '%s' does not exist\n", dir.as_native());
+            return STATUS_NOT_FOUND;
+        }
+
+        // Read the header of the input file, the input is processed at its own sample rate
+        if ((res = read_audio_info(&info, &cfg->sInFile)) != STATUS_OK)
+            return res;
+        if ((cfg->nSampleRate > 0) && (size_t(cfg->nSampleRate) != info.sample_rate))
+        {
+            log_error("Resampling of the input file is not supported in out-of-core mode\n");
+            return STATUS_BAD_ARGUMENTS;
+        }
+        cfg->nSampleRate    = info.sample_rate;
+
+        // Select channels used by the mapping, the impulse response is small enough to be prepared in memory
+        if ((res = select_channels(&in_channels, cfg, false, true)) != STATUS_OK)
+            return res;
+        if ((res = select_channels(&ir_channels, cfg, true, true)) != STATUS_OK)
+            return res;
+        if ((res = prepare_ir(&ir, &latency, cfg, &ir_channels)) != STATUS_OK)
+            return res;
+
+        // Only the range of the input is decoded for the region of the output
+        size_t channels     = (in_channels.is_empty()) ? info.channels : in_channels.size();
+        size_t first        = 0;
+        size_t in_length    = info.length;
+        bool partial        = region_enabled(cfg);
+        if (partial)
+        {
+            if ((res = init_region(&region, cfg, ir.length(), latency, true)) != STATUS_OK)
+                return res;
+            first               = region.input.offset;
+            in_length          -= first;
+            if (region.input.length >= 0)
+                in_length           = lsp_min(in_length, size_t(region.input.length));
+        }
+        if ((res = make_workload(&w, &layout, cfg, channels, in_length, ir.channels(), ir.length(), latency, true)) != STATUS_OK)
+            return res;
+        if ((w.factor > 1) || (w.split > 0) || (w.sparse) || (w.stems))
+            log_info("  decimation, multirate, sparse and stem processing are not available out of core, using direct convolution\n");
+
+        render_t params;
+        params.latency      = latency;
+        params.predelay     = dspu::millis_to_samples(cfg->nSampleRate, cfg->fPreDelay);
+        params.dry          = (cfg->fDry >= MIN_GAIN) ? dspu::db_to_gain(cfg->fDry) : 0.0f;
+        params.wet          = 1.0f;
+        params.mid          = (cfg->fMid  >= MIN_GAIN) ? dspu::db_to_gain(cfg->fMid)  : 0.0f;
+        params.side         = (cfg->fSide >= MIN_GAIN) ? dspu::db_to_gain(cfg->fSide) : 0.0f;
+        params.threshold    = (cfg->fTailThreshold >= MIN_GAIN) ? dspu::db_to_gain(cfg->fTailThreshold) : 0.0f;
+        params.window       = dspu::millis_to_samples(cfg->nSampleRate, cfg->fTailWindow);
+        float tail_thresh   = params.threshold;
+        size_t tail_window  = params.window;
+        size_t wet_end      = 0;
+        size_t length       = w.out_length;
+        bool checkpoints    = cfg->fCheckpoint > 0.0f;
+        io::Path state, data;
+
+        if (checkpoints)
+        {
+            // The output is accumulated in the file kept alongside the output file until the render completes
+            checkpoint_t cp;
+            if ((res = checkpoint_paths(&state, &data, cfg)) != STATUS_OK)
+                return res;
+            if ((res = open_partial(&cp, &out, &state, &data, cfg, w.out_channels, w.out_length)) != STATUS_OK)
+                return res;
+            log_info("  using partial output file '%s': %.1f MiB\n", data.as_native(),
+                mib(wsize_t(w.out_channels) * w.out_length * sizeof(float)));
+            report_mid_side(out.channels());
+            if ((res = render_checkpointed(&cp, &out, &ir, cfg, &state, &in_channels, channels, first, in_length, &params)) != STATUS_OK)
+                return res;
+            wet_end             = cp.wet_end;
+        }
+        else
+        {
+            // Create scratch files
+            if ((res = in.open(&dir, channels, in_length)) != STATUS_OK)
+                return res;
+            if ((res = out.open(&dir, w.out_channels, w.out_length)) != STATUS_OK)
+                return res;
+            log_info("  using scratch files in '%s': input %.1f MiB, output %.1f MiB\n", dir.as_native(),
+                mib(wsize_t(channels) * in_length * sizeof(float)),
+                mib(wsize_t(w.out_channels) * w.out_length * sizeof(float)));
+
+            // Decode the input and form the 'Dry' sound according to the mapping settings
+            if ((res = decode_input(&in, &cfg->sInFile, &in_channels, first)) != STATUS_OK)
+                return res;
+            mix_dry(&out, &in, cfg, latency, params.dry);
+
+            // Accumulate the wet signal, the input is not needed after that
+            if ((res = convolve_routes(&wet_end, &out, &in, &ir, cfg, params.predelay, tail_thresh, tail_window)) != STATUS_OK)
+                return res;
+            in.close();
+            balance_mid_side(&out, length, params.mid, params.side);
+        }
+
+        // Truncate the tail of the output
+        if (tail_thresh > 0.0f)
+        {
+            size_t dry_end  = latency + in_length;
+            size_t tail     = dry_end;
+            length          = lsp_max(dry_end, wet_end);
+            for (size_t i=0; i<out.channels(); ++i)
+                tail            = detect_channel_tail(out.channel(i), length, tail, tail_thresh);
+            length          = (length > tail) ? lsp_min(tail + tail_window, length) : length;
+            log_info("  truncated output tail at %d samples\n", int(length));
+        }
+
+        // Trim file if option is specified
+        if (cfg->bTrim)
+            length          = in_length;
+
+        // Keep only the region of the output
+        size_t head         = 0;
+        if (partial)
+        {
+            if (region.head >= length)
+            {
+                log_error("The region starts after the end of the output\n");
+                return STATUS_UNDERFLOW;
+            }
+            head                = region.head;
+            length             -= head;
+            if (region.length >= 0)
+                length              = lsp_min(length, size_t(region.length));
+        }
+
+        // Normalize and export the processed audio file
+        float gain          = 1.0f;
+        if (cfg->nNormalize != NORM_NONE)
+        {
+            float norm_gain     = (cfg->fNormGain >= MIN_GAIN) ? dspu::db_to_gain(cfg->fNormGain) : 0.0f;
+            gain                = normalize_gain(peak_level(&out, length), norm_gain, cfg->nNormalize);
+        }
+        if ((res = encode_output(&out, head, length, info.sample_rate, gain, &cfg->sOutFile)) != STATUS_OK)
+            return res;
+
+        // The render is complete, the checkpoint is not needed anymore
+        if (checkpoints)
+        {
+            out.close();
+            state.remove();
+            data.remove();
+        }
+        if ((res = save_shard_info(cfg)) != STATUS_OK)
+            return res;
+
+        // Store fingerprint of the output file
+        return ((cfg->bIncremental) && (fp != NULL)) ? save_fingerprint(fp, cfg) : STATUS_OK;
+    }
+}
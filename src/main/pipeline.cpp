@@ -0,0 +1,429 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of far-screamer
+ * Created on: 18 окт. 2026 г.
+ *
+ * far-screamer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * far-screamer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with far-screamer. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <far-screamer/config.h>
+#include <private/pipeline.h>
+#include <private/PairConvolver.h>
+#include <private/Arena.h>
+#include <private/CompactSample.h>
+#include <private/log.h>
+#include <lsp-plug.in/stdlib/stdio.h>
+#include <lsp-plug.in/common/alloc.h>
+#include <lsp-plug.in/dsp/dsp.h>
+
+#define PIPELINE_BLOCK_SIZE     0x1000
+#define PIPELINE_MAX_CHANNELS   8
+
+namespace far_screamer
+{
+    using namespace lsp;
+
+    /*
+     * Each layout has exactly one convolution route per output channel. The route
+     * defines which input signal is convolved with which impulse response. The input
+     * signal of the route is also the dry signal of the corresponding output channel.
+     */
+
+    // Mono input, N-channel IR, N outputs
+    template <size_t N>
+    struct layout_1xn
+    {
+        static const size_t IN      = 1;
+        static const size_t OUT     = N;
+
+        static inline void route_src(float *dst, const float * const *src, size_t /* r */, size_t count)
+        {
+            dsp::copy(dst, src[0], count);
+        }
+
+        static inline void route_ir(float *dst, const dspu::Sample *ir, size_t r)
+        {
+            dsp::copy(dst, ir->channel(r), ir->length());
+        }
+    };
+
+    // N-channel input, mono IR, mono output: the convolution is applied to the sum of inputs
+    template <size_t N>
+    struct layout_nx1
+    {
+        static const size_t IN      = N;
+        static const size_t OUT     = 1;
+
+        static inline void route_src(float *dst, const float * const *src, size_t /* r */, size_t count)
+        {
+            dsp::copy(dst, src[0], count);
+            for (size_t i=1; i<N; ++i)
+                dsp::add2(dst, src[i], count);
+        }
+
+        static inline void route_ir(float *dst, const dspu::Sample *ir, size_t /* r */)
+        {
+            dsp::copy(dst, ir->channel(0), ir->length());
+        }
+    };
+
+    // Stereo input, stereo IR, stereo output
+    struct layout_2x2
+    {
+        static const size_t IN      = 2;
+        static const size_t OUT     = 2;
+
+        static inline void route_src(float *dst, const float * const *src, size_t r, size_t count)
+        {
+            dsp::copy(dst, src[r], count);
+        }
+
+        static inline void route_ir(float *dst, const dspu::Sample *ir, size_t r)
+        {
+            dsp::copy(dst, ir->channel(r), ir->length());
+        }
+    };
+
+    // Stereo input, TrueReverb IR, stereo output: both IR channels of each input are summed
+    struct layout_2x4
+    {
+        static const size_t IN      = 2;
+        static const size_t OUT     = 2;
+
+        static inline void route_src(float *dst, const float * const *src, size_t r, size_t count)
+        {
+            dsp::copy(dst, src[r], count);
+        }
+
+        static inline void route_ir(float *dst, const dspu::Sample *ir, size_t r)
+        {
+            dsp::add3(dst, ir->channel(r * 2), ir->channel(r * 2 + 1), ir->length());
+        }
+    };
+
+    /**
+     * Input of the pipeline: floating-point sample or compact sample decoded by blocks
+     */
+    typedef struct input_t
+    {
+        const dspu::Sample     *sample;     // Floating-point input, NULL if compact
+        const CompactSample    *compact;    // Compact input
+        float                  *buf;        // Buffer to decode one block of each channel
+        size_t                  channels;   // Number of channels
+        size_t                  length;     // Length of the input
+    } input_t;
+
+    static inline const float *fetch_input(const input_t *in, size_t channel, size_t offset, size_t count)
+    {
+        if (in->sample != NULL)
+            return &in->sample->channel(channel)[offset];
+
+        float *dst          = &in->buf[channel * PIPELINE_BLOCK_SIZE];
+        in->compact->read(dst, channel, offset, count);
+        return dst;
+    }
+
+    template <class L>
+    static void load_sources(float * const *dst, const input_t *in, ssize_t pos, size_t count)
+    {
+        // Input data outside of the input sample is silence
+        size_t length       = in->length;
+        size_t head         = (pos < 0) ? lsp_min(size_t(-pos), count) : 0;
+        size_t start        = pos + head;
+        size_t avail        = (start < length) ? lsp_min(count - head, length - start) : 0;
+
+        const float *src[L::IN];
+        for (size_t i=0; i<L::IN; ++i)
+            src[i]              = (avail > 0) ? fetch_input(in, i, start, avail) : NULL;
+
+        for (size_t r=0; r<L::OUT; ++r)
+        {
+            dsp::fill_zero(dst[r], head);
+            if (avail > 0)
+                L::route_src(&dst[r][head], src, r, avail);
+            dsp::fill_zero(&dst[r][head + avail], count - head - avail);
+        }
+    }
+
+    template <size_t N>
+    static inline void mix_output(float * const *dst, float * const *src, float /* mid */, float /* side */, size_t count)
+    {
+        for (size_t i=0; i<N; ++i)
+            dsp::copy(dst[i], src[i], count);
+    }
+
+    template <>
+    inline void mix_output<1>(float * const *dst, float * const *src, float mid, float /* side */, size_t count)
+    {
+        dsp::mul_k3(dst[0], src[0], mid, count);
+    }
+
+    template <>
+    inline void mix_output<2>(float * const *dst, float * const *src, float mid, float side, size_t count)
+    {
+        // Equivalent to the L/R -> M/S -> L/R conversion with adjusted M/S gains
+        float a             = (mid + side) * 0.5f;
+        float b             = (mid - side) * 0.5f;
+        dsp::mix_copy2(dst[0], src[0], src[1], a, b, count);
+        dsp::mix_copy2(dst[1], src[0], src[1], b, a, count);
+    }
+
+    template <class L>
+    static status_t render(
+        size_t *wet_end, dspu::Sample *out, const input_t *input, const dspu::Sample *ir,
+        const render_t *p)
+    {
+        const size_t pairs  = (L::OUT + 1) / 2;
+        PairConvolver conv[pairs];
+        size_t in_length    = input->length;
+        size_t ir_length    = ir->length();
+        Arena *arena        = thread_arena();
+        size_t mark         = arena->mark();
+
+        if ((input->channels != L::IN) || (out->channels() != L::OUT))
+        {
+            log_error("Invalid number of channels for the processing pipeline\n");
+            return STATUS_BAD_ARGUMENTS;
+        }
+
+        // Initialize convolvers, each convolver processes two output channels,
+        // the buffer for routed IR is released with convolvers at the end
+        float *irbuf        = arena->alloc<float>(ir_length * 2);
+        if (irbuf == NULL)
+        {
+            log_error("Not enough memory to allocate temporary buffer\n");
+            return STATUS_NO_MEM;
+        }
+
+        for (size_t i=0; i<pairs; ++i)
+        {
+            size_t r            = i * 2;
+            bool paired         = (r + 1) < L::OUT;
+
+            L::route_ir(irbuf, ir, r);
+            dsp::mul_k2(irbuf, p->wet, ir_length);
+            if (paired)
+            {
+                L::route_ir(&irbuf[ir_length], ir, r + 1);
+                dsp::mul_k2(&irbuf[ir_length], p->wet, ir_length);
+            }
+
+            if (!conv[i].init(irbuf, (paired) ? &irbuf[ir_length] : NULL, ir_length, CONV_RANK))
+            {
+                arena->rewind(mark);
+                log_error("Not enough memory to initialize convolver\n");
+                return STATUS_NO_MEM;
+            }
+        }
+
+        // Allocate buffers for route sources, the dry and the wet signal, and
+        // for decoding of the compact input
+        size_t decoded      = (input->compact != NULL) ? L::IN : 0;
+        float *buf          = arena->alloc<float>((L::OUT * 3 + decoded) * PIPELINE_BLOCK_SIZE);
+        if (buf == NULL)
+        {
+            arena->rewind(mark);
+            log_error("Not enough memory to allocate temporary buffer\n");
+            return STATUS_NO_MEM;
+        }
+
+        float *src[L::OUT], *mix[L::OUT], *wet[L::OUT + 1], *dst[L::OUT];
+        for (size_t i=0; i<L::OUT; ++i)
+        {
+            src[i]              = &buf[i * PIPELINE_BLOCK_SIZE];
+            mix[i]              = &buf[(L::OUT + i) * PIPELINE_BLOCK_SIZE];
+            wet[i]              = &buf[(L::OUT * 2 + i) * PIPELINE_BLOCK_SIZE];
+        }
+        wet[L::OUT]         = NULL;
+
+        input_t in          = *input;
+        in.buf              = &buf[L::OUT * 3 * PIPELINE_BLOCK_SIZE];
+
+        // Compensate the latency of convolvers
+        size_t latency      = conv[0].latency();
+        for (size_t pos=0; pos < latency; )
+        {
+            size_t count        = lsp_min(latency - pos, size_t(PIPELINE_BLOCK_SIZE));
+            load_sources<L>(src, &in, pos, count);
+            for (size_t i=0; i<pairs; ++i)
+                conv[i].process(NULL, NULL, src[i * 2], (i * 2 + 1 < L::OUT) ? src[i * 2 + 1] : NULL, count);
+            pos                += count;
+        }
+
+        // Render the output by blocks
+        size_t out_length   = out->length();
+        size_t wet_length   = in_length + ir_length;
+        size_t wet_pos      = 0;
+        size_t quiet        = 0;
+        bool wet_done       = false;
+
+        for (size_t pos = 0; pos < out_length; )
+        {
+            size_t count        = lsp_min(out_length - pos, size_t(PIPELINE_BLOCK_SIZE));
+
+            // The dry signal
+            load_sources<L>(mix, &in, ssize_t(pos) - ssize_t(p->latency), count);
+            for (size_t i=0; i<L::OUT; ++i)
+                dsp::mul_k2(mix[i], p->dry, count);
+
+            // The wet signal
+            if ((!wet_done) && (pos + count > p->predelay))
+            {
+                size_t off          = (pos < p->predelay) ? p->predelay - pos : 0;
+                size_t to_do        = lsp_min(count - off, wet_length - wet_pos);
+                bool tail           = wet_pos >= in_length;
+
+                load_sources<L>(src, &in, wet_pos + latency, to_do);
+                for (size_t i=0; i<pairs; ++i)
+                    conv[i].process(wet[i * 2], wet[i * 2 + 1], src[i * 2], (i * 2 + 1 < L::OUT) ? src[i * 2 + 1] : NULL, to_do);
+                for (size_t i=0; i<L::OUT; ++i)
+                    dsp::add2(&mix[i][off], wet[i], to_do);
+                wet_pos            += to_do;
+
+                // Stop computing the tail when it stays below threshold for the whole window
+                if ((tail) && (p->threshold > 0.0f))
+                {
+                    float peak          = 0.0f;
+                    for (size_t i=0; i<L::OUT; ++i)
+                        peak                = lsp_max(peak, dsp::abs_max(wet[i], to_do));
+                    quiet               = (peak < p->threshold) ? quiet + to_do : 0;
+                    wet_done            = quiet >= p->window;
+                }
+                if (wet_pos >= wet_length)
+                    wet_done            = true;
+            }
+
+            // Apply the mid/side balance and store the result
+            for (size_t i=0; i<L::OUT; ++i)
+                dst[i]              = &out->channel(i)[pos];
+            mix_output<L::OUT>(dst, mix, p->mid, p->side, count);
+
+            pos                += count;
+            log_progress(float(pos) / float(out_length));
+        }
+
+        arena->rewind(mark);
+        *wet_end            = p->predelay + wet_pos;
+
+        return STATUS_OK;
+    }
+
+    bool layout_supported(layout_t layout, size_t channels)
+    {
+        switch (layout)
+        {
+            case LAYOUT_1X1:
+            case LAYOUT_2X2:
+            case LAYOUT_2X4:
+                return true;
+            case LAYOUT_1XN:
+            case LAYOUT_NX1:
+                return (channels >= 2) && (channels <= PIPELINE_MAX_CHANNELS);
+            default:
+                break;
+        }
+        return false;
+    }
+
+    size_t layout_footprint(size_t out_channels, size_t in_channels, size_t ir_length)
+    {
+        // Each convolver processes two output channels
+        size_t pairs    = (out_channels + 1) / 2;
+        return pairs * PairConvolver::footprint(ir_length, CONV_RANK) +
+            (ir_length * 2 + (out_channels * 3 + in_channels) * PIPELINE_BLOCK_SIZE) * sizeof(float) + DEFAULT_ALIGN * 2;
+    }
+
+    template <template <size_t N> class L>
+    static status_t render_n(
+        size_t channels, size_t *wet_end, dspu::Sample *out, const input_t *in, const dspu::Sample *ir,
+        const render_t *p)
+    {
+        switch (channels)
+        {
+            case 2: return render< L<2> >(wet_end, out, in, ir, p);
+            case 3: return render< L<3> >(wet_end, out, in, ir, p);
+            case 4: return render< L<4> >(wet_end, out, in, ir, p);
+            case 5: return render< L<5> >(wet_end, out, in, ir, p);
+            case 6: return render< L<6> >(wet_end, out, in, ir, p);
+            case 7: return render< L<7> >(wet_end, out, in, ir, p);
+            case 8: return render< L<8> >(wet_end, out, in, ir, p);
+            default: break;
+        }
+
+        log_error("Unsupported number of channels for the processing pipeline: %d\n", int(channels));
+        return STATUS_BAD_ARGUMENTS;
+    }
+
+    static status_t render_input(
+        size_t *wet_end, dspu::Sample *out, const input_t *in, const dspu::Sample *ir,
+        layout_t layout, const render_t *params)
+    {
+        // Output information
+        if (out->channels() == 1)
+            log_info("  mono output has no side part, adjusting only mono part\n");
+        else if (out->channels() == 2)
+            log_info("  adjusting Mid/Side balance for stereo output signal\n");
+        else
+            log_info("  unsupported mid/side balancing for %d output channels, skipping\n", int(out->channels()));
+
+        switch (layout)
+        {
+            case LAYOUT_1X1:
+                return render< layout_1xn<1> >(wet_end, out, in, ir, params);
+            case LAYOUT_1XN:
+                return render_n<layout_1xn>(ir->channels(), wet_end, out, in, ir, params);
+            case LAYOUT_NX1:
+                return render_n<layout_nx1>(in->channels, wet_end, out, in, ir, params);
+            case LAYOUT_2X2:
+                return render<layout_2x2>(wet_end, out, in, ir, params);
+            case LAYOUT_2X4:
+                return render<layout_2x4>(wet_end, out, in, ir, params);
+            default:
+                break;
+        }
+
+        log_error("Unsupported channel layout for the processing pipeline\n");
+        return STATUS_BAD_ARGUMENTS;
+    }
+
+    status_t render_layout(
+        size_t *wet_end, dspu::Sample *out, const dspu::Sample *in, const dspu::Sample *ir,
+        layout_t layout, const render_t *params)
+    {
+        input_t input;
+        input.sample        = in;
+        input.compact       = NULL;
+        input.buf           = NULL;
+        input.channels      = in->channels();
+        input.length        = in->length();
+
+        return render_input(wet_end, out, &input, ir, layout, params);
+    }
+
+    status_t render_layout(
+        size_t *wet_end, dspu::Sample *out, const CompactSample *in, const dspu::Sample *ir,
+        layout_t layout, const render_t *params)
+    {
+        input_t input;
+        input.sample        = NULL;
+        input.compact       = in;
+        input.buf           = NULL;
+        input.channels      = in->channels();
+        input.length        = in->length();
+
+        return render_input(wet_end, out, &input, ir, layout, params);
+    }
+}
@@ -0,0 +1,243 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of far-screamer
+ * Created on: 18 окт. 2026 г.
+ *
+ * far-screamer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * far-screamer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with far-screamer. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <lsp-plug.in/common/alloc.h>
+#include <lsp-plug.in/stdlib/stdio.h>
+
+#include <far-screamer/config.h>
+#include <private/planner.h>
+#include <private/pipeline.h>
+#include <private/PairConvolver.h>
+#include <private/log.h>
+#include <private/util.h>
+
+#ifdef PLATFORM_UNIX_COMPATIBLE
+    #include <pthread.h>
+#endif /* PLATFORM_UNIX_COMPATIBLE */
+
+#define PLAN_MIN_BLOCK          0x1000      // Minimum block size for streaming convolution
+#define PLAN_MAX_BLOCK          0x100000    // Maximum block size for streaming convolution
+#define PLAN_FILTER_MARGIN      0x10000     // Margin for decimation filters and their latency
+#define PLAN_MAX_CANDIDATES     16
+
+namespace far_screamer
+{
+#ifdef PLATFORM_UNIX_COMPATIBLE
+    static pthread_mutex_t  budget_lock     = PTHREAD_MUTEX_INITIALIZER;
+    static pthread_cond_t   budget_cond     = PTHREAD_COND_INITIALIZER;
+#endif /* PLATFORM_UNIX_COMPATIBLE */
+    static wsize_t          budget_used     = 0;
+
+    static inline wsize_t sample_bytes(size_t channels, size_t length)
+    {
+        return wsize_t(channels) * length * sizeof(float);
+    }
+
+    static inline size_t buffer_length(size_t length, size_t block)
+    {
+        return ((block > 0) && (block < length)) ? lsp_max(block, size_t(PLAN_MIN_BLOCK)) : length;
+    }
+
+    static wsize_t direct_footprint(size_t in_length, size_t ir_length, size_t block, bool sparse)
+    {
+        // Single channel convolution, the convolver is assumed to have the same layout of partitions
+        // as the pair convolver
+        size_t length   = in_length + ir_length;
+        wsize_t conv    = PairConvolver::footprint(ir_length, CONV_RANK);
+        wsize_t single  = conv + sample_bytes(1, buffer_length(length, block));
+        if (sparse)
+            return single;
+
+        // Pair convolution, mixed impulse responses and buffers for both channels with latency
+        size_t latency  = size_t(1) << (CONV_RANK - 1);
+        wsize_t pair    = conv + sample_bytes(2, ir_length) + sample_bytes(2, buffer_length(length + latency, block));
+
+        return lsp_max(single, pair);
+    }
+
+    static wsize_t decimated_footprint(
+        const workload_t *w, size_t in_length, size_t ir_length,
+        size_t factor, size_t block, bool sparse)
+    {
+        // Decimated input, impulse response and output are kept until interpolation is complete
+        size_t d_in     = (in_length + factor - 1) / factor;
+        size_t d_ir     = (ir_length + factor - 1) / factor;
+        wsize_t data    =
+            sample_bytes(w->in_channels, d_in) +
+            sample_bytes(w->ir_channels, d_ir) +
+            sample_bytes(w->out_channels, d_in + d_ir);
+
+        wsize_t filter  = sample_bytes(1, in_length + PLAN_FILTER_MARGIN);
+        wsize_t conv    = direct_footprint(d_in, d_ir, block / factor, sparse);
+        wsize_t interp  = sample_bytes(1, (d_in + d_ir) * factor + PLAN_FILTER_MARGIN);
+
+        return data + lsp_max(filter, lsp_max(conv, interp));
+    }
+
+    static wsize_t wet_footprint(const workload_t *w, size_t block)
+    {
+        if (w->factor > 1)
+            return decimated_footprint(w, w->in_length, w->ir_length, w->factor, block, w->sparse);
+
+        if (w->split > 0)
+        {
+            // Early and late parts of the impulse response are processed sequentially
+            size_t split    = lsp_min(size_t(w->split), w->ir_length);
+            wsize_t parts   = sample_bytes(w->ir_channels, w->ir_length + PLAN_FILTER_MARGIN);
+            wsize_t early   = direct_footprint(w->in_length, split, block, w->sparse);
+            wsize_t late    = decimated_footprint(w, w->in_length, w->ir_length - split, w->mr_factor, block, false);
+            return parts + lsp_max(early, late);
+        }
+
+        return direct_footprint(w->in_length, w->ir_length, block, w->sparse);
+    }
+
+    static wsize_t estimate_footprint(const workload_t *w, const plan_t *plan)
+    {
+        bool compact    = w->in_sample != sizeof(float);
+        wsize_t base    =
+            wsize_t(w->in_channels) * w->in_length * w->in_sample +
+            sample_bytes(w->ir_channels, w->ir_length) +
+            sample_bytes(w->out_channels, w->out_length);
+
+        if (plan->strategy == STRATEGY_PIPELINE)
+            return base + layout_footprint(w->out_channels, (compact) ? w->in_channels : 0, w->ir_length);
+
+        // Other strategies process the compact input decoded to the floating-point sample
+        if (compact)
+            base           += sample_bytes(w->in_channels, w->in_length);
+
+        // Wet stems are rendered to the separate sample and then mixed to the output
+        wsize_t wet     = wet_footprint(w, plan->block);
+        if (plan->stems)
+            wet            += sample_bytes(w->mappings, w->in_length + w->ir_length);
+
+        return base + wet;
+    }
+
+    static void set_plan(plan_t *plan, strategy_t strategy, size_t block, bool stems)
+    {
+        plan->strategy      = strategy;
+        plan->block         = block;
+        plan->stems         = stems;
+        plan->fits          = true;
+        plan->footprint     = 0;
+        plan->reserved      = 0;
+    }
+
+    void init_plan(plan_t *plan)
+    {
+        set_plan(plan, STRATEGY_IN_MEMORY, 0, false);
+    }
+
+    void make_plan(plan_t *plan, const workload_t *w, wsize_t budget)
+    {
+        plan_t list[PLAN_MAX_CANDIDATES];
+        size_t count = 0;
+
+        // Form the list of candidates starting with the fastest one
+        if (w->stems)
+            set_plan(&list[count++], STRATEGY_IN_MEMORY, 0, true);
+        set_plan(&list[count++], (w->pipeline) ? STRATEGY_PIPELINE : STRATEGY_IN_MEMORY, 0, false);
+        for (size_t block = PLAN_MAX_BLOCK; block >= PLAN_MIN_BLOCK; block >>= 2)
+            set_plan(&list[count++], STRATEGY_STREAMING, block, false);
+
+        // Select the first candidate that fits, or the candidate with the lowest footprint
+        ssize_t lowest = -1;
+        for (size_t i=0; i<count; ++i)
+        {
+            plan_t *c       = &list[i];
+            c->footprint    = estimate_footprint(w, c);
+            c->fits         = (budget <= 0) || (c->footprint <= budget);
+            if (c->fits)
+            {
+                *plan           = *c;
+                return;
+            }
+
+            if ((lowest < 0) || (c->footprint < list[lowest].footprint))
+                lowest          = i;
+        }
+
+        *plan = list[lowest];
+    }
+
+    void print_plan(const plan_t *plan, wsize_t budget)
+    {
+        char strategy[80];
+        switch (plan->strategy)
+        {
+            case STRATEGY_PIPELINE:
+                snprintf(strategy, sizeof(strategy), "specialized pipeline");
+                break;
+            case STRATEGY_STREAMING:
+                snprintf(strategy, sizeof(strategy), "streaming convolution by blocks of %d samples", int(plan->block));
+                break;
+            default:
+                snprintf(strategy, sizeof(strategy), "in-memory convolution%s", (plan->stems) ? " with wet stem cache" : "");
+                break;
+        }
+        log_info("  memory plan: %s, estimated footprint %.1f MiB of %.1f MiB budget\n",
+            strategy, mib(plan->footprint), mib(budget));
+
+        if (!plan->fits)
+            log_error("  estimated memory footprint exceeds the budget, using the plan with the lowest footprint\n");
+    }
+
+    void reserve_memory(plan_t *plan, wsize_t budget)
+    {
+        if (budget <= 0)
+            return;
+
+#ifdef PLATFORM_UNIX_COMPATIBLE
+        pthread_mutex_lock(&budget_lock);
+        if ((budget_used > 0) && (budget_used + plan->footprint > budget))
+        {
+            log_info("  waiting for %.1f MiB of memory budget\n", mib(plan->footprint));
+            while ((budget_used > 0) && (budget_used + plan->footprint > budget))
+                pthread_cond_wait(&budget_cond, &budget_lock);
+        }
+        budget_used        += plan->footprint;
+        plan->reserved      = plan->footprint;
+        pthread_mutex_unlock(&budget_lock);
+#else
+        budget_used        += plan->footprint;
+        plan->reserved      = plan->footprint;
+#endif /* PLATFORM_UNIX_COMPATIBLE */
+    }
+
+    void release_memory(plan_t *plan)
+    {
+        if (plan->reserved <= 0)
+            return;
+
+#ifdef PLATFORM_UNIX_COMPATIBLE
+        pthread_mutex_lock(&budget_lock);
+        budget_used        -= plan->reserved;
+        plan->reserved      = 0;
+        pthread_cond_broadcast(&budget_cond);
+        pthread_mutex_unlock(&budget_lock);
+#else
+        budget_used        -= plan->reserved;
+        plan->reserved      = 0;
+#endif /* PLATFORM_UNIX_COMPATIBLE */
+    }
+}
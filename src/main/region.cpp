@@ -0,0 +1,159 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of far-screamer
+ * Created on: 18 окт. 2026 г.
+ *
+ * far-screamer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * far-screamer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with far-screamer. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <lsp-plug.in/common/types.h>
+#include <lsp-plug.in/dsp-units/units.h>
+#include <lsp-plug.in/stdlib/stdio.h>
+
+#include <private/region.h>
+#include <private/checkpoint.h>
+#include <private/decimation.h>
+#include <private/draft.h>
+#include <private/log.h>
+
+#define REGION_ALIGN            0x10000     /* Alignment of the decoded input, covers the largest block of convolvers */
+
+namespace far_screamer
+{
+    static inline size_t time_to_samples(double time, size_t srate)
+    {
+        return size_t(time * srate + 0.5);
+    }
+
+    bool region_enabled(const config_t *cfg)
+    {
+        return (cfg->fStart > 0.0) || (cfg->fEnd >= 0.0) || (cfg->nShards > 0);
+    }
+
+    status_t region_sample_rate(config_t *cfg)
+    {
+        if (cfg->nSampleRate > 0)
+            return STATUS_OK;
+
+        audio_info_t info;
+        status_t res = read_audio_info(&info, &cfg->sInFile);
+        if (res != STATUS_OK)
+            return res;
+        cfg->nSampleRate    = info.sample_rate;
+
+        return STATUS_OK;
+    }
+
+    status_t init_region(region_t *region, const config_t *cfg, size_t ir_length, size_t latency, bool verbose)
+    {
+        status_t res;
+        audio_info_t info;
+
+        if ((cfg->nNormalize != NORM_NONE) && (cfg->nShards > 0))
+        {
+            log_error("Normalization can not be applied to the shard, it is applied when shards are merged\n");
+            return STATUS_BAD_ARGUMENTS;
+        }
+        if (cfg->nNormalize != NORM_NONE)
+        {
+            log_error("Normalization can not be applied to the region, the peak of the whole output is unknown\n");
+            return STATUS_BAD_ARGUMENTS;
+        }
+        if ((res = read_audio_info(&info, &cfg->sInFile)) != STATUS_OK)
+            return res;
+
+        // Estimate the length of the whole output
+        size_t srate        = cfg->nSampleRate;
+        size_t in_length    = (wsize_t(info.length) * srate + info.sample_rate - 1) / info.sample_rate;
+        size_t predelay     = dspu::millis_to_samples(srate, cfg->fPreDelay);
+        size_t out_length   = in_length + ir_length + latency + predelay;
+        size_t start        = time_to_samples(cfg->fStart, srate);
+        size_t end          = (cfg->fEnd >= 0.0) ? time_to_samples(cfg->fEnd, srate) : out_length;
+        bool bounded        = cfg->fEnd >= 0.0;
+        if (cfg->nShards > 0)
+        {
+            // Shards split the timeline of the input which is never longer than the
+            // output, the last shard also contains the tail of the output
+            start               = (wsize_t(in_length) * cfg->nShard) / cfg->nShards;
+            bounded             = (cfg->nShard + 1) < cfg->nShards;
+            end                 = (bounded) ? (wsize_t(in_length) * (cfg->nShard + 1)) / cfg->nShards : out_length;
+        }
+        if (start >= out_length)
+        {
+            log_error("The region starts after the end of the output\n");
+            return STATUS_BAD_ARGUMENTS;
+        }
+        if (end <= start)
+        {
+            log_error("The region is shorter than one sample\n");
+            return STATUS_BAD_ARGUMENTS;
+        }
+
+        // The decimated wet signal is processed by blocks of the decimated signal
+        size_t factor       = (cfg->bDecimate) ? decimation_factor(srate, &cfg->sLPF) : 1;
+        if (cfg->fMultirateSplit >= 0.0f)
+            factor              = lsp_max(factor, size_t(cfg->nMultirateFactor));
+        factor              = lsp_max(factor, draft_factor(cfg, srate));
+
+        // The pre-roll covers the impulse response, both ends of the decoded input are aligned
+        // to blocks of convolvers and do not affect blocks which contain samples of the region
+        size_t align        = REGION_ALIGN * factor;
+        size_t segment      = checkpoint_segment(cfg, srate);
+        if (segment > 0)    // Segments of the checkpointed render start at the same samples
+            align               = ((segment % align) == 0) ? segment : segment * factor;
+        size_t preroll      = ir_length + latency + predelay + align;
+        size_t offset       = (start > preroll) ? ((start - preroll) / align) * align : 0;
+        size_t last         = ((end + align - 1) / align + 1) * align;
+
+        region->in_length       = in_length;
+        region->input.offset    = offset;
+        region->input.length    = (bounded) ? ssize_t(last - offset) : -1;
+        region->head            = start - offset;
+        region->length          = (bounded) ? ssize_t(end - start) : -1;
+
+        if (!verbose)
+            return STATUS_OK;
+        if (cfg->nShards > 0)
+            log_info("  rendering shard %d of %d shards\n", int(cfg->nShard), int(cfg->nShards));
+        if (region->length >= 0)
+            log_info("  rendering region of samples %d .. %d, decoding the input from sample %d\n",
+                int(start), int(end), int(offset));
+        else
+            log_info("  rendering region of samples %d .. end, decoding the input from sample %d\n",
+                int(start), int(offset));
+
+        return STATUS_OK;
+    }
+
+    void whole_workload(workload_t *dst, const workload_t *w, const region_t *region)
+    {
+        *dst                = *w;
+        dst->in_length      = region->in_length;
+        dst->out_length     = w->out_length - w->in_length + region->in_length;
+    }
+
+    status_t crop_region(dspu::Sample *out, const region_t *region)
+    {
+        if (region->head >= out->length())
+        {
+            log_error("The region starts after the end of the output\n");
+            return STATUS_UNDERFLOW;
+        }
+
+        crop_sample(out, region->head, (region->length >= 0) ? size_t(region->length) : out->length());
+        return STATUS_OK;
+    }
+}
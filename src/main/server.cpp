@@ -0,0 +1,547 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of far-screamer
+ * Created on: 18 окт. 2026 г.
+ *
+ * far-screamer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * far-screamer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with far-screamer. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <lsp-plug.in/common/types.h>
+#include <lsp-plug.in/common/status.h>
+#include <lsp-plug.in/dsp/dsp.h>
+#include <lsp-plug.in/lltl/darray.h>
+#include <lsp-plug.in/lltl/parray.h>
+#include <lsp-plug.in/stdlib/stdio.h>
+#include <lsp-plug.in/stdlib/string.h>
+
+#include <private/server.h>
+#include <private/cmdline.h>
+#include <private/tool.h>
+#include <private/IRPool.h>
+#include <private/Arena.h>
+#include <private/WorkerPool.h>
+#include <private/log.h>
+#include <private/util.h>
+
+#ifdef PLATFORM_UNIX_COMPATIBLE
+    #include <errno.h>
+    #include <poll.h>
+    #include <pthread.h>
+    #include <stdlib.h>
+    #include <unistd.h>
+    #include <sys/socket.h>
+    #include <sys/stat.h>
+    #include <sys/un.h>
+#endif /* PLATFORM_UNIX_COMPATIBLE */
+
+#define SERVER_IR_POOL_SIZE     16
+#define SERVER_IR_POOL_SHARE    4           /* Unused prepared IRs are limited by the quarter of the memory budget */
+#define SERVER_BACKLOG          16
+#define SERVER_SOCKET_MODE      0600        /* Only the owner of the daemon may submit jobs */
+#define SERVER_READ_SIZE        0x1000
+#define SERVER_MAX_LINE         0x10000
+#define SERVER_POLL_TIMEOUT     500
+
+namespace far_screamer
+{
+#ifdef PLATFORM_UNIX_COMPATIBLE
+    typedef struct client_t
+    {
+        int                 fd;         // Socket of the connection
+        size_t              nRefs;      // Number of references: the connection itself and pending jobs
+        pthread_mutex_t     sWrite;     // Mutex for writing responses
+        char               *pBuf;       // Buffer of the incoming data
+        size_t              nLen;       // Number of bytes in buffer
+        size_t              nCap;       // Capacity of the buffer
+    } client_t;
+
+    typedef struct job_t
+    {
+        client_t           *pClient;    // Client that submitted the job
+        size_t              nId;        // Identifier of the job
+        char               *sLine;      // Command line of the job
+    } job_t;
+
+    typedef struct server_t
+    {
+        pthread_mutex_t     sMutex;     // Mutex for references to clients
+        size_t              nJobs;      // Number of submitted jobs
+        WorkerPool         *pWorkers;   // Pool of worker threads
+        IRPool             *pPool;      // Pool of prepared impulse responses
+        int                 nArgc;      // Number of command line arguments of the daemon
+        const char        **vArgv;      // Command line arguments of the daemon
+    } server_t;
+
+    static inline bool is_blank(char c)
+    {
+        return (c == ' ') || (c == '\t');
+    }
+
+    /**
+     * Split the line into arguments in place. Arguments are separated by blanks,
+     * double quotes group blanks into one argument, backslash escapes the next character
+     */
+    static status_t split_args(lltl::parray<char> *args, char *line)
+    {
+        char *r = line, *w = line;
+
+        while (true)
+        {
+            while (is_blank(*r))
+                ++r;
+            if (*r == '\0')
+                return STATUS_OK;
+
+            char *arg = w;
+            bool quoted = false;
+            while ((*r != '\0') && ((quoted) || (!is_blank(*r))))
+            {
+                if (*r == '"')
+                    quoted  = !quoted;
+                else if ((*r == '\\') && (r[1] != '\0'))
+                    *(w++)  = *(++r);
+                else
+                    *(w++)  = *r;
+                ++r;
+            }
+            if (quoted)
+                return STATUS_BAD_FORMAT;
+
+            if (*r != '\0')
+                ++r;
+            *(w++)  = '\0';
+
+            if (!args->add(arg))
+                return STATUS_NO_MEM;
+        }
+    }
+
+    static status_t execute_job(server_t *srv, char *line, double *ir_time, bool *cached, bool *skipped)
+    {
+        status_t res;
+        lltl::parray<char> args;
+
+        if (!args.add(const_cast<char *>(srv->vArgv[0])))
+            return STATUS_NO_MEM;
+        if ((res = split_args(&args, line)) != STATUS_OK)
+        {
+            log_error("Could not parse job arguments\n");
+            return res;
+        }
+
+        // Apply arguments of the daemon first, then override them by the job
+        config_t cfg;
+        if ((res = parse_cmdline(&cfg, srv->nArgc, srv->vArgv)) != STATUS_OK)
+            return res;
+        size_t mappings = cfg.sMapping.size();
+        if ((res = parse_cmdline(&cfg, args.size(), const_cast<const char **>(args.array()))) != STATUS_OK)
+            return res;
+        if (cfg.sMapping.size() > mappings)
+            cfg.sMapping.remove_n(0, mappings); // Mapping of the job replaces the mapping of the daemon
+        if ((res = check_mandatory(&cfg)) != STATUS_OK)
+            return res;
+        if (cfg.nPlan != PLAN_NONE)
+        {
+            log_error("Planning of jobs is not supported in daemon mode\n");
+            return STATUS_BAD_ARGUMENTS;
+        }
+
+        return render_job(&cfg, srv->pPool, ir_time, cached, skipped);
+    }
+
+    static void send_response(client_t *c, const char *buf, size_t len)
+    {
+        pthread_mutex_lock(&c->sWrite);
+        while (len > 0)
+        {
+            ssize_t n = send(c->fd, buf, len, MSG_NOSIGNAL);
+            if (n < 0)
+            {
+                if (errno == EINTR)
+                    continue;
+                break;
+            }
+            buf    += n;
+            len    -= n;
+        }
+        pthread_mutex_unlock(&c->sWrite);
+    }
+
+    static void release_client(client_t *c)
+    {
+        if ((--c->nRefs) > 0)
+            return;
+
+        close(c->fd);
+        pthread_mutex_destroy(&c->sWrite);
+        free(c->pBuf);
+        delete c;
+    }
+
+    static void run_job(server_t *srv, job_t *job)
+    {
+        char buf[256];
+        bool cached = false, skipped = false;
+        double ir_time = 0.0;
+        double start = time_ms();
+
+        // Temporary buffers of the previous job are released
+        Arena *arena = thread_arena();
+        arena->reset();
+
+        log_info("Job #%d: %s\n", int(job->nId), job->sLine);
+        status_t res = execute_job(srv, job->sLine, &ir_time, &cached, &skipped);
+        double time = time_ms() - start;
+        double mem = mib(arena->peak());
+
+        int len;
+        if (res != STATUS_OK)
+        {
+            log_info("Job #%d failed with code %d in %.3f ms\n", int(job->nId), int(res), time);
+            len = snprintf(buf, sizeof(buf), "ERROR id=%d code=%d time=%.3f\n",
+                int(job->nId), int(res), time);
+        }
+        else if (skipped)
+        {
+            log_info("Job #%d skipped in %.3f ms, output is up to date\n", int(job->nId), time);
+            len = snprintf(buf, sizeof(buf), "SKIP id=%d time=%.3f\n",
+                int(job->nId), time);
+        }
+        else if (cached)
+        {
+            log_info("Job #%d completed in %.3f ms, IR taken from pool, peak scratch memory %.1f MiB\n", int(job->nId), time, mem);
+            len = snprintf(buf, sizeof(buf), "OK id=%d time=%.3f ir=pool mem=%.1f\n",
+                int(job->nId), time, mem);
+        }
+        else
+        {
+            log_info("Job #%d completed in %.3f ms, IR prepared in %.3f ms, peak scratch memory %.1f MiB\n", int(job->nId), time, ir_time, mem);
+            len = snprintf(buf, sizeof(buf), "OK id=%d time=%.3f ir=%.3f mem=%.1f\n",
+                int(job->nId), time, ir_time, mem);
+        }
+        fflush(stdout);
+
+        send_response(job->pClient, buf, lsp_min(size_t(len), sizeof(buf) - 1));
+    }
+
+    static void process_job(void *task, void *arg)
+    {
+        server_t *srv   = static_cast<server_t *>(arg);
+        job_t *job      = static_cast<job_t *>(task);
+
+        run_job(srv, job);
+
+        pthread_mutex_lock(&srv->sMutex);
+        release_client(job->pClient);
+        pthread_mutex_unlock(&srv->sMutex);
+
+        free(job->sLine);
+        delete job;
+    }
+
+    static void submit_job(server_t *srv, client_t *c, const char *line, size_t len)
+    {
+        // Strip carriage return and skip blank lines
+        if ((len > 0) && (line[len-1] == '\r'))
+            --len;
+        size_t blanks = 0;
+        while ((blanks < len) && (is_blank(line[blanks])))
+            ++blanks;
+        if (blanks >= len)
+            return;
+
+        job_t *job      = new job_t;
+        char *text      = static_cast<char *>(malloc(len + 1));
+        if ((job == NULL) || (text == NULL))
+        {
+            log_error("Not enough memory to submit the job\n");
+            delete job;
+            free(text);
+            return;
+        }
+
+        memcpy(text, line, len);
+        text[len]       = '\0';
+        job->pClient    = c;
+        job->sLine      = text;
+        job->nId        = ++srv->nJobs;
+
+        pthread_mutex_lock(&srv->sMutex);
+        ++c->nRefs;
+        pthread_mutex_unlock(&srv->sMutex);
+
+        if (!srv->pWorkers->submit(job))
+        {
+            log_error("Not enough memory to submit the job\n");
+            pthread_mutex_lock(&srv->sMutex);
+            release_client(c);
+            pthread_mutex_unlock(&srv->sMutex);
+            free(text);
+            delete job;
+        }
+    }
+
+    /**
+     * Read data from the client and submit all complete lines as jobs
+     * @return false if the connection should be closed
+     */
+    static bool read_client(server_t *srv, client_t *c)
+    {
+        // Ensure that there is enough space in buffer
+        if ((c->nCap - c->nLen) < SERVER_READ_SIZE)
+        {
+            size_t cap      = c->nCap + SERVER_READ_SIZE;
+            char *buf       = static_cast<char *>(realloc(c->pBuf, cap));
+            if (buf == NULL)
+                return false;
+            c->pBuf         = buf;
+            c->nCap         = cap;
+        }
+
+        ssize_t n = recv(c->fd, &c->pBuf[c->nLen], c->nCap - c->nLen, 0);
+        if (n < 0)
+            return (errno == EINTR) || (errno == EAGAIN);
+        bool eof        = (n == 0);
+        c->nLen        += n;
+
+        // Submit complete lines, the last incomplete line is submitted at end of stream
+        size_t off = 0;
+        for (size_t i=0; i<c->nLen; ++i)
+        {
+            if (c->pBuf[i] != '\n')
+                continue;
+            submit_job(srv, c, &c->pBuf[off], i - off);
+            off     = i + 1;
+        }
+        if ((eof) && (off < c->nLen))
+        {
+            submit_job(srv, c, &c->pBuf[off], c->nLen - off);
+            off     = c->nLen;
+        }
+
+        c->nLen    -= off;
+        if (c->nLen > 0)
+            memmove(c->pBuf, &c->pBuf[off], c->nLen);
+
+        // Protect from the garbage
+        if (c->nLen >= SERVER_MAX_LINE)
+        {
+            char buf[64];
+            int len = snprintf(buf, sizeof(buf), "ERROR id=0 code=%d time=0.000\n", int(STATUS_OVERFLOW));
+            send_response(c, buf, len);
+            return false;
+        }
+
+        return !eof;
+    }
+
+    static status_t open_socket(int *sock, const char *path)
+    {
+        struct sockaddr_un addr;
+        struct stat st;
+
+        if (strlen(path) >= sizeof(addr.sun_path))
+        {
+            log_error("Too long socket path: %s\n", path);
+            return STATUS_BAD_ARGUMENTS;
+        }
+
+        // Remove stale socket left by the previous instance
+        if ((stat(path, &st) == 0) && (S_ISSOCK(st.st_mode)))
+            unlink(path);
+
+        int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd < 0)
+        {
+            log_error("Could not create socket: %s\n", strerror(errno));
+            return STATUS_IO_ERROR;
+        }
+
+        memset(&addr, 0, sizeof(addr));
+        addr.sun_family = AF_UNIX;
+        strcpy(addr.sun_path, path);
+
+        if (bind(fd, reinterpret_cast<struct sockaddr *>(&addr), sizeof(addr)) < 0)
+        {
+            log_error("Could not bind socket %s: %s\n", path, strerror(errno));
+            close(fd);
+            return STATUS_IO_ERROR;
+        }
+        // Jobs read and write arbitrary files on behalf of the daemon, connections are
+        // not accepted before listen(), so there is no window with wider permissions
+        if (chmod(path, SERVER_SOCKET_MODE) < 0)
+        {
+            log_error("Could not change permissions of socket %s: %s\n", path, strerror(errno));
+            close(fd);
+            unlink(path);
+            return STATUS_IO_ERROR;
+        }
+        if (listen(fd, SERVER_BACKLOG) < 0)
+        {
+            log_error("Could not listen socket %s: %s\n", path, strerror(errno));
+            close(fd);
+            unlink(path);
+            return STATUS_IO_ERROR;
+        }
+
+        *sock   = fd;
+        return STATUS_OK;
+    }
+
+    static status_t accept_client(lltl::parray<client_t> *clients, int sock)
+    {
+        int fd = accept(sock, NULL, NULL);
+        if (fd < 0)
+            return ((errno == EINTR) || (errno == EAGAIN) || (errno == ECONNABORTED)) ? STATUS_OK : STATUS_IO_ERROR;
+
+        client_t *c     = new client_t;
+        if ((c == NULL) || (!clients->add(c)))
+        {
+            delete c;
+            close(fd);
+            return STATUS_NO_MEM;
+        }
+
+        c->fd           = fd;
+        c->nRefs        = 1;
+        c->pBuf         = NULL;
+        c->nLen         = 0;
+        c->nCap         = 0;
+        pthread_mutex_init(&c->sWrite, NULL);
+
+        return STATUS_OK;
+    }
+
+    static status_t serve_loop(server_t *srv, int sock)
+    {
+        status_t res = STATUS_OK;
+        lltl::parray<client_t> clients;
+        lltl::darray<struct pollfd> fds;
+
+        while ((res == STATUS_OK) && (!stop_requested()))
+        {
+            // Prepare the list of descriptors to poll
+            fds.clear();
+            struct pollfd *pfd = fds.add_n(clients.size() + 1);
+            if (pfd == NULL)
+            {
+                res     = STATUS_NO_MEM;
+                break;
+            }
+            pfd->fd         = sock;
+            pfd->events     = POLLIN;
+            pfd->revents    = 0;
+            for (size_t i=0, n=clients.size(); i<n; ++i)
+            {
+                ++pfd;
+                pfd->fd         = clients.uget(i)->fd;
+                pfd->events     = POLLIN;
+                pfd->revents    = 0;
+            }
+
+            if (poll(fds.array(), fds.size(), SERVER_POLL_TIMEOUT) < 0)
+            {
+                if (errno != EINTR)
+                    res     = STATUS_IO_ERROR;
+                continue;
+            }
+
+            // Read data from clients, iterate backwards to safely remove closed connections
+            for (size_t i=fds.size()-1; i > 0; --i)
+            {
+                if (!(fds.uget(i)->revents & (POLLIN | POLLHUP | POLLERR)))
+                    continue;
+
+                client_t *c = clients.uget(i - 1);
+                if (read_client(srv, c))
+                    continue;
+
+                clients.remove(i - 1);
+                pthread_mutex_lock(&srv->sMutex);
+                release_client(c);
+                pthread_mutex_unlock(&srv->sMutex);
+            }
+
+            // Accept new connections
+            if (fds.uget(0)->revents & POLLIN)
+                res     = accept_client(&clients, sock);
+        }
+
+        // Drop all connections, the pending jobs hold their own references
+        pthread_mutex_lock(&srv->sMutex);
+        for (size_t i=0, n=clients.size(); i<n; ++i)
+            release_client(clients.uget(i));
+        pthread_mutex_unlock(&srv->sMutex);
+        clients.flush();
+
+        return res;
+    }
+
+    status_t serve(const config_t *cfg, int argc, const char **argv)
+    {
+        status_t res;
+        int sock = -1;
+        const char *path = cfg->sServe.get_native();
+
+        if (cfg->nWorkers < 0)
+        {
+            log_error("Invalid number of workers: %d\n", int(cfg->nWorkers));
+            return STATUS_BAD_ARGUMENTS;
+        }
+
+        if ((res = open_socket(&sock, path)) != STATUS_OK)
+            return res;
+        install_stop_handlers();
+
+        // Initialize server
+        IRPool pool(SERVER_IR_POOL_SIZE, cfg->nMaxMemory / SERVER_IR_POOL_SHARE);
+        WorkerPool workers;
+        server_t srv;
+        pthread_mutex_init(&srv.sMutex, NULL);
+        srv.nJobs       = 0;
+        srv.pWorkers    = &workers;
+        srv.pPool       = &pool;
+        srv.nArgc       = argc;
+        srv.vArgv       = argv;
+
+        // Start workers and serve jobs
+        if ((res = workers.start(cfg->nWorkers, process_job, &srv)) == STATUS_OK)
+        {
+            log_info("Serving jobs on %s with %d workers\n", path, int(workers.workers()));
+            fflush(stdout);
+            res     = serve_loop(&srv, sock);
+            log_info("Shutting down, waiting for pending jobs\n");
+            fflush(stdout);
+        }
+        else
+            log_error("Could not start worker threads\n");
+
+        // Stop listening and complete pending jobs
+        close(sock);
+        unlink(path);
+        workers.stop();
+        pthread_mutex_destroy(&srv.sMutex);
+
+        return res;
+    }
+#else
+    status_t serve(const config_t *cfg, int argc, const char **argv)
+    {
+        log_error("Daemon mode is not supported on this platform\n");
+        return STATUS_NOT_SUPPORTED;
+    }
+#endif /* PLATFORM_UNIX_COMPATIBLE */
+}
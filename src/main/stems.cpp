@@ -0,0 +1,481 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of far-screamer
+ * Created on: 18 окт. 2026 г.
+ *
+ * far-screamer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * far-screamer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with far-screamer. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <lsp-plug.in/common/types.h>
+#include <lsp-plug.in/dsp/dsp.h>
+#include <lsp-plug.in/io/Path.h>
+#include <lsp-plug.in/lltl/darray.h>
+#include <lsp-plug.in/dsp-units/units.h>
+#include <lsp-plug.in/stdlib/stdio.h>
+#include <lsp-plug.in/stdlib/string.h>
+
+#include <private/stems.h>
+#include <private/audio.h>
+#include <private/tool.h>
+#include <private/log.h>
+
+#include <stdlib.h>
+
+#ifdef PLATFORM_UNIX_COMPATIBLE
+    #include <dirent.h>
+    #include <sys/stat.h>
+    #include <utime.h>
+#endif /* PLATFORM_UNIX_COMPATIBLE */
+
+#define STEM_VERSION            1           // Should be incremented when rendering of stems changes
+#define STEM_SIGNATURE          "FSSTEM\0\0"
+#define STEM_EXT                ".stem"
+#define STEM_NAME_LENGTH        (16 + sizeof(STEM_EXT) - 1)
+#define STEM_HASH_SEED          uint64_t(0xcbf29ce484222325ULL)
+#define STEM_HASH_PRIME         uint64_t(0x100000001b3ULL)
+
+namespace far_screamer
+{
+    typedef struct stem_header_t
+    {
+        char        signature[8];   // Signature of the file
+        uint32_t    version;        // Version of the stem format
+        uint32_t    sample_rate;    // Sample rate of the stem
+        uint64_t    key;            // The cache key of the stem
+        uint64_t    length;         // Number of samples stored in the file
+    } stem_header_t;
+
+    typedef struct stem_t
+    {
+        size_t      in;             // Number of the input channel
+        size_t      ir;             // Number of the IR channel
+        uint64_t    key;            // The cache key of the stem
+        bool        cached;         // The stem has been loaded from the cache
+    } stem_t;
+
+    typedef struct stem_file_t
+    {
+        uint64_t    key;            // The cache key of the stem
+        wsize_t     size;           // Size of the file
+        wsize_t     mtime;          // Time of the last use of the stem
+    } stem_file_t;
+
+    static inline uint64_t hash_word(uint64_t hash, uint64_t value)
+    {
+        hash    = (hash ^ value) * STEM_HASH_PRIME;
+        return hash ^ (hash >> 32);
+    }
+
+    static uint64_t hash_channel(const float *data, size_t count)
+    {
+        // Process the data by 64-bit words to keep up with the memory bandwidth
+        const uint8_t *p    = reinterpret_cast<const uint8_t *>(data);
+        size_t bytes        = count * sizeof(float);
+        uint64_t hash       = hash_word(STEM_HASH_SEED, count);
+        uint64_t v;
+
+        for ( ; bytes >= sizeof(uint64_t); bytes -= sizeof(uint64_t), p += sizeof(uint64_t))
+        {
+            memcpy(&v, p, sizeof(uint64_t));
+            hash        = hash_word(hash, v);
+        }
+        if (bytes > 0)
+        {
+            v           = 0;
+            memcpy(&v, p, bytes);
+            hash        = hash_word(hash, v);
+        }
+
+        // Zero value is reserved for channels which have not been hashed yet
+        return (hash != 0) ? hash : 1;
+    }
+
+    static uint64_t channel_hash(uint64_t *hashes, const dspu::Sample *s, size_t channel)
+    {
+        if (hashes[channel] == 0)
+            hashes[channel]     = hash_channel(s->channel(channel), s->length());
+        return hashes[channel];
+    }
+
+    static uint64_t params_hash(const config_t *cfg, size_t factor, ssize_t split, float sparse)
+    {
+        uint32_t sparse_bits;
+        memcpy(&sparse_bits, &sparse, sizeof(sparse_bits));
+
+        uint64_t hash   = hash_word(STEM_HASH_SEED, STEM_VERSION);
+        hash            = hash_word(hash, cfg->nSampleRate);
+        hash            = hash_word(hash, factor);
+        hash            = hash_word(hash, uint64_t(int64_t(split)));
+        hash            = hash_word(hash, (split > 0) ? cfg->nMultirateFactor : 0);
+        return hash_word(hash, sparse_bits);
+    }
+
+    static status_t stem_path(io::Path *path, const LSPString *dir, uint64_t key)
+    {
+        char name[32];
+        snprintf(name, sizeof(name), "%016llx" STEM_EXT, (unsigned long long)key);
+
+        status_t res = path->set(dir);
+        return (res == STATUS_OK) ? path->append_child(name) : res;
+    }
+
+    static void init_header(stem_header_t *hdr, uint64_t key, size_t srate, size_t length)
+    {
+        memset(hdr, 0, sizeof(stem_header_t));
+        memcpy(hdr->signature, STEM_SIGNATURE, sizeof(hdr->signature));
+        hdr->version        = STEM_VERSION;
+        hdr->sample_rate    = uint32_t(srate);
+        hdr->key            = key;
+        hdr->length         = length;
+    }
+
+    static bool load_stem(float *dst, size_t length, const io::Path *path, uint64_t key, size_t srate)
+    {
+        FILE *fd = fopen(path->as_native(), "rb");
+        if (fd == NULL)
+            return false;
+
+        // The header should match the expected one, otherwise the stem is rendered again
+        stem_header_t hdr, expected;
+        init_header(&expected, key, srate, length);
+        bool ok = (fread(&hdr, sizeof(stem_header_t), 1, fd) == 1) &&
+                  (memcmp(&hdr, &expected, sizeof(stem_header_t)) == 0) &&
+                  (fread(dst, sizeof(float), length, fd) == length);
+        fclose(fd);
+
+        if (!ok)
+            dsp::fill_zero(dst, length);
+        return ok;
+    }
+
+    static status_t save_stem(const float *src, size_t length, const io::Path *path, uint64_t key, size_t srate)
+    {
+        status_t res;
+        io::Path tmp;
+        if ((res = make_temp_path(&tmp, path)) != STATUS_OK)
+            return res;
+
+        FILE *fd = fopen(tmp.as_native(), "wb");
+        if (fd == NULL)
+            return STATUS_IO_ERROR;
+
+        stem_header_t hdr;
+        init_header(&hdr, key, srate, length);
+        bool ok = (fwrite(&hdr, sizeof(stem_header_t), 1, fd) == 1) &&
+                  (fwrite(src, sizeof(float), length, fd) == length);
+        if (fclose(fd) != 0)
+            ok      = false;
+
+        // Make the complete stem visible to concurrent readers atomically
+        res = (ok) ? tmp.rename(path) : STATUS_IO_ERROR;
+        if (res != STATUS_OK)
+            tmp.remove();
+        return res;
+    }
+
+    static ssize_t find_stem(const lltl::darray<stem_t> *stems, uint64_t key)
+    {
+        for (size_t i=0, n=stems->size(); i<n; ++i)
+        {
+            if (stems->uget(i)->key == key)
+                return i;
+        }
+        return -1;
+    }
+
+    static void touch_stem(const io::Path *path)
+    {
+    #ifdef PLATFORM_UNIX_COMPATIBLE
+        // The modification time of the stem tracks its last use for the eviction
+        utime(path->as_native(), NULL);
+    #endif /* PLATFORM_UNIX_COMPATIBLE */
+    }
+
+#ifdef PLATFORM_UNIX_COMPATIBLE
+    static int cmp_stem_files(const void *a, const void *b)
+    {
+        const stem_file_t *fa   = static_cast<const stem_file_t *>(a);
+        const stem_file_t *fb   = static_cast<const stem_file_t *>(b);
+        if (fa->mtime != fb->mtime)
+            return (fa->mtime < fb->mtime) ? -1 : 1;
+        return (fa->key < fb->key) ? -1 : (fa->key > fb->key) ? 1 : 0;
+    }
+
+    static status_t list_stems(lltl::darray<stem_file_t> *list, wsize_t *total, const LSPString *dir)
+    {
+        DIR *dd = opendir(dir->get_native());
+        if (dd == NULL)
+            return STATUS_IO_ERROR;
+
+        status_t res    = STATUS_OK;
+        io::Path path;
+        struct stat st;
+        char *end;
+
+        *total          = 0;
+        for (struct dirent *de; (res == STATUS_OK) && ((de = readdir(dd)) != NULL); )
+        {
+            // Only files named by the stem_path() are considered, foreign files are kept
+            const char *name = de->d_name;
+            if ((strlen(name) != STEM_NAME_LENGTH) || (strcmp(&name[16], STEM_EXT) != 0))
+                continue;
+            uint64_t key    = strtoull(name, &end, 16);
+            if (end != &name[16])
+                continue;
+            if ((res = stem_path(&path, dir, key)) != STATUS_OK)
+                break;
+            if ((stat(path.as_native(), &st) != 0) || (!S_ISREG(st.st_mode)))
+                continue;
+
+            stem_file_t *f  = list->add();
+            if (f == NULL)
+            {
+                res             = STATUS_NO_MEM;
+                break;
+            }
+            f->key          = key;
+            f->size         = st.st_size;
+            f->mtime        = st.st_mtime;
+            *total         += f->size;
+        }
+
+        closedir(dd);
+        return res;
+    }
+
+    static void evict_stems(const config_t *cfg, const lltl::darray<stem_t> *stems)
+    {
+        if (cfg->nWetCacheLimit <= 0)
+            return;
+
+        lltl::darray<stem_file_t> list;
+        wsize_t total   = 0;
+        status_t res    = list_stems(&list, &total, &cfg->sWetCache);
+        if (res != STATUS_OK)
+        {
+            log_error("  could not scan cache directory '%s', error code: %d\n", cfg->sWetCache.get_native(), int(res));
+            return;
+        }
+        if (total <= cfg->nWetCacheLimit)
+            return;
+
+        // Remove least recently used stems until the cache fits the limit, stems of the current job are kept
+        qsort(list.array(), list.size(), sizeof(stem_file_t), cmp_stem_files);
+
+        io::Path path;
+        size_t removed  = 0;
+        wsize_t freed   = 0;
+        for (size_t i=0, n=list.size(); (i<n) && (total > cfg->nWetCacheLimit); ++i)
+        {
+            const stem_file_t *f = list.uget(i);
+            if (find_stem(stems, f->key) >= 0)
+                continue;
+            if (stem_path(&path, &cfg->sWetCache, f->key) != STATUS_OK)
+                break;
+            if (path.remove() != STATUS_OK)
+                continue;
+
+            total          -= f->size;
+            freed          += f->size;
+            ++removed;
+        }
+
+        if (removed > 0)
+            log_info("  evicted %d wet stems (%llu bytes) from cache\n", int(removed), (unsigned long long)freed);
+    }
+#else
+    static void evict_stems(const config_t * /* cfg */, const lltl::darray<stem_t> * /* stems */)
+    {
+        // Directories are not enumerated on this platform, the cache is not limited
+    }
+#endif /* PLATFORM_UNIX_COMPATIBLE */
+
+    static status_t render_stems(
+        dspu::Sample *dst, const lltl::darray<stem_t> *stems,
+        const dspu::Sample *in, const dspu::Sample *ir,
+        const config_t *cfg, size_t factor, ssize_t split, float sparse, size_t block)
+    {
+        // Each missing stem is rendered at unit gain to the channel of the same index,
+        // the early stop of convolution is disabled as it depends on the applied gain
+        config_t scfg;
+        scfg.nSampleRate        = cfg->nSampleRate;
+        scfg.nMultirateFactor   = cfg->nMultirateFactor;
+        scfg.fWet               = 0.0f;
+
+        for (size_t i=0, n=stems->size(); i<n; ++i)
+        {
+            const stem_t *s = stems->uget(i);
+            if (s->cached)
+                continue;
+
+            mapping_t *m = scfg.sMapping.add();
+            if (m == NULL)
+            {
+                log_error("Not enough memory for mapping data\n");
+                return STATUS_NO_MEM;
+            }
+            m->in           = s->in;
+            m->ir           = s->ir;
+            m->out          = i;
+            m->gain         = 0.0f;
+        }
+        if (scfg.sMapping.is_empty())
+            return STATUS_OK;
+
+        size_t wet_end = 0;
+        if (factor > 1)
+        {
+            log_info("  decimating the wet signal path by factor %d\n", int(factor));
+            return convolve_decimated(&wet_end, dst, in, ir, &scfg, 0, factor, sparse, 0.0f, 0, block);
+        }
+        else if (split > 0)
+            return convolve_multirate(&wet_end, dst, in, ir, &scfg, 0, split, cfg->nMultirateFactor, sparse, 0.0f, 0, block);
+
+        return convolve_direct(&wet_end, dst, in, ir, &scfg, 0, 1.0f, sparse, 0.0f, 0, block);
+    }
+
+    status_t mix_wet_stems(
+        size_t *wet_end, dspu::Sample *out, const dspu::Sample *in, const dspu::Sample *ir,
+        const config_t *cfg, size_t predelay, size_t factor, ssize_t split, float sparse, size_t block)
+    {
+        status_t res;
+        io::Path path;
+        lltl::darray<stem_t> stems;
+        lltl::darray<uint64_t> hashes;
+        size_t length   = in->length() + ir->length();
+        uint64_t params = params_hash(cfg, factor, split, sparse);
+
+        // Input channels are hashed first, IR channels follow them
+        uint64_t *in_hash = hashes.add_n(in->channels() + ir->channels());
+        if (in_hash == NULL)
+        {
+            log_error("Not enough memory for stem data\n");
+            return STATUS_NO_MEM;
+        }
+        uint64_t *ir_hash = &in_hash[in->channels()];
+        for (size_t i=0, n=hashes.size(); i<n; ++i)
+            in_hash[i]      = 0;
+
+        // Collect the set of stems required by the mapping
+        for (size_t i=0, n=cfg->sMapping.size(); i<n; ++i)
+        {
+            const mapping_t *m = cfg->sMapping.uget(i);
+            float gain = m->gain + cfg->fWet;
+            if (gain < MIN_GAIN)
+                continue;
+            if (m->in >= in->channels())
+            {
+                log_error("Invalid channel number for input file: %d\n", int(m->in));
+                continue;
+            }
+            if (m->ir >= ir->channels())
+            {
+                log_error("Invalid channel number for impulse response file: %d\n", int(m->ir));
+                continue;
+            }
+
+            uint64_t key    = hash_word(params, channel_hash(in_hash, in, m->in));
+            key             = hash_word(key, channel_hash(ir_hash, ir, m->ir));
+            if (find_stem(&stems, key) >= 0)
+                continue;
+
+            stem_t *s       = stems.add();
+            if (s == NULL)
+            {
+                log_error("Not enough memory for stem data\n");
+                return STATUS_NO_MEM;
+            }
+            s->in           = m->in;
+            s->ir           = m->ir;
+            s->key          = key;
+            s->cached       = false;
+        }
+
+        size_t num_stems = stems.size();
+        if (num_stems <= 0)
+            return STATUS_OK;
+
+        dspu::Sample data;
+        if (!data.init(num_stems, length, length))
+        {
+            log_error("Not enough memory for stem data\n");
+            return STATUS_NO_MEM;
+        }
+
+        // Load stems from the cache
+        size_t num_cached = 0;
+        for (size_t i=0; i<num_stems; ++i)
+        {
+            stem_t *s = stems.uget(i);
+            if ((res = stem_path(&path, &cfg->sWetCache, s->key)) != STATUS_OK)
+                return res;
+            s->cached       = load_stem(data.channel(i), length, &path, s->key, cfg->nSampleRate);
+            if (s->cached)
+            {
+                touch_stem(&path);
+                ++num_cached;
+            }
+        }
+        log_info("  found %d of %d wet stems in cache\n", int(num_cached), int(num_stems));
+
+        // Render missing stems and store them to the cache, the failure of caching is not fatal
+        if (num_cached < num_stems)
+        {
+            if ((res = render_stems(&data, &stems, in, ir, cfg, factor, split, sparse, block)) != STATUS_OK)
+                return res;
+
+            if ((res = path.set(&cfg->sWetCache)) == STATUS_OK)
+                res     = path.mkdir(true);
+            if (res != STATUS_OK)
+                log_error("  could not create cache directory '%s', error code: %d\n", cfg->sWetCache.get_native(), int(res));
+
+            for (size_t i=0; (res == STATUS_OK) && (i<num_stems); ++i)
+            {
+                const stem_t *s = stems.uget(i);
+                if (s->cached)
+                    continue;
+                if ((res = stem_path(&path, &cfg->sWetCache, s->key)) != STATUS_OK)
+                    return res;
+                if ((res = save_stem(data.channel(i), length, &path, s->key, cfg->nSampleRate)) != STATUS_OK)
+                    log_error("  could not store wet stem '%s', error code: %d\n", path.as_native(), int(res));
+            }
+
+            evict_stems(cfg, &stems);
+        }
+
+        // Mix stems to the output according to the mapping
+        for (size_t i=0, n=cfg->sMapping.size(); i<n; ++i)
+        {
+            const mapping_t *m = cfg->sMapping.uget(i);
+            float gain = m->gain + cfg->fWet;
+            if ((gain < MIN_GAIN) || (m->in >= in->channels()) || (m->ir >= ir->channels()))
+                continue;
+
+            uint64_t key    = hash_word(params, in_hash[m->in]);
+            key             = hash_word(key, ir_hash[m->ir]);
+            ssize_t index   = find_stem(&stems, key);
+            if (index < 0)
+                continue;
+
+            log_info("  mixing wet stem of IN channel %d and IR channel %d to OUT channel %d at %.2f dB\n",
+                int(m->in), int(m->ir), int(m->out), m->gain);
+            dsp::fmadd_k3(&out->channel(m->out)[predelay], data.channel(index), dspu::db_to_gain(gain), length);
+        }
+
+        *wet_end    = lsp_max(*wet_end, predelay + length);
+        return STATUS_OK;
+    }
+}
@@ -20,45 +20,90 @@
  */
 
 #include <lsp-plug.in/common/status.h>
+#include <lsp-plug.in/common/alloc.h>
+#include <lsp-plug.in/dsp/dsp.h>
+#include <lsp-plug.in/io/Path.h>
+#include <lsp-plug.in/lltl/darray.h>
 #include <lsp-plug.in/dsp-units/sampling/Sample.h>
 #include <lsp-plug.in/dsp-units/units.h>
 #include <lsp-plug.in/stdlib/stdio.h>
 
 #include <private/tool.h>
-#include <private/config.h>
+#include <private/Arena.h>
+#include <far-screamer/config.h>
 #include <private/cmdline.h>
 #include <private/audio.h>
+#include <private/decimation.h>
+#include <private/draft.h>
+#include <private/multirate.h>
+#include <private/pipeline.h>
+#include <private/stems.h>
+#include <private/planner.h>
+#include <private/fingerprint.h>
+#include <private/dryrun.h>
+#include <private/outofcore.h>
+#include <private/album.h>
+#include <private/cues.h>
+#include <private/merge.h>
+#include <private/region.h>
+#include <private/server.h>
+#include <private/watch.h>
+#include <private/log.h>
+#include <private/util.h>
 
 #define MIN_SAMPLE_RATE         8000
 #define MAX_SAMPLE_RATE         192000
-#define MIN_GAIN                -200.0f
 
 namespace far_screamer
 {
     using namespace lsp;
 
-    status_t apply_equalizer(size_t *latency, dspu::Sample *dst, const config_t *cfg)
+    static status_t init_equalizer(dspu::Equalizer *eq, size_t *filters, const config_t *cfg)
     {
-        // Configure the equalizer
-        dspu::Equalizer eq;
-
-        if (!eq.init(2, 0))
+        if (!eq->init(2, 0))
         {
-            fprintf(stderr, "Not enough memory to initialize equalizer\n");
+            log_error("Not enough memory to initialize equalizer\n");
             return STATUS_NO_MEM;
         }
 
-        eq.set_sample_rate(cfg->nSampleRate);
-        eq.set_mode(dspu::EQM_IIR);
-        eq.reset();
+        eq->set_sample_rate(cfg->nSampleRate);
+        eq->set_mode(dspu::EQM_IIR);
+        eq->reset();
 
         // Setup filters
         size_t index = 0;
         if (cfg->sLPF.nType != dspu::FLT_NONE)
-            eq.set_params(index++, &cfg->sLPF);
+            eq->set_params(index++, &cfg->sLPF);
         if (cfg->sHPF.nType != dspu::FLT_NONE)
-            eq.set_params(index++, &cfg->sHPF);
-        if (index <= 0)
+            eq->set_params(index++, &cfg->sHPF);
+        *filters    = index;
+
+        return STATUS_OK;
+    }
+
+    status_t filter_latency(size_t *latency, const config_t *cfg)
+    {
+        dspu::Equalizer eq;
+        size_t filters = 0;
+
+        status_t res = init_equalizer(&eq, &filters, cfg);
+        if (res != STATUS_OK)
+            return res;
+
+        *latency = (filters > 0) ? eq.get_latency() : 0;
+        return STATUS_OK;
+    }
+
+    status_t apply_equalizer(size_t *latency, dspu::Sample *dst, const config_t *cfg)
+    {
+        // Configure the equalizer
+        dspu::Equalizer eq;
+        size_t filters = 0;
+
+        status_t res = init_equalizer(&eq, &filters, cfg);
+        if (res != STATUS_OK)
+            return res;
+        if (filters <= 0)
         {
             *latency    = 0;
             return STATUS_OK;
@@ -82,29 +127,251 @@ namespace far_screamer
         return false;
     }
 
-    status_t convolve_data(dspu::Sample *out, const dspu::Sample *in, const dspu::Sample *ir, config_t *cfg, size_t latency)
+    route_t *find_route(lltl::darray<route_t> *routes, size_t in, size_t out)
     {
-        // Flags that indicate that dry signal has been emitted to the specified output track
-        size_t predelay = dspu::millis_to_samples(cfg->nSampleRate, cfg->fPreDelay);
-        size_t out_length = in->length() + ir->length() + latency + predelay;
-        float g_dry = (cfg->fDry >= MIN_GAIN) ? dspu::db_to_gain(cfg->fDry) : 0.0f;
+        for (size_t i=0, n=routes->size(); i<n; ++i)
+        {
+            route_t *r = routes->uget(i);
+            if ((r->in == in) && (r->out == out))
+                return r;
+        }
+        return NULL;
+    }
+
+    void mix_route_ir(float *dst, const dspu::Sample *ir, const config_t *cfg, const route_t *r, float k)
+    {
+        dsp::fill_zero(dst, ir->length());
+        for (size_t i=0, n=cfg->sMapping.size(); i<n; ++i)
+        {
+            const mapping_t *m = cfg->sMapping.uget(i);
+            float gain = m->gain + cfg->fWet;
+            if ((m->in != r->in) || (m->out != r->out) || (gain < MIN_GAIN))
+                continue;
+            dsp::fmadd_k3(dst, ir->channel(m->ir), dspu::db_to_gain(gain) * k, ir->length());
+        }
+    }
+
+    status_t convolve_direct(
+        size_t *wet_end, dspu::Sample *out, const dspu::Sample *in, const dspu::Sample *ir,
+        const config_t *cfg, size_t predelay, float k,
+        float sparse, float tail_thresh, size_t tail_window, size_t block)
+    {
+        lltl::darray<route_t> routes;
+        route_t *r;
+
+        for (size_t i=0, n=cfg->sMapping.size(); i<n; ++i)
+        {
+            const mapping_t *m = cfg->sMapping.uget(i);
+
+            // Output information
+            log_info("  convolving IN channel %d with IR channel %d to OUT channel %d at %.2f dB\n",
+                int(m->in), int(m->ir), int(m->out), m->gain
+            );
+
+            float gain = m->gain + cfg->fWet;
+            if (gain < MIN_GAIN)
+                continue;
+
+            // All IR channels convolved with the same input channel to the same output channel
+            // can be summed and processed at once if there is no sparse IR head detection
+            if ((sparse <= 0.0f) && (m->in < in->channels()) && (m->ir < ir->channels()))
+            {
+                if (find_route(&routes, m->in, m->out) != NULL)
+                    continue;
+                if ((r = routes.add()) == NULL)
+                {
+                    log_error("Not enough memory for routing data\n");
+                    return STATUS_NO_MEM;
+                }
+                r->in       = m->in;
+                r->out      = m->out;
+                continue;
+            }
+
+            // Perform convolution
+            size_t wet_length = 0;
+            if (convolve(out, in, ir, m->out, m->in, m->ir, predelay, dspu::db_to_gain(gain) * k, sparse,
+                    tail_thresh, tail_window, block, &wet_length) == STATUS_OK)
+                *wet_end    = lsp_max(*wet_end, predelay + wet_length);
+        }
+
+        // Process routes by pairs with packed FFT
+        size_t num_routes = routes.size();
+        if (num_routes >= 2)
+        {
+            size_t ir_length = ir->length();
+            Arena *arena    = thread_arena();
+            size_t mark     = arena->mark();
+            float *ir0      = arena->alloc<float>(ir_length * 2);
+            if (ir0 == NULL)
+            {
+                log_error("Not enough memory to allocate temporary buffer\n");
+                return STATUS_NO_MEM;
+            }
+            float *ir1      = &ir0[ir_length];
+
+            for (size_t i=0; (i + 1) < num_routes; i += 2)
+            {
+                const route_t *r0 = routes.uget(i);
+                const route_t *r1 = routes.uget(i + 1);
+                log_info("  convolving IN channels %d, %d to OUT channels %d, %d with packed FFT\n",
+                    int(r0->in), int(r1->in), int(r0->out), int(r1->out));
+
+                mix_route_ir(ir0, ir, cfg, r0, k);
+                mix_route_ir(ir1, ir, cfg, r1, k);
+
+                size_t wet_length = 0;
+                if (convolve_pair(out, in, ir0, ir1, ir_length, r0->out, r1->out, r0->in, r1->in,
+                        predelay, tail_thresh, tail_window, block, &wet_length) == STATUS_OK)
+                    *wet_end    = lsp_max(*wet_end, predelay + wet_length);
+            }
+
+            arena->rewind(mark);
+        }
+
+        // Process the remaining route
+        if ((num_routes & 1) == 0)
+            return STATUS_OK;
+
+        r = routes.uget(num_routes - 1);
+        for (size_t i=0, n=cfg->sMapping.size(); i<n; ++i)
+        {
+            const mapping_t *m = cfg->sMapping.uget(i);
+            float gain = m->gain + cfg->fWet;
+            if ((m->in != r->in) || (m->out != r->out) || (gain < MIN_GAIN))
+                continue;
+
+            size_t wet_length = 0;
+            if (convolve(out, in, ir, m->out, m->in, m->ir, predelay, dspu::db_to_gain(gain) * k, sparse,
+                    tail_thresh, tail_window, block, &wet_length) == STATUS_OK)
+                *wet_end    = lsp_max(*wet_end, predelay + wet_length);
+        }
+
+        return STATUS_OK;
+    }
+
+    static bool *used_channels(Arena *arena, const config_t *cfg, size_t channels, bool ir)
+    {
+        bool *used = arena->alloc<bool>(lsp_max(channels, size_t(1)));
+        if (used == NULL)
+            return NULL;
+
+        for (size_t i=0; i<channels; ++i)
+            used[i]         = false;
+        for (size_t i=0, n=cfg->sMapping.size(); i<n; ++i)
+        {
+            const mapping_t *m = cfg->sMapping.uget(i);
+            size_t ch       = (ir) ? m->ir : m->in;
+            if ((ch < channels) && (m->gain + cfg->fWet >= MIN_GAIN))
+                used[ch]        = true;
+        }
+
+        return used;
+    }
+
+    status_t convolve_decimated(
+        size_t *wet_end, dspu::Sample *out, const dspu::Sample *in, const dspu::Sample *ir,
+        const config_t *cfg, size_t predelay, size_t factor,
+        float sparse, float tail_thresh, size_t tail_window, size_t block)
+    {
+        status_t res;
+        dspu::Sample d_in, d_ir, d_out;
+
+        // Decimate only the input and IR channels referenced by the mapping
+        Arena *arena    = thread_arena();
+        size_t mark     = arena->mark();
+        bool *in_used   = used_channels(arena, cfg, in->channels(), false);
+        bool *ir_used   = used_channels(arena, cfg, ir->channels(), true);
+        if ((in_used == NULL) || (ir_used == NULL))
+        {
+            arena->rewind(mark);
+            log_error("Not enough memory to allocate temporary buffer\n");
+            return STATUS_NO_MEM;
+        }
+        res             = decimate_sample(&d_in, in, factor, in_used);
+        if (res == STATUS_OK)
+            res             = decimate_sample(&d_ir, ir, factor, ir_used);
+        arena->rewind(mark);
+        if (res != STATUS_OK)
+            return res;
+
+        size_t length = d_in.length() + d_ir.length();
+        if (!d_out.init(out->channels(), length, length))
+        {
+            log_error("Not enough memory for decimated output data\n");
+            return STATUS_NO_MEM;
+        }
 
+        // Perform convolution at the reduced sample rate, the decimated impulse response
+        // requires the gain to be multiplied by the factor
+        size_t d_wet_end = 0;
+        if ((res = convolve_direct(&d_wet_end, &d_out, &d_in, &d_ir, cfg, 0, factor, sparse, tail_thresh, tail_window / factor, block / factor)) != STATUS_OK)
+            return res;
+
+        // Interpolate the wet signal back to the original sample rate
+        d_out.set_length(d_wet_end);
+        for (size_t i=0, n=out->channels(); i<n; ++i)
+        {
+            if ((res = interpolate_channel(out, &d_out, i, i, predelay, factor, 1.0f)) != STATUS_OK)
+                return res;
+        }
+
+        *wet_end    = predelay + d_wet_end * factor;
+        return STATUS_OK;
+    }
+
+    status_t convolve_multirate(
+        size_t *wet_end, dspu::Sample *out, const dspu::Sample *in, const dspu::Sample *ir,
+        const config_t *cfg, size_t predelay, size_t split, size_t factor,
+        float sparse, float tail_thresh, size_t tail_window, size_t block)
+    {
+        status_t res;
+        dspu::Sample early, late;
+        size_t offset = 0;
+
+        // Report the accuracy and split the impulse response
+        if ((res = multirate_report(ir, split, factor)) != STATUS_OK)
+            return res;
+        if ((res = split_impulse_response(&early, &late, &offset, ir, split, factor)) != STATUS_OK)
+            return res;
+
+        // Convolve the early part at the original sample rate
+        log_info("  convolving early part of the impulse response (%d samples)\n", int(early.length()));
+        if ((res = convolve_direct(wet_end, out, in, &early, cfg, predelay, 1.0f, sparse, tail_thresh, tail_window, block)) != STATUS_OK)
+            return res;
+
+        // Convolve the late part at the decimated sample rate, the late part can not contain sparse head
+        size_t late_end = 0;
+        log_info("  convolving late part of the impulse response (%d samples) decimated by factor %d\n",
+            int(late.length()), int(factor));
+        if ((res = convolve_decimated(&late_end, out, in, &late, cfg, predelay + offset, factor, 0.0f, tail_thresh, tail_window, block)) != STATUS_OK)
+            return res;
+
+        *wet_end    = lsp_max(*wet_end, late_end);
+        return STATUS_OK;
+    }
+
+    status_t expand_mapping(layout_t *layout, config_t *cfg, size_t in_channels, size_t ir_channels, bool verbose)
+    {
+        *layout = LAYOUT_GENERIC;
         if (cfg->sMapping.is_empty())
         {
             mapping_t *xm;
 
             // Check typical configurations
-            if ((in->channels() == 2) && (ir->channels() == 2))
+            if ((in_channels == 2) && (ir_channels == 2))
             {
                 // Stereo convolution
-                printf("Applying Stereo IR to stereo file\n");
+                if (verbose)
+                    log_info("Applying Stereo IR to stereo file\n");
                 if (!(xm = cfg->sMapping.add_n(2)))
                 {
-                    fprintf(stderr, "Not enough memory for generating mapping data\n");
+                    log_error("Not enough memory for generating mapping data\n");
                     return STATUS_NO_MEM;
                 }
 
                 // Simple mapping
+                *layout         = LAYOUT_2X2;
                 for (size_t i=0; i<2; ++i)
                 {
                     xm[i].in    = i;
@@ -113,18 +380,20 @@ namespace far_screamer
                     xm[i].gain  = 1.0f;
                 }
             }
-            else if ((in->channels() == 2) && (ir->channels() == 4))
+            else if ((in_channels == 2) && (ir_channels == 4))
             {
                 // True reverb convolution
-                printf("  applying TrueReverb convolution schema\n");
+                if (verbose)
+                    log_info("  applying TrueReverb convolution schema\n");
                 if (!(xm = cfg->sMapping.add_n(4)))
                 {
-                    fprintf(stderr, "Not enough memory for generating mapping data\n");
+                    log_error("Not enough memory for generating mapping data\n");
                     return STATUS_NO_MEM;
                 }
 
                 // Left channel convolved with channels 1 and 2 of the IR
                 // Right channel convolved with channels 3 and 4 of the IR
+                *layout         = LAYOUT_2X4;
                 for (size_t i=0; i<4; ++i)
                 {
                     xm[i].in    = i >> 1;
@@ -133,18 +402,20 @@ namespace far_screamer
                     xm[i].gain  = 1.0f;
                 }
             }
-            else if (in->channels() == 1)
+            else if (in_channels == 1)
             {
-                printf("  applying IR to mono file\n");
+                if (verbose)
+                    log_info("  applying IR to mono file\n");
 
-                if (!(xm = cfg->sMapping.add_n(ir->channels())))
+                if (!(xm = cfg->sMapping.add_n(ir_channels)))
                 {
-                    fprintf(stderr, "Not enough memory for generating mapping data\n");
+                    log_error("Not enough memory for generating mapping data\n");
                     return STATUS_NO_MEM;
                 }
 
                 // Simple 1:n mapping
-                for (size_t i=0; i<ir->channels(); ++i)
+                *layout         = (ir_channels == 1) ? LAYOUT_1X1 : LAYOUT_1XN;
+                for (size_t i=0; i<ir_channels; ++i)
                 {
                     xm[i].in    = 0;
                     xm[i].out   = i;
@@ -152,18 +423,20 @@ namespace far_screamer
                     xm[i].gain  = 1.0f;
                 }
             }
-            else if (ir->channels() == 1)
+            else if (ir_channels == 1)
             {
-                printf("  applying mono IR to file\n");
+                if (verbose)
+                    log_info("  applying mono IR to file\n");
 
-                if (!(xm = cfg->sMapping.add_n(in->channels())))
+                if (!(xm = cfg->sMapping.add_n(in_channels)))
                 {
-                    fprintf(stderr, "Not enough memory for generating mapping data\n");
+                    log_error("Not enough memory for generating mapping data\n");
                     return STATUS_NO_MEM;
                 }
 
                 // Simple n:1 mapping
-                for (size_t i=0; i<in->channels(); ++i)
+                *layout         = LAYOUT_NX1;
+                for (size_t i=0; i<in_channels; ++i)
                 {
                     xm[i].in    = i;
                     xm[i].out   = 0;
@@ -173,12 +446,37 @@ namespace far_screamer
             }
             else
             {
-                fprintf(stderr, "Untypical configuration of input and IR file, need output mapping to be explicitly specified\n");
+                log_error("Untypical configuration of input and IR file, need output mapping to be explicitly specified\n");
                 return STATUS_BAD_ARGUMENTS;
             }
         }
-        else
-            printf("  applying mapping-defined convolution\n");
+        else if (verbose)
+            log_info("  applying mapping-defined convolution\n");
+
+        return STATUS_OK;
+    }
+
+    status_t make_workload(
+        workload_t *w, layout_t *layout, config_t *cfg,
+        size_t in_channels, size_t in_length, size_t ir_channels, size_t ir_length,
+        size_t latency, bool verbose)
+    {
+        status_t res;
+        size_t predelay = dspu::millis_to_samples(cfg->nSampleRate, cfg->fPreDelay);
+        ssize_t tail_window = dspu::millis_to_samples(cfg->nSampleRate, cfg->fTailWindow);
+        if (tail_window < 0)
+        {
+            log_error("Negative tail window value, can not proceed\n");
+            return STATUS_BAD_ARGUMENTS;
+        }
+        if ((cfg->fMultirateSplit >= 0.0f) && ((cfg->nMultirateFactor < 2) || (cfg->nMultirateFactor > 8)))
+        {
+            log_error("Multirate decimation factor should be in range 2 .. 8, can not proceed\n");
+            return STATUS_BAD_ARGUMENTS;
+        }
+
+        if ((res = expand_mapping(layout, cfg, in_channels, ir_channels, verbose)) != STATUS_OK)
+            return res;
 
         // Estimate number of output channels
         size_t out_channels = 0;
@@ -189,43 +487,176 @@ namespace far_screamer
                 out_channels    = m->out + 1;
         }
 
+        // Select the processing method of the wet signal
+        size_t factor = (cfg->bDecimate) ? decimation_factor(cfg->nSampleRate, &cfg->sLPF) : 1;
+        if ((verbose) && (cfg->bDecimate) && (factor <= 1))
+            log_info("  low-pass filter settings do not allow decimation of the wet signal path\n");
+        factor          = lsp_max(factor, draft_factor(cfg, cfg->nSampleRate));
+
+        ssize_t split = ((factor <= 1) && (cfg->fMultirateSplit >= 0.0f)) ? dspu::millis_to_samples(cfg->nSampleRate, cfg->fMultirateSplit) : -1;
+        if ((split == 0) || ((split > 0) && (size_t(split) >= ir_length)))
+        {
+            if (verbose)
+                log_info("  the split point is out of the impulse response, multirate processing is disabled\n");
+            split           = -1;
+        }
+
+        // The specialized pipeline fuses gains into the convolution and can not be used with wet stems
+        bool sparse = cfg->fSparse >= MIN_GAIN;
+        size_t layout_ch = (*layout == LAYOUT_NX1) ? in_channels : ir_channels;
+
+        w->in_channels  = in_channels;
+        w->in_length    = in_length;
+        w->in_sample    = CompactSample::sample_size(cfg->nCompact);
+        w->ir_channels  = ir_channels;
+        w->ir_length    = ir_length;
+        w->out_channels = out_channels;
+        w->out_length   = in_length + ir_length + latency + predelay;
+        w->mappings     = cfg->sMapping.size();
+        w->factor       = factor;
+        w->split        = split;
+        w->mr_factor    = cfg->nMultirateFactor;
+        w->sparse       = sparse;
+        w->pipeline     = (factor <= 1) && (split < 0) && (!sparse) && (layout_supported(*layout, layout_ch));
+        w->stems        = !cfg->sWetCache.is_empty();
+
+        return STATUS_OK;
+    }
+
+    status_t convolve_data(
+        dspu::Sample *out, const dspu::Sample *in, const CompactSample *cin, const dspu::Sample *ir,
+        config_t *cfg, size_t latency, const region_t *region, plan_t *plan)
+    {
+        status_t res;
+        layout_t layout;
+        workload_t w;
+        dspu::Sample decoded;
+        size_t in_channels = (cin->valid()) ? cin->channels() : in->channels();
+        size_t in_length = (cin->valid()) ? cin->length() : in->length();
+
+        // Expand the mapping and estimate the dimensions of the output
+        if ((res = make_workload(&w, &layout, cfg, in_channels, in_length, ir->channels(), ir->length(), latency, true)) != STATUS_OK)
+            return res;
+
+        size_t predelay = dspu::millis_to_samples(cfg->nSampleRate, cfg->fPreDelay);
+        size_t tail_window = dspu::millis_to_samples(cfg->nSampleRate, cfg->fTailWindow);
+        size_t out_channels = w.out_channels;
+        size_t out_length = w.out_length;
+        size_t factor = w.factor;
+        ssize_t split = w.split;
+        size_t wet_end = 0;
+        float g_dry = (cfg->fDry >= MIN_GAIN) ? dspu::db_to_gain(cfg->fDry) : 0.0f;
+        float sparse = (cfg->fSparse >= MIN_GAIN) ? dspu::db_to_gain(cfg->fSparse) : 0.0f;
+        float tail_thresh = (cfg->fTailThreshold >= MIN_GAIN) ? dspu::db_to_gain(cfg->fTailThreshold) : 0.0f;
+        float mid_g  = (cfg->fMid  >= MIN_GAIN) ? dspu::db_to_gain(cfg->fMid)  : 0.0f;
+        float side_g = (cfg->fSide >= MIN_GAIN) ? dspu::db_to_gain(cfg->fSide) : 0.0f;
+
+        // Select the processing strategy that fits into the memory budget, the strategy
+        // of the region is selected for the whole output to produce the same samples.
+        // The memory reserved by reserve_job() before decoding the data is kept.
+        wsize_t reserved = plan->reserved;
+        if (region != NULL)
+        {
+            workload_t whole;
+            whole_workload(&whole, &w, region);
+            make_plan(plan, &whole, cfg->nMaxMemory);
+        }
+        else
+            make_plan(plan, &w, cfg->nMaxMemory);
+        if (cfg->nMaxMemory > 0)
+            print_plan(plan, cfg->nMaxMemory);
+        if (reserved > 0)
+            plan->reserved  = reserved;
+        else
+            reserve_memory(plan, cfg->nMaxMemory);
+
         // Resize the output sample
         if (!out->resize(out_channels, out_length, out_length))
         {
-            fprintf(stderr, "Not enough memory for output data\n");
+            log_error("Not enough memory for output data\n");
             return STATUS_NO_MEM;
         }
 
-        // Form the 'Dry' sound according to the mapping settings
-        for (size_t oc=0; oc<out_channels; ++oc)
+        if (plan->strategy == STRATEGY_PIPELINE)
         {
-            float *dptr = out->channel(oc);
+            // Use the specialized pipeline for the typical channel layout
+            const mapping_t *m = cfg->sMapping.uget(0);
+            float gain = m->gain + cfg->fWet;
+            render_t params;
+
+            params.latency      = latency;
+            params.predelay     = predelay;
+            params.dry          = g_dry;
+            params.wet          = (gain >= MIN_GAIN) ? dspu::db_to_gain(gain) : 0.0f;
+            params.mid          = mid_g;
+            params.side         = side_g;
+            params.threshold    = tail_thresh;
+            params.window       = tail_window;
 
-            for (size_t ic=0; ic<in->channels(); ++ic)
+            log_info("  rendering IN channels to OUT channels at %.2f dB with specialized pipeline\n", m->gain);
+            res = (cin->valid()) ?
+                render_layout(&wet_end, out, cin, ir, layout, &params) :
+                render_layout(&wet_end, out, in, ir, layout, &params);
+            if (res != STATUS_OK)
+                return res;
+        }
+        else
+        {
+            // Other strategies process the whole input at once
+            if (cin->valid())
             {
-                if (!contains_mapping(cfg, oc, ic))
-                    continue;
+                log_error("  the compact input is decoded as a whole, the compact storage does not reduce the peak memory\n");
+                if ((res = cin->decode(&decoded)) != STATUS_OK)
+                {
+                    log_error("Not enough memory for decoded input data\n");
+                    return res;
+                }
+                in              = &decoded;
+            }
+
+            // Form the 'Dry' sound according to the mapping settings
+            for (size_t oc=0; oc<out_channels; ++oc)
+            {
+                float *dptr = out->channel(oc);
 
-                // Copy 'dry' sound with adjusted gain
-                const float *sptr = in->channel(ic);
-                dsp::fmadd_k3(&dptr[latency], sptr, g_dry, in->length());
+                for (size_t ic=0; ic<in->channels(); ++ic)
+                {
+                    if (!contains_mapping(cfg, oc, ic))
+                        continue;
+
+                    // Copy 'dry' sound with adjusted gain
+                    const float *sptr = in->channel(ic);
+                    dsp::fmadd_k3(&dptr[latency], sptr, g_dry, in->length());
+                }
             }
-        }
 
-        // Now apply mapping function
-        for (size_t i=0, n=cfg->sMapping.size(); i<n; ++i)
-        {
-            const mapping_t *m = cfg->sMapping.uget(i);
+            // Now apply mapping function
+            if (plan->stems)
+                res = mix_wet_stems(&wet_end, out, in, ir, cfg, predelay, factor, split, sparse, plan->block);
+            else if (factor > 1)
+            {
+                log_info("  decimating the wet signal path by factor %d\n", int(factor));
+                res = convolve_decimated(&wet_end, out, in, ir, cfg, predelay, factor, sparse, tail_thresh, tail_window, plan->block);
+            }
+            else if (split > 0)
+                res = convolve_multirate(&wet_end, out, in, ir, cfg, predelay, split, cfg->nMultirateFactor, sparse, tail_thresh, tail_window, plan->block);
+            else
+                res = convolve_direct(&wet_end, out, in, ir, cfg, predelay, 1.0f, sparse, tail_thresh, tail_window, plan->block);
+            if (res != STATUS_OK)
+                return res;
+            log_progress(1.0f);
 
-            // Output information
-            printf("  convolving IN channel %d with IR channel %d to OUT channel %d at %.2f dB\n",
-                int(m->in), int(m->ir), int(m->out), m->gain
-            );
+            // Apply mid/side balance
+            apply_mid_side(out, mid_g, side_g);
+        }
 
-            // Perform convolution
-            float gain = m->gain + cfg->fWet;
-            if (gain >= MIN_GAIN)
-                convolve(out, in, ir, m->out, m->in, m->ir, predelay, dspu::db_to_gain(gain));
+        // Truncate the tail of the output
+        if (tail_thresh > 0.0f)
+        {
+            size_t dry_end  = latency + in_length;
+            out->set_length(lsp_max(dry_end, wet_end));
+            out->set_length(detect_tail_length(out, dry_end, tail_thresh, tail_window));
+            log_info("  truncated output tail at %d samples\n", int(out->length()));
         }
 
         return STATUS_OK;
@@ -236,91 +667,447 @@ namespace far_screamer
         ssize_t head_cut = dspu::millis_to_samples(s->sample_rate(), cfg->fHeadCut);
         if (head_cut < 0)
         {
-            fprintf(stderr, "Negative head cut value, can not proceed\n");
+            log_error("Negative head cut value, can not proceed\n");
             return STATUS_BAD_ARGUMENTS;
         }
 
         ssize_t tail_cut = dspu::millis_to_samples(s->sample_rate(), cfg->fTailCut);
         if (tail_cut < 0)
         {
-            fprintf(stderr, "Negative tail cut value, can not proceed\n");
+            log_error("Negative tail cut value, can not proceed\n");
             return STATUS_BAD_ARGUMENTS;
         }
 
         ssize_t fade_in = dspu::millis_to_samples(s->sample_rate(), cfg->fFadeIn);
         if (fade_in < 0)
         {
-            fprintf(stderr, "Negative fade in value, can not proceed\n");
+            log_error("Negative fade in value, can not proceed\n");
             return STATUS_BAD_ARGUMENTS;
         }
 
         ssize_t fade_out = dspu::millis_to_samples(s->sample_rate(), cfg->fFadeOut);
         if (fade_in < 0)
         {
-            fprintf(stderr, "Negative fade out value, can not proceed\n");
+            log_error("Negative fade out value, can not proceed\n");
             return STATUS_BAD_ARGUMENTS;
         }
 
         return cut_sample(s, head_cut, tail_cut, fade_in, fade_out);
     }
 
-    int main(int argc, const char **argv)
+    status_t check_output(LSPString *fp, bool *up_to_date, const config_t *cfg)
+    {
+        *up_to_date     = false;
+        if (!cfg->bIncremental)
+            return STATUS_OK;
+
+        status_t res = check_fingerprint(fp, up_to_date, cfg);
+        if ((res == STATUS_OK) && (*up_to_date))
+            log_info("  output file '%s' is up to date, skipping\n", cfg->sOutFile.get_native());
+
+        return res;
+    }
+
+    static inline size_t *mapping_channel(mapping_t *m, bool ir)
+    {
+        return (ir) ? &m->ir : &m->in;
+    }
+
+    static bool uses_channel(const config_t *cfg, size_t ch, bool ir)
+    {
+        for (size_t i=0, n=cfg->sMapping.size(); i<n; ++i)
+        {
+            const mapping_t *m = cfg->sMapping.uget(i);
+            if (((ir) ? m->ir : m->in) == ch)
+                return true;
+        }
+        return false;
+    }
+
+    status_t select_channels(lltl::darray<size_t> *list, config_t *cfg, bool ir, bool verbose)
     {
-        config_t cfg;
         status_t res;
-        size_t latency = 0;
-        dspu::Sample in, out, ir;
+        audio_info_t info;
 
-        // Parse configuration
-        if ((res = parse_cmdline(&cfg, argc, argv)) != STATUS_OK)
-            return (res == STATUS_SKIP) ? STATUS_OK : res;
+        // The automatically generated mapping uses all channels
+        list->clear();
+        if (cfg->sMapping.is_empty())
+            return STATUS_OK;
+        if ((res = read_audio_info(&info, (ir) ? &cfg->sIRFile : &cfg->sInFile)) != STATUS_OK)
+            return res;
+
+        // Invalid channel numbers are reported on processing
+        for (size_t i=0, n=cfg->sMapping.size(); i<n; ++i)
+        {
+            if (*mapping_channel(cfg->sMapping.uget(i), ir) >= info.channels)
+                return STATUS_OK;
+        }
+
+        for (size_t ch=0; ch<info.channels; ++ch)
+        {
+            if ((uses_channel(cfg, ch, ir)) && (!list->add(ch)))
+                return STATUS_NO_MEM;
+        }
+        if (list->size() >= info.channels)
+        {
+            list->clear();
+            return STATUS_OK;
+        }
+
+        // Refer to channels in the order of loading
+        for (size_t i=0, n=cfg->sMapping.size(); i<n; ++i)
+        {
+            size_t *ch      = mapping_channel(cfg->sMapping.uget(i), ir);
+            for (size_t j=0, m=list->size(); j<m; ++j)
+            {
+                if (*list->uget(j) == *ch)
+                {
+                    *ch             = j;
+                    break;
+                }
+            }
+        }
+
+        if (verbose)
+        {
+            LSPString text;
+            for (size_t i=0, n=list->size(); i<n; ++i)
+                text.fmt_append_ascii((i > 0) ? ", %d" : "%d", int(*list->uget(i)));
+            log_info("  loading channels %s of %d channels of the %s file used by the mapping as channels 0 .. %d\n",
+                text.get_native(), int(info.channels), (ir) ? "impulse response" : "input", int(list->size() - 1));
+        }
+
+        return STATUS_OK;
+    }
+
+    status_t load_input(dspu::Sample *in, CompactSample *cin, config_t *cfg, const audio_range_t *range)
+    {
+        status_t res;
+        lltl::darray<size_t> channels;
+
+        if ((res = select_channels(&channels, cfg, false, true)) != STATUS_OK)
+            return res;
+
+        // Load audio file to the compact storage if it is enabled
+        if (cfg->nCompact != COMPACT_NONE)
+        {
+            if ((res = load_compact_file(cin, cfg->nSampleRate, cfg->nCompact, &cfg->sInFile, &channels, range)) != STATUS_OK)
+                return res;
+            cfg->nSampleRate = cin->sample_rate();
+            return STATUS_OK;
+        }
 
         // Load audio file
-        if ((res = load_audio_file(&in, cfg.nSampleRate, &cfg.sInFile)) != STATUS_OK)
+        if ((res = load_audio_file(in, cfg->nSampleRate, &cfg->sInFile, &channels, range)) != STATUS_OK)
             return res;
-        cfg.nSampleRate = in.sample_rate();
+        cfg->nSampleRate = in->sample_rate();
+
+        return STATUS_OK;
+    }
+
+    status_t prepare_ir(dspu::Sample *ir, size_t *latency, const config_t *cfg, const lltl::darray<size_t> *channels)
+    {
+        status_t res;
 
         // Load IR file
-        if ((res = load_audio_file(&ir, cfg.nSampleRate, &cfg.sIRFile)) != STATUS_OK)
+        if ((res = load_audio_file(ir, cfg->nSampleRate, &cfg->sIRFile, channels, NULL)) != STATUS_OK)
             return res;
 
         // Apply fades to the IR file
-        LSPString path;
-        path.set_ascii("tmp/ir-no-fades.wav");
-        save_audio_file(&ir, &path);
-        if ((res = apply_fades(&ir, &cfg)) != STATUS_OK)
+        if ((res = apply_fades(ir, cfg)) != STATUS_OK)
             return res;
-        path.set_ascii("tmp/ir-with-fades.wav");
-        save_audio_file(&ir, &path);
 
         // Apply filters to the IR
-        printf("  applying IR filters\n");
-        if ((res = apply_equalizer(&latency, &ir, &cfg)) != STATUS_OK)
+        log_info("  applying IR filters\n");
+        *latency    = 0;
+        if ((res = apply_equalizer(latency, ir, cfg)) != STATUS_OK)
             return res;
 
-        // Convolve the input file with the IR and store to output file
-        if ((res = convolve_data(&out, &in, &ir, &cfg, latency)) != STATUS_OK)
+        // Apply cheaper settings of the draft render
+        return draft_impulse_response(ir, cfg);
+    }
+
+    status_t render_sample(
+        dspu::Sample *out, const dspu::Sample *in, const CompactSample *cin, const dspu::Sample *ir,
+        size_t latency, config_t *cfg, const region_t *region, plan_t *plan)
+    {
+        status_t res;
+        draft_t draft;
+
+        // Render identical output channels of the draft once
+        if ((res = draft_paths(&draft, cfg, (cin->valid()) ? cin->channels() : in->channels(), ir)) != STATUS_OK)
+            return res;
+        if ((res = convolve_data(out, in, cin, ir, cfg, latency, region, plan)) != STATUS_OK)
             return res;
 
+        return restore_paths(out, &draft);
+    }
+
+    status_t finish_output(dspu::Sample *out, size_t in_length, const config_t *cfg, const region_t *region)
+    {
+        status_t res;
+
         // Trim file if option is specified
-        if (cfg.bTrim)
-            out.set_length(in.length());
+        if (cfg->bTrim)
+            out->set_length(in_length);
 
-        // Apply mid/side balance
-        float mid_g  = (cfg.fMid  >= MIN_GAIN) ? dspu::db_to_gain(cfg.fMid)  : 0.0f;
-        float side_g = (cfg.fSide >= MIN_GAIN) ? dspu::db_to_gain(cfg.fSide) : 0.0f;
-        apply_mid_side(&out, mid_g, side_g);
+        // Keep only the region of the output
+        if ((region != NULL) && ((res = crop_region(out, region)) != STATUS_OK))
+            return res;
 
         // Normalize file
-        float norm_gain = (cfg.fNormGain >= MIN_GAIN) ? dspu::db_to_gain(cfg.fNormGain) : 0.0f;
-        normalize(&out, norm_gain, cfg.nNormalize);
+        float norm_gain = (cfg->fNormGain >= MIN_GAIN) ? dspu::db_to_gain(cfg->fNormGain) : 0.0f;
+        return normalize(out, norm_gain, cfg->nNormalize);
+    }
+
+    status_t reserve_job(plan_t *plan, config_t *cfg)
+    {
+        status_t res;
+        audio_info_t info;
+        io::Path path, dir;
+
+        init_plan(plan);
+        if ((cfg->nMaxMemory <= 0) && (cfg->nCompact == COMPACT_NONE))
+            return STATUS_OK;
+
+        // Estimate the footprint from headers of files, so the job waits for the budget before decoding
+        if ((res = plan_job(plan, &info, cfg)) != STATUS_OK)
+            return res;
+
+        // Only the specialized pipeline processes the compact input by blocks, other strategies
+        // decode the whole input, so the compact copy would only add to the peak memory
+        if ((cfg->nCompact != COMPACT_NONE) && (plan->strategy != STRATEGY_PIPELINE))
+        {
+            log_info("  compact storage of the input is used by the specialized pipeline only, loading floating-point data\n");
+            cfg->nCompact       = COMPACT_NONE;
+            if ((res = plan_job(plan, &info, cfg)) != STATUS_OK)
+                return res;
+        }
+        if (cfg->nMaxMemory <= 0)
+        {
+            init_plan(plan);
+            return STATUS_OK;
+        }
+        if (plan->fits)
+        {
+            reserve_memory(plan, cfg->nMaxMemory);
+            return STATUS_OK;
+        }
+
+        // The out-of-core mode does not resample the input, the job is processed in memory then
+        if ((cfg->nSampleRate > 0) && (size_t(cfg->nSampleRate) != info.sample_rate))
+        {
+            reserve_memory(plan, cfg->nMaxMemory);
+            return STATUS_OK;
+        }
+
+        // Stream the job that does not fit into the budget through scratch files alongside the output file
+        if ((res = path.set(&cfg->sOutFile)) != STATUS_OK)
+            return res;
+        if ((res = path.get_parent(&dir)) != STATUS_OK)
+            res     = dir.set(".");
+        if (res != STATUS_OK)
+            return res;
+        if (!cfg->sScratchDir.set(dir.as_string()))
+            return STATUS_NO_MEM;
+
+        log_info("  estimated memory footprint %.1f MiB exceeds the budget, rendering out of core in '%s'\n",
+            mib(plan->footprint), dir.as_native());
+        init_plan(plan);
+        return STATUS_OK;
+    }
+
+    status_t render_output(
+        const dspu::Sample *in, const CompactSample *cin, const dspu::Sample *ir,
+        size_t latency, config_t *cfg, const region_t *region, const LSPString *fp, plan_t *plan)
+    {
+        status_t res;
+        dspu::Sample out;
+        size_t in_length = (cin->valid()) ? cin->length() : in->length();
+        size_t sample_rate = (cin->valid()) ? cin->sample_rate() : in->sample_rate();
+
+        // Convolve the input file with the IR, the memory reserved for the job
+        // is returned to the budget after the output file has been saved
+        res = render_sample(&out, in, cin, ir, latency, cfg, region, plan);
+
+        // Trim, crop and normalize the output
+        if (res == STATUS_OK)
+            res = finish_output(&out, in_length, cfg, region);
 
         // Export the processed audio file
-        out.set_sample_rate(in.sample_rate());
-        if ((res = save_audio_file(&out, &cfg.sOutFile)) != STATUS_OK)
+        if (res == STATUS_OK)
+        {
+            out.set_sample_rate(sample_rate);
+            res = save_audio_file(&out, &cfg->sOutFile);
+        }
+        release_memory(plan);
+        if (res == STATUS_OK)
+            res = save_shard_info(cfg);
+        if (res != STATUS_OK)
+            return res;
+
+        // Store fingerprint of the output file
+        return ((cfg->bIncremental) && (fp != NULL)) ? save_fingerprint(fp, cfg) : STATUS_OK;
+    }
+
+    status_t render_job(config_t *cfg, IRPool *pool, double *ir_time, bool *cached, bool *skipped)
+    {
+        status_t res;
+
+        // Skip the job if the output file is up to date
+        LSPString fp;
+        if ((res = check_output(&fp, skipped, cfg)) != STATUS_OK)
+            return res;
+        if (*skipped)
+            return STATUS_OK;
+        if (!cfg->sScratchDir.is_empty())
+            return render_out_of_core(cfg, &fp);
+        if (!cfg->sCueList.is_empty())
+            return render_cues(cfg, &fp);
+
+        // Wait for the memory budget before decoding, jobs that do not fit are rendered out of core
+        plan_t plan;
+        if ((res = reserve_job(&plan, cfg)) != STATUS_OK)
+            return res;
+        if (!cfg->sScratchDir.is_empty())
+            return render_out_of_core(cfg, &fp);
+
+        // Load the input file, the region of the input is known only after the IR is prepared
+        dspu::Sample in;
+        CompactSample cin;
+        region_t region;
+        bool partial = region_enabled(cfg);
+        if ((res = (partial) ? region_sample_rate(cfg) : load_input(&in, &cin, cfg, NULL)) != STATUS_OK)
+        {
+            release_memory(&plan);
             return res;
+        }
+
+        // Obtain the prepared IR from the pool
+        const dspu::Sample *ir = NULL;
+        size_t latency = 0;
+        double start = time_ms();
+        if ((res = pool->acquire(&ir, &latency, cfg, cached)) != STATUS_OK)
+        {
+            release_memory(&plan);
+            return res;
+        }
+        *ir_time    = time_ms() - start;
+
+        // Render the output file
+        if (partial)
+        {
+            if ((res = init_region(&region, cfg, ir->length(), latency, true)) == STATUS_OK)
+                res = load_input(&in, &cin, cfg, &region.input);
+        }
+        if (res == STATUS_OK)
+            res = render_output(&in, &cin, ir, latency, cfg, (partial) ? &region : NULL, &fp, &plan);
+        else
+            release_memory(&plan);
+        pool->release(ir);
+
+        return res;
+    }
+
+    int main(int argc, const char **argv)
+    {
+        config_t cfg;
+        status_t res;
+        size_t latency = 0;
+        bool up_to_date = false;
+        dspu::Sample in, ir;
+        CompactSample cin;
+        region_t region;
+        LSPString fp;
+
+        // Parse configuration
+        if ((res = parse_cmdline(&cfg, argc, argv)) != STATUS_OK)
+            return (res == STATUS_SKIP) ? STATUS_OK : res;
+
+        // Output the plan of the job without processing
+        if (cfg.nPlan != PLAN_NONE)
+            return dry_run(&cfg);
+
+        // Run as a daemon if the socket is specified
+        if (!cfg.sServe.is_empty())
+            return serve(&cfg, argc, argv);
+        // Watch the directory if it is specified
+        if (!cfg.sWatchDir.is_empty())
+            return watch(&cfg, argc, argv);
+
+        // Merge shards of the output rendered by separate processes
+        if (!cfg.sMerge.is_empty())
+            return merge_shards(&cfg);
+        // Render files of the album with tails carried across files
+        if (!cfg.sAlbum.is_empty())
+            return render_album(&cfg);
+
+        // Skip processing if the output file is up to date
+        if ((res = check_output(&fp, &up_to_date, &cfg)) != STATUS_OK)
+            return res;
+        if (up_to_date)
+            return STATUS_OK;
+
+        // Plan the job before decoding, the job that does not fit into the memory budget is rendered out of core
+        plan_t plan;
+        init_plan(&plan);
+        if ((cfg.sScratchDir.is_empty()) && (cfg.sCueList.is_empty()))
+        {
+            if ((res = reserve_job(&plan, &cfg)) != STATUS_OK)
+                return res;
+        }
+
+        if (!cfg.sScratchDir.is_empty())
+        {
+            // Render the output file out of core
+            if ((res = render_out_of_core(&cfg, &fp)) != STATUS_OK)
+                return res;
+        }
+        else if (!cfg.sCueList.is_empty())
+        {
+            // Render the output file with the IR switched at cues
+            if ((res = render_cues(&cfg, &fp)) != STATUS_OK)
+                return res;
+        }
+        else if (region_enabled(&cfg))
+        {
+            // Prepare the IR first, it defines the pre-roll of the region
+            lltl::darray<size_t> ir_channels;
+            if ((res = region_sample_rate(&cfg)) != STATUS_OK)
+                return res;
+            if ((res = select_channels(&ir_channels, &cfg, true, true)) != STATUS_OK)
+                return res;
+            if ((res = prepare_ir(&ir, &latency, &cfg, &ir_channels)) != STATUS_OK)
+                return res;
+            if ((res = init_region(&region, &cfg, ir.length(), latency, true)) != STATUS_OK)
+                return res;
+            if ((res = load_input(&in, &cin, &cfg, &region.input)) != STATUS_OK)
+                return res;
+
+            // Render the region of the output file
+            if ((res = render_output(&in, &cin, &ir, latency, &cfg, &region, &fp, &plan)) != STATUS_OK)
+                return res;
+        }
+        else
+        {
+            // Load the input file and prepare the IR, the IR is used only by this job
+            lltl::darray<size_t> ir_channels;
+            if ((res = load_input(&in, &cin, &cfg, NULL)) != STATUS_OK)
+                return res;
+            if ((res = select_channels(&ir_channels, &cfg, true, true)) != STATUS_OK)
+                return res;
+            if ((res = prepare_ir(&ir, &latency, &cfg, &ir_channels)) != STATUS_OK)
+                return res;
+
+            // Render the output file
+            if ((res = render_output(&in, &cin, &ir, latency, &cfg, NULL, &fp, &plan)) != STATUS_OK)
+                return res;
+        }
+
+        Arena *arena = thread_arena();
+        log_info("  scratch memory: peak %.1f MiB, allocated %.1f MiB in total\n",
+            mib(arena->peak()), mib(arena->total()));
 
         return STATUS_OK;
     }
 }
-
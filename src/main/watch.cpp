@@ -0,0 +1,293 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of far-screamer
+ * Created on: 18 окт. 2026 г.
+ *
+ * far-screamer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * far-screamer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with far-screamer. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <lsp-plug.in/common/types.h>
+#include <lsp-plug.in/common/status.h>
+#include <lsp-plug.in/io/Path.h>
+#include <lsp-plug.in/stdlib/stdio.h>
+#include <lsp-plug.in/stdlib/string.h>
+
+#include <private/watch.h>
+#include <private/cmdline.h>
+#include <private/tool.h>
+#include <private/IRPool.h>
+#include <private/Arena.h>
+#include <private/WorkerPool.h>
+#include <private/log.h>
+#include <private/util.h>
+
+#ifdef PLATFORM_LINUX
+    #include <errno.h>
+    #include <poll.h>
+    #include <unistd.h>
+    #include <sys/inotify.h>
+    #include <sys/stat.h>
+#endif /* PLATFORM_LINUX */
+
+#define WATCH_IR_POOL_SIZE      4
+#define WATCH_IR_POOL_SHARE     4           /* Unused prepared IRs are limited by the quarter of the memory budget */
+#define WATCH_POLL_TIMEOUT      500
+#define WATCH_EVENT_BUF_SIZE    0x4000
+
+namespace far_screamer
+{
+#ifdef PLATFORM_LINUX
+    typedef struct watcher_t
+    {
+        IRPool             *pPool;      // Pool of prepared impulse responses
+        WorkerPool         *pWorkers;   // Pool of worker threads
+        io::Path            sInDir;     // Watched directory
+        io::Path            sOutDir;    // Output directory
+        size_t              nFiles;     // Number of submitted files
+        int                 nArgc;      // Number of command line arguments
+        const char        **vArgv;      // Command line arguments
+    } watcher_t;
+
+    typedef struct task_t
+    {
+        size_t              nId;        // Identifier of the task
+        LSPString           sInFile;    // Input file
+        LSPString           sOutFile;   // Output file
+    } task_t;
+
+    static status_t execute_task(watcher_t *w, const task_t *task, bool *skipped)
+    {
+        status_t res;
+        config_t cfg;
+
+        // Configure processing from the command line, files are taken from the task
+        if ((res = parse_cmdline(&cfg, w->nArgc, w->vArgv)) != STATUS_OK)
+            return res;
+        if ((!cfg.sInFile.set(&task->sInFile)) || (!cfg.sOutFile.set(&task->sOutFile)))
+            return STATUS_NO_MEM;
+
+        double ir_time  = 0.0;
+        bool cached     = false;
+        return render_job(&cfg, w->pPool, &ir_time, &cached, skipped);
+    }
+
+    static void process_task(void *t, void *arg)
+    {
+        watcher_t *w    = static_cast<watcher_t *>(arg);
+        task_t *task    = static_cast<task_t *>(t);
+
+        log_info("File #%d: %s\n", int(task->nId), task->sInFile.get_native());
+        bool skipped    = false;
+        Arena *arena    = thread_arena();
+        arena->reset();     // Temporary buffers of the previous file are released
+        double start    = time_ms();
+        status_t res    = execute_task(w, task, &skipped);
+        double time     = time_ms() - start;
+
+        if ((res == STATUS_OK) && (skipped))
+            log_info("File #%d: %s is up to date\n", int(task->nId), task->sOutFile.get_native());
+        else if (res == STATUS_OK)
+            log_info("File #%d: %s completed in %.3f ms, peak scratch memory %.1f MiB\n",
+                int(task->nId), task->sOutFile.get_native(), time, mib(arena->peak()));
+        else
+            log_error("File #%d: %s failed with code %d\n", int(task->nId), task->sInFile.get_native(), int(res));
+        fflush(stdout);
+
+        delete task;
+    }
+
+    static status_t submit_file(watcher_t *w, const char *name)
+    {
+        status_t res;
+        io::Path in, out;
+
+        // Skip hidden and temporary files
+        if (name[0] == '.')
+            return STATUS_OK;
+
+        if ((res = in.set(&w->sInDir, name)) != STATUS_OK)
+            return res;
+        if ((res = out.set(&w->sOutDir, name)) != STATUS_OK)
+            return res;
+
+        task_t *task    = new task_t;
+        if (task == NULL)
+            return STATUS_NO_MEM;
+        task->nId       = ++w->nFiles;
+        if ((!task->sInFile.set(in.as_string())) ||
+            (!task->sOutFile.set(out.as_string())) ||
+            (!w->pWorkers->submit(task)))
+        {
+            delete task;
+            return STATUS_NO_MEM;
+        }
+
+        return STATUS_OK;
+    }
+
+    static bool same_directory(const io::Path *a, const io::Path *b)
+    {
+        struct stat sa, sb;
+        if ((stat(a->as_native(), &sa) != 0) || (stat(b->as_native(), &sb) != 0))
+            return false;
+        return (sa.st_dev == sb.st_dev) && (sa.st_ino == sb.st_ino);
+    }
+
+    static status_t watch_loop(watcher_t *w, int fd)
+    {
+        char buf[WATCH_EVENT_BUF_SIZE] __attribute__((aligned(__alignof__(struct inotify_event))));
+        struct pollfd pfd;
+
+        while (!stop_requested())
+        {
+            pfd.fd          = fd;
+            pfd.events      = POLLIN;
+            pfd.revents     = 0;
+
+            if (poll(&pfd, 1, WATCH_POLL_TIMEOUT) < 0)
+            {
+                if (errno != EINTR)
+                    return STATUS_IO_ERROR;
+                continue;
+            }
+            if (!(pfd.revents & POLLIN))
+                continue;
+
+            ssize_t n = read(fd, buf, sizeof(buf));
+            if (n < 0)
+            {
+                if ((errno == EINTR) || (errno == EAGAIN))
+                    continue;
+                return STATUS_IO_ERROR;
+            }
+
+            // Submit all completed files
+            for (ssize_t off = 0; off < n; )
+            {
+                const struct inotify_event *ev = reinterpret_cast<const struct inotify_event *>(&buf[off]);
+                off    += sizeof(struct inotify_event) + ev->len;
+
+                if (ev->mask & IN_Q_OVERFLOW)
+                    log_error("Event queue overflow, some files may be skipped\n");
+                if (ev->mask & IN_IGNORED)
+                {
+                    log_error("Watched directory has been removed\n");
+                    return STATUS_NOT_FOUND;
+                }
+                if ((ev->len <= 0) || (ev->mask & IN_ISDIR))
+                    continue;
+
+                status_t res = submit_file(w, ev->name);
+                if (res != STATUS_OK)
+                    log_error("Could not submit file '%s', error code: %d\n", ev->name, int(res));
+            }
+        }
+
+        return STATUS_OK;
+    }
+
+    status_t watch(const config_t *cfg, int argc, const char **argv)
+    {
+        status_t res;
+        IRPool pool(WATCH_IR_POOL_SIZE, cfg->nMaxMemory / WATCH_IR_POOL_SHARE);
+        WorkerPool workers;
+        watcher_t w;
+
+        if (cfg->nWorkers < 0)
+        {
+            log_error("Invalid number of workers: %d\n", int(cfg->nWorkers));
+            return STATUS_BAD_ARGUMENTS;
+        }
+
+        w.pPool         = &pool;
+        w.pWorkers      = &workers;
+        w.nFiles        = 0;
+        w.nArgc         = argc;
+        w.vArgv         = argv;
+        if ((res = w.sInDir.set(&cfg->sWatchDir)) != STATUS_OK)
+            return res;
+        if ((res = w.sOutDir.set(&cfg->sOutDir)) != STATUS_OK)
+            return res;
+
+        // Check directories, results should not be written to the watched directory
+        if (!w.sInDir.is_dir())
+        {
+            log_error("Watched path '%s' is not a directory\n", w.sInDir.as_native());
+            return STATUS_NOT_DIRECTORY;
+        }
+        if ((res = w.sOutDir.mkdir(true)) != STATUS_OK)
+        {
+            log_error("Could not create directory '%s', error code: %d\n", w.sOutDir.as_native(), int(res));
+            return res;
+        }
+        if (same_directory(&w.sInDir, &w.sOutDir))
+        {
+            log_error("Output directory should differ from the watched directory\n");
+            return STATUS_BAD_ARGUMENTS;
+        }
+
+        // Prepare the resident IR if the sample rate is known in advance
+        const dspu::Sample *ir = NULL;
+        size_t latency = 0;
+        if (cfg->nSampleRate > 0)
+        {
+            if ((res = pool.acquire(&ir, &latency, cfg, NULL)) != STATUS_OK)
+                return res;
+        }
+
+        // Watch for files which have been completely written or moved to the directory
+        int fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (fd < 0)
+        {
+            log_error("Could not initialize inotify: %s\n", strerror(errno));
+            res     = STATUS_IO_ERROR;
+        }
+        else if (inotify_add_watch(fd, w.sInDir.as_native(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_ONLYDIR) < 0)
+        {
+            log_error("Could not watch directory '%s': %s\n", w.sInDir.as_native(), strerror(errno));
+            res     = STATUS_IO_ERROR;
+        }
+        else
+        {
+            install_stop_handlers();
+            if ((res = workers.start(cfg->nWorkers, process_task, &w)) == STATUS_OK)
+            {
+                log_info("Watching directory %s with %d workers\n", w.sInDir.as_native(), int(workers.workers()));
+                fflush(stdout);
+                res     = watch_loop(&w, fd);
+                log_info("Shutting down, waiting for pending files\n");
+                fflush(stdout);
+            }
+            else
+                log_error("Could not start worker threads\n");
+            workers.stop();
+        }
+
+        if (fd >= 0)
+            close(fd);
+        if (ir != NULL)
+            pool.release(ir);
+
+        return res;
+    }
+#else
+    status_t watch(const config_t *cfg, int argc, const char **argv)
+    {
+        log_error("Watch mode is not supported on this platform\n");
+        return STATUS_NOT_SUPPORTED;
+    }
+#endif /* PLATFORM_LINUX */
+}
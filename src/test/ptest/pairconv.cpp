@@ -0,0 +1,114 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of far-screamer
+ * Created on: 18 окт. 2026 г.
+ *
+ * far-screamer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * far-screamer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with far-screamer. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <lsp-plug.in/test-fw/ptest.h>
+#include <lsp-plug.in/common/alloc.h>
+#include <lsp-plug.in/stdlib/math.h>
+#include <lsp-plug.in/stdlib/stdio.h>
+#include <lsp-plug.in/dsp/dsp.h>
+#include <lsp-plug.in/dsp-units/util/Convolver.h>
+
+#include <far-screamer/config.h>
+#include <private/Arena.h>
+#include <private/PairConvolver.h>
+
+#define BUF_LENGTH      0x10000
+
+PTEST_BEGIN("far_screamer", pairconv, 10, 100)
+
+    void call_pair(const char *label, float *dst0, float *dst1, const float *src0, const float *src1,
+        const float *ir0, const float *ir1, size_t ir_length)
+    {
+        char buf[80];
+        snprintf(buf, sizeof(buf), "%s x %d", label, int(ir_length));
+        printf("Testing %s IR samples...\n", buf);
+
+        far_screamer::Arena *arena  = far_screamer::thread_arena();
+        size_t mark                 = arena->mark();
+        far_screamer::PairConvolver cv;
+        if (!cv.init(ir0, ir1, ir_length, CONV_RANK))
+            PTEST_FAIL_MSG("Could not initialize convolver");
+
+        PTEST_LOOP(buf,
+            cv.process(dst0, dst1, src0, src1, BUF_LENGTH);
+        );
+
+        cv.destroy();
+        arena->rewind(mark);
+    }
+
+    void call_convolvers(const char *label, float *dst0, float *dst1, const float *src0, const float *src1,
+        const float *ir0, const float *ir1, size_t ir_length)
+    {
+        char buf[80];
+        snprintf(buf, sizeof(buf), "%s x %d", label, int(ir_length));
+        printf("Testing %s IR samples...\n", buf);
+
+        dspu::Convolver cv0, cv1;
+        if ((!cv0.init(ir0, ir_length, CONV_RANK, 0)) || (!cv1.init(ir1, ir_length, CONV_RANK, 0)))
+            PTEST_FAIL_MSG("Could not initialize convolvers");
+
+        PTEST_LOOP(buf,
+            cv0.process(dst0, src0, BUF_LENGTH);
+            cv1.process(dst1, src1, BUF_LENGTH);
+        );
+
+        cv0.destroy();
+        cv1.destroy();
+    }
+
+    PTEST_MAIN
+    {
+        static const size_t ir_lengths[] = { 0x1000, 0x8000, 0x20000 };
+        const size_t max_ir = 0x20000;
+
+        uint8_t *data   = NULL;
+        float *src0     = alloc_aligned<float>(data, BUF_LENGTH * 4 + max_ir * 2);
+        if (src0 == NULL)
+            PTEST_FAIL_MSG("Could not allocate data");
+        float *src1     = &src0[BUF_LENGTH];
+        float *dst0     = &src1[BUF_LENGTH];
+        float *dst1     = &dst0[BUF_LENGTH];
+        float *ir0      = &dst1[BUF_LENGTH];
+        float *ir1      = &ir0[max_ir];
+
+        for (size_t i=0; i<BUF_LENGTH; ++i)
+        {
+            src0[i]         = float(rand()) / RAND_MAX - 0.5f;
+            src1[i]         = float(rand()) / RAND_MAX - 0.5f;
+        }
+        for (size_t i=0; i<max_ir; ++i)
+        {
+            ir0[i]          = (float(rand()) / RAND_MAX - 0.5f) * expf(-5.0f * i / max_ir);
+            ir1[i]          = (float(rand()) / RAND_MAX - 0.5f) * expf(-5.0f * i / max_ir);
+        }
+
+        for (size_t i=0; i<sizeof(ir_lengths)/sizeof(size_t); ++i)
+        {
+            call_convolvers("2 x dspu::Convolver", dst0, dst1, src0, src1, ir0, ir1, ir_lengths[i]);
+            call_pair("PairConvolver", dst0, dst1, src0, src1, ir0, ir1, ir_lengths[i]);
+            PTEST_SEPARATOR;
+        }
+
+        free_aligned(data);
+    }
+
+PTEST_END
@@ -0,0 +1,87 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of far-screamer
+ * Created on: 18 окт. 2026 г.
+ *
+ * far-screamer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * far-screamer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with far-screamer. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <lsp-plug.in/test-fw/utest.h>
+#include <lsp-plug.in/test-fw/helpers.h>
+#include <lsp-plug.in/common/alloc.h>
+#include <lsp-plug.in/stdlib/math.h>
+#include <lsp-plug.in/dsp/dsp.h>
+
+#include <private/analysis.h>
+
+#define IR_LENGTH       0x2000
+
+UTEST_BEGIN("far_screamer", analysis)
+
+    void test_sparse_head(float *ir)
+    {
+        lltl::darray<far_screamer::tap_t> taps;
+        far_screamer::tap_t *t;
+
+        // Three discrete reflections followed by the dense tail
+        dsp::fill_zero(ir, IR_LENGTH);
+        ir[100]     = 1.0f;
+        ir[400]     = -0.5f;
+        ir[700]     = 0.25f;
+        for (size_t i=1000; i<IR_LENGTH; ++i)
+            ir[i]       = ((i & 1) ? 0.1f : -0.1f) * expf(-1e-3f * (i - 1000));
+
+        UTEST_ASSERT(far_screamer::find_sparse_head(&taps, ir, IR_LENGTH, 1e-6f) == 1000);
+        UTEST_ASSERT(taps.size() == 3);
+        UTEST_ASSERT((t = taps.uget(0)) != NULL);
+        UTEST_ASSERT((t->offset == 100) && (float_equals_absolute(t->gain, 1.0f)));
+        UTEST_ASSERT((t = taps.uget(1)) != NULL);
+        UTEST_ASSERT((t->offset == 400) && (float_equals_absolute(t->gain, -0.5f)));
+        UTEST_ASSERT((t = taps.uget(2)) != NULL);
+        UTEST_ASSERT((t->offset == 700) && (float_equals_absolute(t->gain, 0.25f)));
+
+        // Reflections below the threshold are considered to be silent
+        ir[500]     = 1e-7f;
+        UTEST_ASSERT(far_screamer::find_sparse_head(&taps, ir, IR_LENGTH, 1e-6f) == 1000);
+        UTEST_ASSERT(taps.size() == 3);
+
+        // Dense cluster of reflections starts the dense part
+        ir[300]     = 0.1f;
+        ir[301]     = 0.1f;
+        ir[302]     = 0.1f;
+        UTEST_ASSERT(far_screamer::find_sparse_head(&taps, ir, IR_LENGTH, 1e-6f) == 300);
+        UTEST_ASSERT(taps.size() == 1);
+
+        // Too short sparse head should be ignored
+        ir[120]     = 0.1f;
+        ir[121]     = 0.1f;
+        ir[122]     = 0.1f;
+        UTEST_ASSERT(far_screamer::find_sparse_head(&taps, ir, IR_LENGTH, 1e-6f) == 0);
+        UTEST_ASSERT(taps.size() == 0);
+    }
+
+    UTEST_MAIN
+    {
+        uint8_t *data   = NULL;
+        float *ir       = alloc_aligned<float>(data, IR_LENGTH);
+        UTEST_ASSERT(ir != NULL);
+
+        test_sparse_head(ir);
+
+        free_aligned(data);
+    }
+
+UTEST_END
@@ -0,0 +1,127 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of far-screamer
+ * Created on: 18 окт. 2026 г.
+ *
+ * far-screamer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * far-screamer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with far-screamer. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <lsp-plug.in/test-fw/utest.h>
+#include <lsp-plug.in/test-fw/helpers.h>
+#include <lsp-plug.in/lltl/darray.h>
+#include <lsp-plug.in/runtime/LSPString.h>
+#include <lsp-plug.in/stdlib/stdio.h>
+#include <lsp-plug.in/stdlib/string.h>
+#include <lsp-plug.in/dsp-units/sampling/Sample.h>
+
+#include <private/checkpoint.h>
+
+#include "fixtures.h"
+
+#define SAMPLE_RATE         8000
+#define SEGMENT_LENGTH      0x10000                         /* One second of checkpoint interval is aligned to the segment */
+#define IN_LENGTH           (SEGMENT_LENGTH * 5 + 1234)
+#define IR_LENGTH           (SAMPLE_RATE / 10)
+
+UTEST_BEGIN("far_screamer", checkpoint)
+
+    void make_file(LSPString *path, const char *name, size_t length, float decay, uint32_t seed)
+    {
+        dspu::Sample s;
+        UTEST_ASSERT(far_screamer::test::make_noise(&s, 2, length, SAMPLE_RATE, decay, seed));
+        UTEST_ASSERT(far_screamer::test::save_temp_file(path, &s, tempdir(), full_name(), name) == STATUS_OK);
+    }
+
+    int render(const LSPString *out, const LSPString *in, const LSPString *ir, bool resume)
+    {
+        const char *argv[] =
+        {
+            "-if", in->get_native(),
+            "-ir", ir->get_native(),
+            "-of", out->get_native(),
+            "-oc", tempdir(),
+            "-ck", "1",
+            "-pd", "10",
+            "-sb", "-3",
+            (resume) ? "-ru" : NULL,
+            NULL
+        };
+
+        return far_screamer::test::run_tool(argv);
+    }
+
+    void load_bytes(lltl::darray<uint8_t> *dst, const LSPString *name)
+    {
+        uint8_t buf[0x1000];
+        FILE *fd = fopen(name->get_native(), "rb");
+        UTEST_ASSERT_MSG(fd != NULL, "could not open file '%s'", name->get_native());
+
+        size_t read;
+        while ((read = fread(buf, 1, sizeof(buf), fd)) > 0)
+        {
+            uint8_t *ptr = dst->append_n(read);
+            UTEST_ASSERT(ptr != NULL);
+            memcpy(ptr, buf, read);
+        }
+        fclose(fd);
+    }
+
+    UTEST_MAIN
+    {
+        LSPString in, ir, ref, out;
+        lltl::darray<uint8_t> a, b;
+
+        make_file(&in, "in.wav", IN_LENGTH, 0.0f, 1);
+        make_file(&ir, "ir.wav", IR_LENGTH, 5.0f / IR_LENGTH, 2);
+        UTEST_ASSERT(far_screamer::test::temp_path(&ref, tempdir(), full_name(), "ref.wav"));
+        UTEST_ASSERT(far_screamer::test::temp_path(&out, tempdir(), full_name(), "out.wav"));
+
+        printf("Testing uninterrupted checkpointed render\n");
+        int res = render(&ref, &in, &ir, false);
+        UTEST_ASSERT_MSG(res == STATUS_OK, "uninterrupted render failed with code %d", res);
+
+        // Stop the render after two segments, then after one more segment, then complete it
+        printf("Testing interrupted checkpointed render\n");
+        far_screamer::limit_checkpoints(2);
+        res = render(&out, &in, &ir, false);
+        UTEST_ASSERT_MSG(res == STATUS_CANCELLED, "interrupted render returned code %d", res);
+        UTEST_ASSERT(far_screamer::test::file_exists(&out, ".checkpoint"));
+        UTEST_ASSERT(far_screamer::test::file_exists(&out, ".partial"));
+
+        printf("Testing resumed checkpointed render\n");
+        far_screamer::limit_checkpoints(1);
+        res = render(&out, &in, &ir, true);
+        UTEST_ASSERT_MSG(res == STATUS_CANCELLED, "interrupted render returned code %d", res);
+
+        far_screamer::limit_checkpoints(0);
+        res = render(&out, &in, &ir, true);
+        UTEST_ASSERT_MSG(res == STATUS_OK, "resumed render failed with code %d", res);
+        UTEST_ASSERT(!far_screamer::test::file_exists(&out, ".checkpoint"));
+        UTEST_ASSERT(!far_screamer::test::file_exists(&out, ".partial"));
+
+        // The resumed render should match the uninterrupted one byte for byte
+        load_bytes(&a, &ref);
+        load_bytes(&b, &out);
+        UTEST_ASSERT_MSG(a.size() == b.size(), "file size %d != %d", int(a.size()), int(b.size()));
+        UTEST_ASSERT(memcmp(a.array(), b.array(), a.size()) == 0);
+
+        far_screamer::test::remove_file(&in);
+        far_screamer::test::remove_file(&ir);
+        far_screamer::test::remove_file(&ref);
+        far_screamer::test::remove_file(&out);
+    }
+
+UTEST_END
@@ -26,7 +26,7 @@
 #include <lsp-plug.in/io/Path.h>
 #include <lsp-plug.in/dsp-units/filters/common.h>
 
-#include <private/config.h>
+#include <far-screamer/config.h>
 #include <private/cmdline.h>
 
 UTEST_BEGIN("far_screamer", cmdline)
@@ -52,6 +52,36 @@ UTEST_BEGIN("far_screamer", cmdline)
         UTEST_ASSERT(float_equals_absolute(cfg->fNormGain, -3.0f));
         UTEST_ASSERT(cfg->nNormalize == far_screamer::NORM_ALWAYS);
         UTEST_ASSERT(cfg->bTrim == true);
+        UTEST_ASSERT(cfg->bDecimate == true);
+        UTEST_ASSERT(cfg->bDraft == true);
+        UTEST_ASSERT(cfg->bIncremental == true);
+        UTEST_ASSERT(float_equals_absolute(cfg->fTailThreshold, -90.0f));
+        UTEST_ASSERT(float_equals_absolute(cfg->fTailWindow, 250.0f));
+        UTEST_ASSERT(float_equals_absolute(cfg->fSparse, -100.0f));
+        UTEST_ASSERT(float_equals_absolute(cfg->fMultirateSplit, 150.0f));
+        UTEST_ASSERT(cfg->nMultirateFactor == 8);
+        UTEST_ASSERT(cfg->sServe.equals_ascii("far-screamer.sock"));
+        UTEST_ASSERT(cfg->nWorkers == 3);
+        UTEST_ASSERT(cfg->sWatchDir.is_empty());
+        UTEST_ASSERT(cfg->sOutDir.equals_ascii("out-dir"));
+        UTEST_ASSERT(cfg->sWetCache.equals_ascii("wet-cache"));
+        UTEST_ASSERT(cfg->nWetCacheLimit == (wsize_t(1) << 28));
+        UTEST_ASSERT(cfg->sScratchDir.equals_ascii("scratch-dir"));
+        UTEST_ASSERT(cfg->nMaxMemory == (wsize_t(3) << 29));
+        UTEST_ASSERT(cfg->nPlan == far_screamer::PLAN_JSON);
+        UTEST_ASSERT(cfg->nCompact == far_screamer::COMPACT_HALF);
+        UTEST_ASSERT(cfg->fStart == 62.5);
+        UTEST_ASSERT(cfg->fEnd == 3675.25);
+        UTEST_ASSERT(float_equals_absolute(cfg->fCheckpoint, 300.0f));
+        UTEST_ASSERT(cfg->bResume == true);
+        UTEST_ASSERT(cfg->sMerge.size() == 2);
+        UTEST_ASSERT(cfg->sMerge.uget(0)->equals_ascii("shard-0.wav"));
+        UTEST_ASSERT(cfg->sMerge.uget(1)->equals_ascii("shard-1.wav"));
+        UTEST_ASSERT(cfg->sAlbum.size() == 2);
+        UTEST_ASSERT(cfg->sAlbum.uget(0)->equals_ascii("track-1.wav"));
+        UTEST_ASSERT(cfg->sAlbum.uget(1)->equals_ascii("track-2.wav"));
+        UTEST_ASSERT(float_equals_absolute(cfg->fCueFade, 20.0f));
+        UTEST_ASSERT(cfg->sCueList.is_empty());
 
         // Check channel mapping
         UTEST_ASSERT(cfg->sMapping.size() == 3);
@@ -113,8 +143,34 @@ UTEST_BEGIN("far_screamer", cmdline)
             "-lp",  "RLC_BT:2:100.0",
             "-hp",  "LRX_MT:3:10000.0:12",
             "-tl",
+            "-dc",
+            "-dr",
+            "-ic",
             "-ng",  "-3.0",
             "-n",   "ALWAYS",
+            "-tt",  "-90",
+            "-tw",  "250",
+            "-st",  "-100",
+            "-ms",  "150",
+            "-mf",  "8",
+            "-sv",  "far-screamer.sock",
+            "-wk",  "3",
+            "-od",  "out-dir",
+            "-wc",  "wet-cache",
+            "-wl",  "256M",
+            "-mm",  "1.5G",
+            "-pl",  "json",
+            "-oc",  "scratch-dir",
+            "-ci",  "half",
+            "-rs",  "1:02.5",
+            "-re",  "1:01:15.25",
+            "-ck",  "300",
+            "-ru",
+            "-mg",  "shard-0.wav",
+            "-mg",  "shard-1.wav",
+            "-al",  "track-1.wav",
+            "-al",  "track-2.wav",
+            "-cf",  "20",
 
             NULL
         };
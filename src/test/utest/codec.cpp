@@ -0,0 +1,338 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of far-screamer
+ * Created on: 18 окт. 2026 г.
+ *
+ * far-screamer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * far-screamer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with far-screamer. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <lsp-plug.in/test-fw/utest.h>
+#include <lsp-plug.in/test-fw/helpers.h>
+#include <lsp-plug.in/io/Path.h>
+#include <lsp-plug.in/lltl/darray.h>
+#include <lsp-plug.in/stdlib/math.h>
+#include <lsp-plug.in/stdlib/stdio.h>
+#include <lsp-plug.in/stdlib/string.h>
+#include <lsp-plug.in/dsp-units/sampling/Sample.h>
+
+#include <private/AudioReader.h>
+#include <private/AudioWriter.h>
+
+#define CHANNELS            3
+#define LENGTH              0x30011     /* Several blocks of raw data of the reader */
+#define SAMPLE_RATE         48000
+#define READ_FRAMES         1000        /* Not aligned to blocks of the reader */
+#define WAVE_FORMAT_PCM     0x0001
+#define WAVE_FORMAT_FLOAT   0x0003
+
+UTEST_BEGIN("far_screamer", codec)
+
+    typedef struct format_t
+    {
+        const char *name;
+        size_t      tag;
+        size_t      bits;
+    } format_t;
+
+    // Wave64 GUIDs of chunks
+    const uint8_t *w64_guid(const char *id)
+    {
+        static const uint8_t riff[] = { 'r', 'i', 'f', 'f', 0x2e, 0x91, 0xcf, 0x11, 0xa5, 0xd6, 0x28, 0xdb, 0x04, 0xc1, 0x00, 0x00 };
+        static const uint8_t wave[] = { 'w', 'a', 'v', 'e', 0xf3, 0xac, 0xd3, 0x11, 0x8c, 0xd1, 0x00, 0xc0, 0x4f, 0x8e, 0xdb, 0x8a };
+        static const uint8_t fmt[]  = { 'f', 'm', 't', ' ', 0xf3, 0xac, 0xd3, 0x11, 0x8c, 0xd1, 0x00, 0xc0, 0x4f, 0x8e, 0xdb, 0x8a };
+        static const uint8_t data[] = { 'd', 'a', 't', 'a', 0xf3, 0xac, 0xd3, 0x11, 0x8c, 0xd1, 0x00, 0xc0, 0x4f, 0x8e, 0xdb, 0x8a };
+
+        if (!strcmp(id, "riff"))
+            return riff;
+        if (!strcmp(id, "wave"))
+            return wave;
+        return (!strcmp(id, "fmt ")) ? fmt : data;
+    }
+
+    void put(lltl::darray<uint8_t> *dst, uint64_t v, size_t bytes)
+    {
+        uint8_t *p = dst->add_n(bytes);
+        UTEST_ASSERT(p != NULL);
+        for (size_t i=0; i<bytes; ++i, v >>= 8)
+            p[i]    = uint8_t(v);
+    }
+
+    void put_id(lltl::darray<uint8_t> *dst, const void *id, size_t bytes)
+    {
+        uint8_t *p = dst->add_n(bytes);
+        UTEST_ASSERT(p != NULL);
+        memcpy(p, id, bytes);
+    }
+
+    /**
+     * Quantize the signal the same way as the encoder of the format does,
+     * the result is exactly representable by the decoded floating-point value
+     */
+    void quantize(float *dst, const float *src, size_t count, const format_t *f)
+    {
+        if (f->tag == WAVE_FORMAT_FLOAT)
+        {
+            memcpy(dst, src, count * sizeof(float));
+            return;
+        }
+
+        double scale    = double(1ULL << (f->bits - 1));
+        for (size_t i=0; i<count; ++i)
+        {
+            double v        = floor(double(src[i]) * scale + 0.5);
+            v               = lsp_limit(v, -scale, scale - 1.0);
+            dst[i]          = float(v / scale);
+        }
+    }
+
+    void encode(lltl::darray<uint8_t> *dst, const float *data, size_t count, const format_t *f)
+    {
+        size_t bytes    = f->bits >> 3;
+        double scale    = double(1ULL << (f->bits - 1));
+        for (size_t i=0; i<count; ++i)
+        {
+            if (f->tag == WAVE_FORMAT_FLOAT)
+            {
+                uint32_t v;
+                memcpy(&v, &data[i], sizeof(float));
+                put(dst, v, sizeof(uint32_t));
+            }
+            else
+                put(dst, uint64_t(int64_t(double(data[i]) * scale)), bytes);
+        }
+    }
+
+    void make_fmt(lltl::darray<uint8_t> *dst, const format_t *f)
+    {
+        size_t align    = CHANNELS * (f->bits >> 3);
+        put(dst, f->tag, 2);
+        put(dst, CHANNELS, 2);
+        put(dst, SAMPLE_RATE, 4);
+        put(dst, SAMPLE_RATE * align, 4);
+        put(dst, align, 2);
+        put(dst, f->bits, 2);
+    }
+
+    void save_file(const io::Path *path, const lltl::darray<uint8_t> *data)
+    {
+        FILE *fd = fopen(path->as_native(), "wb");
+        UTEST_ASSERT(fd != NULL);
+        UTEST_ASSERT(fwrite(data->array(), 1, data->size(), fd) == data->size());
+        UTEST_ASSERT(fclose(fd) == 0);
+    }
+
+    void write_wav(const io::Path *path, const lltl::darray<uint8_t> *pcm, const format_t *f)
+    {
+        lltl::darray<uint8_t> file, fmt;
+        make_fmt(&fmt, f);
+
+        put_id(&file, "RIFF", 4);
+        put(&file, 4 + 8 + fmt.size() + 8 + pcm->size(), 4);
+        put_id(&file, "WAVE", 4);
+        put_id(&file, "fmt ", 4);
+        put(&file, fmt.size(), 4);
+        put_id(&file, fmt.array(), fmt.size());
+        put_id(&file, "data", 4);
+        put(&file, pcm->size(), 4);
+        put_id(&file, pcm->array(), pcm->size());
+
+        save_file(path, &file);
+    }
+
+    void write_w64(const io::Path *path, const lltl::darray<uint8_t> *pcm, const format_t *f)
+    {
+        lltl::darray<uint8_t> file, fmt;
+        make_fmt(&fmt, f);
+
+        // Chunks are aligned to 8 bytes, sizes include headers of chunks
+        size_t fmt_chunk    = 24 + ((fmt.size() + 7) & ~size_t(7));
+        put_id(&file, w64_guid("riff"), 16);
+        put(&file, 40 + fmt_chunk + 24 + pcm->size(), 8);
+        put_id(&file, w64_guid("wave"), 16);
+        put_id(&file, w64_guid("fmt "), 16);
+        put(&file, 24 + fmt.size(), 8);
+        put_id(&file, fmt.array(), fmt.size());
+        while (file.size() < 40 + fmt_chunk)
+            put(&file, 0, 1);
+        put_id(&file, w64_guid("data"), 16);
+        put(&file, 24 + pcm->size(), 8);
+        put_id(&file, pcm->array(), pcm->size());
+
+        save_file(path, &file);
+    }
+
+    void write_rf64(const io::Path *path, const float * const *data)
+    {
+        far_screamer::AudioWriter wr;
+        UTEST_ASSERT(wr.open(path, CHANNELS, LENGTH, SAMPLE_RATE, true) == STATUS_OK);
+        for (size_t offset=0; offset < LENGTH; )
+        {
+            const float *ptr[CHANNELS];
+            size_t to_do    = lsp_min(size_t(LENGTH - offset), size_t(READ_FRAMES));
+            for (size_t i=0; i<CHANNELS; ++i)
+                ptr[i]          = &data[i][offset];
+            UTEST_ASSERT(wr.write(ptr, to_do) == ssize_t(to_do));
+            offset         += to_do;
+        }
+        UTEST_ASSERT(wr.close() == STATUS_OK);
+
+        // The header should be promoted to RF64 although the file fits into 4 GiB
+        char id[4];
+        FILE *fd = fopen(path->as_native(), "rb");
+        UTEST_ASSERT(fd != NULL);
+        UTEST_ASSERT(fread(id, sizeof(id), 1, fd) == 1);
+        fclose(fd);
+        UTEST_ASSERT(!memcmp(id, "RF64", 4));
+    }
+
+    void read_file(dspu::Sample *dst, const io::Path *path)
+    {
+        far_screamer::AudioReader rd;
+        UTEST_ASSERT(rd.open(path) == STATUS_OK);
+        UTEST_ASSERT_MSG(rd.native(), "file '%s' should be decoded by the built-in codec", path->as_native());
+        UTEST_ASSERT(rd.channels() == CHANNELS);
+        UTEST_ASSERT(rd.length() == LENGTH);
+        UTEST_ASSERT(rd.sample_rate() == SAMPLE_RATE);
+        UTEST_ASSERT(dst->init(CHANNELS, LENGTH, LENGTH));
+
+        for (size_t offset=0; offset < LENGTH; )
+        {
+            float *ptr[CHANNELS];
+            for (size_t i=0; i<CHANNELS; ++i)
+                ptr[i]          = &dst->channel(i)[offset];
+            ssize_t read    = rd.read(ptr, READ_FRAMES);
+            UTEST_ASSERT_MSG(read > 0, "unexpected end of file '%s' at frame %d", path->as_native(), int(offset));
+            offset         += read;
+        }
+
+        float tail;
+        float *ptr[CHANNELS] = { &tail, &tail, &tail };
+        UTEST_ASSERT(rd.read(ptr, 1) == 0);
+        rd.close();
+    }
+
+    void compare(const dspu::Sample *s, const float * const *expected, const char *what)
+    {
+        UTEST_ASSERT(s->channels() == CHANNELS);
+        UTEST_ASSERT(s->length() == LENGTH);
+        for (size_t i=0; i<CHANNELS; ++i)
+        {
+            const float *v = s->channel(i);
+            for (size_t j=0; j<LENGTH; ++j)
+                UTEST_ASSERT_MSG(v[j] == expected[i][j],
+                    "%s: channel %d sample %d: %.10f != %.10f", what, int(i), int(j), v[j], expected[i][j]);
+        }
+    }
+
+    void test_file(const io::Path *path, const float * const *expected, const char *what)
+    {
+        dspu::Sample decoded, loaded;
+
+        // The built-in codec should produce the same samples as the library
+        read_file(&decoded, path);
+        compare(&decoded, expected, what);
+
+        UTEST_ASSERT(loaded.load(path) == STATUS_OK);
+        UTEST_ASSERT(loaded.sample_rate() == SAMPLE_RATE);
+        compare(&loaded, expected, what);
+
+        path->remove();
+    }
+
+    void make_path(io::Path *path, const char *name)
+    {
+        char buf[0x100];
+        snprintf(buf, sizeof(buf), "utest-%s-%s", full_name(), name);
+        UTEST_ASSERT(path->set(tempdir()) == STATUS_OK);
+        UTEST_ASSERT(path->append_child(buf) == STATUS_OK);
+    }
+
+    UTEST_MAIN
+    {
+        static const format_t formats[] =
+        {
+            { "pcm16",   WAVE_FORMAT_PCM,   16 },
+            { "pcm24",   WAVE_FORMAT_PCM,   24 },
+            { "pcm32",   WAVE_FORMAT_PCM,   32 },
+            { "float32", WAVE_FORMAT_FLOAT, 32 },
+        };
+
+        dspu::Sample src, exp;
+        UTEST_ASSERT(src.init(CHANNELS, LENGTH, LENGTH));
+        UTEST_ASSERT(exp.init(CHANNELS, LENGTH, LENGTH));
+
+        // Pseudo-random 24-bit signal which covers the whole range including the full scale values
+        uint32_t seed = 1;
+        for (size_t i=0; i<CHANNELS; ++i)
+        {
+            float *dst = src.channel(i);
+            for (size_t j=0; j<LENGTH; ++j)
+            {
+                seed            = seed * 1664525 + 1013904223;
+                dst[j]          = float(int32_t(seed) >> 8) * (1.0f / 8388608.0f);
+            }
+            dst[0]          = -1.0f;
+            dst[1]          = 0.0f;
+        }
+
+        const float *expected[CHANNELS];
+        for (size_t i=0; i<CHANNELS; ++i)
+            expected[i]     = exp.channel(i);
+
+        for (size_t k=0; k<sizeof(formats)/sizeof(format_t); ++k)
+        {
+            const format_t *f = &formats[k];
+            char name[64];
+            io::Path path;
+
+            // Interleave the quantized signal
+            lltl::darray<float> frames;
+            float *p = frames.add_n(CHANNELS * LENGTH);
+            UTEST_ASSERT(p != NULL);
+            for (size_t i=0; i<CHANNELS; ++i)
+                quantize(exp.channel(i), src.channel(i), LENGTH, f);
+            for (size_t j=0; j<LENGTH; ++j)
+                for (size_t i=0; i<CHANNELS; ++i)
+                    *(p++)          = expected[i][j];
+
+            lltl::darray<uint8_t> pcm;
+            encode(&pcm, frames.array(), frames.size(), f);
+
+            printf("Testing %s WAV file\n", f->name);
+            snprintf(name, sizeof(name), "%s.wav", f->name);
+            make_path(&path, name);
+            write_wav(&path, &pcm, f);
+            test_file(&path, expected, name);
+
+            printf("Testing %s W64 file\n", f->name);
+            snprintf(name, sizeof(name), "%s.w64", f->name);
+            make_path(&path, name);
+            write_w64(&path, &pcm, f);
+            test_file(&path, expected, name);
+        }
+
+        // The writer encodes 32-bit floating-point data only
+        printf("Testing float32 RF64 file\n");
+        io::Path path;
+        make_path(&path, "float32-rf64.wav");
+        const float *data[CHANNELS];
+        for (size_t i=0; i<CHANNELS; ++i)
+            data[i]         = src.channel(i);
+        write_rf64(&path, data);
+        test_file(&path, data, "float32-rf64.wav");
+    }
+
+UTEST_END
@@ -0,0 +1,177 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of far-screamer
+ * Created on: 18 окт. 2026 г.
+ *
+ * far-screamer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * far-screamer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with far-screamer. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <lsp-plug.in/test-fw/utest.h>
+#include <lsp-plug.in/test-fw/helpers.h>
+#include <lsp-plug.in/stdlib/math.h>
+#include <lsp-plug.in/stdlib/stdio.h>
+#include <lsp-plug.in/dsp-units/sampling/Sample.h>
+
+#include <far-screamer/config.h>
+#include <private/CompactSample.h>
+
+#define SAMPLE_RATE         48000
+#define LENGTH              0x1001      /* Not aligned to the storage */
+
+UTEST_BEGIN("far_screamer", compact)
+
+    typedef struct sample_t
+    {
+        float       in;         // Encoded value
+        float       out;        // Expected decoded value
+    } sample_t;
+
+    void check_values(size_t format, const char *name, const sample_t *values, size_t count, size_t clipped)
+    {
+        far_screamer::CompactSample cs;
+        float buf[0x20];
+
+        printf("Testing conversion of %s values\n", name);
+        UTEST_ASSERT(count <= sizeof(buf) / sizeof(float));
+        UTEST_ASSERT(cs.init(2, count, SAMPLE_RATE, format) == STATUS_OK);
+
+        // Write values to the second channel to check the layout of channels
+        for (size_t i=0; i<count; ++i)
+            cs.write(1, i, &values[i].in, 1);
+        UTEST_ASSERT_MSG(cs.clipped() == clipped, "%s: clipped %d != %d", name, int(cs.clipped()), int(clipped));
+
+        cs.read(buf, 1, 0, count);
+        for (size_t i=0; i<count; ++i)
+        {
+            float v = buf[i];
+            bool same = (isnan(values[i].out)) ? isnan(v) : (v == values[i].out);
+            UTEST_ASSERT_MSG(same, "%s: value %.10g decoded as %.10g, expected %.10g",
+                name, values[i].in, v, values[i].out);
+        }
+
+        // The first channel stays silent
+        cs.read(buf, 0, 0, count);
+        for (size_t i=0; i<count; ++i)
+            UTEST_ASSERT_MSG(buf[i] == 0.0f, "%s: sample %d of silent channel is %.10g", name, int(i), buf[i]);
+    }
+
+    void check_round_trip(size_t format, const char *name, size_t bits)
+    {
+        dspu::Sample src, dst;
+        far_screamer::CompactSample cs;
+
+        // Random values with the specified number of significant bits should be restored as is
+        printf("Testing round trip of %s sample\n", name);
+        UTEST_ASSERT(src.init(3, LENGTH, LENGTH));
+        src.set_sample_rate(SAMPLE_RATE);
+        float scale     = 1.0f / float(1 << (bits - 1));
+        uint32_t seed   = 1;
+        for (size_t i=0; i<src.channels(); ++i)
+        {
+            float *p = src.channel(i);
+            for (size_t j=0; j<LENGTH; ++j)
+            {
+                seed            = seed * 1664525 + 1013904223;
+                p[j]            = float(int32_t(seed) >> (32 - bits)) * scale;
+            }
+        }
+
+        UTEST_ASSERT(cs.encode(&src, format) == STATUS_OK);
+        UTEST_ASSERT(cs.clipped() == 0);
+        UTEST_ASSERT(cs.decode(&dst) == STATUS_OK);
+        UTEST_ASSERT(dst.channels() == src.channels());
+        UTEST_ASSERT(dst.length() == src.length());
+        UTEST_ASSERT(dst.sample_rate() == SAMPLE_RATE);
+        for (size_t i=0; i<src.channels(); ++i)
+        {
+            const float *a  = src.channel(i);
+            const float *b  = dst.channel(i);
+            for (size_t j=0; j<LENGTH; ++j)
+                UTEST_ASSERT_MSG(a[j] == b[j], "%s: channel %d sample %d: %.10g != %.10g",
+                    name, int(i), int(j), a[j], b[j]);
+        }
+    }
+
+    UTEST_MAIN
+    {
+        static const float i16 = 1.0f / 32768.0f;
+        static const float i24 = 1.0f / 8388608.0f;
+
+        // Samples at the limits of the range are clipped to the nearest value
+        static const sample_t int16_values[] =
+        {
+            { 0.0f,                 0.0f                },
+            { 0.5f,                 0.5f                },
+            { -i16,                 -i16                },
+            { 1.4f * i16,           i16                 },
+            { 2.5f * i16,           2.0f * i16          },  // Rounds to the nearest even
+            { -1.0f,                -1.0f               },
+            { 1.0f,                 1.0f - i16          },  // Clipped
+            { 1.5f,                 1.0f - i16          },  // Clipped
+            { -1.5f,                -1.0f               },  // Clipped
+        };
+
+        // Negative values should restore the sign from the packed 24 bits
+        static const sample_t int24_values[] =
+        {
+            { 0.0f,                 0.0f                },
+            { i24,                  i24                 },
+            { -i24,                 -i24                },
+            { -0.5f,                -0.5f               },
+            { -0.25f - i24,         -0.25f - i24        },
+            { 0.5f - i24,           0.5f - i24          },
+            { -1.0f,                -1.0f               },
+            { 1.0f,                 1.0f - i24          },  // Clipped
+            { -2.0f,                -1.0f               },  // Clipped
+        };
+
+        // Values are rounded to the nearest even, overflow turns to infinity
+        static const sample_t half_values[] =
+        {
+            { 0.0f,                 0.0f                },
+            { -2.5f,                -2.5f               },
+            { 1.0f + 1.0f / 2048,   1.0f                },  // Halfway, rounds down to even
+            { 1.0f + 3.0f / 2048,   1.0f + 1.0f / 512   },  // Halfway, rounds up to even
+            { 1.0f + 1.5f / 2048,   1.0f + 1.0f / 1024  },  // Above halfway
+            { 65504.0f,             65504.0f            },  // Maximum value
+            { 65519.0f,             65504.0f            },
+            { 65520.0f,             INFINITY            },  // Overflow
+            { -1e+10f,              -INFINITY           },
+            { INFINITY,             INFINITY            },
+            { NAN,                  NAN                 },
+            { ldexpf(1.0f, -14),    ldexpf(1.0f, -14)   },  // Minimum normal value
+            { ldexpf(1.0f, -24),    ldexpf(1.0f, -24)   },  // Minimum subnormal value
+            { ldexpf(3.0f, -24),    ldexpf(3.0f, -24)   },
+            { ldexpf(1.0f, -25),    0.0f                },  // Halfway, rounds down to zero
+            { ldexpf(3.0f, -25),    ldexpf(1.0f, -23)   },  // Halfway, rounds up to even
+            { -ldexpf(5.0f, -24),   -ldexpf(5.0f, -24)  },
+            { ldexpf(1.0f, -14) - ldexpf(1.0f, -26), ldexpf(1.0f, -14) },  // Subnormal rounds to normal
+        };
+
+        check_values(far_screamer::COMPACT_INT16, "int16", int16_values, sizeof(int16_values) / sizeof(sample_t), 3);
+        check_values(far_screamer::COMPACT_INT24, "int24", int24_values, sizeof(int24_values) / sizeof(sample_t), 2);
+        check_values(far_screamer::COMPACT_HALF, "half", half_values, sizeof(half_values) / sizeof(sample_t), 0);
+
+        check_round_trip(far_screamer::COMPACT_INT16, "int16", 16);
+        check_round_trip(far_screamer::COMPACT_INT24, "int24", 24);
+        check_round_trip(far_screamer::COMPACT_HALF, "half", 11);      // Precision of the mantissa
+
+        // The storage format should be specified
+        far_screamer::CompactSample cs;
+        UTEST_ASSERT(cs.init(1, LENGTH, SAMPLE_RATE, far_screamer::COMPACT_NONE) == STATUS_BAD_ARGUMENTS);
+    }
+
+UTEST_END
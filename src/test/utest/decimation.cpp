@@ -0,0 +1,134 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of far-screamer
+ * Created on: 18 окт. 2026 г.
+ *
+ * far-screamer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * far-screamer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with far-screamer. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <lsp-plug.in/test-fw/utest.h>
+#include <lsp-plug.in/test-fw/helpers.h>
+#include <lsp-plug.in/stdlib/math.h>
+#include <lsp-plug.in/dsp/dsp.h>
+#include <lsp-plug.in/dsp-units/sampling/Sample.h>
+
+#include <private/decimation.h>
+
+#define SAMPLE_RATE     48000
+#define SRC_LENGTH      0x4000
+#define IR_LENGTH       0x800
+#define MAX_ERROR       1e-2f       /* Maximum error relative to the peak of the full-rate output */
+
+UTEST_BEGIN("far_screamer", decimation)
+
+    void init_signals(dspu::Sample *in, dspu::Sample *ir)
+    {
+        UTEST_ASSERT(in->init(2, SRC_LENGTH, SRC_LENGTH));
+        UTEST_ASSERT(ir->init(2, IR_LENGTH, IR_LENGTH));
+        in->set_sample_rate(SAMPLE_RATE);
+        ir->set_sample_rate(SAMPLE_RATE);
+
+        // All frequencies are below the pass band of the maximum decimation factor
+        const float w = 2.0f * M_PI / SAMPLE_RATE;
+        for (size_t i=0; i<SRC_LENGTH; ++i)
+        {
+            in->channel(0)[i]   = 0.5f * sinf(w * 200.0f * i) + 0.3f * sinf(w * 650.0f * i) + 0.2f * sinf(w * 1000.0f * i);
+            in->channel(1)[i]   = 0.7f * sinf(w * 450.0f * i);
+        }
+        for (size_t i=0; i<IR_LENGTH; ++i)
+        {
+            ir->channel(0)[i]   = sinf(w * 400.0f * i) * expf(-float(i) / 300.0f);
+            ir->channel(1)[i]   = sinf(w * 700.0f * i) * expf(-float(i) / 200.0f);
+        }
+    }
+
+    void test_convolution(const dspu::Sample *in, const dspu::Sample *ir, size_t channel, size_t factor)
+    {
+        dspu::Sample d_in, d_ir, d_out, out, full;
+        size_t length   = SRC_LENGTH + IR_LENGTH;
+
+        printf("Testing decimated convolution of channel %d with factor %d\n", int(channel), int(factor));
+
+        // Compute the full-rate convolution
+        UTEST_ASSERT(full.init(1, length, length));
+        float *ref      = full.channel(0);
+        dsp::fill_zero(ref, length);
+        dsp::convolve(ref, in->channel(channel), ir->channel(channel), IR_LENGTH, SRC_LENGTH);
+        float peak      = dsp::abs_max(ref, length);
+
+        // Convolve at the reduced sample rate, the decimated IR requires the gain to be multiplied by the factor
+        UTEST_ASSERT(far_screamer::decimate_sample(&d_in, in, factor, NULL) == STATUS_OK);
+        UTEST_ASSERT(far_screamer::decimate_sample(&d_ir, ir, factor, NULL) == STATUS_OK);
+        UTEST_ASSERT(d_in.sample_rate() == SAMPLE_RATE / factor);
+        UTEST_ASSERT(d_in.length() == (SRC_LENGTH + factor - 1) / factor);
+        UTEST_ASSERT(d_ir.length() == (IR_LENGTH + factor - 1) / factor);
+
+        size_t d_length = d_in.length() + d_ir.length();
+        UTEST_ASSERT(d_out.init(1, d_length, d_length));
+        dsp::fill_zero(d_out.channel(0), d_length);
+        dsp::convolve(d_out.channel(0), d_in.channel(channel), d_ir.channel(channel), d_ir.length(), d_in.length());
+        dsp::mul_k2(d_out.channel(0), float(factor), d_length);
+
+        // Interpolate back to the original sample rate and compare with the full-rate convolution
+        UTEST_ASSERT(out.init(1, length, length));
+        dsp::fill_zero(out.channel(0), length);
+        UTEST_ASSERT(far_screamer::interpolate_channel(&out, &d_out, 0, 0, 0, factor, 1.0f) == STATUS_OK);
+
+        // Transients of the filters at the edges of the signal are not compared
+        const float *dst    = out.channel(0);
+        size_t guard        = IR_LENGTH;
+        float max_err       = 0.0f;
+        for (size_t i=guard; i<SRC_LENGTH - guard; ++i)
+            max_err             = lsp_max(max_err, fabsf(dst[i] - ref[i]));
+
+        printf("  maximum error: %f of peak %f\n", max_err, peak);
+        UTEST_ASSERT_MSG(max_err <= peak * MAX_ERROR,
+            "error %f exceeds %f for factor %d", max_err, peak * MAX_ERROR, int(factor));
+    }
+
+    void test_unused_channels(const dspu::Sample *in, size_t factor)
+    {
+        dspu::Sample all, part;
+        const bool used[] = { false, true };
+
+        printf("Testing decimation of used channels with factor %d\n", int(factor));
+        UTEST_ASSERT(far_screamer::decimate_sample(&all, in, factor, NULL) == STATUS_OK);
+        UTEST_ASSERT(far_screamer::decimate_sample(&part, in, factor, used) == STATUS_OK);
+        UTEST_ASSERT(part.channels() == in->channels());
+        UTEST_ASSERT(part.length() == all.length());
+
+        for (size_t i=0, n=part.length(); i<n; ++i)
+        {
+            UTEST_ASSERT_MSG(part.channel(0)[i] == 0.0f, "sample %d of unused channel is not zero", int(i));
+            UTEST_ASSERT_MSG(part.channel(1)[i] == all.channel(1)[i],
+                "sample %d: %f != %f", int(i), part.channel(1)[i], all.channel(1)[i]);
+        }
+    }
+
+    UTEST_MAIN
+    {
+        dspu::Sample in, ir;
+        init_signals(&in, &ir);
+
+        for (size_t factor=2; factor<=8; factor *= 2)
+        {
+            test_convolution(&in, &ir, 0, factor);
+            test_convolution(&in, &ir, 1, factor);
+            test_unused_channels(&in, factor);
+        }
+    }
+
+UTEST_END
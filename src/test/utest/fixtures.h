@@ -0,0 +1,181 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of far-screamer
+ * Created on: 18 окт. 2026 г.
+ *
+ * far-screamer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * far-screamer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with far-screamer. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef TEST_UTEST_FIXTURES_H_
+#define TEST_UTEST_FIXTURES_H_
+
+#include <lsp-plug.in/common/types.h>
+#include <lsp-plug.in/common/status.h>
+#include <lsp-plug.in/io/Path.h>
+#include <lsp-plug.in/lltl/parray.h>
+#include <lsp-plug.in/runtime/LSPString.h>
+#include <lsp-plug.in/stdlib/math.h>
+#include <lsp-plug.in/stdlib/stdio.h>
+#include <lsp-plug.in/dsp-units/sampling/Sample.h>
+
+#include <private/audio.h>
+#include <private/tool.h>
+
+namespace far_screamer
+{
+    /**
+     * Fixtures shared by unit tests which render files with the command-line tool
+     */
+    namespace test
+    {
+        using namespace lsp;
+
+        /**
+         * Form the path of the temporary file of the test: <dir>/utest-<test>-<name>
+         *
+         * @param dst string to store the path
+         * @param dir temporary directory
+         * @param test name of the test
+         * @param name name of the file
+         * @return true on success
+         */
+        inline bool temp_path(LSPString *dst, const char *dir, const char *test, const char *name)
+        {
+            io::Path path;
+            char buf[0x100];
+            snprintf(buf, sizeof(buf), "utest-%s-%s", test, name);
+            return (path.set(dir) == STATUS_OK) &&
+                (path.append_child(buf) == STATUS_OK) &&
+                (dst->set(path.as_string()));
+        }
+
+        /**
+         * Remove the file if it exists
+         *
+         * @param name name of the file
+         * @param ext extension appended to the name of the file, may be NULL
+         */
+        inline void remove_file(const LSPString *name, const char *ext = NULL)
+        {
+            io::Path path;
+            if (path.set(name) != STATUS_OK)
+                return;
+            if ((ext == NULL) || (path.concat(ext) == STATUS_OK))
+                path.remove();
+        }
+
+        /**
+         * Check that the regular file exists
+         *
+         * @param name name of the file
+         * @param ext extension appended to the name of the file, may be NULL
+         * @return true if the file exists
+         */
+        inline bool file_exists(const LSPString *name, const char *ext = NULL)
+        {
+            io::Path path;
+            if (path.set(name) != STATUS_OK)
+                return false;
+            if ((ext != NULL) && (path.concat(ext) != STATUS_OK))
+                return false;
+            return path.is_reg();
+        }
+
+        /**
+         * Fill the sample with the white noise of the linear congruential generator,
+         * the noise decays exponentially with the specified rate
+         *
+         * @param s sample to initialize
+         * @param channels number of channels
+         * @param length length of the sample
+         * @param sample_rate sample rate
+         * @param decay decay rate per sample, 0 for the noise without decay
+         * @param seed seed of the generator
+         * @return true on success
+         */
+        inline bool make_noise(dspu::Sample *s, size_t channels, size_t length, size_t sample_rate, float decay, uint32_t seed)
+        {
+            if (!s->init(channels, length, length))
+                return false;
+            s->set_sample_rate(sample_rate);
+
+            for (size_t i=0; i<s->channels(); ++i)
+            {
+                float *dst = s->channel(i);
+                for (size_t j=0; j<length; ++j)
+                {
+                    seed            = seed * 1664525 + 1013904223;
+                    dst[j]          = float(int32_t(seed)) * (0.25f / 2147483648.0f) * expf(-decay * j);
+                }
+            }
+
+            return true;
+        }
+
+        /**
+         * Save the sample to the temporary file of the test
+         *
+         * @param path string to store the path of the file
+         * @param s sample to save
+         * @param dir temporary directory
+         * @param test name of the test
+         * @param name name of the file
+         * @return status of operation
+         */
+        inline status_t save_temp_file(LSPString *path, dspu::Sample *s, const char *dir, const char *test, const char *name)
+        {
+            if (!temp_path(path, dir, test, name))
+                return STATUS_NO_MEM;
+            return save_audio_file(s, path);
+        }
+
+        /**
+         * Run the command-line tool, the name of the tool is passed as the first argument
+         *
+         * @param args arguments terminated by NULL
+         * @return status of operation
+         */
+        inline int run_tool(const char * const *args)
+        {
+            lltl::parray<char> argv;
+            if (!argv.add(const_cast<char *>("far-screamer")))
+                return STATUS_NO_MEM;
+            for ( ; *args != NULL; ++args)
+                if (!argv.add(const_cast<char *>(*args)))
+                    return STATUS_NO_MEM;
+
+            return main(argv.size(), const_cast<const char **>(argv.array()));
+        }
+
+        /**
+         * Find the first sample which differs in two buffers
+         *
+         * @param a first buffer
+         * @param b second buffer
+         * @param count number of samples to compare
+         * @return index of the first different sample, -1 if buffers are equal
+         */
+        inline ssize_t find_difference(const float *a, const float *b, size_t count)
+        {
+            for (size_t i=0; i<count; ++i)
+                if (a[i] != b[i])
+                    return i;
+            return -1;
+        }
+    }
+}
+
+#endif /* TEST_UTEST_FIXTURES_H_ */
@@ -0,0 +1,165 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of far-screamer
+ * Created on: 18 окт. 2026 г.
+ *
+ * far-screamer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * far-screamer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with far-screamer. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <lsp-plug.in/test-fw/utest.h>
+#include <lsp-plug.in/test-fw/helpers.h>
+#include <lsp-plug.in/runtime/LSPString.h>
+#include <lsp-plug.in/stdlib/stdio.h>
+#include <lsp-plug.in/dsp-units/sampling/Sample.h>
+
+#include <private/audio.h>
+
+#include "fixtures.h"
+
+#define SAMPLE_RATE         8000
+#define IN_LENGTH           (SAMPLE_RATE * 30 + 123)
+#define IR_LENGTH           (SAMPLE_RATE / 10)
+#define SHARDS              3
+
+UTEST_BEGIN("far_screamer", merge)
+
+    void make_path(LSPString *dst, const char *name)
+    {
+        UTEST_ASSERT(far_screamer::test::temp_path(dst, tempdir(), full_name(), name));
+    }
+
+    void make_file(LSPString *path, const char *name, size_t length, float decay, uint32_t seed)
+    {
+        dspu::Sample s;
+        UTEST_ASSERT(far_screamer::test::make_noise(&s, 2, length, SAMPLE_RATE, decay, seed));
+        UTEST_ASSERT(far_screamer::test::save_temp_file(path, &s, tempdir(), full_name(), name) == STATUS_OK);
+    }
+
+    int render(const LSPString *out, const LSPString *in, const LSPString *ir, const char *predelay, const char *shard)
+    {
+        const char *args[13];
+        size_t n = 0;
+        args[n++]   = "-if";
+        args[n++]   = in->get_native();
+        args[n++]   = "-ir";
+        args[n++]   = ir->get_native();
+        args[n++]   = "-of";
+        args[n++]   = out->get_native();
+        args[n++]   = "-pd";
+        args[n++]   = predelay;
+        if (shard != NULL)
+        {
+            args[n++]   = "-sh";
+            args[n++]   = shard;
+        }
+        else
+        {
+            args[n++]   = "-n";
+            args[n++]   = "above";
+        }
+        args[n++]   = NULL;
+
+        return far_screamer::test::run_tool(args);
+    }
+
+    int merge(const LSPString *out, const LSPString *const *shards, size_t count)
+    {
+        const char *args[17];
+        size_t n = 0;
+        for (size_t i=0; i<count; ++i)
+        {
+            args[n++]   = "-mg";
+            args[n++]   = shards[i]->get_native();
+        }
+        args[n++]   = "-n";
+        args[n++]   = "above";
+        args[n++]   = "-of";
+        args[n++]   = out->get_native();
+        args[n++]   = NULL;
+
+        return far_screamer::test::run_tool(args);
+    }
+
+    UTEST_MAIN
+    {
+        LSPString in, ir, single, merged, other, shard[SHARDS];
+        dspu::Sample a, b;
+        char name[0x40];
+        int res;
+
+        make_file(&in, "in.wav", IN_LENGTH, 0.0f, 1);
+        make_file(&ir, "ir.wav", IR_LENGTH, 5.0f / IR_LENGTH, 2);
+        make_path(&single, "single.wav");
+        make_path(&merged, "merged.wav");
+        make_path(&other, "other.wav");
+
+        printf("Testing single-process render\n");
+        res = render(&single, &in, &ir, "10", NULL);
+        UTEST_ASSERT_MSG(res == STATUS_OK, "render failed with code %d", res);
+
+        printf("Testing render of shards\n");
+        for (size_t i=0; i<SHARDS; ++i)
+        {
+            char index[0x20];
+            snprintf(name, sizeof(name), "shard-%d.wav", int(i));
+            snprintf(index, sizeof(index), "%d/%d", int(i), int(SHARDS));
+            make_path(&shard[i], name);
+            res = render(&shard[i], &in, &ir, "10", index);
+            UTEST_ASSERT_MSG(res == STATUS_OK, "render of shard %d failed with code %d", int(i), res);
+        }
+
+        // The merged output should match the output of the single process bit for bit
+        printf("Testing merge of shards\n");
+        const LSPString *list[SHARDS] = { &shard[0], &shard[1], &shard[2] };
+        res = merge(&merged, list, SHARDS);
+        UTEST_ASSERT_MSG(res == STATUS_OK, "merge failed with code %d", res);
+
+        UTEST_ASSERT(far_screamer::load_audio_file(&a, -1, &single, NULL, NULL) == STATUS_OK);
+        UTEST_ASSERT(far_screamer::load_audio_file(&b, -1, &merged, NULL, NULL) == STATUS_OK);
+        UTEST_ASSERT(a.channels() == b.channels());
+        UTEST_ASSERT_MSG(a.length() == b.length(), "length %d != %d", int(a.length()), int(b.length()));
+        for (size_t i=0; i<a.channels(); ++i)
+        {
+            ssize_t idx = far_screamer::test::find_difference(a.channel(i), b.channel(i), a.length());
+            UTEST_ASSERT_MSG(idx < 0, "channel %d sample %d: %.10f != %.10f",
+                int(i), int(idx), a.channel(i)[idx], b.channel(i)[idx]);
+        }
+
+        // Shards in the wrong order, the incomplete set of shards and shards of another job are rejected
+        printf("Testing validation of shards\n");
+        const LSPString *swapped[SHARDS] = { &shard[1], &shard[0], &shard[2] };
+        UTEST_ASSERT(merge(&other, swapped, SHARDS) != STATUS_OK);
+        UTEST_ASSERT(merge(&other, list, SHARDS - 1) != STATUS_OK);
+
+        res = render(&other, &in, &ir, "20", "2/3");
+        UTEST_ASSERT_MSG(res == STATUS_OK, "render of shard failed with code %d", res);
+        const LSPString *mixed[SHARDS] = { &shard[0], &shard[1], &other };
+        UTEST_ASSERT(merge(&merged, mixed, SHARDS) != STATUS_OK);
+
+        far_screamer::test::remove_file(&in, NULL);
+        far_screamer::test::remove_file(&ir, NULL);
+        far_screamer::test::remove_file(&single, NULL);
+        far_screamer::test::remove_file(&merged, NULL);
+        far_screamer::test::remove_file(&other, NULL);
+        far_screamer::test::remove_file(&other, ".shard");
+        for (size_t i=0; i<SHARDS; ++i)
+        {
+            far_screamer::test::remove_file(&shard[i], NULL);
+            far_screamer::test::remove_file(&shard[i], ".shard");
+        }
+    }
+
+UTEST_END
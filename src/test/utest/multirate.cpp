@@ -0,0 +1,86 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of far-screamer
+ * Created on: 18 окт. 2026 г.
+ *
+ * far-screamer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * far-screamer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with far-screamer. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <lsp-plug.in/test-fw/utest.h>
+#include <lsp-plug.in/test-fw/helpers.h>
+#include <lsp-plug.in/stdlib/math.h>
+#include <lsp-plug.in/dsp/dsp.h>
+#include <lsp-plug.in/dsp-units/sampling/Sample.h>
+
+#include <private/multirate.h>
+
+#define IR_LENGTH       0x4000
+#define IR_SPLIT        0x1000
+
+UTEST_BEGIN("far_screamer", multirate)
+
+    void test_split(const dspu::Sample *ir, size_t factor)
+    {
+        dspu::Sample early, late;
+        size_t offset = 0;
+
+        printf("Testing split of impulse response for factor %d\n", int(factor));
+        UTEST_ASSERT(far_screamer::split_impulse_response(&early, &late, &offset, ir, IR_SPLIT, factor) == STATUS_OK);
+        UTEST_ASSERT(early.length() == IR_SPLIT);
+        UTEST_ASSERT(offset < IR_SPLIT);
+        UTEST_ASSERT((offset % factor) == 0);
+        UTEST_ASSERT(late.length() == IR_LENGTH - offset);
+
+        // The sum of both parts should give the original impulse response
+        for (size_t i=0; i<ir->channels(); ++i)
+        {
+            const float *src    = ir->channel(i);
+            const float *e      = early.channel(i);
+            const float *l      = late.channel(i);
+
+            for (size_t j=0; j<IR_LENGTH; ++j)
+            {
+                float v     = (j < IR_SPLIT) ? e[j] : 0.0f;
+                if (j >= offset)
+                    v          += l[j - offset];
+                UTEST_ASSERT_MSG(float_equals_absolute(v, src[j], 1e-6f),
+                    "channel %d sample %d: %f != %f", int(i), int(j), v, src[j]);
+            }
+        }
+
+        // Split points out of the impulse response are not allowed
+        UTEST_ASSERT(far_screamer::split_impulse_response(&early, &late, &offset, ir, 0, factor) != STATUS_OK);
+        UTEST_ASSERT(far_screamer::split_impulse_response(&early, &late, &offset, ir, IR_LENGTH, factor) != STATUS_OK);
+    }
+
+    UTEST_MAIN
+    {
+        dspu::Sample ir;
+        UTEST_ASSERT(ir.init(2, IR_LENGTH, IR_LENGTH));
+        ir.set_sample_rate(48000);
+
+        for (size_t i=0; i<IR_LENGTH; ++i)
+        {
+            ir.channel(0)[i]    = ((i & 1) ? 0.5f : -0.5f) * expf(-1e-3f * i);
+            ir.channel(1)[i]    = sinf(i * 0.01f) * expf(-2e-3f * i);
+        }
+
+        test_split(&ir, 2);
+        test_split(&ir, 4);
+        test_split(&ir, 8);
+    }
+
+UTEST_END
@@ -0,0 +1,117 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of far-screamer
+ * Created on: 18 окт. 2026 г.
+ *
+ * far-screamer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * far-screamer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with far-screamer. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <lsp-plug.in/test-fw/utest.h>
+#include <lsp-plug.in/test-fw/helpers.h>
+#include <lsp-plug.in/common/alloc.h>
+#include <lsp-plug.in/stdlib/math.h>
+#include <lsp-plug.in/dsp/dsp.h>
+
+#include <private/PairConvolver.h>
+
+#define SRC_LENGTH      0x3000
+
+UTEST_BEGIN("far_screamer", pairconv)
+
+    void test_convolution(size_t ir_length, size_t rank)
+    {
+        uint8_t *data   = NULL;
+        size_t total    = SRC_LENGTH + ir_length;
+        float *src0     = alloc_aligned<float>(data, SRC_LENGTH * 2 + ir_length * 2 + total * 4);
+        UTEST_ASSERT(src0 != NULL);
+        float *src1     = &src0[SRC_LENGTH];
+        float *ir0      = &src1[SRC_LENGTH];
+        float *ir1      = &ir0[ir_length];
+        float *ref0     = &ir1[ir_length];
+        float *ref1     = &ref0[total];
+        float *dst0     = &ref1[total];
+        float *dst1     = &dst0[total];
+
+        printf("Testing convolution with IR of %d samples, rank=%d\n", int(ir_length), int(rank));
+
+        // Prepare data
+        for (size_t i=0; i<SRC_LENGTH; ++i)
+        {
+            src0[i]         = sinf(i * 0.05f);
+            src1[i]         = ((i % 7) < 3) ? 0.5f : -0.25f;
+        }
+        for (size_t i=0; i<ir_length; ++i)
+        {
+            ir0[i]          = cosf(i * 0.3f) * expf(-5.0f * i / ir_length);
+            ir1[i]          = ((i & 1) ? 0.3f : -0.6f) * expf(-3.0f * i / ir_length);
+        }
+
+        // Compute reference data
+        dsp::fill_zero(ref0, total);
+        dsp::fill_zero(ref1, total);
+        dsp::convolve(ref0, src0, ir0, ir_length, SRC_LENGTH);
+        dsp::convolve(ref1, src1, ir1, ir_length, SRC_LENGTH);
+
+        // Process data with blocks of different size, flush the convolver with silence
+        far_screamer::PairConvolver cv;
+        UTEST_ASSERT(cv.init(ir0, ir1, ir_length, rank));
+        size_t latency  = cv.latency();
+
+        dsp::copy(dst0, src0, SRC_LENGTH);
+        dsp::copy(dst1, src1, SRC_LENGTH);
+        dsp::fill_zero(&dst0[SRC_LENGTH], ir_length);
+        dsp::fill_zero(&dst1[SRC_LENGTH], ir_length);
+        for (size_t offset=0, step=1; offset < total; step = (step * 3 + 1) % 1000)
+        {
+            size_t to_do    = lsp_min(step, total - offset);
+            cv.process(&dst0[offset], &dst1[offset], &dst0[offset], &dst1[offset], to_do);
+            offset         += to_do;
+        }
+
+        // Compare data
+        for (size_t i=latency; i<total; ++i)
+        {
+            UTEST_ASSERT_MSG(float_equals_adaptive(dst0[i], ref0[i - latency], 1e-3f),
+                "channel 0 sample %d: %f != %f", int(i), dst0[i], ref0[i - latency]);
+            UTEST_ASSERT_MSG(float_equals_adaptive(dst1[i], ref1[i - latency], 1e-3f),
+                "channel 1 sample %d: %f != %f", int(i), dst1[i], ref1[i - latency]);
+        }
+
+        // Single-channel mode
+        UTEST_ASSERT(cv.init(ir0, NULL, ir_length, rank));
+        dsp::copy(dst0, src0, SRC_LENGTH);
+        dsp::fill_zero(&dst0[SRC_LENGTH], ir_length);
+        cv.process(dst0, NULL, dst0, NULL, total);
+        for (size_t i=latency; i<total; ++i)
+        {
+            UTEST_ASSERT_MSG(float_equals_adaptive(dst0[i], ref0[i - latency], 1e-3f),
+                "channel 0 sample %d: %f != %f", int(i), dst0[i], ref0[i - latency]);
+        }
+
+        cv.destroy();
+        free_aligned(data);
+    }
+
+    UTEST_MAIN
+    {
+        test_convolution(1, 10);
+        test_convolution(100, 10);
+        test_convolution(1000, 8);
+        test_convolution(0x1000, 10);
+        test_convolution(5000, 16);
+    }
+
+UTEST_END
@@ -0,0 +1,228 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of far-screamer
+ * Created on: 18 окт. 2026 г.
+ *
+ * far-screamer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * far-screamer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with far-screamer. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <lsp-plug.in/test-fw/utest.h>
+#include <lsp-plug.in/test-fw/helpers.h>
+#include <lsp-plug.in/runtime/LSPString.h>
+#include <lsp-plug.in/stdlib/stdio.h>
+#include <lsp-plug.in/dsp-units/sampling/Sample.h>
+
+#include <far-screamer/Processor.h>
+#include <private/Arena.h>
+#include <private/audio.h>
+
+#include "fixtures.h"
+
+#ifdef PLATFORM_UNIX_COMPATIBLE
+    #include <pthread.h>
+#endif /* PLATFORM_UNIX_COMPATIBLE */
+
+#define SAMPLE_RATE         8000
+#define IN_LENGTH           (SAMPLE_RATE * 5 + 321)
+#define IR_LENGTH           (SAMPLE_RATE / 10)
+#define THREADS             2
+
+UTEST_BEGIN("far_screamer", processor)
+
+    typedef struct counter_t
+    {
+        size_t  messages;
+        size_t  progress;
+    } counter_t;
+
+    typedef struct worker_t
+    {
+        far_screamer::Processor    *proc;
+        const dspu::Sample         *in;
+        const LSPString            *in_file;
+        LSPString                   out_file;
+        dspu::Sample                out;
+        status_t                    buffer_res;
+        status_t                    file_res;
+        size_t                      reserved;
+    } worker_t;
+
+    static void on_log(void *arg, far_screamer::log_level_t /* level */, const char * /* message */)
+    {
+        counter_t *c = static_cast<counter_t *>(arg);
+        ++c->messages;
+    }
+
+    static void on_progress(void *arg, float /* progress */)
+    {
+        counter_t *c = static_cast<counter_t *>(arg);
+        ++c->progress;
+    }
+
+    static void *process_worker(void *arg)
+    {
+        worker_t *w     = static_cast<worker_t *>(arg);
+        w->buffer_res   = w->proc->process(&w->out, w->in);
+        w->file_res     = w->proc->process(&w->out_file, w->in_file);
+        w->reserved     = far_screamer::thread_arena()->reserved();
+        return NULL;
+    }
+
+    void make_path(LSPString *dst, const char *name)
+    {
+        UTEST_ASSERT(far_screamer::test::temp_path(dst, tempdir(), full_name(), name));
+    }
+
+    void check_same(const dspu::Sample *a, const dspu::Sample *b, const char *what)
+    {
+        UTEST_ASSERT(a->channels() == b->channels());
+        UTEST_ASSERT_MSG(a->length() == b->length(), "%s: length %d != %d", what, int(a->length()), int(b->length()));
+        for (size_t i=0; i<a->channels(); ++i)
+        {
+            ssize_t idx = far_screamer::test::find_difference(a->channel(i), b->channel(i), a->length());
+            UTEST_ASSERT_MSG(idx < 0, "%s: channel %d sample %d: %.10f != %.10f",
+                what, int(i), int(idx), a->channel(i)[idx], b->channel(i)[idx]);
+        }
+    }
+
+    void check_concurrent(far_screamer::Processor *proc, const dspu::Sample *ref,
+        const dspu::Sample *in, const LSPString *in_file)
+    {
+    #ifdef PLATFORM_UNIX_COMPATIBLE
+        worker_t w[THREADS];
+        pthread_t tid[THREADS];
+        dspu::Sample file;
+        char name[0x20];
+
+        for (size_t i=0; i<THREADS; ++i)
+        {
+            snprintf(name, sizeof(name), "out-%d.wav", int(i));
+            make_path(&w[i].out_file, name);
+            w[i].proc       = proc;
+            w[i].in         = in;
+            w[i].in_file    = in_file;
+            w[i].buffer_res = STATUS_UNKNOWN_ERR;
+            w[i].file_res   = STATUS_UNKNOWN_ERR;
+            w[i].reserved   = 0;
+        }
+
+        for (size_t i=0; i<THREADS; ++i)
+            UTEST_ASSERT(pthread_create(&tid[i], NULL, process_worker, &w[i]) == 0);
+        for (size_t i=0; i<THREADS; ++i)
+            UTEST_ASSERT(pthread_join(tid[i], NULL) == 0);
+
+        for (size_t i=0; i<THREADS; ++i)
+        {
+            UTEST_ASSERT_MSG(w[i].buffer_res == STATUS_OK, "thread %d: buffer failed with code %d", int(i), int(w[i].buffer_res));
+            UTEST_ASSERT_MSG(w[i].file_res == STATUS_OK, "thread %d: file failed with code %d", int(i), int(w[i].file_res));
+            UTEST_ASSERT(w[i].reserved == 0);
+            check_same(ref, &w[i].out, "concurrent buffer");
+            UTEST_ASSERT(far_screamer::load_audio_file(&file, -1, &w[i].out_file, NULL, NULL) == STATUS_OK);
+            check_same(ref, &file, "concurrent file");
+            far_screamer::test::remove_file(&w[i].out_file);
+        }
+    #endif /* PLATFORM_UNIX_COMPATIBLE */
+    }
+
+    UTEST_MAIN
+    {
+        LSPString in_file, ir_file, ref_file, out_file;
+        dspu::Sample in, ir, ref, out, file;
+        counter_t def, own;
+        far_screamer::callbacks_t def_cb, own_cb;
+        far_screamer::config_t cfg;
+        far_screamer::Processor proc;
+        far_screamer::Arena *arena = far_screamer::thread_arena();
+
+        UTEST_ASSERT(far_screamer::test::make_noise(&in, 2, IN_LENGTH, SAMPLE_RATE, 0.0f, 1));
+        UTEST_ASSERT(far_screamer::test::make_noise(&ir, 2, IR_LENGTH, SAMPLE_RATE, 5.0f / IR_LENGTH, 2));
+        UTEST_ASSERT(far_screamer::test::save_temp_file(&in_file, &in, tempdir(), full_name(), "in.wav") == STATUS_OK);
+        UTEST_ASSERT(far_screamer::test::save_temp_file(&ir_file, &ir, tempdir(), full_name(), "ir.wav") == STATUS_OK);
+        make_path(&ref_file, "ref.wav");
+        make_path(&out_file, "out.wav");
+
+        // The reference is rendered by the command-line tool
+        printf("Testing render of the reference file\n");
+        const char *args[] =
+        {
+            "-if", in_file.get_native(),
+            "-ir", ir_file.get_native(),
+            "-of", ref_file.get_native(),
+            "-dg", "-3",
+            "-pd", "5",
+            NULL
+        };
+        int res = far_screamer::test::run_tool(args);
+        UTEST_ASSERT_MSG(res == STATUS_OK, "render failed with code %d", res);
+        UTEST_ASSERT(far_screamer::load_audio_file(&ref, -1, &ref_file, NULL, NULL) == STATUS_OK);
+
+        // Callbacks passed to init() are used by processing calls without own callbacks
+        printf("Testing initialization of the processor\n");
+        def.messages    = 0;
+        def.progress    = 0;
+        own.messages    = 0;
+        own.progress    = 0;
+        def_cb.log      = on_log;
+        def_cb.progress = on_progress;
+        def_cb.arg      = &def;
+        own_cb.log      = on_log;
+        own_cb.progress = on_progress;
+        own_cb.arg      = &own;
+
+        UTEST_ASSERT(cfg.sIRFile.set(&ir_file));
+        cfg.nSampleRate = SAMPLE_RATE;
+        cfg.fDry        = -3.0f;
+        cfg.fPreDelay   = 5.0f;
+        UTEST_ASSERT(proc.init(&cfg, &def_cb) == STATUS_OK);
+        UTEST_ASSERT(proc.init(&cfg, &def_cb) == STATUS_BAD_STATE);
+        UTEST_ASSERT(def.messages > 0);
+        UTEST_ASSERT(arena->reserved() == 0);
+
+        printf("Testing processing of buffers\n");
+        size_t messages = def.messages;
+        UTEST_ASSERT(proc.process(&out, &in) == STATUS_OK);
+        UTEST_ASSERT(def.messages > messages);
+        UTEST_ASSERT(arena->reserved() == 0);
+        check_same(&ref, &out, "buffer");
+
+        messages        = def.messages;
+        UTEST_ASSERT(proc.process(&out, &in, &own_cb) == STATUS_OK);
+        UTEST_ASSERT(def.messages == messages);
+        UTEST_ASSERT(own.messages > 0);
+        UTEST_ASSERT(arena->reserved() == 0);
+        check_same(&ref, &out, "buffer with callbacks");
+
+        printf("Testing processing of files\n");
+        UTEST_ASSERT(proc.process(&out_file, &in_file) == STATUS_OK);
+        UTEST_ASSERT(arena->reserved() == 0);
+        UTEST_ASSERT(far_screamer::load_audio_file(&file, -1, &out_file, NULL, NULL) == STATUS_OK);
+        check_same(&ref, &file, "file");
+
+        // Buffers and files are processed by several threads at the same time
+        printf("Testing concurrent processing\n");
+        check_concurrent(&proc, &ref, &in, &in_file);
+
+        // The processor can not be used after destruction
+        proc.destroy();
+        UTEST_ASSERT(proc.process(&out, &in) == STATUS_BAD_STATE);
+
+        far_screamer::test::remove_file(&in_file);
+        far_screamer::test::remove_file(&ir_file);
+        far_screamer::test::remove_file(&ref_file);
+        far_screamer::test::remove_file(&out_file);
+    }
+
+UTEST_END
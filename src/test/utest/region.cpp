@@ -0,0 +1,132 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of far-screamer
+ * Created on: 18 окт. 2026 г.
+ *
+ * far-screamer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * far-screamer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with far-screamer. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <lsp-plug.in/test-fw/utest.h>
+#include <lsp-plug.in/test-fw/helpers.h>
+#include <lsp-plug.in/runtime/LSPString.h>
+#include <lsp-plug.in/stdlib/stdio.h>
+#include <lsp-plug.in/dsp-units/sampling/Sample.h>
+
+#include <private/audio.h>
+
+#include "fixtures.h"
+
+#define SAMPLE_RATE         8000
+#define IN_LENGTH           (SAMPLE_RATE * 160)     /* Covers several aligned blocks for the decimation factor 8 */
+#define IR_LENGTH           (SAMPLE_RATE / 10)
+#define REGION_START        "140.1234"
+#define REGION_END          "150.0"
+
+UTEST_BEGIN("far_screamer", region)
+
+    typedef struct setup_t
+    {
+        const char *name;
+        const char *args[4];
+    } setup_t;
+
+    void make_file(LSPString *path, const char *name, size_t length, float decay, uint32_t seed)
+    {
+        dspu::Sample s;
+        UTEST_ASSERT(far_screamer::test::make_noise(&s, 2, length, SAMPLE_RATE, decay, seed));
+        UTEST_ASSERT(far_screamer::test::save_temp_file(path, &s, tempdir(), full_name(), name) == STATUS_OK);
+    }
+
+    void render(dspu::Sample *out, const setup_t *setup, const LSPString *in, const LSPString *ir, const char *name, bool region)
+    {
+        LSPString path;
+        const char *argv[16];
+        size_t n = 0;
+        UTEST_ASSERT(far_screamer::test::temp_path(&path, tempdir(), full_name(), name));
+
+        argv[n++]   = "-if";
+        argv[n++]   = in->get_native();
+        argv[n++]   = "-ir";
+        argv[n++]   = ir->get_native();
+        argv[n++]   = "-of";
+        argv[n++]   = path.get_native();
+        for (size_t i=0; (i < 4) && (setup->args[i] != NULL); ++i)
+            argv[n++]   = setup->args[i];
+        if (region)
+        {
+            argv[n++]   = "-rs";
+            argv[n++]   = REGION_START;
+            argv[n++]   = "-re";
+            argv[n++]   = REGION_END;
+        }
+        argv[n]     = NULL;
+
+        int res = far_screamer::test::run_tool(argv);
+        UTEST_ASSERT_MSG(res == STATUS_OK, "rendering of '%s' failed with code %d", path.get_native(), res);
+        UTEST_ASSERT(far_screamer::load_audio_file(out, -1, &path, NULL, NULL) == STATUS_OK);
+
+        far_screamer::test::remove_file(&path);
+    }
+
+    void test_region(const setup_t *setup, const LSPString *in, const LSPString *ir)
+    {
+        dspu::Sample full, part;
+        char name[0x40];
+
+        printf("Testing region of %s render\n", setup->name);
+        snprintf(name, sizeof(name), "%s-full.wav", setup->name);
+        render(&full, setup, in, ir, name, false);
+        snprintf(name, sizeof(name), "%s-region.wav", setup->name);
+        render(&part, setup, in, ir, name, true);
+
+        // The region should match the slice of the whole output bit for bit
+        size_t start    = size_t(atof(REGION_START) * SAMPLE_RATE + 0.5);
+        size_t end      = size_t(atof(REGION_END) * SAMPLE_RATE + 0.5);
+        UTEST_ASSERT(full.channels() == part.channels());
+        UTEST_ASSERT(full.length() >= end);
+        UTEST_ASSERT_MSG(part.length() == end - start, "region length %d != %d", int(part.length()), int(end - start));
+
+        for (size_t i=0; i<full.channels(); ++i)
+        {
+            const float *a  = &full.channel(i)[start];
+            const float *b  = part.channel(i);
+            ssize_t j       = far_screamer::test::find_difference(a, b, part.length());
+            UTEST_ASSERT_MSG(j < 0, "%s: channel %d sample %d: %.10f != %.10f",
+                setup->name, int(i), int(start + j), a[j], b[j]);
+        }
+    }
+
+    UTEST_MAIN
+    {
+        static const setup_t setups[] =
+        {
+            { "plain",      { NULL                                      } },
+            { "decimated",  { "-dc", "-lp", "BWC_BT:4:300", NULL        } },   // Decimation factor 8
+            { "multirate",  { "-ms", "20", "-mf", "4"                   } },
+        };
+
+        LSPString in, ir;
+        make_file(&in, "in.wav", IN_LENGTH, 0.0f, 1);
+        make_file(&ir, "ir.wav", IR_LENGTH, 5.0f / IR_LENGTH, 2);
+
+        for (size_t i=0; i<sizeof(setups)/sizeof(setup_t); ++i)
+            test_region(&setups[i], &in, &ir);
+
+        far_screamer::test::remove_file(&in);
+        far_screamer::test::remove_file(&ir);
+    }
+
+UTEST_END
@@ -0,0 +1,130 @@
+/*
+ * Copyright (C) 2026 Linux Studio Plugins Project <https://lsp-plug.in/>
+ *           (C) 2026 Vladimir Sadovnikov <sadko4u@gmail.com>
+ *
+ * This file is part of far-screamer
+ * Created on: 18 окт. 2026 г.
+ *
+ * far-screamer is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * any later version.
+ *
+ * far-screamer is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with far-screamer. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <lsp-plug.in/test-fw/utest.h>
+#include <lsp-plug.in/test-fw/helpers.h>
+#include <lsp-plug.in/runtime/LSPString.h>
+#include <lsp-plug.in/stdlib/math.h>
+#include <lsp-plug.in/stdlib/stdio.h>
+#include <lsp-plug.in/dsp-units/sampling/Sample.h>
+#include <lsp-plug.in/dsp-units/units.h>
+
+#include <private/audio.h>
+
+#include "fixtures.h"
+
+#define SAMPLE_RATE         8000
+#define IN_LENGTH           (SAMPLE_RATE / 2)
+#define IR_LENGTH           (SAMPLE_RATE * 2)
+#define TAIL_THRESHOLD      "-60"
+#define TAIL_WINDOW         "100"
+
+UTEST_BEGIN("far_screamer", tail)
+
+    void make_file(LSPString *path, const char *name, size_t length, float decay, uint32_t seed)
+    {
+        dspu::Sample s;
+        UTEST_ASSERT(far_screamer::test::make_noise(&s, 2, length, SAMPLE_RATE, decay, seed));
+        UTEST_ASSERT(far_screamer::test::save_temp_file(path, &s, tempdir(), full_name(), name) == STATUS_OK);
+    }
+
+    void render(dspu::Sample *out, const LSPString *in, const LSPString *ir, const char *name, bool truncate)
+    {
+        LSPString path;
+        const char *argv[12];
+        size_t n = 0;
+        UTEST_ASSERT(far_screamer::test::temp_path(&path, tempdir(), full_name(), name));
+
+        argv[n++]   = "-if";
+        argv[n++]   = in->get_native();
+        argv[n++]   = "-ir";
+        argv[n++]   = ir->get_native();
+        argv[n++]   = "-of";
+        argv[n++]   = path.get_native();
+        if (truncate)
+        {
+            argv[n++]   = "-tt";
+            argv[n++]   = TAIL_THRESHOLD;
+            argv[n++]   = "-tw";
+            argv[n++]   = TAIL_WINDOW;
+        }
+        argv[n]     = NULL;
+
+        int res = far_screamer::test::run_tool(argv);
+        UTEST_ASSERT_MSG(res == STATUS_OK, "rendering of '%s' failed with code %d", path.get_native(), res);
+        UTEST_ASSERT(far_screamer::load_audio_file(out, -1, &path, NULL, NULL) == STATUS_OK);
+
+        far_screamer::test::remove_file(&path);
+    }
+
+    UTEST_MAIN
+    {
+        LSPString in, ir;
+        dspu::Sample ref, cut;
+
+        // The IR decays by 20 dB per 1/4 second, the tail of the output crosses the threshold
+        // long before the end of the IR
+        make_file(&in, "in.wav", IN_LENGTH, 0.0f, 1);
+        make_file(&ir, "ir.wav", IR_LENGTH, 9.2f / SAMPLE_RATE, 2);
+
+        printf("Testing render without tail truncation\n");
+        render(&ref, &in, &ir, "ref.wav", false);
+        printf("Testing render with tail truncation\n");
+        render(&cut, &in, &ir, "cut.wav", true);
+
+        // Find the end of the last sample above the threshold in the reference
+        float threshold = dspu::db_to_gain(atof(TAIL_THRESHOLD));
+        size_t window   = size_t(atof(TAIL_WINDOW) * SAMPLE_RATE / 1000.0f + 0.5f);
+        size_t loud_end = IN_LENGTH;
+        for (size_t i=0; i<ref.channels(); ++i)
+        {
+            const float *p  = ref.channel(i);
+            for (size_t j=ref.length(); j > loud_end; --j)
+                if (fabsf(p[j-1]) >= threshold)
+                {
+                    loud_end    = j;
+                    break;
+                }
+        }
+
+        // The output should be cut within the window after the threshold crossing
+        printf("Threshold crossing at %d samples, output length %d of %d samples\n",
+            int(loud_end), int(cut.length()), int(ref.length()));
+        UTEST_ASSERT(ref.channels() == cut.channels());
+        UTEST_ASSERT(loud_end > IN_LENGTH);
+        UTEST_ASSERT(loud_end + window < ref.length());
+        UTEST_ASSERT_MSG((cut.length() >= loud_end) && (cut.length() <= loud_end + window),
+            "output length %d is out of range [%d, %d]", int(cut.length()), int(loud_end), int(loud_end + window));
+
+        // Samples before the cut should match the render without truncation
+        for (size_t i=0; i<ref.channels(); ++i)
+        {
+            const float *a  = ref.channel(i);
+            const float *b  = cut.channel(i);
+            ssize_t j       = far_screamer::test::find_difference(a, b, cut.length());
+            UTEST_ASSERT_MSG(j < 0, "channel %d sample %d: %.10f != %.10f", int(i), int(j), a[j], b[j]);
+        }
+
+        far_screamer::test::remove_file(&in);
+        far_screamer::test::remove_file(&ir);
+    }
+
+UTEST_END